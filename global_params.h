@@ -22,6 +22,8 @@
 #include "MQTTClient.h"
 #include "MQTTNetwork.h"
 #include "MQTTmbed.h"
+#include "latency_trace.h"
+#include "param_control.h"
 
 /* Factory-set Device UUID */
 extern const std::string device_uuid;
@@ -36,42 +38,69 @@ extern Mutex mqtt_mutex;
 /* Event flags */
 extern EventFlags event_flags;
 const uint32_t FLAG_MQTT_OK = (1U << 1);    // Signals MQTT is up
+const uint32_t FLAG_WAKE_COMMS = (1U << 2);     // Mail for the communications controller (idle wake-up)
+const uint32_t FLAG_WAKE_SENSOR = (1U << 3);    // Mail for the sensor thread (idle wake-up)
+const uint32_t FLAG_WAKE_BEHAVIOR = (1U << 4);  // Mail for the behavior coordinator (idle wake-up)
+const uint32_t FLAG_WAKE_EVENT = (1U << 5);     // Mail for the event manager (idle wake-up)
+
+/* Sensor data stream markers, sent as llp_sensor_mail_t::sensor_type */
+const char* const LLP_STREAM_START = "header_start";
+const char* const LLP_STREAM_END = "header_end";
 
 /* RTOS Mailboxes Declarations*/
 typedef struct {
-    char* sensor_type;
-    char* value;
-    int raw_time_stamp;
+    const char* sensor_type;    // measure point id with static lifetime, or a stream marker
+    float value;
+    uint8_t quality;            // bitmask of SensorType::ReadingQuality
+    int64_t time_stamp_ms;      // EpochMsNow() when the reading was taken
+    uint32_t read_cycles;       // DiagnosticsCycles() when the reading was taken
+#if LATENCY_TRACE_ENABLED
+    uint32_t trace_cycle;       // sample cycle of the reading, for LATENCY_TRACE()
+#endif  // LATENCY_TRACE_ENABLED
 } llp_sensor_mail_t;
 extern Mail<llp_sensor_mail_t, 256> llp_sensor_mail_box;    // Low-level platform (i/o-facing thread)
 
 typedef struct {
     char* payload;
+    uint32_t read_cycles;       // DiagnosticsCycles() of the oldest reading in the payload; 0 if not from a single stream
+#if LATENCY_TRACE_ENABLED
+    uint32_t trace_cycle;       // sample cycle that completed the payload, for LATENCY_TRACE()
+#endif  // LATENCY_TRACE_ENABLED
 } comms_upstream_mail_t;
 extern Mail<comms_upstream_mail_t, 256> comms_upstream_mail_box;
 
+/* Service responses are written straight into their mail slot */
+#define SERVICE_RESPONSE_SIZE       512     // longest service response json, terminator included
+#define SERVICE_RESPONSE_POOL_SIZE  8
+
 typedef struct {
-    char* response;     // service response json
-    char* service_id;   // service identifier
+    ControlParam param;                     // service answered, which names the response topic
+    size_t length;                          // length of response
+    char response[SERVICE_RESPONSE_SIZE];   // service response json
 } service_response_mail_t;
-extern Mail<service_response_mail_t, 256> service_response_mail_box;
+extern Mail<service_response_mail_t, SERVICE_RESPONSE_POOL_SIZE> service_response_mail_box;
 
 typedef struct {
-    char* endpoint_id;
-    char* msg_id;
-    char* param;
-    char* value;
+    ControlParam param;
+    int value;
+    char msg_id[CONTROL_MSG_ID_SIZE];
 } mqtt_arrived_mail_t;
 extern Mail<mqtt_arrived_mail_t, 128> mqtt_arrived_mail_box;
 
 typedef struct {
-    char* param;
+    ControlParam param;
     int value;
-    char* msg_id;
-    char* endpoint_id;
+    char msg_id[CONTROL_MSG_ID_SIZE];
 } sensor_control_mail_t;
 extern Mail<sensor_control_mail_t, 64> sensor_control_mail_box;
 
+typedef struct {
+    ControlParam param;
+    int value;
+    char msg_id[CONTROL_MSG_ID_SIZE];
+} behavior_control_mail_t;
+extern Mail<behavior_control_mail_t, 64> behavior_control_mail_box;
+
 /* For passing pointers to Subscription Manager Thread */
 typedef struct{
     MQTT::Client<MQTTNetwork, Countdown> **mqtt_client_ptr;
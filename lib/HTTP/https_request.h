@@ -90,15 +90,30 @@ public:
 
     virtual ~HttpsRequest() {}
 
+    /**
+     * Connect to an address resolved by the caller, instead of looking up the host of the URL.
+     * The host name is still used for SNI and verification of the server certificate.
+     *
+     * @param[in] address Address of the host of the URL
+     */
+    void set_address(const SocketAddress& address) {
+        _address = address;
+    }
+
 protected:
     virtual nsapi_error_t connect_socket(char *host, uint16_t port) {
-        SocketAddress socketAddress;
-        _network->gethostbyname(host, &socketAddress);
+        SocketAddress socketAddress = _address;
+        if (!socketAddress) {
+            _network->gethostbyname(host, &socketAddress);
+        }
         socketAddress.set_port(port);
 
         ((TLSSocket*)_socket)->set_hostname(host);
         return ((TLSSocket*)_socket)->connect(socketAddress);
     }
+
+private:
+    SocketAddress _address;
 };
 
 #endif // _MBED_HTTPS_REQUEST_H_
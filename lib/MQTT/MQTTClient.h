@@ -28,6 +28,7 @@
 #include "MQTTPacket.h"
 #include <stdio.h>
 #include "MQTTLogging.h"
+#include "MQTTTopicIndex.h"
 
 #if !defined(MQTTCLIENT_QOS1)
     #define MQTTCLIENT_QOS1 1
@@ -247,7 +248,6 @@ private:
     int readPacket(Timer& timer);
     int sendPacket(int length, Timer& timer);
     int deliverMessage(MQTTString& topicName, Message& message);
-    bool isTopicMatched(char* topicFilter, MQTTString& topicName);
 
     Network& ipstack;
     unsigned long command_timeout_ms;
@@ -262,11 +262,7 @@ private:
 
     PacketId packetid;
 
-    struct MessageHandlers
-    {
-        const char* topicFilter;
-        MQTT_FP<void, MessageData&> fp;
-    } messageHandlers[MAX_MESSAGE_HANDLERS];      // Message handlers are indexed by subscription topic
+    TopicIndex<MQTT_FP<void, MessageData&>, MAX_MESSAGE_HANDLERS> messageHandlers;      // Message handlers are indexed by subscription topic
 
     MQTT_FP<void, MessageData&> defaultMessageHandler;
 
@@ -298,8 +294,7 @@ private:
 template<class Network, class Timer, int a, int MAX_MESSAGE_HANDLERS>
 void MQTT::Client<Network, Timer, a, MAX_MESSAGE_HANDLERS>::cleanSession()
 {
-    for (int i = 0; i < MAX_MESSAGE_HANDLERS; ++i)
-        messageHandlers[i].topicFilter = 0;
+    messageHandlers.clear();
 
 #if MQTTCLIENT_QOS1 || MQTTCLIENT_QOS2
     inflightMsgid = 0;
@@ -490,62 +485,27 @@ exit:
 }
 
 
-// assume topic filter and name is in correct format
-// # can only be at end
-// + and # can only be next to separator
-template<class Network, class Timer, int a, int b>
-bool MQTT::Client<Network, Timer, a, b>::isTopicMatched(char* topicFilter, MQTTString& topicName)
-{
-    char* curf = topicFilter;
-    char* curn = topicName.lenstring.data;
-    char* curn_end = curn + topicName.lenstring.len;
-
-    while (*curf && curn < curn_end)
-    {
-        if (*curn == '/' && *curf != '/')
-            break;
-        if (*curf != '+' && *curf != '#' && *curf != *curn)
-            break;
-        if (*curf == '+')
-        {   // skip until we meet the next separator, or end of string
-            char* nextpos = curn + 1;
-            while (nextpos < curn_end && *nextpos != '/')
-                nextpos = ++curn + 1;
-        }
-        else if (*curf == '#')
-            curn = curn_end - 1;    // skip until end of string
-        curf++;
-        curn++;
-    };
-
-    return (curn == curn_end) && (*curf == '\0');
-}
-
-
-
 template<class Network, class Timer, int a, int MAX_MESSAGE_HANDLERS>
 int MQTT::Client<Network, Timer, a, MAX_MESSAGE_HANDLERS>::deliverMessage(MQTTString& topicName, Message& message)
 {
     int rc = FAILURE;
+    MessageData md(topicName, message);
 
-    // we have to find the right message handler - indexed by topic
-    for (int i = 0; i < MAX_MESSAGE_HANDLERS; ++i)
+    // we have to find the right message handlers - indexed by topic
+    const char* name = (topicName.cstring != 0) ? topicName.cstring : topicName.lenstring.data;
+    int len = (topicName.cstring != 0) ? (int)strlen(topicName.cstring) : topicName.lenstring.len;
+    auto deliver = [&md, &rc](MQTT_FP<void, MessageData&>& fp)
     {
-        if (messageHandlers[i].topicFilter != 0 && (MQTTPacket_equals(&topicName, (char*)messageHandlers[i].topicFilter) ||
-                isTopicMatched((char*)messageHandlers[i].topicFilter, topicName)))
+        if (fp.attached())
         {
-            if (messageHandlers[i].fp.attached())
-            {
-                MessageData md(topicName, message);
-                messageHandlers[i].fp(md);
-                rc = SUCCESS;
-            }
+            fp(md);
+            rc = SUCCESS;
         }
-    }
+    };
+    messageHandlers.match(name, len, deliver);
 
     if (rc == FAILURE && defaultMessageHandler.attached())
     {
-        MessageData md(topicName, message);
         defaultMessageHandler(md);
         rc = SUCCESS;
     }
@@ -809,39 +769,19 @@ template<class Network, class Timer, int MAX_MQTT_PACKET_SIZE, int MAX_MESSAGE_H
 int MQTT::Client<Network, Timer, MAX_MQTT_PACKET_SIZE, MAX_MESSAGE_HANDLERS>::setMessageHandler(const char* topicFilter, messageHandler messageHandler)
 {
     int rc = FAILURE;
-    int i = -1;
 
-    // first check for an existing matching slot
-    for (i = 0; i < MAX_MESSAGE_HANDLERS; ++i)
+    if (messageHandler == 0) // remove existing
     {
-        if (messageHandlers[i].topicFilter != 0 && strcmp(messageHandlers[i].topicFilter, topicFilter) == 0)
-        {
-            if (messageHandler == 0) // remove existing
-            {
-                messageHandlers[i].topicFilter = 0;
-                messageHandlers[i].fp.detach();
-            }
-            rc = SUCCESS; // return i when adding new subscription
-            break;
-        }
+        if (messageHandlers.erase(topicFilter))
+            rc = SUCCESS;
     }
-    // if no existing, look for empty slot (unless we are removing)
-    if (messageHandler != 0) {
-        if (rc == FAILURE)
-        {
-            for (i = 0; i < MAX_MESSAGE_HANDLERS; ++i)
-            {
-                if (messageHandlers[i].topicFilter == 0)
-                {
-                    rc = SUCCESS;
-                    break;
-                }
-            }
-        }
-        if (i < MAX_MESSAGE_HANDLERS)
+    else // existing matching slot, or a new one
+    {
+        MQTT_FP<void, MessageData&>* fp = messageHandlers.insert(topicFilter);
+        if (fp != 0)
         {
-            messageHandlers[i].topicFilter = topicFilter;
-            messageHandlers[i].fp.attach(messageHandler);
+            fp->attach(messageHandler);
+            rc = SUCCESS;
         }
     }
     return rc;
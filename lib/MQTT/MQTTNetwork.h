@@ -1,7 +1,9 @@
 #ifndef MQTTNETWORK_H
 #define MQTTNETWORK_H
 
+#include <string.h>
 #include "NetworkInterface.h"
+#include "MQTTmbed.h"
 
 #undef USE_TLS
 #if defined(MBED_CONF_APP_USE_TLS) && (MBED_CONF_APP_USE_TLS == 1)
@@ -21,9 +23,19 @@
 #include "TCPSocket.h"
 #endif  // USE_TLS
 
+/**
+ * Read-ahead buffer between the MQTT client and the socket. The client reads the fixed header
+ * and each remaining-length byte with separate calls; these are served from memory, so that a
+ * packet costs one recv() (one TLS record) instead of one per byte. Reads at least this large
+ * bypass the buffer.
+ */
+#if !defined(MQTTNETWORK_READ_BUFFER_SIZE)
+    #define MQTTNETWORK_READ_BUFFER_SIZE 1024
+#endif
+
 class MQTTNetwork {
 public:
-    MQTTNetwork(NetworkInterface* aNetwork) : network(aNetwork) {
+    MQTTNetwork(NetworkInterface* aNetwork) : network(aNetwork), rx_head(0), rx_tail(0), socket_timeout(-1) {
 #ifdef USE_TLS
 #if defined(MBED_CONF_APP_USE_SECURE_ELEMENT) && (MBED_CONF_APP_USE_SECURE_ELEMENT == 1)
         socket = new SecureElementSocket();
@@ -39,33 +51,91 @@ public:
         delete socket;
     }
 
+    /**
+     * Reads len bytes, waiting at most timeout ms for them.
+     * @return bytes read, fewer than len on timeout; negative if the connection was lost
+     */
     int read(unsigned char* buffer, int len, int timeout) {
-        return socket->recv(buffer, len);
+        Countdown timer((timeout > 0) ? timeout : 0);
+        int copied = 0;
+
+        while (copied < len) {
+            if (rx_head == rx_tail) {
+                int left_ms = (timer.left_ms() > 0) ? timer.left_ms() : 0;
+                int rc;
+                if (len - copied >= MQTTNETWORK_READ_BUFFER_SIZE) {
+                    rc = recv(buffer + copied, len - copied, left_ms);
+                    if (rc > 0) {
+                        copied += rc;
+                        continue;
+                    }
+                } else {
+                    rc = recv(rx_buffer, MQTTNETWORK_READ_BUFFER_SIZE, left_ms);
+                    if (rc > 0) {
+                        rx_head = 0;
+                        rx_tail = rc;
+                    }
+                }
+                if (rc == NSAPI_ERROR_WOULD_BLOCK) {
+                    break;
+                } else if (rc <= 0) {
+                    /* 0 is an orderly close by the broker */
+                    return (copied > 0) ? copied : NSAPI_ERROR_CONNECTION_LOST;
+                }
+            }
+
+            int chunk = rx_tail - rx_head;
+            if (chunk > len - copied) {
+                chunk = len - copied;
+            }
+            memcpy(buffer + copied, rx_buffer + rx_head, chunk);
+            rx_head += chunk;
+            copied += chunk;
+        }
+
+        return copied;
     }
 
+    /**
+     * Writes up to len bytes. Publishes write from another thread than the one reading, so the socket
+     * timeout is left to read(); a write that times out under it returns 0 and is retried by the client
+     * until its own command timer expires.
+     * @return bytes written, 0 on timeout; negative if the connection was lost
+     */
     int write(unsigned char* buffer, int len, int timeout) {
-        return socket->send(buffer, len);
+        int rc = socket->send(buffer, len);
+        return (rc == NSAPI_ERROR_WOULD_BLOCK) ? 0 : rc;
     }
 
+    /**
+     * Connects to hostname, at address if it has already been resolved by the caller;
+     * hostname is still used for SNI and verification of the broker certificate.
+     */
 #if defined(MBED_CONF_APP_USE_SECURE_ELEMENT) && (MBED_CONF_APP_USE_SECURE_ELEMENT == 1)
     int connect(const char* hostname, int port, const char *ssl_ca_pem,
-            const char *ssl_cli_pem, const mbedtls_pk_context& mbedtls_pk_ctx) {
+            const char *ssl_cli_pem, const mbedtls_pk_context& mbedtls_pk_ctx,
+            const SocketAddress* address = NULL) {
 #else   
     int connect(const char* hostname, int port, const char *ssl_ca_pem,
-            const char *ssl_cli_pem, const char *ssl_pk_pem) {
+            const char *ssl_cli_pem, const char *ssl_pk_pem,
+            const SocketAddress* address = NULL) {
 #endif  // MBED_CONF_APP_USE_SECURE_ELEMENT
         int ret = NSAPI_ERROR_OK;
+        rx_head = rx_tail = 0;
         if ((ret = socket->open(network)) != NSAPI_ERROR_OK) {
             return ret;
         }
 
         SocketAddress addr;
-        if (network->gethostbyname(hostname, &addr) != NSAPI_ERROR_OK) {
+        if (address != NULL) {
+            addr = *address;
+        } else if (network->gethostbyname(hostname, &addr) != NSAPI_ERROR_OK) {
             return NSAPI_ERROR_DNS_FAILURE;
         }
 
         addr.set_port(port);
         socket->set_hostname(hostname);
+        set_timeout(-1);
 
 #ifdef USE_TLS
         socket->set_root_ca_cert(ssl_ca_pem);
@@ -79,11 +149,29 @@ public:
     }
 
     int disconnect() {
+        rx_head = rx_tail = 0;
         return socket->close();
     }
 
 private:
+    /* Socket timeout is only changed when it differs from the last one set; only the reading thread sets it */
+    void set_timeout(int timeout) {
+        if (timeout != socket_timeout) {
+            socket->set_timeout(timeout);
+            socket_timeout = timeout;
+        }
+    }
+
+    int recv(unsigned char* buffer, int len, int timeout) {
+        set_timeout(timeout);
+        return socket->recv(buffer, len);
+    }
+
     NetworkInterface* network;
+    unsigned char rx_buffer[MQTTNETWORK_READ_BUFFER_SIZE];
+    int rx_head;                /// next unread byte of rx_buffer
+    int rx_tail;                /// end of the buffered bytes
+    int socket_timeout;
 #ifdef USE_TLS
 #if defined(MBED_CONF_APP_USE_SECURE_ELEMENT) && (MBED_CONF_APP_USE_SECURE_ELEMENT == 1)
     SecureElementSocket* socket;
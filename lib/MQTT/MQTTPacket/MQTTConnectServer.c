@@ -31,7 +31,8 @@ int MQTTPacket_checkVersion(MQTTString* protocol, int version)
 {
 	int rc = 0;
 
-	if (version == 3 && memcmp(protocol->lenstring.data, "MQIdsp",
+	/* MQTT 3.1 protocol name; this copy compared against "MQIdsp", rejecting every 3.1 CONNECT */
+	if (version == 3 && memcmp(protocol->lenstring.data, "MQIsdp",
 			min(6, protocol->lenstring.len)) == 0)
 		rc = 1;
 	else if (version == 4 && memcmp(protocol->lenstring.data, "MQTT",
@@ -0,0 +1,379 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#if !defined(MQTT_TOPIC_INDEX_H)
+#define MQTT_TOPIC_INDEX_H
+
+#include <stdint.h>
+#include <string.h>
+
+namespace MQTT
+{
+
+// smallest power of two with at least twice as many buckets as filters
+constexpr int topicIndexBuckets(int filters, int buckets = 1)
+{
+    return (buckets >= 2 * filters) ? buckets : topicIndexBuckets(filters, 2 * buckets);
+}
+
+/**
+ * @class TopicIndex
+ * @brief Index of subscription topic filters, for dispatching incoming messages
+ *
+ * Exact topic filters are kept in a hash table, and filters with '+' or '#' wildcards in a trie
+ * with one node per topic level. A topic is matched in time proportional to its number of levels,
+ * however many filters are indexed. Filters are not copied, and must outlive their entries.
+ * @param Value value kept for each filter, e.g. its message handler
+ * @param MAX_FILTERS number of filters that can be indexed
+ * @param MAX_NODES number of trie nodes, shared by the levels of all wildcard filters
+ */
+template<class Value, int MAX_FILTERS, int MAX_NODES = MAX_FILTERS * 8>
+class TopicIndex
+{
+public:
+    TopicIndex()
+    {
+        clear();
+    }
+
+    /** Find the value of a topic filter, adding the filter if it is not indexed
+     *  @param topicFilter - topic filter, which must outlive its entry
+     *  @return the value of the filter, or 0 if the index is full
+     */
+    Value* insert(const char* topicFilter);
+
+    /** Find the value of a topic filter
+     *  @return the value of the filter, or 0 if it is not indexed
+     */
+    Value* find(const char* topicFilter);
+
+    /** Remove a topic filter
+     *  @return true if the filter was indexed
+     */
+    bool erase(const char* topicFilter);
+
+    /** Remove all topic filters
+     */
+    void clear();
+
+    /** Call visit(value) for the value of each filter matching a topic name
+     *  @param topicName - topic name, not terminated
+     *  @param len - length of the topic name
+     *  @return the number of matching filters
+     */
+    template<class Visitor>
+    int match(const char* topicName, int len, Visitor& visit);
+
+    int size() const
+    {
+        return count;
+    }
+
+private:
+    static const int BUCKETS = topicIndexBuckets(MAX_FILTERS);
+
+    struct Slot
+    {
+        const char* filter;     // 0 when the slot is free
+        Value value;
+        short next;             // next slot of an exact filter in the same bucket
+    };
+
+    struct Node
+    {
+        const char* level;      // text of the level within a filter, not terminated
+        unsigned short len;
+        short child;            // first child with a literal level
+        short sibling;          // next child of the parent with a literal level
+        short plusChild;        // child for '+'
+        short hashFilter;       // slot of the filter ending in '#' after this level
+        short filter;           // slot of the filter ending at this level
+    };
+
+    static bool isWildcard(const char* topicFilter)
+    {
+        return strpbrk(topicFilter, "+#") != 0;
+    }
+
+    static uint32_t hash(const char* s, int len)
+    {
+        uint32_t h = 2166136261UL;      // FNV-1a
+        for (int i = 0; i < len; ++i)
+            h = (h ^ (unsigned char)s[i]) * 16777619UL;
+        return h;
+    }
+
+    short findSlot(const char* topicFilter);
+    short newNode(const char* level, int len);
+    bool insertNode(short slot);
+    void rebuild();
+    template<class Visitor>
+    int matchNode(short n, const char* level, const char* end, Visitor& visit);
+
+    Slot slots[MAX_FILTERS];
+    short buckets[BUCKETS];
+    Node nodes[MAX_NODES];      // nodes[0] is the root, before the first level
+    int numNodes;
+    int count;
+};
+
+}
+
+
+template<class Value, int MAX_FILTERS, int MAX_NODES>
+Value* MQTT::TopicIndex<Value, MAX_FILTERS, MAX_NODES>::insert(const char* topicFilter)
+{
+    short i = findSlot(topicFilter);
+    if (i >= 0)
+        return &slots[i].value;
+
+    i = 0;
+    while (i < MAX_FILTERS && slots[i].filter != 0)
+        ++i;
+    if (i == MAX_FILTERS)
+        return 0;
+
+    slots[i].filter = topicFilter;
+    slots[i].value = Value();
+    if (isWildcard(topicFilter))
+    {
+        if (!insertNode(i))
+        {
+            slots[i].filter = 0;
+            rebuild();      // drop the levels added before the nodes ran out
+            return 0;
+        }
+    }
+    else
+    {
+        short& bucket = buckets[hash(topicFilter, strlen(topicFilter)) & (BUCKETS - 1)];
+        slots[i].next = bucket;
+        bucket = i;
+    }
+    ++count;
+    return &slots[i].value;
+}
+
+
+template<class Value, int MAX_FILTERS, int MAX_NODES>
+Value* MQTT::TopicIndex<Value, MAX_FILTERS, MAX_NODES>::find(const char* topicFilter)
+{
+    short i = findSlot(topicFilter);
+    return (i >= 0) ? &slots[i].value : 0;
+}
+
+
+template<class Value, int MAX_FILTERS, int MAX_NODES>
+bool MQTT::TopicIndex<Value, MAX_FILTERS, MAX_NODES>::erase(const char* topicFilter)
+{
+    short i = findSlot(topicFilter);
+    if (i < 0)
+        return false;
+
+    Slot& slot = slots[i];
+    const char* filter = slot.filter;
+    slot.filter = 0;
+    slot.value = Value();
+    --count;
+
+    if (isWildcard(filter))
+        rebuild();
+    else
+    {
+        for (short* link = &buckets[hash(filter, strlen(filter)) & (BUCKETS - 1)]; *link >= 0; link = &slots[*link].next)
+        {
+            if (*link == i)
+            {
+                *link = slot.next;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+
+template<class Value, int MAX_FILTERS, int MAX_NODES>
+void MQTT::TopicIndex<Value, MAX_FILTERS, MAX_NODES>::clear()
+{
+    for (int i = 0; i < MAX_FILTERS; ++i)
+    {
+        slots[i].filter = 0;
+        slots[i].value = Value();
+    }
+    for (int i = 0; i < BUCKETS; ++i)
+        buckets[i] = -1;
+    count = 0;
+    rebuild();
+}
+
+
+template<class Value, int MAX_FILTERS, int MAX_NODES>
+template<class Visitor>
+int MQTT::TopicIndex<Value, MAX_FILTERS, MAX_NODES>::match(const char* topicName, int len, Visitor& visit)
+{
+    int matched = 0;
+
+    for (short i = buckets[hash(topicName, len) & (BUCKETS - 1)]; i >= 0; i = slots[i].next)
+    {
+        if (strncmp(slots[i].filter, topicName, len) == 0 && slots[i].filter[len] == '\0')
+        {
+            visit(slots[i].value);
+            ++matched;
+        }
+    }
+
+    if (numNodes > 1)
+        matched += matchNode(0, topicName, topicName + len, visit);
+
+    return matched;
+}
+
+
+// filters are only looked up by subscribe and unsubscribe, so a scan will do
+template<class Value, int MAX_FILTERS, int MAX_NODES>
+short MQTT::TopicIndex<Value, MAX_FILTERS, MAX_NODES>::findSlot(const char* topicFilter)
+{
+    for (short i = 0; i < MAX_FILTERS; ++i)
+    {
+        if (slots[i].filter != 0 && strcmp(slots[i].filter, topicFilter) == 0)
+            return i;
+    }
+    return -1;
+}
+
+
+template<class Value, int MAX_FILTERS, int MAX_NODES>
+short MQTT::TopicIndex<Value, MAX_FILTERS, MAX_NODES>::newNode(const char* level, int len)
+{
+    if (numNodes == MAX_NODES)
+        return -1;
+
+    Node& node = nodes[numNodes];
+    node.level = level;
+    node.len = len;
+    node.child = node.sibling = node.plusChild = -1;
+    node.hashFilter = node.filter = -1;
+    return numNodes++;
+}
+
+
+template<class Value, int MAX_FILTERS, int MAX_NODES>
+bool MQTT::TopicIndex<Value, MAX_FILTERS, MAX_NODES>::insertNode(short slot)
+{
+    short n = 0;
+    const char* level = slots[slot].filter;
+
+    while (true)
+    {
+        const char* end = strchr(level, '/');
+        int len = (end != 0) ? end - level : strlen(level);
+
+        if (len == 1 && *level == '#')      // # can only be the last level
+        {
+            nodes[n].hashFilter = slot;
+            return true;
+        }
+
+        short next = -1;
+        if (len == 1 && *level == '+')
+        {
+            if (nodes[n].plusChild < 0)
+                nodes[n].plusChild = newNode(level, len);
+            next = nodes[n].plusChild;
+        }
+        else
+        {
+            for (next = nodes[n].child; next >= 0; next = nodes[next].sibling)
+            {
+                if (nodes[next].len == len && memcmp(nodes[next].level, level, len) == 0)
+                    break;
+            }
+            if (next < 0 && (next = newNode(level, len)) >= 0)
+            {
+                nodes[next].sibling = nodes[n].child;
+                nodes[n].child = next;
+            }
+        }
+        if (next < 0)
+            return false;
+
+        n = next;
+        if (end == 0)
+            break;
+        level = end + 1;
+    }
+
+    nodes[n].filter = slot;
+    return true;
+}
+
+
+template<class Value, int MAX_FILTERS, int MAX_NODES>
+void MQTT::TopicIndex<Value, MAX_FILTERS, MAX_NODES>::rebuild()
+{
+    numNodes = 0;
+    newNode("", 0);
+    for (short i = 0; i < MAX_FILTERS; ++i)
+    {
+        if (slots[i].filter != 0 && isWildcard(slots[i].filter))
+            insertNode(i);
+    }
+}
+
+
+// level is the next level of the topic name after node n, or 0 when the topic name is used up
+template<class Value, int MAX_FILTERS, int MAX_NODES>
+template<class Visitor>
+int MQTT::TopicIndex<Value, MAX_FILTERS, MAX_NODES>::matchNode(short n, const char* level, const char* end, Visitor& visit)
+{
+    const Node& node = nodes[n];
+    int matched = 0;
+
+    if (node.hashFilter >= 0)       // # matches the parent level, and any number of levels after it
+    {
+        visit(slots[node.hashFilter].value);
+        ++matched;
+    }
+
+    if (level == 0)
+    {
+        if (node.filter >= 0)
+        {
+            visit(slots[node.filter].value);
+            ++matched;
+        }
+        return matched;
+    }
+
+    const char* sep = (const char*)memchr(level, '/', end - level);
+    int len = ((sep != 0) ? sep : end) - level;
+    const char* next = (sep != 0) ? sep + 1 : 0;
+
+    for (short c = node.child; c >= 0; c = nodes[c].sibling)
+    {
+        if (nodes[c].len == len && memcmp(nodes[c].level, level, len) == 0)
+        {
+            matched += matchNode(c, next, end, visit);
+            break;
+        }
+    }
+    if (node.plusChild >= 0)
+        matched += matchNode(node.plusChild, next, end, visit);
+
+    return matched;
+}
+
+#endif
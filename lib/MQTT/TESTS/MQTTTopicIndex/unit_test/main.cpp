@@ -0,0 +1,140 @@
+#include <string.h>
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "MQTTTopicIndex.h"
+
+using namespace utest::v1;
+
+// Collects the ids of the matching filters as a bit mask
+struct MatchMask
+{
+    uint32_t mask = 0;
+    void operator()(int& id) { mask |= (1UL << id); }
+};
+
+template<int MAX_FILTERS>
+static uint32_t Match(MQTT::TopicIndex<int, MAX_FILTERS>& index, const char* topic)
+{
+    MatchMask visit;
+    int matched = index.match(topic, strlen(topic), visit);
+    TEST_ASSERT_EQUAL_INT(__builtin_popcount(visit.mask), matched);
+    return visit.mask;
+}
+
+template<int MAX_FILTERS>
+static void Insert(MQTT::TopicIndex<int, MAX_FILTERS>& index, const char* filter, int id)
+{
+    int* value = index.insert(filter);
+    TEST_ASSERT_NOT_NULL(value);
+    *value = id;
+}
+
+// Test matching of exact and wildcard topic filters
+static control_t topic_index_test_1(const size_t call_count)
+{
+    MQTT::TopicIndex<int, 10> index;
+    Insert(index, "/sys/pk/dev/thing/service/a", 0);
+    Insert(index, "/sys/pk/dev/thing/service/+", 1);
+    Insert(index, "/sys/#", 2);
+    Insert(index, "sport/tennis/#", 3);
+    Insert(index, "sport/+/player1", 4);
+    Insert(index, "+/+", 5);
+    Insert(index, "#", 6);
+    TEST_ASSERT_EQUAL_INT(7, index.size());
+
+    TEST_ASSERT_EQUAL_UINT32(0x47, Match(index, "/sys/pk/dev/thing/service/a"));
+    TEST_ASSERT_EQUAL_UINT32(0x46, Match(index, "/sys/pk/dev/thing/service/b"));
+    TEST_ASSERT_EQUAL_UINT32(0x44, Match(index, "/sys/pk/dev/thing/service"));
+    TEST_ASSERT_EQUAL_UINT32(0x64, Match(index, "/sys"));                       // "" and "sys" levels
+    TEST_ASSERT_EQUAL_UINT32(0x48, Match(index, "sport/tennis/player2"));
+    TEST_ASSERT_EQUAL_UINT32(0x58, Match(index, "sport/tennis/player1"));
+    TEST_ASSERT_EQUAL_UINT32(0x68, Match(index, "sport/tennis"));               // # matches the parent level
+    TEST_ASSERT_EQUAL_UINT32(0x50, Match(index, "sport/golf/player1"));
+    TEST_ASSERT_EQUAL_UINT32(0x40, Match(index, "sport/golf/player1/score"));
+
+    /* Topic names are not terminated */
+    MatchMask visit;
+    TEST_ASSERT_EQUAL_INT(4, index.match("/sys/pk/dev/thing/service/abc", 27, visit));
+    TEST_ASSERT_EQUAL_UINT32(0x47, visit.mask);
+
+    return CaseNext;
+}
+
+// Test that a filter is indexed once, and that the index holds more than 10 filters
+static control_t topic_index_test_2(const size_t call_count)
+{
+    static char filters[33][32];
+    MQTT::TopicIndex<int, 32> index;
+
+    for (int i = 0; i < 32; i++)
+    {
+        snprintf(filters[i], sizeof(filters[i]), (i % 2) ? "/sys/pk/dev/%d/+" : "/sys/pk/dev/service/%d", i);
+        Insert(index, filters[i], i);
+    }
+    snprintf(filters[32], sizeof(filters[32]), "/sys/pk/dev/service/32");
+    TEST_ASSERT_NULL(index.insert(filters[32]));
+    TEST_ASSERT_EQUAL_INT(32, index.size());
+
+    /* Same filter text gives the same entry */
+    TEST_ASSERT_EQUAL_INT(4, *index.insert("/sys/pk/dev/service/4"));
+    TEST_ASSERT_EQUAL_INT(32, index.size());
+
+    TEST_ASSERT_EQUAL_UINT32(1UL << 6, Match(index, "/sys/pk/dev/service/6"));
+    TEST_ASSERT_EQUAL_UINT32(1UL << 7, Match(index, "/sys/pk/dev/7/reply"));
+    TEST_ASSERT_EQUAL_UINT32(0, Match(index, "/sys/pk/dev/8/reply"));
+
+    return CaseNext;
+}
+
+// Test that removed filters no longer match, and that their entries can be reused
+static control_t topic_index_test_3(const size_t call_count)
+{
+    MQTT::TopicIndex<int, 3> index;
+    Insert(index, "a/b", 0);
+    Insert(index, "a/+", 1);
+    Insert(index, "a/#", 2);
+    TEST_ASSERT_NULL(index.insert("c"));
+    TEST_ASSERT_EQUAL_UINT32(0x7, Match(index, "a/b"));
+
+    TEST_ASSERT_TRUE(index.erase("a/+"));
+    TEST_ASSERT_FALSE(index.erase("a/+"));
+    TEST_ASSERT_EQUAL_UINT32(0x5, Match(index, "a/b"));
+    TEST_ASSERT_TRUE(index.erase("a/b"));
+    TEST_ASSERT_EQUAL_UINT32(0x4, Match(index, "a/b"));
+    TEST_ASSERT_NULL(index.find("a/b"));
+
+    Insert(index, "c", 3);
+    TEST_ASSERT_EQUAL_UINT32(0x8, Match(index, "c"));
+    TEST_ASSERT_EQUAL_INT(2, index.size());
+
+    index.clear();
+    TEST_ASSERT_EQUAL_INT(0, index.size());
+    TEST_ASSERT_EQUAL_UINT32(0, Match(index, "a/b"));
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test matching of topic filters", topic_index_test_1),
+    Case("Test capacity of the topic index", topic_index_test_2),
+    Case("Test removal of topic filters", topic_index_test_3)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -23,6 +23,12 @@
 #include "boot_manager.h"
 #include "device_uid.h"
 #include "persist_store.h"
+#include "diagnostics.h"
+#include "power_manager.h"
+#include "watchdog_supervisor.h"
+#include "latency_trace.h"
+#include "decada_endpoints.h"
+#include "dns_cache.h"
 
 #if (MBED_MAJOR_VERSION != 6 || MBED_MINOR_VERSION != 5 || MBED_PATCH_VERSION != 0)
 #error "MBed OS version is not targeted 6.5.0"
@@ -40,9 +46,10 @@ Mutex stdio_mutex;
 Mutex mqtt_mutex;
 Mail<llp_sensor_mail_t, 256> llp_sensor_mail_box;
 Mail<comms_upstream_mail_t, 256> comms_upstream_mail_box;
-Mail<service_response_mail_t, 256> service_response_mail_box;
+Mail<service_response_mail_t, SERVICE_RESPONSE_POOL_SIZE> service_response_mail_box;
 Mail<mqtt_arrived_mail_t, 128> mqtt_arrived_mail_box;
 Mail<sensor_control_mail_t, 64> sensor_control_mail_box;
+Mail<behavior_control_mail_t, 64> behavior_control_mail_box;
 
 /* RTOS Main Threads Initialization */
 Thread thread_1 (osPriorityNormal, OS_STACK_SIZE*8, NULL, "CommunicationsControllerThread");
@@ -74,12 +81,29 @@ int main()
     }
     else
     {
+        DecadaEndpointsInit(device_uuid);
+        DnsCacheInit();
+        DiagnosticsInit();
+        DiagnosticsRegisterThread(&thread_1, "comms");
+        DiagnosticsRegisterThread(&thread_2, "sensor");
+        DiagnosticsRegisterThread(&thread_3, "behavior");
+        DiagnosticsRegisterThread(&thread_4, "event");
+        SupervisorRegisterThread(&thread_1, "comms", SUPERVISOR_THREAD_DEADLINE_MS);
+        SupervisorRegisterThread(&thread_2, "sensor", SUPERVISOR_THREAD_DEADLINE_MS);
+        SupervisorRegisterThread(&thread_3, "behavior", SUPERVISOR_THREAD_DEADLINE_MS);
+        SupervisorRegisterThread(&thread_4, "event", SUPERVISOR_THREAD_DEADLINE_MS);
+#if LATENCY_TRACE_ENABLED
+        LatencyTraceInit();
+#endif  // LATENCY_TRACE_ENABLED
+
         thread_1.start(communications_controller_thread);
         thread_2.start(sensor_thread);
         thread_3.start(behavior_coordinator_thread);
         thread_4.start(event_manager_thread);
         
         watchdog.start(wd_timeout_ms);
+        SupervisorInit();
+        PowerInit();
         
         ThisThread::sleep_for(rtos::Kernel::wait_for_u32_forever);
     }
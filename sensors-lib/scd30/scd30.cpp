@@ -1,5 +1,6 @@
 #include "mbed.h"
 #include "scd30.h"
+#include "sensors-lib/sensirion/sensirion_frame.h"
 
 /** Create a SCD30 object using the specified I2C object
  * @param sda - mbed I2C interface pin
@@ -145,7 +146,7 @@ uint8_t Scd30::GetReadyStatus()
 
 /** Get all data values (CO2, Temp and Hum) 
  *
- * @see Results in private member variables
+ * @see Results in meas
  *
  * @return enum SCDerror
  */
@@ -156,45 +157,10 @@ uint8_t Scd30::ReadMeasurement()
     int res = _i2c.write(SCD30_I2C_ADDR, i2cbuff, 2, false);
     if(res) return SCDNOACKERROR;
     
-    _i2c.read(SCD30_I2C_ADDR | 1, i2cbuff, 18, false);
+    _i2c.read(SCD30_I2C_ADDR | 1, i2cbuff, SCD30_MEAS_SIZE, false);
     
-    uint16_t stat = (i2cbuff[0] << 8) | i2cbuff[1];
-    co2m = stat;
-    uint8_t dat = Scd30::CheckCrc2b(stat, i2cbuff[2]);
-    if(dat == SCDCRCERROR) return SCDCRCERROR;
-    
-    stat = (i2cbuff[3] << 8) | i2cbuff[4];
-    co2l = stat;
-    dat = Scd30::CheckCrc2b(stat, i2cbuff[5]);
-    if(dat == SCDCRCERROR) return SCDCRCERROR;
-    
-    stat = (i2cbuff[6] << 8) | i2cbuff[7];
-    tempm = stat;
-    dat = Scd30::CheckCrc2b(stat, i2cbuff[8]);
-    if(dat == SCDCRCERROR) return SCDCRCERROR;
-    
-    stat = (i2cbuff[9] << 8) | i2cbuff[10];
-    templ = stat;
-    dat = Scd30::CheckCrc2b(stat, i2cbuff[11]);
-    if(dat == SCDCRCERROR) return SCDCRCERROR;
-    
-    stat = (i2cbuff[12] << 8) | i2cbuff[13];
-    humm = stat;
-    dat = Scd30::CheckCrc2b(stat, i2cbuff[14]);
-    if(dat == SCDCRCERROR) return SCDCRCERROR;
-    
-    stat = (i2cbuff[15] << 8) | i2cbuff[16];
-    huml = stat;
-    dat = Scd30::CheckCrc2b(stat, i2cbuff[17]);
-    if(dat == SCDCRCERROR) return SCDCRCERROR;
-    
-    co2i = (co2m << 16) | co2l ;
-    tempi = (tempm << 16) | templ ;
-    humi = (humm << 16) | huml ;
-    
-    co2f = *(float*)&co2i;
-    tempf = *(float*)&tempi;
-    humf = *(float*)&humi;
+    int stat = SensirionDecodeFrame(i2cbuff, SCD30_MEAS_SIZE, meas);
+    if(stat != SENSIRION_FRAME_OK) return SCDCRCERROR;
     
     return SCDNOERROR;
 }
@@ -292,26 +258,7 @@ uint8_t Scd30::SoftReset()
  */
 uint8_t Scd30::CalcCrc2b(uint16_t seed)
 {
-  uint8_t bit;                  // bit mask
-  uint8_t crc = SCD30_CRC_INIT; // calculated checksum
-  
-  // calculates 8-Bit checksum with given polynomial
-
-    crc ^= (seed >> 8) & 255;
-    for(bit = 8; bit > 0; --bit)
-    {
-      if(crc & 0x80) crc = (crc << 1) ^ SCD30_POLYNOMIAL;
-      else           crc = (crc << 1);
-    }
-
-    crc ^= seed & 255;
-    for(bit = 8; bit > 0; --bit)
-    {
-      if(crc & 0x80) crc = (crc << 1) ^ SCD30_POLYNOMIAL;
-      else           crc = (crc << 1);
-    }
-    
-  return crc;
+    return SensirionCrc8Word(seed);
 }
 
 /** Compare received CRC value with calculated CRC value
@@ -341,12 +288,20 @@ std::string Scd30::GetName()
 
 /** Get Sensor Data (Overrides SensorType virtual func)
  * 
- * @param   data_list   vector of string pairs (data_name, data_value)
+ * @param   readings    caller-provided array of readings
+ * @param   capacity    number of elements in readings (at least 3)
+ * @param   count       number of readings written
  *
  * @return  enum SensorStatus in SensorType base class
  */
-int Scd30::GetData(std::vector<std::pair<std::string, std::string>>& data_list)
+int Scd30::GetData(sensor_reading_t* readings, size_t capacity, size_t& count)
 {
+    count = 0;
+    if (capacity < 3)
+    {
+        return SensorType::DATA_NOT_RDY;
+    }
+
     uint8_t dat = GetReadyStatus();
     if (dat == SCDNOACKERROR)
     {
@@ -358,34 +313,17 @@ int Scd30::GetData(std::vector<std::pair<std::string, std::string>>& data_list)
         uint8_t crcc = ReadMeasurement();
         if (crcc == SCDNOERROR)
         {
-            data_oor_list.clear();
-            std::string co2 = ConvertDataToString(co2f);
-            std::string temp = ConvertDataToString(tempf);
-            std::string hum = ConvertDataToString(humf);
-
-            int ret = ValidateData(co2f, CO2_MIN, CO2_MAX);
-            if (ret == DATA_OUT_OF_RANGE)
-            {
-                std::string msg = "_co2_out_of_range_" + co2;
-                data_oor_list.push_back(msg);
-            }
-            data_list.push_back(make_pair("co2", co2));
+            int ret = ValidateData(meas.co2, CO2_MIN, CO2_MAX);
+            uint8_t quality = (ret == DATA_OUT_OF_RANGE) ? READING_OUT_OF_RANGE : READING_OK;
+            readings[count++] = {"co2", meas.co2, quality};
 
-            ret = ValidateData(tempf, TEMP_MIN, TEMP_MAX);
-            if (ret == DATA_OUT_OF_RANGE)
-            {
-                std::string msg = "_temperature_out_of_range_" + temp;
-                data_oor_list.push_back(msg);
-            }
-            data_list.push_back(make_pair("temperature", temp));
+            ret = ValidateData(meas.temperature, TEMP_MIN, TEMP_MAX);
+            quality = (ret == DATA_OUT_OF_RANGE) ? READING_OUT_OF_RANGE : READING_OK;
+            readings[count++] = {"temperature", meas.temperature, quality};
 
-            ret = ValidateData(humf, HUM_MIN, HUM_MAX);
-            if (ret == DATA_OUT_OF_RANGE)
-            {
-                std::string msg = "_humidity_out_of_range_" + hum;
-                data_oor_list.push_back(msg);
-            }
-            data_list.push_back(make_pair("humidity", hum));
+            ret = ValidateData(meas.humidity, HUM_MIN, HUM_MAX);
+            quality = (ret == DATA_OUT_OF_RANGE) ? READING_OUT_OF_RANGE : READING_OK;
+            readings[count++] = {"humidity", meas.humidity, quality};
 
             return SensorType::DATA_OK;
         }
@@ -36,10 +36,8 @@
 
 #define SCD30_CMMD_READ_SERIALNBR       0xD033
     
-#define SCD30_POLYNOMIAL                0x31   // P(x) = x^8 + x^5 + x^4 + 1 = 100110001
-#define SCD30_CRC_INIT                  0xff
-
 #define SCD30_SN_SIZE                   33      //size of the s/n ascii string + CRC values
+#define SCD30_MEAS_SIZE                 18      //3 floats, each sent as 2 CRC triplets
 
 #define CO2_MAX         10000.00f
 #define CO2_MIN         0.00f
@@ -50,6 +48,13 @@
 
 #define I2C_FREQUENCY   400000
 
+/** Measurement frame of the SCD30, in the order returned by SCD30_CMMD_READ_MEAS */
+typedef struct {
+    float co2;              /**< CO2 concentration */
+    float temperature;      /**< Temp */
+    float humidity;         /**< Hum */
+} scd30_measurement_t;
+
 /** Create SCD30 driver class
  * @brief Driver for the SCD30 CO2, RH/T sensor
  * Inherits SensorType virtual functions essential for interfacing with SensorManager
@@ -84,7 +89,8 @@ public:
     Scd30(PinName sda, PinName scl, int i2c_frequency);
     ~Scd30();
     std::string GetName();
-    int GetData(std::vector<std::pair<std::string, std::string>>&);
+    using SensorType::GetData;
+    int GetData(sensor_reading_t* readings, size_t capacity, size_t& count);
     void Enable();
 	void Disable();
     // void Configure();   // To be done in SENP-286
@@ -104,22 +110,9 @@ private:
     uint16_t scd_ready;     /* 1 = ready, 0 = busy */
     uint16_t meas_interval; /* measurement interval */
 
-    float co2f;             /* float of CO2 concentration */
-    float tempf;            /* float of Temp */
-    float humf;             /* float of Hum */
+    scd30_measurement_t meas;   /**< Decoded measurement frame */
     
     char i2cbuff[34];
-    
-    uint16_t co2m;          /**< High order 16 bit word of CO2 */
-    uint16_t co2l;          /**< Low  order 16 bit word of CO2 */
-    uint16_t tempm;         /**< High order 16 bit word of Temp */
-    uint16_t templ;         /**< Low order 16 bit word of Temp */
-    uint16_t humm;          /**< High order 16 bit word of Hum */
-    uint16_t huml;          /**< Low order 16 bit word of Hum */
-
-    uint32_t co2i;          /* 32 bit int of CO2 */
-    uint32_t tempi;         /* 32 bit int of Temp */
-    uint32_t humi;          /* 32 bit int of Hum */
 
     uint8_t StartMeasurement(uint16_t baro);
     uint8_t StopMeasurement();
@@ -0,0 +1,228 @@
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "sensirion_frame.h"
+
+#define BENCHMARK_ITERATIONS    1000
+
+using namespace utest::v1;
+
+/* SPS30 frame captured from SPS30_CMMD_READ_MEAS */
+static const uint8_t sps30_frame[60] = {
+    0x40, 0x4B, 0xDF, 0x85, 0x1F, 0xB8,     // mass PM1.0   3.18
+    0x40, 0x80, 0x72, 0xA3, 0xD7, 0xC0,     // mass PM2.5   4.02
+    0x40, 0x90, 0x31, 0x51, 0xEC, 0x2E,     // mass PM4.0   4.51
+    0x40, 0x97, 0xA6, 0x5C, 0x29, 0xDC,     // mass PM10    4.73
+    0x41, 0xA8, 0xB9, 0x8F, 0x5C, 0x38,     // num PM0.5    21.07
+    0x41, 0xC8, 0x02, 0xE1, 0x48, 0x87,     // num PM1.0    25.11
+    0x41, 0xCA, 0x60, 0xE1, 0x48, 0x87,     // num PM2.5    25.36
+    0x41, 0xCB, 0x51, 0x1E, 0xB8, 0x84,     // num PM4.0    25.39
+    0x41, 0xCB, 0x51, 0x33, 0x33, 0x88,     // num PM10     25.40
+    0x3F, 0x05, 0x5F, 0x1E, 0xB8, 0x84,     // typical size 0.52
+};
+
+/* SCD30 frame captured from SCD30_CMMD_READ_MEAS */
+static const uint8_t scd30_frame[18] = {
+    0x44, 0x19, 0x40, 0x1E, 0x14, 0x05,     // co2          612.47
+    0x41, 0xC6, 0x1D, 0xA3, 0xD7, 0xC0,     // temperature  24.83
+    0x42, 0x5C, 0xD2, 0xD7, 0x0A, 0x30,     // humidity     55.21
+};
+
+typedef struct {
+    float co2;
+    float temperature;
+    float humidity;
+} scd30_test_meas_t;
+
+/* Bitwise reference implementation previously used by the SPS30 and SCD30 drivers */
+static uint8_t BitwiseCrc2b(uint16_t seed)
+{
+    uint8_t crc = SENSIRION_CRC8_INIT;
+
+    crc ^= (seed >> 8) & 255;
+    for (uint8_t bit = 8; bit > 0; --bit)
+    {
+        if (crc & 0x80) crc = (crc << 1) ^ SENSIRION_CRC8_POLYNOMIAL;
+        else            crc = (crc << 1);
+    }
+
+    crc ^= seed & 255;
+    for (uint8_t bit = 8; bit > 0; --bit)
+    {
+        if (crc & 0x80) crc = (crc << 1) ^ SENSIRION_CRC8_POLYNOMIAL;
+        else            crc = (crc << 1);
+    }
+
+    return crc;
+}
+
+static control_t sensirion_crc_test_1(const size_t call_count)
+{
+    /* Example from Sensirion datasheet */
+    const uint8_t data[2] = {0xBE, 0xEF};
+
+    TEST_ASSERT_EQUAL_HEX8(0x92, SensirionCrc8(data, 2));
+    TEST_ASSERT_EQUAL_HEX8(0x92, SensirionCrc8Word(0xBEEF));
+
+    return CaseNext;
+}
+
+static control_t sensirion_crc_test_2(const size_t call_count)
+{
+    for (uint32_t word = 0; word <= 0xffff; word++)
+    {
+        TEST_ASSERT_EQUAL_HEX8(BitwiseCrc2b(word), SensirionCrc8Word(word));
+    }
+
+    return CaseNext;
+}
+
+static control_t sensirion_validate_test_1(const size_t call_count)
+{
+    int actual_ret = SensirionValidateFrame((const char*)sps30_frame, sizeof(sps30_frame));
+
+    TEST_ASSERT_EQUAL_INT(SENSIRION_FRAME_OK, actual_ret);
+
+    return CaseNext;
+}
+
+static control_t sensirion_validate_test_2(const size_t call_count)
+{
+    /* Corrupt the CRC of the last triplet only */
+    char frame[sizeof(sps30_frame)];
+    std::memcpy(frame, sps30_frame, sizeof(frame));
+    frame[59] ^= 0x01;
+
+    int actual_ret = SensirionValidateFrame(frame, sizeof(frame));
+
+    TEST_ASSERT_EQUAL_INT(SENSIRION_FRAME_CRC_ERR, actual_ret);
+
+    return CaseNext;
+}
+
+static control_t sensirion_validate_test_3(const size_t call_count)
+{
+    int actual_ret = SensirionValidateFrame((const char*)sps30_frame, sizeof(sps30_frame) - 1);
+
+    TEST_ASSERT_EQUAL_INT(SENSIRION_FRAME_LEN_ERR, actual_ret);
+
+    return CaseNext;
+}
+
+static control_t sensirion_decode_words_test_1(const size_t call_count)
+{
+    uint16_t words[6];
+    int actual_ret = SensirionDecodeWords((const char*)scd30_frame, sizeof(scd30_frame), words, 6);
+
+    TEST_ASSERT_EQUAL_INT(SENSIRION_FRAME_OK, actual_ret);
+    TEST_ASSERT_EQUAL_HEX16(0x4419, words[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x1E14, words[1]);
+    TEST_ASSERT_EQUAL_HEX16(0xD70A, words[5]);
+
+    return CaseNext;
+}
+
+static control_t sensirion_decode_floats_test_1(const size_t call_count)
+{
+    float values[10];
+    int actual_ret = SensirionDecodeFloats((const char*)sps30_frame, sizeof(sps30_frame), values, 10);
+
+    const float expected[10] = {3.18f, 4.02f, 4.51f, 4.73f, 21.07f, 25.11f, 25.36f, 25.39f, 25.40f, 0.52f};
+
+    TEST_ASSERT_EQUAL_INT(SENSIRION_FRAME_OK, actual_ret);
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(expected, values, 10);
+
+    return CaseNext;
+}
+
+static control_t sensirion_decode_frame_test_1(const size_t call_count)
+{
+    scd30_test_meas_t meas;
+    int actual_ret = SensirionDecodeFrame((const char*)scd30_frame, sizeof(scd30_frame), meas);
+
+    TEST_ASSERT_EQUAL_INT(SENSIRION_FRAME_OK, actual_ret);
+    TEST_ASSERT_EQUAL_FLOAT(612.47f, meas.co2);
+    TEST_ASSERT_EQUAL_FLOAT(24.83f, meas.temperature);
+    TEST_ASSERT_EQUAL_FLOAT(55.21f, meas.humidity);
+
+    return CaseNext;
+}
+
+static control_t sensirion_decode_frame_test_2(const size_t call_count)
+{
+    /* Frame length does not match the struct */
+    scd30_test_meas_t meas;
+    int actual_ret = SensirionDecodeFrame((const char*)sps30_frame, sizeof(sps30_frame), meas);
+
+    TEST_ASSERT_EQUAL_INT(SENSIRION_FRAME_LEN_ERR, actual_ret);
+
+    return CaseNext;
+}
+
+static control_t sensirion_benchmark_test_1(const size_t call_count)
+{
+    Timer timer;
+    volatile uint8_t sink = 0;
+
+    /* Bitwise: one CheckCrc2b per triplet, as in the original drivers */
+    timer.start();
+    for (int n = 0; n < BENCHMARK_ITERATIONS; n++)
+    {
+        for (size_t i = 0; i < sizeof(sps30_frame); i += SENSIRION_TRIPLET_SIZE)
+        {
+            uint16_t word = (sps30_frame[i] << 8) | sps30_frame[i + 1];
+            sink |= BitwiseCrc2b(word) ^ sps30_frame[i + 2];
+        }
+    }
+    timer.stop();
+    auto bitwise_us = timer.elapsed_time().count();
+
+    /* Table driven: validate and decode the whole frame */
+    float values[10];
+    timer.reset();
+    timer.start();
+    for (int n = 0; n < BENCHMARK_ITERATIONS; n++)
+    {
+        sink |= SensirionDecodeFloats((const char*)sps30_frame, sizeof(sps30_frame), values, 10);
+    }
+    timer.stop();
+    auto table_us = timer.elapsed_time().count();
+
+    printf("SPS30 frame x%d: bitwise %lld us, table %lld us\r\n",
+           BENCHMARK_ITERATIONS, (long long)bitwise_us, (long long)table_us);
+
+    TEST_ASSERT_EQUAL_UINT8(0, sink);
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Sensirion CRC-8 of datasheet example", sensirion_crc_test_1),
+    Case("Sensirion CRC-8 table matches bitwise reference for all words", sensirion_crc_test_2),
+    Case("Sensirion validate captured SPS30 frame", sensirion_validate_test_1),
+    Case("Sensirion validate frame with corrupted CRC", sensirion_validate_test_2),
+    Case("Sensirion validate frame with invalid length", sensirion_validate_test_3),
+    Case("Sensirion decode SCD30 frame to words", sensirion_decode_words_test_1),
+    Case("Sensirion decode SPS30 frame to floats", sensirion_decode_floats_test_1),
+    Case("Sensirion decode SCD30 frame to struct", sensirion_decode_frame_test_1),
+    Case("Sensirion decode frame to struct of wrong size", sensirion_decode_frame_test_2),
+    Case("Sensirion benchmark bitwise vs table CRC on SPS30 frame", sensirion_benchmark_test_1),
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
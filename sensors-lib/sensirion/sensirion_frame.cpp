@@ -0,0 +1,228 @@
+/**
+ * @defgroup sensirion_frame Sensirion Frame Decoder
+ * @{
+ */
+
+#include <cstring>
+#include "mbed.h"
+#include "sensirion_frame.h"
+
+#if MBED_CONF_SENSORS_LIB_SENSIRION_HW_CRC && defined(CRC) && defined(CRC_CR_POLYSIZE_1)
+#define SENSIRION_USE_HW_CRC 1
+#else
+#define SENSIRION_USE_HW_CRC 0
+#endif
+
+/* CRC-8 lookup table for polynomial 0x31, indexed by (crc ^ data_byte) */
+static const uint8_t crc8_table[256] = {
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
+    0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4, 0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D,
+    0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+    0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C, 0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB,
+    0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA, 0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13,
+    0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+    0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95,
+    0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F, 0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6,
+    0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC, 0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+    0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE, 0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17,
+    0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B, 0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2,
+    0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+    0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69,
+    0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93, 0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A,
+    0xC1, 0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+    0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15, 0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC,
+};
+
+#if SENSIRION_USE_HW_CRC
+static Mutex crc_hw_mutex;
+static bool crc_hw_initialized = false;
+
+/**
+ *  @brief  Configures the STM32 CRC peripheral for 8 bit CRC with the Sensirion polynomial.
+ *  @author Lee Tze Han
+ */
+static void CrcHwInit(void)
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_CRCEN;
+    (void)RCC->AHB1ENR;     // Wait for peripheral clock to be enabled
+
+    CRC->POL = SENSIRION_CRC8_POLYNOMIAL;
+    CRC->INIT = SENSIRION_CRC8_INIT;
+    CRC->CR = CRC_CR_POLYSIZE_1;    // 8 bit polynomial, no input/output reversal
+
+    crc_hw_initialized = true;
+}
+
+/**
+ *  @brief  Computes CRC-8 of a 16 bit word with the STM32 CRC peripheral. Caller must hold crc_hw_mutex.
+ *  @author Lee Tze Han
+ *  @param  msb     most significant byte of the word
+ *  @param  lsb     least significant byte of the word
+ *  @return 8 bit CRC value
+ */
+static inline uint8_t CrcHwWord(uint8_t msb, uint8_t lsb)
+{
+    CRC->CR |= CRC_CR_RESET;
+    *(__IO uint8_t*)(&CRC->DR) = msb;
+    *(__IO uint8_t*)(&CRC->DR) = lsb;
+
+    return (uint8_t)(CRC->DR & 0xff);
+}
+#endif  // SENSIRION_USE_HW_CRC
+
+/**
+ *  @brief  Computes the Sensirion CRC-8 (poly 0x31, init 0xff) of an arbitrary byte sequence.
+ *  @author Lee Tze Han
+ *  @param  data    bytes to compute CRC over
+ *  @param  len     number of bytes in data
+ *  @return 8 bit CRC value
+ */
+uint8_t SensirionCrc8(const uint8_t* data, size_t len)
+{
+    uint8_t crc = SENSIRION_CRC8_INIT;
+    for (size_t i = 0; i < len; i++)
+    {
+        crc = crc8_table[crc ^ data[i]];
+    }
+
+    return crc;
+}
+
+/**
+ *  @brief  Computes the Sensirion CRC-8 of a 16 bit word, most significant byte first.
+ *  @author Lee Tze Han
+ *  @param  word    16 bit value to perform a CRC check on
+ *  @return 8 bit CRC value
+ */
+uint8_t SensirionCrc8Word(uint16_t word)
+{
+    uint8_t crc = crc8_table[SENSIRION_CRC8_INIT ^ (word >> 8)];
+
+    return crc8_table[crc ^ (word & 0xff)];
+}
+
+/**
+ *  @brief  Computes the CRC-8 of the data word in a triplet using the configured CRC engine.
+ *  @author Lee Tze Han
+ *  @param  p   pointer to the start of a triplet
+ *  @return 8 bit CRC value
+ */
+static inline uint8_t TripletCrc(const uint8_t* p)
+{
+#if SENSIRION_USE_HW_CRC
+    return CrcHwWord(p[0], p[1]);
+#else
+    return crc8_table[crc8_table[SENSIRION_CRC8_INIT ^ p[0]] ^ p[1]];
+#endif  // SENSIRION_USE_HW_CRC
+}
+
+/**
+ *  @brief  Acquires the CRC engine (no-op for the lookup table).
+ *  @author Lee Tze Han
+ */
+static inline void CrcLock(void)
+{
+#if SENSIRION_USE_HW_CRC
+    crc_hw_mutex.lock();
+    if (!crc_hw_initialized)
+    {
+        CrcHwInit();
+    }
+#endif  // SENSIRION_USE_HW_CRC
+}
+
+/**
+ *  @brief  Releases the CRC engine (no-op for the lookup table).
+ *  @author Lee Tze Han
+ */
+static inline void CrcUnlock(void)
+{
+#if SENSIRION_USE_HW_CRC
+    crc_hw_mutex.unlock();
+#endif  // SENSIRION_USE_HW_CRC
+}
+
+/**
+ *  @brief  Validates and decodes a frame of CRC triplets into 16 bit words in a single pass.
+ *  @author Lee Tze Han
+ *  @param  frame       raw bytes read from the sensor
+ *  @param  frame_len   number of bytes in frame
+ *  @param  words       output array of decoded words (may be NULL to only validate); undefined on CRC error
+ *  @param  num_words   number of words expected in frame
+ *  @return enum SensirionFrameStatus
+ */
+int SensirionDecodeWords(const char* frame, size_t frame_len, uint16_t* words, size_t num_words)
+{
+    if (frame_len != num_words * SENSIRION_TRIPLET_SIZE)
+    {
+        return SENSIRION_FRAME_LEN_ERR;
+    }
+
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(frame);
+    uint8_t crc_err = 0;
+
+    CrcLock();
+    for (size_t i = 0; i < num_words; i++, p += SENSIRION_TRIPLET_SIZE)
+    {
+        crc_err |= TripletCrc(p) ^ p[2];
+        if (words != NULL)
+        {
+            words[i] = (uint16_t)((p[0] << 8) | p[1]);
+        }
+    }
+    CrcUnlock();
+
+    return (crc_err == 0) ? SENSIRION_FRAME_OK : SENSIRION_FRAME_CRC_ERR;
+}
+
+/**
+ *  @brief  Validates every CRC triplet in a frame.
+ *  @author Lee Tze Han
+ *  @param  frame       raw bytes read from the sensor
+ *  @param  frame_len   number of bytes in frame; must be a multiple of 3
+ *  @return enum SensirionFrameStatus
+ */
+int SensirionValidateFrame(const char* frame, size_t frame_len)
+{
+    if (frame_len % SENSIRION_TRIPLET_SIZE != 0)
+    {
+        return SENSIRION_FRAME_LEN_ERR;
+    }
+
+    return SensirionDecodeWords(frame, frame_len, NULL, frame_len / SENSIRION_TRIPLET_SIZE);
+}
+
+/**
+ *  @brief  Validates and decodes a frame of big-endian IEEE754 floats (two triplets each) in a single pass.
+ *  @author Lee Tze Han
+ *  @param  frame       raw bytes read from the sensor
+ *  @param  frame_len   number of bytes in frame
+ *  @param  values      output array of decoded floats; undefined on CRC error
+ *  @param  num_values  number of floats expected in frame
+ *  @return enum SensirionFrameStatus
+ */
+int SensirionDecodeFloats(const char* frame, size_t frame_len, float* values, size_t num_values)
+{
+    if (frame_len != num_values * 2 * SENSIRION_TRIPLET_SIZE)
+    {
+        return SENSIRION_FRAME_LEN_ERR;
+    }
+
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(frame);
+    uint8_t crc_err = 0;
+
+    CrcLock();
+    for (size_t i = 0; i < num_values; i++, p += 2 * SENSIRION_TRIPLET_SIZE)
+    {
+        crc_err |= TripletCrc(p) ^ p[2];
+        crc_err |= TripletCrc(p + SENSIRION_TRIPLET_SIZE) ^ p[5];
+
+        uint32_t raw = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[3] << 8) | p[4];
+        std::memcpy(&values[i], &raw, sizeof(float));
+    }
+    CrcUnlock();
+
+    return (crc_err == 0) ? SENSIRION_FRAME_OK : SENSIRION_FRAME_CRC_ERR;
+}
+
+ /** @}*/
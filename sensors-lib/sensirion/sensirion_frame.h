@@ -0,0 +1,82 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+
+#ifndef SENSIRION_FRAME_H
+#define SENSIRION_FRAME_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SENSIRION_CRC8_POLYNOMIAL       0x31    // P(x) = x^8 + x^5 + x^4 + 1 = 100110001
+#define SENSIRION_CRC8_INIT             0xff
+
+#define SENSIRION_WORD_SIZE             2       // 16 bit data word
+#define SENSIRION_TRIPLET_SIZE          3       // 16 bit data word followed by its CRC-8
+
+/** Sensirion I2C frame decoder
+ *  @brief  Shared CRC-8 validation and big-endian decoding of Sensirion sensor frames (SPS30, SCD30)
+ *
+ *  Sensirion sensors return data as a sequence of triplets, each holding a 16 bit big-endian word and
+ *  the CRC-8 of that word. A 32 bit float is sent as two consecutive triplets (high word first).
+ *  The CRC is computed from a 256-entry lookup table, or by the STM32 CRC peripheral when
+ *  sensors-lib.sensirion-hw-crc is enabled.
+ *
+ *  Example:
+ *  @code{.cpp}
+ *  typedef struct {
+ *      float co2;
+ *      float temperature;
+ *      float humidity;
+ *  } measurement_t;
+ *
+ *  measurement_t meas;
+ *  int stat = SensirionDecodeFrame(i2cbuff, 18, meas);
+ *  if (stat == SENSIRION_FRAME_OK)
+ *  {
+ *      printf("co2: %f\r\n", meas.co2);
+ *  }
+ *  @endcode
+ */
+
+enum SensirionFrameStatus {
+    SENSIRION_FRAME_OK,         // all triplets passed CRC check
+    SENSIRION_FRAME_CRC_ERR,    // at least one triplet failed CRC check
+    SENSIRION_FRAME_LEN_ERR,    // frame length does not match the requested number of words
+};
+
+uint8_t SensirionCrc8(const uint8_t* data, size_t len);
+uint8_t SensirionCrc8Word(uint16_t word);
+int SensirionValidateFrame(const char* frame, size_t frame_len);
+int SensirionDecodeWords(const char* frame, size_t frame_len, uint16_t* words, size_t num_words);
+int SensirionDecodeFloats(const char* frame, size_t frame_len, float* values, size_t num_values);
+
+/**
+ *  @brief  Validates and decodes a Sensirion frame into a struct made up only of float members.
+ *  @author Lee Tze Han
+ *  @param  frame       raw bytes read from the sensor
+ *  @param  frame_len   number of bytes in frame
+ *  @param  out         struct of floats, in the same order as they appear in the frame
+ *  @return enum SensirionFrameStatus
+ */
+template <typename T>
+int SensirionDecodeFrame(const char* frame, size_t frame_len, T& out)
+{
+    static_assert(sizeof(T) % sizeof(float) == 0, "Sensirion frame struct must only contain float members");
+
+    return SensirionDecodeFloats(frame, frame_len, reinterpret_cast<float*>(&out), sizeof(T) / sizeof(float));
+}
+
+#endif  // SENSIRION_FRAME_H
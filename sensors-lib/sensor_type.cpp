@@ -30,4 +30,42 @@ int SensorType::ValidateData(float data, float data_min, float data_max)
             return DATA_OUT_OF_RANGE;
         }
     else return DATA_OK;
-}
\ No newline at end of file
+}
+
+/**
+ *  @brief  String adapter over the numeric GetData; formats each reading and rebuilds data_oor_list.
+ *  @author Lee Tze Han
+ *  @param  data_list   vector of string pairs (data_name, data_value); events are reported with an empty value
+ *  @return enum SensorStatus
+ */
+int SensorType::GetData(std::vector<std::pair<std::string, std::string>>& data_list)
+{
+	sensor_reading_t readings[SENSOR_MAX_READINGS];
+	size_t count = 0;
+
+	int stat = GetData(readings, SENSOR_MAX_READINGS, count);
+	if (stat != DATA_OK)
+	{
+		return stat;
+	}
+
+	data_oor_list.clear();
+	for (size_t i = 0; i < count; i++)
+	{
+		std::string id = readings[i].measure_point_id;
+		if (readings[i].quality & READING_EVENT)
+		{
+			data_list.push_back(make_pair(id, ""));
+			continue;
+		}
+
+		std::string value = ConvertDataToString(readings[i].value);
+		if (readings[i].quality & READING_OUT_OF_RANGE)
+		{
+			data_oor_list.push_back("_" + id + "_out_of_range_" + value);
+		}
+		data_list.push_back(make_pair(id, value));
+	}
+
+	return stat;
+}
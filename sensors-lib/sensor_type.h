@@ -17,9 +17,20 @@
 #ifndef __SENSOR_TYPE_H_INCLUDED__
 #define __SENSOR_TYPE_H_INCLUDED__
 
+#include <stddef.h>
+#include <stdint.h>
 #include <string>
 #include <vector>
 
+#define SENSOR_MAX_READINGS		12	// capacity of the reading buffer used by the string GetData adapter
+
+/** Single measurement produced by a sensor driver */
+typedef struct {
+	const char* measure_point_id;	// must point to storage with static lifetime (e.g. a string literal)
+	float value;
+	uint8_t quality;				// bitmask of SensorType::ReadingQuality
+} sensor_reading_t;
+
 /** SensorType Abstract class.
  *  @brief  Used as an interface between SensorManager class and individual Sensor Drivers
  *
@@ -32,7 +43,8 @@
  *  {
  *  public:
  * 		virtual int GetName() { return "sensorname"; };
- * 		virtual std::vector<std::pair<std::string, std::string>> GetData();
+ * 		using SensorType::GetData;	// keep the string adapter visible
+ * 		virtual int GetData(sensor_reading_t* readings, size_t capacity, size_t& count);
  * 
  * 		// other public methods and members
  * 
@@ -53,9 +65,16 @@ public:
         DATA_NOT_RDY,
 		DATA_OUT_OF_RANGE,
 	};
+
+	enum ReadingQuality {
+		READING_OK = 0,
+		READING_OUT_OF_RANGE = (1U << 0),	// value failed ValidateData
+		READING_EVENT = (1U << 1),			// event without a meaningful value (e.g. threshold alert)
+	};
 	
 	virtual std::string GetName() = 0;
-	virtual int GetData(std::vector<std::pair<std::string, std::string>>&) = 0;  // getting data
+	virtual int GetData(sensor_reading_t* readings, size_t capacity, size_t& count) = 0;  // getting data
+	virtual int GetData(std::vector<std::pair<std::string, std::string>>& data_list);   // string adapter over numeric GetData
 	virtual void Enable() = 0;
 	virtual void Disable() = 0;
 	virtual void Reset() = 0;
@@ -1,5 +1,6 @@
 #include "mbed.h"
 #include "sps30.h"
+#include "sensors-lib/sensirion/sensirion_frame.h"
 
 /** Create a SPS30 object using the specified I2C object
  * @param sda - mbed I2C interface pin
@@ -104,7 +105,7 @@ uint8_t Sps30::GetReadyStatus()
 
 /** Get all particulate matter parameters
  *
- * @see Results in Public member variables
+ * @see Results in meas
  *
  * @return enum SPSerror
  */
@@ -115,148 +116,10 @@ uint8_t Sps30::ReadMeasurement()
     int res = _i2c.write(SPS30_I2C_ADDR, i2cbuff, 2, false);
     if(res) return SPSNOACKERROR;
     
-    _i2c.read(SPS30_I2C_ADDR | 1, i2cbuff, 60, false);
+    _i2c.read(SPS30_I2C_ADDR | 1, i2cbuff, SPS30_MEAS_SIZE, false);
     
-    uint16_t stat = (i2cbuff[0] << 8) | i2cbuff[1];
-    mass_1p0_m = stat;
-    uint8_t dat = Sps30::CheckCrc2b(stat, i2cbuff[2]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-    
-    stat = (i2cbuff[3] << 8) | i2cbuff[4];
-    mass_1p0_l = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[5]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-
-
-    
-    stat = (i2cbuff[6] << 8) | i2cbuff[7];
-    mass_2p5_m = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[8]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-    
-    stat = (i2cbuff[9] << 8) | i2cbuff[10];
-    mass_2p5_l = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[11]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-
-
-    
-    stat = (i2cbuff[12] << 8) | i2cbuff[13];
-    mass_4p0_m = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[14]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-    
-    stat = (i2cbuff[15] << 8) | i2cbuff[16];
-    mass_4p0_l = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[17]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-
-
-
-    stat = (i2cbuff[18] << 8) | i2cbuff[19];
-    mass_10p0_m = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[20]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-    
-    stat = (i2cbuff[21] << 8) | i2cbuff[22];
-    mass_10p0_l = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[23]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-
-
-
-    stat = (i2cbuff[24] << 8) | i2cbuff[25];
-    num_0p5_m = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[26]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-    
-    stat = (i2cbuff[27] << 8) | i2cbuff[28];
-    num_0p5_l = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[29]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-
-
-    stat = (i2cbuff[30] << 8) | i2cbuff[31];
-    num_1p0_m = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[32]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-    
-    stat = (i2cbuff[33] << 8) | i2cbuff[34];
-    num_1p0_l = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[35]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-
-
-    
-    stat = (i2cbuff[36] << 8) | i2cbuff[37];
-    num_2p5_m = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[38]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-    
-    stat = (i2cbuff[39] << 8) | i2cbuff[40];
-    num_2p5_l = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[41]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-
-
-    
-    stat = (i2cbuff[42] << 8) | i2cbuff[43];
-    num_4p0_m = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[44]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-    
-    stat = (i2cbuff[45] << 8) | i2cbuff[46];
-    num_4p0_l = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[47]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-
-
-    stat = (i2cbuff[48] << 8) | i2cbuff[49];
-    num_10p0_m = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[50]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-    
-    stat = (i2cbuff[51] << 8) | i2cbuff[52];
-    num_10p0_l = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[53]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-
-
-    stat = (i2cbuff[54] << 8) | i2cbuff[55];
-    typ_pm_size_m = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[56]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-    
-    stat = (i2cbuff[57] << 8) | i2cbuff[58];
-    typ_pm_size_l = stat;
-    dat = Sps30::CheckCrc2b(stat, i2cbuff[59]);
-    if(dat == SPSCRCERROR) return SPSCRCERROR;
-    
-    mass_1p0_i = (mass_1p0_m << 16) | mass_1p0_l;
-    mass_2p5_i = (mass_2p5_m << 16) | mass_2p5_l;
-    mass_4p0_i = (mass_4p0_m << 16) | mass_4p0_l;
-    mass_10p0_i = (mass_10p0_m << 16) | mass_10p0_l;
-
-    num_0p5_i = (num_0p5_m << 16) | num_0p5_l;
-    num_1p0_i = (num_1p0_m << 16) | num_1p0_l;
-    num_2p5_i = (num_2p5_m << 16) | num_2p5_l;
-    num_4p0_i = (num_4p0_m << 16) | num_4p0_l;
-    num_10p0_i = (num_10p0_m << 16) | num_10p0_l;          
-
-    typ_pm_size_i = (typ_pm_size_m << 16) | typ_pm_size_l;          
-
-    mass_1p0_f = *(float*)&mass_1p0_i;
-    mass_2p5_f = *(float*)&mass_2p5_i;
-    mass_4p0_f = *(float*)&mass_4p0_i;
-    mass_10p0_f = *(float*)&mass_10p0_i;
-
-    num_0p5_f = *(float*)&num_0p5_i;
-    num_1p0_f = *(float*)&num_1p0_i;
-    num_2p5_f = *(float*)&num_2p5_i;
-    num_4p0_f = *(float*)&num_4p0_i;
-    num_10p0_f = *(float*)&num_10p0_i;          
-
-    typ_pm_size_f = *(float*)&typ_pm_size_i;
+    int stat = SensirionDecodeFrame(i2cbuff, SPS30_MEAS_SIZE, meas);
+    if(stat != SENSIRION_FRAME_OK) return SPSCRCERROR;
     
     return SPSNOERROR;
 }
@@ -371,26 +234,7 @@ uint8_t Sps30::SoftReset()
  */
 uint8_t Sps30::CalcCrc2b(uint16_t seed)
 {
-  uint8_t bit;                  // bit mask
-  uint8_t crc = SPS30_CRC_INIT; // calculated checksum
-  
-  // calculates 8-Bit checksum with given polynomial
-
-    crc ^= (seed >> 8) & 255;
-    for(bit = 8; bit > 0; --bit)
-    {
-      if(crc & 0x80) crc = (crc << 1) ^ SPS30_POLYNOMIAL;
-      else           crc = (crc << 1);
-    }
-
-    crc ^= seed & 255;
-    for(bit = 8; bit > 0; --bit)
-    {
-      if(crc & 0x80) crc = (crc << 1) ^ SPS30_POLYNOMIAL;
-      else           crc = (crc << 1);
-    }
-    
-  return crc;
+    return SensirionCrc8Word(seed);
 }
 
 /** Compare received CRC value with calculated CRC value
@@ -420,12 +264,20 @@ std::string Sps30::GetName()
 
 /** Get Sensor Data (Overrides SensorType virtual func)
  * 
- * @param   data_list   vector of string pairs (data_name, data_value)
+ * @param   readings    caller-provided array of readings
+ * @param   capacity    number of elements in readings (at least 2)
+ * @param   count       number of readings written
  *
  * @return  enum SensorStatus in SensorType base class
  */
-int Sps30::GetData(std::vector<std::pair<std::string, std::string>>& data_list)
+int Sps30::GetData(sensor_reading_t* readings, size_t capacity, size_t& count)
 {
+    count = 0;
+    if (capacity < 2)
+    {
+        return SensorType::DATA_NOT_RDY;
+    }
+
     uint8_t dat = GetReadyStatus();
     if (dat == SPSNOACKERROR)
     {
@@ -437,26 +289,13 @@ int Sps30::GetData(std::vector<std::pair<std::string, std::string>>& data_list)
         uint8_t crcc = ReadMeasurement();
         if (crcc == SPSNOERROR)
         {
-            data_oor_list.clear();
-
-            std::string mass_2p5 = ConvertDataToString(mass_2p5_f);
-            std::string mass_10p0 = ConvertDataToString(mass_10p0_f);
-
-            int ret = ValidateData(mass_2p5_f, MASS_MIN, MASS_MAX);
-            if (ret == DATA_OUT_OF_RANGE)
-            {
-                std::string msg = "_PM2.5_mass_out_of_range_" + mass_2p5;
-                data_oor_list.push_back(msg);
-            }
-            data_list.push_back(make_pair("PM2.5_mass", mass_2p5));
+            int ret = ValidateData(meas.mass_2p5, MASS_MIN, MASS_MAX);
+            uint8_t quality = (ret == DATA_OUT_OF_RANGE) ? READING_OUT_OF_RANGE : READING_OK;
+            readings[count++] = {"PM2.5_mass", meas.mass_2p5, quality};
 
-            ret = ValidateData(mass_10p0_f, MASS_MIN, MASS_MAX);
-            if (ret == DATA_OUT_OF_RANGE)
-            {
-                std::string msg = "_PM10_mass_out_of_range_" + mass_10p0;
-                data_oor_list.push_back(msg);
-            }
-            data_list.push_back(make_pair("PM10_mass",mass_10p0));
+            ret = ValidateData(meas.mass_10p0, MASS_MIN, MASS_MAX);
+            quality = (ret == DATA_OUT_OF_RANGE) ? READING_OUT_OF_RANGE : READING_OK;
+            readings[count++] = {"PM10_mass", meas.mass_10p0, quality};
 
             return SensorType::DATA_OK;
         }
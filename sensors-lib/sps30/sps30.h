@@ -36,10 +36,8 @@
 
 #define SPS30_STRT_MEAS_WRITE_DATA      0x0300
     
-#define SPS30_POLYNOMIAL                0x31    // P(x) = x^8 + x^5 + x^4 + 1 = 100110p01
-#define SPS30_CRC_INIT                  0xff
-
 #define SPS30_SN_SIZE                   33      // size of the s/n ascii string + CRC values
+#define SPS30_MEAS_SIZE                 60      // 10 floats, each sent as 2 CRC triplets
 
 #define MASS_MAX            1000.00f
 #define MASS_MIN            0.00f
@@ -48,6 +46,20 @@
 
 #define I2C_FREQUENCY_STD   100000              // SPS30 uses 100MHz for I2C communication
 
+/** Measurement frame of the SPS30, in the order returned by SPS30_CMMD_READ_MEAS */
+typedef struct {
+    float mass_1p0;         /**< Mass Conc of PM1.0 */
+    float mass_2p5;         /**< Mass Conc of PM2.5 */
+    float mass_4p0;         /**< Mass Conc of PM4.0 */
+    float mass_10p0;        /**< Mass Conc of PM10 */
+    float num_0p5;          /**< Number Conc of PM0.5 */
+    float num_1p0;          /**< Number Conc of PM1.0 */
+    float num_2p5;          /**< Number Conc of PM2.5 */
+    float num_4p0;          /**< Number Conc of PM4.0 */
+    float num_10p0;         /**< Number Conc of PM10 */
+    float typ_pm_size;      /**< Typical Particle Size */
+} sps30_measurement_t;
+
 /** Create SPS30 controller class
  * @brief Driver for the SPS30 Particulate Matter sensor
  * Inherits SensorType virtual functions essential for interfacing with SensorManager
@@ -83,7 +95,8 @@ public:
      Sps30(PinName sda, PinName scl, int i2c_frequency);
     ~Sps30();
     std::string GetName();
-    int GetData(std::vector<std::pair<std::string, std::string>>& data_list);
+    using SensorType::GetData;
+    int GetData(sensor_reading_t* readings, size_t capacity, size_t& count);
     void Enable();
 	void Disable();
 	// void Configure();   // To be done in SENP-286
@@ -103,60 +116,13 @@ private:
     uint16_t sps_ready;            /**< 1 = ready, 0 = busy */
     uint32_t clean_interval_i;     /** 32 unsigned bit in seconds */
 
-    float mass_1p0_f;       /**< float of Mass Conc of PM1.0 */
-    float mass_2p5_f;       /**< float of Mass Conc of PM2.5 */
-    float mass_4p0_f;       /**< float of Mass Conc of PM4.0 */
-    float mass_10p0_f;      /**< float of Mass Conc of PM10 */
-
-    float num_0p5_f;        /**< float of Number Conc of PM0.5 */
-    float num_1p0_f;        /**< float of Number Conc of PM1.0 */
-    float num_2p5_f;        /**< float of Number Conc of PM2.5 */
-    float num_4p0_f;        /**< float of Number Conc of PM4.0 */
-    float num_10p0_f;       /**< float of Number Conc of PM10 */
+    sps30_measurement_t meas;   /**< Decoded measurement frame */
 
-    float typ_pm_size_f;    /**< float of Typical Particle Size */
-    
-    char i2cbuff[60];
+    char i2cbuff[SPS30_MEAS_SIZE];
     
     uint16_t clean_interval_m;    /**< High order 16 bit word of Auto Clean Interval */
     uint16_t clean_interval_l;    /**< High order 16 bit word of Auto Clean Interval */
 
-    uint16_t mass_1p0_m;          /**< High order 16 bit word of Mass Conc of PM1.0 */
-    uint16_t mass_1p0_l;          /**< Low order 16 bit word of Mass Conc of PM1.0 */
-    uint16_t mass_2p5_m;          /**< High order 16 bit word of Mass Conc of PM2.5 */
-    uint16_t mass_2p5_l;          /**< Low order 16 bit word of Mass Conc of PM2.5 */
-    uint16_t mass_4p0_m;          /**< High order 16 bit word of Mass Conc of PM4.0 */
-    uint16_t mass_4p0_l;          /**< Low order 16 bit word of Mass Conc of PM4.0 */
-    uint16_t mass_10p0_m;         /**< High order 16 bit word of Mass Conc of PM10 */
-    uint16_t mass_10p0_l;         /**< Low order 16 bit word of Mass Conc of PM10 */
-
-    uint16_t num_0p5_m;           /**< High order 16 bit word of Number Conc of PM0.5 */
-    uint16_t num_0p5_l;           /**< Low order 16 bit word of Number Conc of PM0.5 */
-    uint16_t num_1p0_m;           /**< High order 16 bit word of Number Conc of PM1.0 */
-    uint16_t num_1p0_l;           /**< Low order 16 bit word of Number Conc of PM1.0 */
-    uint16_t num_2p5_m;           /**< High order 16 bit word of Number Conc of PM2.5 */
-    uint16_t num_2p5_l;           /**< Low order 16 bit word of Number Conc of PM2.5 */
-    uint16_t num_4p0_m;           /**< High order 16 bit word of Number Conc of PM4.0 */
-    uint16_t num_4p0_l;           /**< Low order 16 bit word of Number Conc of PM4.0 */
-    uint16_t num_10p0_m;          /**< High order 16 bit word of Number Conc of PM10 */
-    uint16_t num_10p0_l;          /**< Low order 16 bit word of Number Conc of PM10 */
-
-    uint16_t typ_pm_size_m;       /**< High order 16 bit word of Typical Particle Size */
-    uint16_t typ_pm_size_l;       /**< Low order 16 bit word of Typical Particle Size */
-
-    uint32_t mass_1p0_i;          /**< 32 bit int of Mass Conc of PM1.0 */
-    uint32_t mass_2p5_i;          /**< 32 bit int of Mass Conc of PM2.5 */
-    uint32_t mass_4p0_i;          /**< 32 bit int of Mass Conc of PM4.0 */
-    uint32_t mass_10p0_i;         /**< 32 bit int of Mass Conc of PM10 */
-
-    uint32_t num_0p5_i;           /**< 32 bit int of Number Conc of PM0.5 */
-    uint32_t num_1p0_i;           /**< 32 bit int of Number Conc of PM1.0 */
-    uint32_t num_2p5_i;           /**< 32 bit int of Number Conc of PM2.5 */
-    uint32_t num_4p0_i;           /**< 32 bit int of Number Conc of PM4.0 */
-    uint32_t num_10p0_i;          /**< 32 bit int of Number Conc of PM10 */
-
-    uint32_t typ_pm_size_i;       /**< 32 bit int of Typical Particle Size */
-
     uint8_t StartMeasurement();
     uint8_t StopMeasurement();
     uint8_t GetSerialNumber();
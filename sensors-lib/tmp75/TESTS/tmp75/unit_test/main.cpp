@@ -68,6 +68,29 @@ static control_t tmp_get_data_test_2(const size_t call_count)
     return CaseNext;
 }
 
+static control_t tmp_get_data_test_3(const size_t call_count) 
+{
+    
+    Tmp75 tmp_test(TMP75_SDA, TMP75_SCL, ALRT_PIN, 400000);
+    sensor_reading_t readings[SENSOR_MAX_READINGS];
+    size_t count = 0;
+    std::string actual_str;
+
+    tmp_test.Enable();
+    int ret = tmp_test.GetData(readings, SENSOR_MAX_READINGS, count);
+    if (ret == Tmp75::DATA_OK && count > 0)
+    {
+        actual_str = readings[0].measure_point_id;
+        TEST_ASSERT_FLOAT_WITHIN(50.00, 50.00, readings[0].value);    // test range between 0 to 100C
+    }
+    else actual_str = "disconnected";
+
+    std::string expected_str = "ambient_temp";
+    TEST_ASSERT_EQUAL_STRING(expected_str.c_str(), actual_str.c_str());
+
+    return CaseNext;
+}
+
 static control_t tmp_enable_test_1(const size_t call_count) 
 {
     
@@ -284,6 +307,7 @@ Case cases[] =
     Case("Check Tmp75 GetName sensor name", tmp_get_name_test_1),
     Case("Check Tmp75 GetData data name", tmp_get_data_test_1),
     Case("Check Tmp75 GetData data value range between 0 to 100", tmp_get_data_test_2),
+    Case("Check Tmp75 numeric GetData data name and value range", tmp_get_data_test_3),
     Case("Check Tmp75 Enable", tmp_enable_test_1),
     Case("Check Tmp75 Disable", tmp_disable_test_1),
     Case("Check Tmp75 Reset when enabled", tmp_reset_test_1),
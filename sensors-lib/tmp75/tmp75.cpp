@@ -28,25 +28,29 @@ std::string Tmp75::GetName()
 
 /** Get Sensor Data (Overrides SensorType virtual func)
  * 
- * @param   data_list   vector of string pairs (data_name, data_value)
+ * @param   readings    caller-provided array of readings
+ * @param   capacity    number of elements in readings (at least 2)
+ * @param   count       number of readings written
  *
  * @return  enum SensorStatus in SensorType base class
  */
-int Tmp75::GetData(std::vector<std::pair<std::string, std::string>>& data_list)
+int Tmp75::GetData(sensor_reading_t* readings, size_t capacity, size_t& count)
 {
+	count = 0;
 	if (!active_) return DISCONNECT;
 
 	int ret = ReadTemp();
 	if (ret != Tmp75::TMPACK) return DISCONNECT;
 
-	float tmp_temp = GetTempData();
-	std::string amb_temp = ConvertDataToString(tmp_temp);
-	data_list.push_back(make_pair("ambient_temp", amb_temp));
+	if (capacity > count)
+	{
+		readings[count++] = {"ambient_temp", GetTempData(), READING_OK};
+	}
 
 	int alert = ReadAlert();
-	if (alert == TMPALERT)
+	if (alert == TMPALERT && capacity > count)
 	{
-		data_list.push_back(make_pair("ambient_temp_alert", ""));
+		readings[count++] = {"ambient_temp_alert", 0.0f, READING_EVENT};
 	}
 	return DATA_OK;
 }
@@ -98,7 +98,8 @@ public:
 	~Tmp75();
 
 	std::string GetName();
-	int GetData(std::vector<std::pair<std::string, std::string>>& data_list);
+	using SensorType::GetData;
+	int GetData(sensor_reading_t* readings, size_t capacity, size_t& count);
 	void Enable();
 	void Disable();
 	void Reset();
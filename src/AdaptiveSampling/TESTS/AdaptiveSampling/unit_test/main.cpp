@@ -0,0 +1,151 @@
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "adaptive_sampling.h"
+
+using namespace utest::v1;
+
+static const sampling_policy_t fixed_policy = {false, 0, 0, 0.0f, 0.0f};
+static const sampling_policy_t adaptive_policy = {true, 2000, 60000, 0.05f, 0.02f};
+
+// Reads the sampler once when due, with a single co2 reading
+static bool Sample(AdaptiveSampler& sampler, uint64_t now_ms, float value)
+{
+    if (!sampler.Due(now_ms))
+    {
+        return false;
+    }
+
+    sensor_reading_t reading = {"co2", value, SensorType::READING_OK};
+    sampler.Update(&reading, 1, now_ms);
+
+    return true;
+}
+
+// Test that the fixed policy reads at the base interval, on the grid of the due times
+static control_t fixed_policy_test_1(const size_t call_count)
+{
+    AdaptiveSampler sampler;
+    sampler.SetPolicy(fixed_policy, 10000);
+
+    TEST_ASSERT_TRUE(Sample(sampler, 1000, 400.0f));
+    TEST_ASSERT_FALSE(sampler.Due(10999));
+    TEST_ASSERT_TRUE(Sample(sampler, 11000, 800.0f));
+
+    /* A late read does not delay the next one */
+    TEST_ASSERT_TRUE(Sample(sampler, 21400, 400.0f));
+    TEST_ASSERT_TRUE(sampler.Due(31000));
+    TEST_ASSERT_EQUAL_UINT32(10000, sampler.GetInterval());
+
+    /* A new poll rate counts from the previous read */
+    sampler.SetBaseInterval(20000);
+    TEST_ASSERT_FALSE(sampler.Due(41399));
+    TEST_ASSERT_TRUE(sampler.Due(41400));
+
+    return CaseNext;
+}
+
+// Test that a stable signal backs off exponentially up to the max interval
+static control_t adaptive_policy_test_1(const size_t call_count)
+{
+    AdaptiveSampler sampler;
+    sampler.SetPolicy(adaptive_policy, 10000);
+
+    uint64_t now_ms = 0;
+    TEST_ASSERT_TRUE(Sample(sampler, now_ms, 400.0f));
+    TEST_ASSERT_EQUAL_UINT32(10000, sampler.GetInterval());
+
+    const uint32_t expected_ms[] = {20000, 40000, 60000, 60000};
+    for (size_t i = 0; i < sizeof(expected_ms) / sizeof(expected_ms[0]); i++)
+    {
+        now_ms += sampler.GetInterval();
+        TEST_ASSERT_TRUE(Sample(sampler, now_ms, 400.0f));
+        TEST_ASSERT_EQUAL_UINT32(expected_ms[i], sampler.GetInterval());
+    }
+
+    return CaseNext;
+}
+
+// Test that a spike drops to the min interval until the signal settles again
+static control_t adaptive_policy_test_2(const size_t call_count)
+{
+    AdaptiveSampler sampler;
+    sampler.SetPolicy(adaptive_policy, 60000);
+
+    uint64_t now_ms = 0;
+    TEST_ASSERT_TRUE(Sample(sampler, now_ms, 400.0f));
+    now_ms += sampler.GetInterval();
+    TEST_ASSERT_TRUE(Sample(sampler, now_ms, 400.0f));
+    TEST_ASSERT_EQUAL_UINT32(60000, sampler.GetInterval());
+
+    /* CO2 spike */
+    now_ms += sampler.GetInterval();
+    TEST_ASSERT_TRUE(Sample(sampler, now_ms, 1200.0f));
+    TEST_ASSERT_EQUAL_UINT32(2000, sampler.GetInterval());
+    TEST_ASSERT_FALSE(sampler.Due(now_ms + 1999));
+
+    /* Held at the min interval while the variance decays, then backs off */
+    size_t fast_reads = 0;
+    while (sampler.GetInterval() == 2000)
+    {
+        now_ms += 2000;
+        TEST_ASSERT_TRUE(Sample(sampler, now_ms, 1200.0f));
+        fast_reads++;
+        TEST_ASSERT_TRUE(fast_reads < 100);
+    }
+    TEST_ASSERT_TRUE(fast_reads > 1);
+    TEST_ASSERT_EQUAL_UINT32(4000, sampler.GetInterval());
+
+    return CaseNext;
+}
+
+// Test that failed reads and readings of bad quality keep the schedule without updating the statistics
+static control_t adaptive_policy_test_3(const size_t call_count)
+{
+    AdaptiveSampler sampler;
+    sampler.SetPolicy(adaptive_policy, 500);
+    TEST_ASSERT_EQUAL_UINT32(2000, sampler.GetInterval());
+
+    TEST_ASSERT_TRUE(Sample(sampler, 0, 25.0f));
+    sampler.Update(NULL, 0, 2000);
+    TEST_ASSERT_EQUAL_UINT32(2000, sampler.GetInterval());
+    TEST_ASSERT_FALSE(sampler.Due(3999));
+
+    sensor_reading_t reading = {"temperature", 1000.0f, SensorType::READING_OUT_OF_RANGE};
+    sampler.Update(&reading, 1, 4000);
+    TEST_ASSERT_EQUAL_UINT32(4000, sampler.GetInterval());
+
+    /* Temperature near 0 is judged against a floor of 1, not its own small mean */
+    AdaptiveSampler cold_sampler;
+    cold_sampler.SetPolicy(adaptive_policy, 10000);
+    TEST_ASSERT_TRUE(Sample(cold_sampler, 0, 0.01f));
+    TEST_ASSERT_TRUE(Sample(cold_sampler, 10000, 0.011f));
+    TEST_ASSERT_EQUAL_UINT32(20000, cold_sampler.GetInterval());
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test fixed sampling policy", fixed_policy_test_1),
+    Case("Test backoff of a stable signal", adaptive_policy_test_1),
+    Case("Test response to a spike", adaptive_policy_test_2),
+    Case("Test failed and bad quality reads", adaptive_policy_test_3)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,189 @@
+/**
+ * @defgroup adaptive_sampling Adaptive Sampling
+ * @{
+ */
+
+#include "adaptive_sampling.h"
+#include <math.h>
+#include "mbed_trace.h"
+
+#define TRACE_GROUP  "AdaptiveSampling"
+
+/**
+ *  @brief  Sets the sampling policy and the interval of the fixed policy, restarting the statistics.
+ *  @author Lee Tze Han
+ *  @param  policy              Sampling policy
+ *  @param  base_interval_ms    Fixed interval; the starting interval of the adaptive policy
+ */
+void AdaptiveSampler::SetPolicy(const sampling_policy_t& policy, uint32_t base_interval_ms)
+{
+    policy_ = policy;
+    if (policy_.adaptive && (policy_.max_interval_ms < policy_.min_interval_ms))
+    {
+        tr_warn("Sampling max interval below min interval");
+        policy_.max_interval_ms = policy_.min_interval_ms;
+    }
+    primed_points_ = 0;
+
+    SetBaseInterval(base_interval_ms);
+}
+
+/**
+ *  @brief  Sets the interval of the fixed policy, taking effect from the previous read.
+ *  @author Lee Tze Han
+ *  @param  base_interval_ms    Fixed interval (sensorpollrate)
+ */
+void AdaptiveSampler::SetBaseInterval(uint32_t base_interval_ms)
+{
+    interval_ms_ = Clamp(base_interval_ms);
+    if (next_due_ms_ != 0)
+    {
+        next_due_ms_ = last_sample_ms_ + interval_ms_;
+    }
+}
+
+/**
+ *  @brief  Whether the sensor is due to be read.
+ *  @author Lee Tze Han
+ *  @param  now_ms  Kernel time in ms
+ *  @return Whether the next read is due
+ */
+bool AdaptiveSampler::Due(uint64_t now_ms) const
+{
+    return now_ms >= next_due_ms_;
+}
+
+/**
+ *  @brief  Time the sensor is next due.
+ *  @author Lee Tze Han
+ *  @return Kernel time in ms; 0 before the first read
+ */
+uint64_t AdaptiveSampler::NextDue(void) const
+{
+    return next_due_ms_;
+}
+
+/**
+ *  @brief  Records a read and schedules the next one.
+ *  @author Lee Tze Han
+ *  @param  readings    Readings of the sensor, in the order of its measure points
+ *  @param  count       Number of readings; 0 when the read failed
+ *  @param  now_ms      Kernel time in ms the read was due at
+ */
+void AdaptiveSampler::Update(const sensor_reading_t* readings, size_t count, uint64_t now_ms)
+{
+    if (policy_.adaptive)
+    {
+        const bool primed = primed_points_ > 0;
+        const float elapsed_s = primed ? (now_ms - last_sample_ms_) / 1000.0f : 0.0f;
+        const uint32_t previous_ms = interval_ms_;
+
+        if (Active(readings, count, elapsed_s))
+        {
+            interval_ms_ = policy_.min_interval_ms;
+        }
+        else if (primed && (count > 0))
+        {
+            /* Exponential backoff while stable; the first and failed reads keep the interval */
+            interval_ms_ = (interval_ms_ > policy_.max_interval_ms / 2) ? policy_.max_interval_ms : Clamp(interval_ms_ * 2);
+        }
+
+        if (interval_ms_ != previous_ms)
+        {
+            tr_debug("Sampling interval %lu ms", (unsigned long)interval_ms_);
+        }
+    }
+
+    /* Keep to the grid of the previous due time unless this is the first read or a full interval late */
+    if ((next_due_ms_ == 0) || (next_due_ms_ + interval_ms_ <= now_ms))
+    {
+        next_due_ms_ = now_ms + interval_ms_;
+    }
+    else
+    {
+        next_due_ms_ += interval_ms_;
+    }
+    last_sample_ms_ = now_ms;
+}
+
+uint32_t AdaptiveSampler::GetInterval(void) const
+{
+    return interval_ms_;
+}
+
+/**
+ *  @brief  Updates the running statistics of each measure point with a read.
+ *  @author Lee Tze Han
+ *  @param  readings    Readings of the sensor
+ *  @param  count       Number of readings
+ *  @param  elapsed_s   Time since the previous read; 0 before the first
+ *  @return Whether any measure point changed faster or varies more than its threshold
+ */
+bool AdaptiveSampler::Active(const sensor_reading_t* readings, size_t count, float elapsed_s)
+{
+    bool active = false;
+
+    if (count > SAMPLING_MAX_POINTS)
+    {
+        count = SAMPLING_MAX_POINTS;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        if (readings[i].quality != SensorType::READING_OK)
+        {
+            continue;
+        }
+
+        const float x = readings[i].value;
+        point_stats_t& stats = stats_[i];
+        if (i >= primed_points_)
+        {
+            stats = {x, 0.0f, x};
+            primed_points_ = i + 1;
+            continue;
+        }
+
+        /* Relative to the running mean, floored so that signals near 0 do not look active */
+        const float scale = fmaxf(fabsf(stats.mean), 1.0f);
+        const float rate = (elapsed_s > 0.0f) ? fabsf(x - stats.last) / scale / elapsed_s * 60.0f : 0.0f;
+
+        const float diff = x - stats.mean;
+        stats.mean += SAMPLING_EWMA_ALPHA * diff;
+        stats.variance = (1.0f - SAMPLING_EWMA_ALPHA) * (stats.variance + SAMPLING_EWMA_ALPHA * diff * diff);
+        stats.last = x;
+
+        const float variation = sqrtf(stats.variance) / scale;
+        if ((rate > policy_.change_threshold) || (variation > policy_.variance_threshold))
+        {
+            active = true;
+        }
+    }
+
+    return active;
+}
+
+/**
+ *  @brief  Bounds an interval by the adaptive policy.
+ *  @author Lee Tze Han
+ *  @param  interval_ms Interval to bound
+ *  @return interval_ms, within [min_interval_ms, max_interval_ms] under the adaptive policy
+ */
+uint32_t AdaptiveSampler::Clamp(uint32_t interval_ms) const
+{
+    if (!policy_.adaptive)
+    {
+        return interval_ms;
+    }
+    if (interval_ms < policy_.min_interval_ms)
+    {
+        return policy_.min_interval_ms;
+    }
+    if (interval_ms > policy_.max_interval_ms)
+    {
+        return policy_.max_interval_ms;
+    }
+
+    return interval_ms;
+}
+
+/** @}*/
@@ -0,0 +1,93 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef ADAPTIVE_SAMPLING_H
+#define ADAPTIVE_SAMPLING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sensor_type.h"
+
+#define SAMPLING_MAX_POINTS     4           // measure points of one sensor whose statistics are tracked
+#define SAMPLING_EWMA_ALPHA     0.25f       // weight of the newest sample in the running mean and variance
+
+/** Sampling policy shared by the sensors of a SensorBusGroup */
+typedef struct {
+    bool adaptive;                  /// false: fixed interval (sensorpollrate)
+    uint32_t min_interval_ms;       /// adaptive: interval while the signal is active
+    uint32_t max_interval_ms;       /// adaptive: longest interval the backoff reaches
+    float change_threshold;         /// adaptive: relative change per minute that marks the signal active
+    float variance_threshold;       /// adaptive: coefficient of variation that marks the signal active
+} sampling_policy_t;
+
+/** AdaptiveSampler class.
+ *  @brief  Sampling schedule of one sensor, fixed or adapted to the activity of its readings
+ *
+ *  Under the adaptive policy, each measure point of the sensor keeps a running (EWMA) mean and variance.
+ *  After a read, the signal is active when any point changed faster than change_threshold (relative to
+ *  max(|mean|, 1), per minute) or its coefficient of variation exceeds variance_threshold. An active
+ *  signal is sampled at min_interval_ms; a stable one doubles its interval on each read up to
+ *  max_interval_ms. Reads are scheduled on the grid of the previous due time, so the average interval
+ *  does not drift with the latency of the read.
+ *
+ *  Example:
+ *  @code{.cpp}
+ *  #include "adaptive_sampling.h"
+ *
+ *  int main()
+ *  {
+ *      sampling_policy_t policy = {true, 2000, 600000, 0.05f, 0.02f};
+ *      AdaptiveSampler sampler;
+ *      sampler.SetPolicy(policy, 60000);
+ *
+ *      uint64_t now_ms = Kernel::get_ms_count();
+ *      if (sampler.Due(now_ms))
+ *      {
+ *          sensor_reading_t reading = {"co2", 450.0f, SensorType::READING_OK};
+ *          sampler.Update(&reading, 1, now_ms);
+ *      }
+ *  }
+ *  @endcode
+ */
+
+class AdaptiveSampler
+{
+    public:
+        void SetPolicy(const sampling_policy_t& policy, uint32_t base_interval_ms);
+        void SetBaseInterval(uint32_t base_interval_ms);
+        bool Due(uint64_t now_ms) const;
+        uint64_t NextDue(void) const;
+        void Update(const sensor_reading_t* readings, size_t count, uint64_t now_ms);
+        uint32_t GetInterval(void) const;
+
+    private:
+        typedef struct {
+            float mean;                                                                     /// running mean
+            float variance;                                                                 /// running variance
+            float last;                                                                     /// previous sample
+        } point_stats_t;
+
+        bool Active(const sensor_reading_t* readings, size_t count, float elapsed_s);
+        uint32_t Clamp(uint32_t interval_ms) const;
+
+        sampling_policy_t policy_ = {false, 0, 0, 0.0f, 0.0f};
+        uint32_t interval_ms_ = 0;                                                          /// current interval
+        uint64_t next_due_ms_ = 0;                                                          /// 0: due at once
+        uint64_t last_sample_ms_ = 0;                                                       /// time of the previous read
+        point_stats_t stats_[SAMPLING_MAX_POINTS];
+        size_t primed_points_ = 0;                                                          /// points with statistics
+};
+
+#endif  // ADAPTIVE_SAMPLING_H
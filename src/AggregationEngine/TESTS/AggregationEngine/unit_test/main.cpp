@@ -0,0 +1,138 @@
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "aggregation_engine.h"
+#include "sensor_profile.h"
+#include "global_params.h"
+
+using namespace utest::v1;
+
+// Test that aggregation is disabled with a zero window
+static control_t aggregation_enable_test_1(const size_t call_count)
+{
+    AggregationEngine aggregation;
+
+    TEST_ASSERT_FALSE(aggregation.IsEnabled());
+    TEST_ASSERT_FALSE(aggregation.IsWindowClosed(100000));
+
+    aggregation.SetWindow(60000);
+    TEST_ASSERT_TRUE(aggregation.IsEnabled());
+    TEST_ASSERT_EQUAL_UINT32(60000, aggregation.GetWindow());
+
+    return CaseNext;
+}
+
+// Test for window closing only after window length has elapsed since first sample
+static control_t aggregation_window_test_1(const size_t call_count)
+{
+    AggregationEngine aggregation(60000);
+    aggregation.AddSample("temp", 1.0f, 1000);
+
+    TEST_ASSERT_FALSE(aggregation.IsWindowClosed(60999));
+    TEST_ASSERT_TRUE(aggregation.IsWindowClosed(61000));
+
+    return CaseNext;
+}
+
+// Test for window closing across 32 bit millisecond wrap-around
+static control_t aggregation_window_test_2(const size_t call_count)
+{
+    AggregationEngine aggregation(60000);
+    aggregation.AddSample("temp", 1.0f, 0xFFFFF000);
+
+    TEST_ASSERT_FALSE(aggregation.IsWindowClosed(0x00000100));
+    TEST_ASSERT_TRUE(aggregation.IsWindowClosed(0xFFFFF000 + 60000));
+
+    return CaseNext;
+}
+
+// Test for avg/min/max/stddev measure points in json packet at window close
+static control_t aggregation_close_test_1(const size_t call_count)
+{
+    std::string expected_packet, actual_packet;
+    SensorProfile temperature_profile;
+    AggregationEngine aggregation(60000);
+
+    aggregation.AddSample("temp", 1.0f, 0);
+    aggregation.AddSample("temp", 2.0f, 10000);
+    aggregation.AddSample("temp", 3.0f, 20000);
+    aggregation.AddSample("temp", 4.0f, 30000);
+    size_t actual_count = aggregation.CloseWindow(temperature_profile, 60000, 5);
+
+    // {"id":"<replace with actual uuid>","method":"thing.measurepoint.post","params":{"measurepoints":{"temp_avg":2.5,"temp_max":4.0,"temp_min":1.0,"temp_stddev":1.29}},"version":"1.0"}
+    expected_packet = "{\"id\":\"" + device_uuid + "\",\"method\":\"thing.measurepoint.post\",\"params\":{\"measurepoints\":{\"temp_avg\":2.5,\"temp_max\":4.0,\"temp_min\":1.0,\"temp_stddev\":1.29}},\"version\":\"1.0\"}";
+    actual_packet = temperature_profile.GetNewDecadaPacket();
+
+    TEST_ASSERT_EQUAL_UINT32(1, actual_count);
+    TEST_ASSERT_EQUAL_STRING(expected_packet.c_str(), actual_packet.c_str());
+
+    return CaseNext;
+}
+
+// Test that statistics are reset at window close
+static control_t aggregation_close_test_2(const size_t call_count)
+{
+    std::string expected_packet, actual_packet;
+    SensorProfile co2_profile;
+    AggregationEngine aggregation(60000);
+
+    aggregation.AddSample("co2", 1000.0f, 0);
+    aggregation.CloseWindow(co2_profile, 60000, 5);
+    co2_profile.ClearEntityList();
+
+    aggregation.AddSample("co2", 400.0f, 70000);
+    aggregation.CloseWindow(co2_profile, 120000, 10);
+
+    // {"id":"<replace with actual uuid>","method":"thing.measurepoint.post","params":{"measurepoints":{"co2_avg":400.0,"co2_max":400.0,"co2_min":400.0,"co2_stddev":0.0}},"version":"1.0"}
+    expected_packet = "{\"id\":\"" + device_uuid + "\",\"method\":\"thing.measurepoint.post\",\"params\":{\"measurepoints\":{\"co2_avg\":400.0,\"co2_max\":400.0,\"co2_min\":400.0,\"co2_stddev\":0.0}},\"version\":\"1.0\"}";
+    actual_packet = co2_profile.GetNewDecadaPacket();
+
+    TEST_ASSERT_EQUAL_STRING(expected_packet.c_str(), actual_packet.c_str());
+
+    return CaseNext;
+}
+
+// Test that samples beyond the measure point table capacity are dropped
+static control_t aggregation_capacity_test_1(const size_t call_count)
+{
+    static const char* ids[AGGREGATION_MAX_MEASURE_POINTS + 1] = {
+        "p0", "p1", "p2", "p3", "p4", "p5", "p6", "p7", "p8",
+        "p9", "p10", "p11", "p12", "p13", "p14", "p15", "p16"
+    };
+    AggregationEngine aggregation(60000);
+
+    for (size_t i = 0; i < AGGREGATION_MAX_MEASURE_POINTS; i++)
+    {
+        TEST_ASSERT_TRUE(aggregation.AddSample(ids[i], 1.0f, 0));
+    }
+    TEST_ASSERT_FALSE(aggregation.AddSample(ids[AGGREGATION_MAX_MEASURE_POINTS], 1.0f, 0));
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test aggregation enable with window length", aggregation_enable_test_1),
+    Case("Test window close after window length", aggregation_window_test_1),
+    Case("Test window close across millisecond wrap-around", aggregation_window_test_2),
+    Case("Test avg/min/max/stddev measure points at window close", aggregation_close_test_1),
+    Case("Test statistics reset at window close", aggregation_close_test_2),
+    Case("Test measure point table capacity", aggregation_capacity_test_1)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,177 @@
+/**
+ * @defgroup aggregation_engine Aggregation Engine
+ * @{
+ */
+
+#include <cmath>
+#include <cstring>
+#include <string>
+#include "aggregation_engine.h"
+#include "mbed.h"
+#include "mbed_trace.h"
+
+#define TRACE_GROUP "AggregationEngine"
+
+/**
+ *  @brief  Constructs an aggregation engine.
+ *  @author Lee Tze Han
+ *  @param  window_ms   Tumbling window length in milliseconds; 0 disables aggregation
+ */
+AggregationEngine::AggregationEngine(uint32_t window_ms)
+    : num_stats_(0), window_ms_(window_ms), window_start_ms_(0), window_started_(false)
+{
+}
+
+/**
+ *  @brief  Changes the window length. Accumulated samples are discarded and a new window starts with the next sample.
+ *  @author Lee Tze Han
+ *  @param  window_ms   Tumbling window length in milliseconds; 0 disables aggregation
+ */
+void AggregationEngine::SetWindow(uint32_t window_ms)
+{
+    window_ms_ = window_ms;
+    num_stats_ = 0;
+    window_started_ = false;
+}
+
+/**
+ *  @brief  Returns the window length.
+ *  @author Lee Tze Han
+ *  @return Tumbling window length in milliseconds
+ */
+uint32_t AggregationEngine::GetWindow(void) const
+{
+    return window_ms_;
+}
+
+/**
+ *  @brief  Returns whether aggregation is enabled.
+ *  @author Lee Tze Han
+ *  @return true if window length is non-zero
+ */
+bool AggregationEngine::IsEnabled(void) const
+{
+    return window_ms_ > 0;
+}
+
+/**
+ *  @brief  Folds a sample into the running statistics of its measure point (Welford's algorithm).
+ *  @author Lee Tze Han
+ *  @param  measure_point_id    Measure point id with static lifetime
+ *  @param  value               Sample value
+ *  @param  now_ms              Monotonic time of the sample in milliseconds
+ *  @return false if the measure point table is full and the sample was dropped
+ */
+bool AggregationEngine::AddSample(const char* measure_point_id, float value, uint32_t now_ms)
+{
+    if (!window_started_)
+    {
+        window_start_ms_ = now_ms;
+        window_started_ = true;
+    }
+
+    running_stats_t* stats = FindOrCreate(measure_point_id);
+    if (stats == NULL)
+    {
+        tr_warn("Measure point table full, dropping %s", measure_point_id);
+        return false;
+    }
+
+    stats->count++;
+    double delta = value - stats->mean;
+    stats->mean += delta / stats->count;
+    stats->m2 += delta * (value - stats->mean);
+
+    if (stats->count == 1 || value < stats->min)
+    {
+        stats->min = value;
+    }
+    if (stats->count == 1 || value > stats->max)
+    {
+        stats->max = value;
+    }
+
+    return true;
+}
+
+/**
+ *  @brief  Checks whether the current window has elapsed.
+ *  @author Lee Tze Han
+ *  @param  now_ms  Monotonic time in milliseconds
+ *  @return true if a window is open and its length has elapsed
+ */
+bool AggregationEngine::IsWindowClosed(uint32_t now_ms) const
+{
+    return IsEnabled() && window_started_ && (uint32_t)(now_ms - window_start_ms_) >= window_ms_;
+}
+
+/**
+ *  @brief  Writes <id>_avg/_min/_max/_stddev of every measure point into profile, then starts a new window.
+ *  @author Lee Tze Han
+ *  @param  profile     SensorProfile receiving the aggregated measure points
+ *  @param  now_ms      Monotonic time in milliseconds; start of the next window
+ *  @param  time_stamp  Epoch milliseconds recorded against the aggregated measure points
+ *  @return Number of measure points aggregated
+ */
+size_t AggregationEngine::CloseWindow(SensorProfile& profile, uint32_t now_ms, int64_t time_stamp)
+{
+    size_t num_aggregated = 0;
+    for (size_t i = 0; i < num_stats_; i++)
+    {
+        running_stats_t& stats = stats_[i];
+        if (stats.count == 0)
+        {
+            continue;
+        }
+
+        double variance = (stats.count > 1) ? stats.m2 / (stats.count - 1) : 0.0;
+        std::string id = stats.measure_point_id;
+
+        profile.UpdateValue(id + "_avg", (float)stats.mean, time_stamp);
+        profile.UpdateValue(id + "_min", stats.min, time_stamp);
+        profile.UpdateValue(id + "_max", stats.max, time_stamp);
+        profile.UpdateValue(id + "_stddev", (float)std::sqrt(variance), time_stamp);
+
+        stats.count = 0;
+        stats.mean = 0.0;
+        stats.m2 = 0.0;
+        num_aggregated++;
+    }
+
+    window_start_ms_ = now_ms;
+    return num_aggregated;
+}
+
+/**
+ *  @brief  Returns the accumulator for a measure point, allocating a free slot on first use.
+ *  @author Lee Tze Han
+ *  @param  measure_point_id    Measure point id with static lifetime
+ *  @return Pointer to accumulator, or NULL if the table is full
+ */
+AggregationEngine::running_stats_t* AggregationEngine::FindOrCreate(const char* measure_point_id)
+{
+    for (size_t i = 0; i < num_stats_; i++)
+    {
+        if (stats_[i].measure_point_id == measure_point_id || std::strcmp(stats_[i].measure_point_id, measure_point_id) == 0)
+        {
+            return &stats_[i];
+        }
+    }
+
+    if (num_stats_ >= AGGREGATION_MAX_MEASURE_POINTS)
+    {
+        return NULL;
+    }
+
+    running_stats_t& stats = stats_[num_stats_++];
+    stats.measure_point_id = measure_point_id;
+    stats.count = 0;
+    stats.mean = 0.0;
+    stats.m2 = 0.0;
+    stats.min = 0.0f;
+    stats.max = 0.0f;
+
+    return &stats;
+}
+
+/** @}*/
@@ -0,0 +1,82 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef AGGREGATION_ENGINE_H
+#define AGGREGATION_ENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sensor_profile.h"
+
+#define AGGREGATION_MAX_MEASURE_POINTS  16      // number of measure points tracked per window
+#define AGGREGATION_MAX_WINDOW_S        86400   // longest window accepted from a service call, 1 day
+
+/** AggregationEngine class.
+ *  @brief  Streaming tumbling-window statistics (mean, min, max, standard deviation) per measure point
+ *
+ *  Each measure point keeps a fixed-size Welford accumulator, so memory use does not grow with the number
+ *  of samples in a window. When the window closes, <id>_avg, <id>_min, <id>_max and <id>_stddev are written
+ *  into a SensorProfile and the accumulators are reset. A window of 0 disables aggregation.
+ *
+ *  Example:
+ *  @code{.cpp}
+ *  #include "aggregation_engine.h"
+ *
+ *  int main() 
+ *  {
+ *      SensorProfile sensors_profile;
+ *      AggregationEngine aggregation(60000);
+ *      aggregation.AddSample("ambient_temp", 23.45f, 0);
+ *      aggregation.AddSample("ambient_temp", 23.55f, 10000);
+ *      if (aggregation.IsWindowClosed(60000))
+ *      {
+ *          aggregation.CloseWindow(sensors_profile, 60000, 0);
+ *      }
+ *  }
+ *  @endcode
+ */
+
+class AggregationEngine 
+{
+    public:
+        AggregationEngine(uint32_t window_ms = 0);
+
+        void SetWindow(uint32_t window_ms);
+        uint32_t GetWindow(void) const;
+        bool IsEnabled(void) const;
+        bool AddSample(const char* measure_point_id, float value, uint32_t now_ms);
+        bool IsWindowClosed(uint32_t now_ms) const;
+        size_t CloseWindow(SensorProfile& profile, uint32_t now_ms, int64_t time_stamp);
+
+    private:
+        typedef struct {
+            const char* measure_point_id;   /// static measure point id from sensor_reading_t
+            uint32_t count;                 /// number of samples in the current window
+            double mean;                    /// running mean
+            double m2;                      /// running sum of squared differences from the mean
+            float min;
+            float max;
+        } running_stats_t;
+
+        running_stats_t* FindOrCreate(const char* measure_point_id);
+
+        running_stats_t stats_[AGGREGATION_MAX_MEASURE_POINTS];
+        size_t num_stats_;
+        uint32_t window_ms_;
+        uint32_t window_start_ms_;
+        bool window_started_;
+};
+
+#endif  // AGGREGATION_ENGINE_H
@@ -15,6 +15,7 @@ const chrono::seconds boot_timeout = 5s;
 const std::string sdk_ver = "3.1.0";
 const uint8_t max_login_attempts = 3;
 const std::string poll_rate_ms = "10000";
+const std::string aggregation_window_ms = "0";
 const std::string boot_login_pw = "stack2020";
 const std::string uuid = GetDeviceUid();
 
@@ -158,6 +159,7 @@ void RunBootManager(void)
 void InitAfterLogin(void)
 {
     WriteCycleInterval(poll_rate_ms);
+    WriteAggregationWindow(aggregation_window_ms);
     WriteInitFlag("true");
 }
 
@@ -236,13 +238,14 @@ void SetDefaultConfig(void)
 }
 
 /**
- *  @brief  Clears client data used for SSL sessions
+ *  @brief  Clears client data used for SSL sessions, and the device secret so that it is provisioned again
  *  @author Lee Tze Han
  */
 void ClearClientSslData(void)
 {
     WriteClientCertificate("");
     WriteClientCertificateSerialNumber("");
+    WriteDeviceSecret("");
 #if defined(MBED_CONF_APP_USE_SECURE_ELEMENT) && (MBED_CONF_APP_USE_SECURE_ELEMENT == 0)
     WriteClientPrivateKey("");
 #endif  // MBED_CONF_APP_USE_SECURE_ELEMENT
@@ -27,23 +27,27 @@ std::string const WIFI_PASSWORD = ReadWifiPass();
 /**
  *  @brief  Configure network interface (WiFi / Ethernet)
  *  @author Lee Tze Han
- *  @param network Reference to NetworkInterface pointer
+ *  @param network Reference to NetworkInterface pointer; an interface from a previous call is connected again
  *  @return Success of NetworkInterface connection
  */
 bool ConfigNetworkInterface(NetworkInterface*& network)
 {
     int rc;
     
-    #ifdef USE_WIFI
-    const int esp32_serial_baud_rate = 115200;
-    ESP32Interface* netif = new ESP32Interface(MBED_CONF_APP_WIFI_EN, NC, MBED_CONF_APP_WIFI_TX, MBED_CONF_APP_WIFI_RX, false, NC, NC, esp32_serial_baud_rate);
-    rc = netif->connect(WIFI_SSID.c_str(), WIFI_PASSWORD.c_str(), MBED_CONF_APP_WIFI_SECURITY);
-    #else
-    EthernetInterface* netif = new EthernetInterface();
-    rc = netif->connect();
-    #endif  // USE_WIFI
-    
-    network = netif;
+    if (network == NULL)
+    {
+        #ifdef USE_WIFI
+        const int esp32_serial_baud_rate = 115200;
+        ESP32Interface* netif = new ESP32Interface(MBED_CONF_APP_WIFI_EN, NC, MBED_CONF_APP_WIFI_TX, MBED_CONF_APP_WIFI_RX, false, NC, NC, esp32_serial_baud_rate);
+        netif->set_credentials(WIFI_SSID.c_str(), WIFI_PASSWORD.c_str(), MBED_CONF_APP_WIFI_SECURITY);
+        #else
+        EthernetInterface* netif = new EthernetInterface();
+        #endif  // USE_WIFI
+
+        network = netif;
+    }
+
+    rc = network->connect();
     
     if (rc != 0)
     {
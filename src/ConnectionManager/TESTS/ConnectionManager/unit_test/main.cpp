@@ -0,0 +1,130 @@
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "connection_manager.h"
+
+using namespace utest::v1;
+
+static const reconnect_policy_t policy = {1000, 8000, 0};
+
+// Test that only the broken layer and those above it are reconnected
+static control_t connection_layer_test_1(const size_t call_count)
+{
+    ConnectionManager connection(policy, 1);
+    TEST_ASSERT_FALSE(connection.IsConnected());
+    TEST_ASSERT_EQUAL(CONN_LAYER_LINK, connection.GetBrokenLayer());
+    TEST_ASSERT_TRUE(connection.Due(0));
+
+    connection.Up(CONN_LAYER_LINK);
+    TEST_ASSERT_EQUAL(CONN_LAYER_DNS, connection.GetBrokenLayer());
+    connection.Up(CONN_LAYER_MQTT);
+    TEST_ASSERT_TRUE(connection.IsConnected());
+    TEST_ASSERT_FALSE(connection.Due(0));
+
+    /* A lost session is retried at once, from its own layer */
+    connection.Down(CONN_LAYER_TRANSPORT);
+    TEST_ASSERT_EQUAL(CONN_LAYER_TRANSPORT, connection.GetBrokenLayer());
+    TEST_ASSERT_TRUE(connection.Due(0));
+
+    /* A lower layer found down takes over; a higher one does not */
+    connection.Down(CONN_LAYER_MQTT);
+    TEST_ASSERT_EQUAL(CONN_LAYER_TRANSPORT, connection.GetBrokenLayer());
+    connection.Down(CONN_LAYER_LINK);
+    TEST_ASSERT_EQUAL(CONN_LAYER_LINK, connection.GetBrokenLayer());
+
+    return CaseNext;
+}
+
+// Test the jittered exponential backoff of each layer
+static control_t connection_backoff_test_1(const size_t call_count)
+{
+    ConnectionManager connection(policy, 12345);
+    connection.Up(CONN_LAYER_LINK);
+
+    /* 1, 2, 4, 8, 8 s; each in the upper half of its delay */
+    const uint32_t expected_ms[] = {1000, 2000, 4000, 8000, 8000};
+    uint64_t now_ms = 100000;
+    for (size_t i = 0; i < sizeof(expected_ms) / sizeof(expected_ms[0]); i++)
+    {
+        connection.Fail(CONN_LAYER_DNS, now_ms);
+        uint64_t backoff_ms = connection.NextAttempt() - now_ms;
+        TEST_ASSERT_TRUE(backoff_ms >= expected_ms[i] / 2);
+        TEST_ASSERT_TRUE(backoff_ms <= expected_ms[i]);
+        TEST_ASSERT_FALSE(connection.Due(now_ms + backoff_ms - 1));
+        TEST_ASSERT_TRUE(connection.Due(now_ms + backoff_ms));
+        now_ms += backoff_ms;
+    }
+    TEST_ASSERT_EQUAL_UINT32(5, connection.GetFailures(CONN_LAYER_DNS));
+
+    /* Layers back off on their own counts; a layer coming up clears its own and those below */
+    connection.Up(CONN_LAYER_TRANSPORT);
+    TEST_ASSERT_EQUAL_UINT32(0, connection.GetFailures(CONN_LAYER_DNS));
+    connection.Fail(CONN_LAYER_MQTT, now_ms);
+    TEST_ASSERT_TRUE(connection.NextAttempt() - now_ms <= 1000);
+    TEST_ASSERT_EQUAL(CONN_LAYER_MQTT, connection.GetBrokenLayer());
+
+    /* Devices seeded differently spread their retries */
+    ConnectionManager other(policy, 54321);
+    uint64_t spread_ms = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        connection.Fail(CONN_LAYER_LINK, 0);
+        other.Fail(CONN_LAYER_LINK, 0);
+        spread_ms += (connection.NextAttempt() > other.NextAttempt()) ? connection.NextAttempt() - other.NextAttempt()
+                                                                      : other.NextAttempt() - connection.NextAttempt();
+    }
+    TEST_ASSERT_TRUE(spread_ms > 0);
+
+    return CaseNext;
+}
+
+// Test that a reset is only due after the configured failed attempts in a row
+static control_t connection_reset_test_1(const size_t call_count)
+{
+    ConnectionManager never(policy, 1);
+    for (int i = 0; i < 100; i++)
+    {
+        never.Fail(CONN_LAYER_TRANSPORT, 0);
+    }
+    TEST_ASSERT_FALSE(never.ResetDue());
+
+    const reconnect_policy_t reset_policy = {1000, 8000, 3};
+    ConnectionManager connection(reset_policy, 1);
+    connection.Fail(CONN_LAYER_LINK, 0);
+    connection.Up(CONN_LAYER_LINK);
+    connection.Fail(CONN_LAYER_DNS, 0);
+    TEST_ASSERT_FALSE(connection.ResetDue());
+    connection.Fail(CONN_LAYER_DNS, 0);
+    TEST_ASSERT_TRUE(connection.ResetDue());
+
+    /* Connecting clears the count */
+    connection.Up(CONN_LAYER_MQTT);
+    TEST_ASSERT_FALSE(connection.ResetDue());
+    TEST_ASSERT_EQUAL_UINT64(0, connection.NextAttempt());
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test reconnection of the broken layer", connection_layer_test_1),
+    Case("Test reconnection backoff", connection_backoff_test_1),
+    Case("Test reset as the last resort", connection_reset_test_1)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
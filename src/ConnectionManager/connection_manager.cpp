@@ -0,0 +1,195 @@
+/**
+ * @defgroup connection_manager Connection Manager
+ * @{
+ */
+
+#include "connection_manager.h"
+#include "mbed_trace.h"
+
+#define TRACE_GROUP  "ConnectionManager"
+
+/**
+ *  @brief  Starts with every layer down, due for an attempt at once.
+ *  @author Lee Tze Han
+ *  @param  policy  Backoff and reset policy
+ *  @param  seed    Seed of the jitter; should differ between devices
+ */
+ConnectionManager::ConnectionManager(const reconnect_policy_t& policy, uint32_t seed)
+    : policy_(policy), random_state_((seed != 0) ? seed : 1)
+{
+    if (policy_.backoff_min_ms == 0)
+    {
+        policy_.backoff_min_ms = 1;
+    }
+    if (policy_.backoff_max_ms < policy_.backoff_min_ms)
+    {
+        tr_warn("Reconnect backoff max below min");
+        policy_.backoff_max_ms = policy_.backoff_min_ms;
+    }
+}
+
+/**
+ *  @brief  Records that a layer, and so every layer below it, is up.
+ *  @author Lee Tze Han
+ *  @param  layer   Layer that connected
+ */
+void ConnectionManager::Up(conn_layer_t layer)
+{
+    for (int i = CONN_LAYER_LINK; i <= layer; i++)
+    {
+        failures_[i] = 0;
+    }
+    if (broken_ <= layer)
+    {
+        broken_ = static_cast<conn_layer_t>(layer + 1);
+    }
+
+    if (broken_ == CONN_LAYER_COUNT)
+    {
+        attempts_ = 0;
+        next_attempt_ms_ = 0;
+    }
+}
+
+/**
+ *  @brief  Records that a layer, and so every layer above it, was lost; it is retried without backoff.
+ *  @author Lee Tze Han
+ *  @param  layer   Layer found down
+ */
+void ConnectionManager::Down(conn_layer_t layer)
+{
+    if (layer < broken_)
+    {
+        broken_ = layer;
+    }
+}
+
+/**
+ *  @brief  Records a failed attempt to connect a layer, and backs it off.
+ *  @author Lee Tze Han
+ *  @param  layer   Layer whose attempt failed
+ *  @param  now_ms  Kernel time in ms
+ */
+void ConnectionManager::Fail(conn_layer_t layer, uint64_t now_ms)
+{
+    Down(layer);
+    failures_[layer]++;
+    attempts_++;
+
+    uint32_t backoff_ms = Backoff(layer);
+    next_attempt_ms_ = now_ms + backoff_ms;
+    tr_warn("%s failed (%lu in a row), retrying in %lu ms", LayerName(layer), (unsigned long)failures_[layer], (unsigned long)backoff_ms);
+}
+
+/**
+ *  @brief  Lowest layer that is down; the one to reconnect next.
+ *  @author Lee Tze Han
+ *  @return Layer; CONN_LAYER_COUNT when connected
+ */
+conn_layer_t ConnectionManager::GetBrokenLayer(void) const
+{
+    return broken_;
+}
+
+/**
+ *  @brief  Whether every layer is up.
+ *  @author Lee Tze Han
+ *  @return Whether connected
+ */
+bool ConnectionManager::IsConnected(void) const
+{
+    return broken_ == CONN_LAYER_COUNT;
+}
+
+/**
+ *  @brief  Whether the broken layer may be attempted.
+ *  @author Lee Tze Han
+ *  @param  now_ms  Kernel time in ms
+ *  @return Whether the backoff of the last failure has passed
+ */
+bool ConnectionManager::Due(uint64_t now_ms) const
+{
+    return !IsConnected() && (now_ms >= next_attempt_ms_);
+}
+
+/**
+ *  @brief  Time of the next attempt.
+ *  @author Lee Tze Han
+ *  @return Kernel time in ms; 0 when due at once
+ */
+uint64_t ConnectionManager::NextAttempt(void) const
+{
+    return next_attempt_ms_;
+}
+
+/**
+ *  @brief  Failed attempts in a row of a layer.
+ *  @author Lee Tze Han
+ *  @param  layer   Layer
+ *  @return Failures since the layer was last up
+ */
+uint32_t ConnectionManager::GetFailures(conn_layer_t layer) const
+{
+    return failures_[layer];
+}
+
+/**
+ *  @brief  Whether the failures in a row reached the reset of the policy; the last resort.
+ *  @author Lee Tze Han
+ *  @return Whether a system reset is due
+ */
+bool ConnectionManager::ResetDue(void) const
+{
+    return (policy_.reset_after != 0) && (attempts_ >= policy_.reset_after);
+}
+
+/**
+ *  @brief  Name of a layer, for traces.
+ *  @author Lee Tze Han
+ *  @param  layer   Layer
+ *  @return Name
+ */
+const char* ConnectionManager::LayerName(conn_layer_t layer)
+{
+    static const char* const names[CONN_LAYER_COUNT + 1] = {"Link", "DNS", "TCP/TLS", "MQTT", "None"};
+
+    return names[layer];
+}
+
+/**
+ *  @brief  Backoff after a failure of a layer: exponential in its failures, with the upper half jittered.
+ *  @author Lee Tze Han
+ *  @param  layer   Layer whose attempt failed
+ *  @return Delay in ms
+ */
+uint32_t ConnectionManager::Backoff(conn_layer_t layer)
+{
+    uint64_t backoff_ms = policy_.backoff_min_ms;
+    for (uint32_t i = 1; (i < failures_[layer]) && (backoff_ms < policy_.backoff_max_ms); i++)
+    {
+        backoff_ms *= 2;
+    }
+    if (backoff_ms > policy_.backoff_max_ms)
+    {
+        backoff_ms = policy_.backoff_max_ms;
+    }
+
+    uint32_t half_ms = (uint32_t)(backoff_ms / 2);
+    return (uint32_t)backoff_ms - half_ms + (Random() % (half_ms + 1));
+}
+
+/**
+ *  @brief  Next value of the xorshift32 generator.
+ *  @author Lee Tze Han
+ *  @return Pseudo-random value
+ */
+uint32_t ConnectionManager::Random(void)
+{
+    random_state_ ^= random_state_ << 13;
+    random_state_ ^= random_state_ >> 17;
+    random_state_ ^= random_state_ << 5;
+
+    return random_state_;
+}
+
+/** @}*/
@@ -0,0 +1,104 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef CONNECTION_MANAGER_H
+#define CONNECTION_MANAGER_H
+
+#include <stdint.h>
+
+/* Layers of the connection to DECADA, from the bottom up */
+typedef enum {
+    CONN_LAYER_LINK = 0,            /// Wi-Fi / Ethernet link
+    CONN_LAYER_DNS,                 /// resolution of the broker
+    CONN_LAYER_TRANSPORT,           /// TCP connection and TLS handshake
+    CONN_LAYER_MQTT,                /// MQTT CONNECT / CONNACK and subscriptions
+    CONN_LAYER_COUNT                /// none; every layer is up
+} conn_layer_t;
+
+typedef struct {
+    uint32_t backoff_min_ms;        /// delay after the first failure of a layer
+    uint32_t backoff_max_ms;        /// longest delay, reached by doubling on each failure
+    uint32_t reset_after;           /// failed attempts in a row before a reset is due; 0 never
+} reconnect_policy_t;
+
+/* Policy of the reconnect-* settings in mbed_app.json */
+#define RECONNECT_POLICY_CONFIG     {MBED_CONF_APP_RECONNECT_BACKOFF_MIN * 1000UL, MBED_CONF_APP_RECONNECT_BACKOFF_MAX * 1000UL, \
+                                     MBED_CONF_APP_RECONNECT_RESET_AFTER}
+
+/** ConnectionManager class.
+ *  @brief  Reconnection state machine of the layered connection to DECADA
+ *
+ *  The manager tracks the lowest broken layer. A layer found down by other means (e.g. the MQTT
+ *  client reports it is disconnected) is retried at once; a failed attempt at a layer backs that
+ *  layer off for min(backoff_max_ms, backoff_min_ms * 2^(failures - 1)), with half of the delay
+ *  randomised so that devices cut off together do not reconnect together. Only the broken layer
+ *  and those above it are reconnected, and a reset is only due after reset_after failed attempts.
+ *
+ *  Example:
+ *  @code{.cpp}
+ *  #include "connection_manager.h"
+ *
+ *  int main()
+ *  {
+ *      reconnect_policy_t policy = {1000, 300000, 0};
+ *      ConnectionManager connection(policy, 1);
+ *
+ *      while (!connection.IsConnected())
+ *      {
+ *          uint64_t now_ms = Kernel::get_ms_count();
+ *          if (connection.Due(now_ms))
+ *          {
+ *              conn_layer_t layer = connection.GetBrokenLayer();
+ *              if (Repair(layer))
+ *                  connection.Up(layer);
+ *              else
+ *                  connection.Fail(layer, now_ms);
+ *          }
+ *      }
+ *  }
+ *  @endcode
+ */
+
+class ConnectionManager
+{
+    public:
+        ConnectionManager(const reconnect_policy_t& policy, uint32_t seed);
+
+        void Up(conn_layer_t layer);
+        void Down(conn_layer_t layer);
+        void Fail(conn_layer_t layer, uint64_t now_ms);
+
+        conn_layer_t GetBrokenLayer(void) const;
+        bool IsConnected(void) const;
+        bool Due(uint64_t now_ms) const;
+        uint64_t NextAttempt(void) const;
+        uint32_t GetFailures(conn_layer_t layer) const;
+        bool ResetDue(void) const;
+
+        static const char* LayerName(conn_layer_t layer);
+
+    private:
+        uint32_t Backoff(conn_layer_t layer);
+        uint32_t Random(void);
+
+        reconnect_policy_t policy_;
+        conn_layer_t broken_ = CONN_LAYER_LINK;                                             /// lowest layer that is down
+        uint32_t failures_[CONN_LAYER_COUNT] = {};                                          /// failed attempts in a row of each layer
+        uint32_t attempts_ = 0;                                                             /// failed attempts in a row of any layer
+        uint64_t next_attempt_ms_ = 0;                                                      /// 0: at once
+        uint32_t random_state_;                                                             /// xorshift32 state of the jitter
+};
+
+#endif  // CONNECTION_MANAGER_H
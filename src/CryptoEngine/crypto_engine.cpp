@@ -138,7 +138,7 @@ std::string CryptoEngine::GenerateCertificateSigningRequest(void)
  */
 std::string CryptoEngine::GetCertificateSubjectName(void)
 {
-    const std::string timestamp_ms = MsPaddingIntToString(RawRtcTimeNow());
+    const std::string timestamp_ms = EpochMsNowToString();
 
     return cert_subject_base_ + device_uuid + timestamp_ms;
 }
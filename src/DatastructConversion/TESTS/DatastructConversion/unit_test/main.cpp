@@ -2,6 +2,9 @@
 #include "utest/utest.h"
 #include "unity/unity.h"
 #include "greentea-client/test_env.h"
+#include <climits>
+#include <cinttypes>
+#include <limits>
 #include "conversions.h"
 
 using namespace utest::v1;
@@ -72,6 +75,28 @@ static control_t convert_int_to_hex_test_3(const size_t call_count)
     return CaseNext;
 }
 
+// Test against printf for every power of two and a sweep of values
+static control_t convert_int_to_hex_test_4(const size_t call_count) 
+{
+    char expected_hex[16];
+
+    for (int shift = 0; shift < 32; shift++)
+    {
+        uint32_t actual = (uint32_t)1 << shift;
+        snprintf(expected_hex, sizeof(expected_hex), "%" PRIx32, actual);
+        TEST_ASSERT_EQUAL_STRING(expected_hex, IntToHex(actual).c_str());
+        snprintf(expected_hex, sizeof(expected_hex), "%" PRIx32, actual - 1);
+        TEST_ASSERT_EQUAL_STRING(expected_hex, IntToHex(actual - 1).c_str());
+    }
+    for (uint32_t actual = 0xFFFFFFFF; actual > 0x10000; actual -= 0x10FFF)
+    {
+        snprintf(expected_hex, sizeof(expected_hex), "%" PRIx32, actual);
+        TEST_ASSERT_EQUAL_STRING(expected_hex, IntToHex(actual).c_str());
+    }
+
+    return CaseNext;
+}
+
 // Test for functionality - positive int
 static control_t convert_int_to_string_test_1(const size_t call_count) 
 {
@@ -108,6 +133,62 @@ static control_t convert_int_to_string_test_3(const size_t call_count)
     return CaseNext;
 }
 
+// Test against printf for range limits, powers of 10 and a sweep of values
+static control_t convert_int_to_string_test_4(const size_t call_count) 
+{
+    char expected_str[16];
+    const int limits[] = {INT_MIN, INT_MIN + 1, -1, 0, 1, INT_MAX - 1, INT_MAX};
+
+    for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); i++)
+    {
+        snprintf(expected_str, sizeof(expected_str), "%d", limits[i]);
+        TEST_ASSERT_EQUAL_STRING(expected_str, IntToString(limits[i]).c_str());
+    }
+    for (int power = 1; power <= 100000000; power *= 10)
+    {
+        for (int actual = -power - 1; actual <= -power + 1; actual++)
+        {
+            snprintf(expected_str, sizeof(expected_str), "%d", actual);
+            TEST_ASSERT_EQUAL_STRING(expected_str, IntToString(actual).c_str());
+            snprintf(expected_str, sizeof(expected_str), "%d", -actual);
+            TEST_ASSERT_EQUAL_STRING(expected_str, IntToString(-actual).c_str());
+        }
+    }
+    for (int actual = -100000; actual <= 100000; actual += 7)
+    {
+        snprintf(expected_str, sizeof(expected_str), "%d", actual);
+        TEST_ASSERT_EQUAL_STRING(expected_str, IntToString(actual).c_str());
+    }
+
+    return CaseNext;
+}
+
+// Test for 64-bit range limits of IntToChar
+static control_t convert_int_to_char_test_1(const size_t call_count) 
+{
+    char buf[INT_TO_CHAR_BUFFER_SIZE];
+    char expected_str[32];
+    const int64_t limits[] = {INT64_MIN, INT64_MIN + 1, -1000000000000LL, (int64_t)UINT32_MAX + 1, 999999999999999999LL, INT64_MAX};
+
+    for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); i++)
+    {
+        snprintf(expected_str, sizeof(expected_str), "%" PRId64, limits[i]);
+        TEST_ASSERT_EQUAL_STRING(expected_str, IntToChar(buf, limits[i]));
+    }
+
+    return CaseNext;
+}
+
+// Test for milliseconds padding of seconds
+static control_t convert_ms_padding_int_to_string_test_1(const size_t call_count) 
+{
+    TEST_ASSERT_EQUAL_STRING("1600000000000", MsPaddingIntToString(1600000000).c_str());
+    TEST_ASSERT_EQUAL_STRING("0000", MsPaddingIntToString(0).c_str());
+    TEST_ASSERT_EQUAL_STRING("-1000", MsPaddingIntToString(-1).c_str());
+
+    return CaseNext;
+}
+
 // Test for decimal place attenuations
 static control_t convert_double_to_char_test_1(const size_t call_count) 
 {
@@ -160,6 +241,36 @@ static control_t convert_double_to_char_test_3(const size_t call_count)
     return CaseNext;
 }
 
+// Test for negative input between -1 and 0
+static control_t convert_double_to_char_test_4(const size_t call_count) 
+{
+    char buf[32];
+
+    TEST_ASSERT_EQUAL_STRING("-0.50", DoubleToChar(buf, -0.5, 2));
+    TEST_ASSERT_EQUAL_STRING("-0.05", DoubleToChar(buf, -0.0512, 2));
+    TEST_ASSERT_EQUAL_STRING("0.00", DoubleToChar(buf, -0.001, 2));     // Expected: no sign when truncated to zero
+    TEST_ASSERT_EQUAL_STRING("0.0", DoubleToChar(buf, -0.5, 0));
+
+    return CaseNext;
+}
+
+// Test against integer arithmetic for a sweep of values at 2 decimal places
+static control_t convert_double_to_char_test_5(const size_t call_count) 
+{
+    char buf[32];
+    char expected_str[32];
+
+    for (int hundredths = -1000000; hundredths <= 1000000; hundredths += 13)
+    {
+        int magnitude = (hundredths < 0) ? -hundredths : hundredths;
+        double actual_data = hundredths / 100.0 + ((hundredths < 0) ? -0.001 : 0.001);
+        snprintf(expected_str, sizeof(expected_str), "%s%d.%02d", (hundredths < 0) ? "-" : "", magnitude / 100, magnitude % 100);
+        TEST_ASSERT_EQUAL_STRING(expected_str, DoubleToChar(buf, actual_data, 2));
+    }
+
+    return CaseNext;
+}
+
 // Test for large string
 static control_t convert_string_to_int_test_1(const size_t call_count) 
 {
@@ -219,6 +330,35 @@ static control_t convert_string_to_int_test_5(const size_t call_count)
     return CaseNext;
 }
 
+// Test for whitespace, sign, trailing characters and saturation as with stream extraction
+static control_t convert_string_to_int_test_6(const size_t call_count) 
+{
+    TEST_ASSERT_EQUAL_INT(42, StringToInt("  42"));
+    TEST_ASSERT_EQUAL_INT(7, StringToInt("+7"));
+    TEST_ASSERT_EQUAL_INT(12, StringToInt("12abc"));
+    TEST_ASSERT_EQUAL_INT(0, StringToInt("-"));
+    TEST_ASSERT_EQUAL_INT(0, StringToInt(""));
+    TEST_ASSERT_EQUAL_INT(INT_MIN, StringToInt("-2147483648"));
+    TEST_ASSERT_EQUAL_INT(INT_MAX, StringToInt("2147483648"));
+    TEST_ASSERT_EQUAL_INT(INT_MIN, StringToInt("-2147483649"));
+    TEST_ASSERT_EQUAL_INT(INT_MAX, StringToInt("99999999999999999999999"));
+
+    return CaseNext;
+}
+
+// Test for round trip through IntToString
+static control_t convert_string_to_int_test_7(const size_t call_count) 
+{
+    for (int expected_int = -100000; expected_int <= 100000; expected_int += 3)
+    {
+        TEST_ASSERT_EQUAL_INT(expected_int, StringToInt(IntToString(expected_int)));
+    }
+    TEST_ASSERT_EQUAL_INT(INT_MIN, StringToInt(IntToString(INT_MIN)));
+    TEST_ASSERT_EQUAL_INT(INT_MAX, StringToInt(IntToString(INT_MAX)));
+
+    return CaseNext;
+}
+
 // Test for functionality - positive time
 static control_t convert_timet_to_string_test_1(const size_t call_count) 
 {
@@ -311,6 +451,19 @@ static control_t convert_string_to_timet_test_5(const size_t call_count)
     return CaseNext;
 }
 
+// Test for round trip through TimeToString across the range of time_t
+static control_t convert_string_to_timet_test_6(const size_t call_count) 
+{
+    const std::time_t times[] = {std::numeric_limits<std::time_t>::min(), -1, 0, 1600000000, 2147483647, std::numeric_limits<std::time_t>::max()};
+
+    for (size_t i = 0; i < sizeof(times) / sizeof(times[0]); i++)
+    {
+        TEST_ASSERT_TRUE(times[i] == StringToTime(TimeToString(times[i])));
+    }
+
+    return CaseNext;
+}
+
 // Test for converting lowercase alphabets to uppercase - pure lowercase
 static control_t convert_lowercase_to_uppercase_alphabets_test_1(const size_t call_count) 
 {
@@ -425,17 +578,25 @@ Case cases[] =
     Case("Check IntToHex Large decimal value", convert_int_to_hex_test_1),
     Case("Check IntToHex Decimal 0", convert_int_to_hex_test_2),
     Case("Check IntToHex Wrong conversion", convert_int_to_hex_test_3),
+    Case("Check IntToHex Against printf", convert_int_to_hex_test_4),
     Case("Check IntToString Functionality - positive int", convert_int_to_string_test_1),
     Case("Check IntToString Functionality - negative int", convert_int_to_string_test_2),
     Case("Check IntToString Functionality - failure by attenuation", convert_int_to_string_test_3),
+    Case("Check IntToString Against printf", convert_int_to_string_test_4),
+    Case("Check IntToChar 64-bit range limits", convert_int_to_char_test_1),
+    Case("Check MsPaddingIntToString Milliseconds padding", convert_ms_padding_int_to_string_test_1),
     Case("Check DoubleToChar Decimal place attenuations", convert_double_to_char_test_1),
     Case("Check DoubleToChar Attenuation without rounding", convert_double_to_char_test_2),
     Case("Check DoubleToChar Negative input", convert_double_to_char_test_3),
+    Case("Check DoubleToChar Negative input between -1 and 0", convert_double_to_char_test_4),
+    Case("Check DoubleToChar Sweep at 2 decimal places", convert_double_to_char_test_5),
     Case("Check StringToInt Large string", convert_string_to_int_test_1),
     Case("Check StringToInt Corner case - zero", convert_string_to_int_test_2),
     Case("Check StringToInt Negative input", convert_string_to_int_test_3),
     Case("Check StringToInt Non-decimal value", convert_string_to_int_test_4),
     Case("Check StringToInt Attenuating leading zero", convert_string_to_int_test_5),
+    Case("Check StringToInt Whitespace, sign and saturation", convert_string_to_int_test_6),
+    Case("Check StringToInt Round trip", convert_string_to_int_test_7),
     Case("Check TimeToString Functionality - positive time", convert_timet_to_string_test_1),
     Case("Check TimeToString Functionality - negative time (thrown during error)", convert_timet_to_string_test_2),
     Case("Check TimeToString Failure by attenuation", convert_timet_to_string_test_3),
@@ -444,6 +605,7 @@ Case cases[] =
     Case("Check StringToTime Negative input", convert_string_to_timet_test_3),
     Case("Check StringToTime Non-decimal value", convert_string_to_timet_test_4),
     Case("Check StringToTime Attenuating leading zero", convert_string_to_timet_test_5),
+    Case("Check StringToTime Round trip", convert_string_to_timet_test_6),
     Case("Check ToUpperCase converting lowercase alphabets to uppercase - pure lowercase", convert_lowercase_to_uppercase_alphabets_test_1),
     Case("Check ToUpperCase converting lowercase alphabets to uppercase - mix of uppercase, lowercase, numbers, special symbols", convert_lowercase_to_uppercase_alphabets_test_2),
     Case("Check ToUpperCase converting lowercase alphabets to uppercase - null input string", convert_lowercase_to_uppercase_alphabets_test_3),
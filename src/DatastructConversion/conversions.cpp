@@ -4,11 +4,9 @@
  */
 
 #include <algorithm>
-#include <sstream>
-#include <iomanip>
-#include <vector>
+#include <cctype>
 #include <cstdlib>
-#include <cstdio>
+#include <limits>
 #include "conversions.h"
 
 /**
@@ -28,6 +26,141 @@ char* StringToChar(const std::string& str)
     return buffer; 
 }
 
+/* "00" .. "99"; two digits are emitted per division */
+static const char digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const char hex_digits[] = "0123456789abcdef";
+
+/**
+ *  @brief  Writes the decimal digits of a 32-bit value backwards from end.
+ *  @author Lee Tze Han
+ *  @param  end         One past the last character to write
+ *  @param  v           Value
+ *  @param  min_digits  Zero-pads the result to at least this many digits
+ *  @return Pointer to the first digit
+ */
+static char* FormatDigits32(char* end, uint32_t v, int min_digits)
+{
+    char* const last = end;
+    while (v >= 100)
+    {
+        uint32_t r = v % 100;
+        v /= 100;
+        end -= 2;
+        std::memcpy(end, &digit_pairs[r * 2], 2);
+    }
+    if (v >= 10)
+    {
+        end -= 2;
+        std::memcpy(end, &digit_pairs[v * 2], 2);
+    }
+    else
+    {
+        *--end = (char)('0' + v);
+    }
+
+    while (last - end < min_digits)
+    {
+        *--end = '0';
+    }
+    return end;
+}
+
+/**
+ *  @brief  Writes the decimal digits of a 64-bit value at out, without terminating it.
+ *          Values above 32 bits are split into 9-digit groups to keep 64-bit divisions (a libcall on Cortex-M) rare.
+ *  @author Lee Tze Han
+ *  @param  out Destination with room for 20 characters
+ *  @param  v   Value
+ *  @return Pointer one past the last digit written
+ */
+static char* WriteUnsigned(char* out, uint64_t v)
+{
+    char digits[20];
+    char* const end = digits + sizeof(digits);
+    char* first = end;
+
+    while (v > UINT32_MAX)
+    {
+        first = FormatDigits32(first, (uint32_t)(v % 1000000000), 9);
+        v /= 1000000000;
+    }
+    first = FormatDigits32(first, (uint32_t)v, 1);
+
+    size_t len = end - first;
+    std::memcpy(out, first, len);
+    return out + len;
+}
+
+/**
+ *  @brief  Writes a signed value in decimal at out, without terminating it.
+ *  @author Lee Tze Han
+ *  @param  out Destination with room for INT_TO_CHAR_BUFFER_SIZE - 1 characters
+ *  @param  v   Value
+ *  @return Pointer one past the last character written
+ */
+static char* WriteInt(char* out, int64_t v)
+{
+    if (v < 0)
+    {
+        *out++ = '-';
+        return WriteUnsigned(out, 0 - (uint64_t)v);
+    }
+    return WriteUnsigned(out, (uint64_t)v);
+}
+
+/**
+ *  @brief  Parses a decimal integer the way operator>> does: leading whitespace and one sign are accepted,
+ *          parsing stops at the first non-digit and out-of-range values saturate. No digits yields 0.
+ *  @author Lee Tze Han
+ *  @param  str Null-terminated string
+ *  @return Parsed value
+ */
+template <typename T>
+static T ParseInteger(const char* str)
+{
+    while (std::isspace((unsigned char)*str))
+    {
+        str++;
+    }
+
+    bool negative = false;
+    if (*str == '+' || *str == '-')
+    {
+        negative = (*str == '-');
+        str++;
+    }
+
+    const uint64_t limit = negative ? (uint64_t)std::numeric_limits<T>::max() + 1 : (uint64_t)std::numeric_limits<T>::max();
+    uint64_t magnitude = 0;
+    for (; *str >= '0' && *str <= '9'; str++)
+    {
+        unsigned digit = *str - '0';
+        if (magnitude > (limit - digit) / 10)
+        {
+            magnitude = limit;
+            break;
+        }
+        magnitude = magnitude * 10 + digit;
+    }
+
+    if (negative && magnitude > 0)
+    {
+        return (T)(-(int64_t)(magnitude - 1) - 1);
+    }
+    return (T)magnitude;
+}
+
 /**
  *  @brief  Converts an int-type to string-type hex.
  *  @author Lau Lee Hong
@@ -36,9 +169,16 @@ char* StringToChar(const std::string& str)
  */
 std::string IntToHex(uint32_t i)
 {
-  std::stringstream stream;
-  stream << std::hex << i;
-  return stream.str();
+    char buf[8];
+    char* const end = buf + sizeof(buf);
+    char* first = end;
+    do
+    {
+        *--first = hex_digits[i & 0xF];
+        i >>= 4;
+    } while (i != 0);
+
+    return std::string(first, end);
 }
 
 /**
@@ -49,9 +189,21 @@ std::string IntToHex(uint32_t i)
  */
 std::string IntToString(int v)
 {
-    std::ostringstream oss;
-    oss << v;
-    return oss.str();
+    char buf[INT_TO_CHAR_BUFFER_SIZE];
+    return std::string(buf, WriteInt(buf, v));
+}
+
+/**
+ *  @brief  Converts a 64-bit integer to a C-string without allocating.
+ *  @author Lee Tze Han
+ *  @param  str buffer of at least INT_TO_CHAR_BUFFER_SIZE characters to store result
+ *  @param  v   value
+ *  @return str
+ */
+char* IntToChar(char* str, int64_t v)
+{
+    *WriteInt(str, v) = '\0';
+    return str;
 }
 
 /**
@@ -62,57 +214,54 @@ std::string IntToString(int v)
  */
 std::string MsPaddingIntToString(int v)
 {
-    std::ostringstream oss;
-    oss << v;
-    std::string time_ms = oss.str() + "000";
-    return time_ms;
+    char buf[INT_TO_CHAR_BUFFER_SIZE + 3];
+    char* end = WriteInt(buf, v);
+    std::memcpy(end, "000", 3);
+    return std::string(buf, end + 3);
 }
 
 /**
  *  @brief  Converts an double-type to a C-string with variable number of decimal places.
+ *          Digits beyond decimal_digits are truncated, not rounded; 0 decimal places still prints one fractional digit.
  *  @author Lau Lee Hong
  *  @param  str             buffer to store result
  *  @param  v               value
- *  @param  decimal_digits  number of decimal places
+ *  @param  decimal_digits  number of decimal places (at most 9)
  *  @return Null-terminated charcter array of double value with user-defined number of decimal places
  */
 char* DoubleToChar(char* str, double v, int decimal_digits)
 {
-    int i = 1;
-    int int_part, fract_part;
-    int len;
-    char *ptr;
+    if (decimal_digits > 9)
+    {
+        decimal_digits = 9;
+    }
 
     /* Prepare decimal digits multiplicator */
-    for (; decimal_digits != 0; i *= 10, decimal_digits--);
-
-    /* Calculate integer & fractional parts */
-    int_part = (int)v;
-    if (v < 0)
+    uint32_t scale = 1;
+    for (int i = 0; i < decimal_digits; i++)
     {
-        v = -v;
+        scale *= 10;
     }
-    fract_part = (int)((v - (double)(int)v) * i);
 
-    /* Fill in integer part */
-    std::sprintf(str, "%i.", int_part);
+    /* Calculate integer & fractional parts of the magnitude, so that values in (-1, 0) keep their sign */
+    double magnitude = (v < 0) ? -v : v;
+    uint64_t int_part = (uint64_t)magnitude;
+    uint32_t fract_part = (uint32_t)((magnitude - (double)int_part) * scale);
 
-    /* Prepare fill in of fractional part */
-    len = std::strlen(str);
-    ptr = &str[len];
-
-    /* Fill in leading fractional zeros */
-    for (i /= 10; i > 1; i /= 10, ptr++)
+    char* ptr = str;
+    if (v < 0 && (int_part != 0 || fract_part != 0))
     {
-        if (fract_part >= i)
-        {
-            break;
-        }
-        *ptr = '0';
+        *ptr++ = '-';
     }
+    ptr = WriteUnsigned(ptr, int_part);
+    *ptr++ = '.';
 
-    /* Fill in (rest of) fractional part */
-    std::sprintf(ptr, "%i", fract_part);
+    /* Fractional part with leading zeros */
+    char digits[10];
+    char* const end = digits + sizeof(digits);
+    char* first = FormatDigits32(end, fract_part, (decimal_digits > 0) ? decimal_digits : 1);
+    std::memcpy(ptr, first, end - first);
+    ptr[end - first] = '\0';
 
     return str;
 }
@@ -125,10 +274,7 @@ char* DoubleToChar(char* str, double v, int decimal_digits)
  */
 int StringToInt(const std::string& str)
 {
-    std::istringstream iss(str);
-    int v;
-    iss >> v;
-    return v;   
+    return ParseInteger<int>(str.c_str());
 }
 
 /**
@@ -139,9 +285,8 @@ int StringToInt(const std::string& str)
  */
 std::string TimeToString(const std::time_t time)
 {
-    std::ostringstream oss;
-    oss << time;
-    return oss.str();   
+    char buf[INT_TO_CHAR_BUFFER_SIZE];
+    return std::string(buf, WriteInt(buf, (int64_t)time));
 }
 
 /**
@@ -152,10 +297,7 @@ std::string TimeToString(const std::time_t time)
  */
 std::time_t StringToTime(const std::string& str)
 {
-    std::istringstream iss(str);
-    std::time_t time;
-    iss >> time;
-    return time;    
+    return ParseInteger<std::time_t>(str.c_str());
 }
 
 /**
@@ -21,9 +21,13 @@
 #include <ctime>
 #include <stdint.h>
 
+/* Longest IntToChar result: sign, 19 digits and terminator */
+#define INT_TO_CHAR_BUFFER_SIZE 21
+
 char* StringToChar(const std::string& str);
 std::string IntToHex(uint32_t i);
 std::string IntToString(int v);
+char* IntToChar(char* str, int64_t v);
 std::string MsPaddingIntToString(int v);
 char* DoubleToChar(char* str, double v, int decimalDigits);
 int StringToInt(const std::string& str);
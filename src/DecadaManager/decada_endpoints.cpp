@@ -0,0 +1,130 @@
+/**
+ * @defgroup decada_endpoints DECADA Endpoints
+ * @{
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "decada_endpoints.h"
+#include "mbed_trace.h"
+#include "global_params.h"
+
+#undef TRACE_GROUP
+#define TRACE_GROUP  "DecadaEndpoints"
+
+static bool endpoints_ready = false;
+static char measurepoint_topic[DECADA_DEVICE_TOPIC_SIZE(DECADA_MEASUREPOINT_TOPIC_SUFFIX)];
+static char service_topic_prefix[DECADA_DEVICE_TOPIC_SIZE(DECADA_SERVICE_TOPIC_SUFFIX)];
+static size_t service_topic_prefix_length = 0;
+static char envelope_prefix[DECADA_ENVELOPE_PREFIX_SIZE];
+static size_t envelope_prefix_length = 0;
+
+/**
+ *  @brief  Writes <head><uuid><tail> into a buffer sized for the longest UUID.
+ *  @author Lee Tze Han
+ *  @param  out     Destination, with room for the terminator
+ *  @param  head    Compile-time fragment before the UUID
+ *  @param  uuid    Device UUID, at most DEVICE_UUID_MAX_LENGTH characters
+ *  @param  tail    Compile-time fragment after the UUID
+ *  @return Length written, excluding the terminator
+ */
+template <size_t N, size_t H, size_t T>
+static size_t Assemble(char (&out)[N], const char (&head)[H], const std::string& uuid, const char (&tail)[T])
+{
+    static_assert(N >= H - 1 + DEVICE_UUID_MAX_LENGTH + T, "buffer too small for fragments and UUID");
+
+    size_t uuid_length = std::min(uuid.size(), (size_t)DEVICE_UUID_MAX_LENGTH);
+    char* p = out;
+    std::memcpy(p, head, H - 1);
+    p += H - 1;
+    std::memcpy(p, uuid.data(), uuid_length);
+    p += uuid_length;
+    std::memcpy(p, tail, T);            // with terminator
+    return (p - out) + T - 1;
+}
+
+/**
+ *  @brief  Patches the device UUID into the topics and the measure point envelope.
+ *  @author Lee Tze Han
+ *  @param  uuid    Device UUID
+ */
+void DecadaEndpointsInit(const std::string& uuid)
+{
+    if (uuid.size() > DEVICE_UUID_MAX_LENGTH)
+    {
+        tr_err("Device UUID longer than %d characters", DEVICE_UUID_MAX_LENGTH);
+    }
+
+    Assemble(measurepoint_topic, DECADA_TOPIC_PREFIX, uuid, DECADA_MEASUREPOINT_TOPIC_SUFFIX);
+    service_topic_prefix_length = Assemble(service_topic_prefix, DECADA_TOPIC_PREFIX, uuid, DECADA_SERVICE_TOPIC_SUFFIX);
+    envelope_prefix_length = Assemble(envelope_prefix, DECADA_ENVELOPE_ID, uuid, DECADA_ENVELOPE_METHOD);
+    endpoints_ready = true;
+}
+
+/**
+ *  @brief  Topic of thing.measurepoint.post.
+ *  @author Lee Tze Han
+ *  @return /sys/<product key>/<uuid>/thing/measurepoint/post
+ */
+const char* DecadaMeasurePointTopic(void)
+{
+    if (!endpoints_ready)
+    {
+        DecadaEndpointsInit(device_uuid);
+    }
+    return measurepoint_topic;
+}
+
+/**
+ *  @brief  Writes the topic of a service, or of its reply, without allocating.
+ *  @author Lee Tze Han
+ *  @param  topic       Destination, DECADA_SERVICE_TOPIC_SIZE is always enough
+ *  @param  size        Size of topic
+ *  @param  service_id  Service identifier, at most DECADA_SERVICE_ID_MAX characters
+ *  @param  reply       true for the reply topic
+ *  @return Length of the topic, or 0 if it does not fit
+ */
+size_t DecadaServiceTopic(char* topic, size_t size, const char* service_id, bool reply)
+{
+    if (!endpoints_ready)
+    {
+        DecadaEndpointsInit(device_uuid);
+    }
+
+    size_t id_length = std::strlen(service_id);
+    size_t suffix_length = reply ? LiteralLength(DECADA_REPLY_TOPIC_SUFFIX) : 0;
+    size_t length = service_topic_prefix_length + id_length + suffix_length;
+    if (length + 1 > size)
+    {
+        tr_warn("Service topic for %s does not fit", service_id);
+        return 0;
+    }
+
+    char* p = topic;
+    std::memcpy(p, service_topic_prefix, service_topic_prefix_length);
+    p += service_topic_prefix_length;
+    std::memcpy(p, service_id, id_length);
+    p += id_length;
+    std::memcpy(p, DECADA_REPLY_TOPIC_SUFFIX, suffix_length);
+    p[suffix_length] = '\0';
+
+    return length;
+}
+
+/**
+ *  @brief  Start of every measure point packet, up to the measure points.
+ *  @author Lee Tze Han
+ *  @param  length  Length of the prefix
+ *  @return {"id":"<uuid>","method":"thing.measurepoint.post","params":{"measurepoints":
+ */
+const char* DecadaEnvelopePrefix(size_t& length)
+{
+    if (!endpoints_ready)
+    {
+        DecadaEndpointsInit(device_uuid);
+    }
+    length = envelope_prefix_length;
+    return envelope_prefix;
+}
+
+/** @}*/
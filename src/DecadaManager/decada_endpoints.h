@@ -0,0 +1,63 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef DECADA_ENDPOINTS_H
+#define DECADA_ENDPOINTS_H
+
+#include <stddef.h>
+#include <string>
+
+#define DEVICE_UUID_MAX_LENGTH      24      // hexadecimal digits of the 96-bit UID
+#define DECADA_SERVICE_ID_MAX       32      // longest service identifier in a service topic
+
+/* Compile-time fragments of the DECADA topics; only the device UUID between them is known at boot */
+#define DECADA_TOPIC_PREFIX                 "/sys/" MBED_CONF_APP_DECADA_PRODUCT_KEY "/"
+#define DECADA_MEASUREPOINT_TOPIC_SUFFIX    "/thing/measurepoint/post"
+#define DECADA_SERVICE_TOPIC_SUFFIX         "/thing/service/"
+#define DECADA_REPLY_TOPIC_SUFFIX           "_reply"
+
+/*
+ *  Compile-time fragments of the thing.measurepoint.post envelope, in the key order of JsonCpp (sorted):
+ *  {"id":"<uuid>","method":"thing.measurepoint.post","params":{"measurepoints":<body>},"version":"1.0"}
+ *  where <body> is the object of measure points, or null if there are none
+ */
+#define DECADA_MEASUREPOINT_METHOD          "thing.measurepoint.post"
+#define DECADA_PROTOCOL_VERSION             "1.0"
+#define DECADA_ENVELOPE_ID                  "{\"id\":\""
+#define DECADA_ENVELOPE_METHOD              "\",\"method\":\"" DECADA_MEASUREPOINT_METHOD "\",\"params\":{\"measurepoints\":"
+#define DECADA_ENVELOPE_SUFFIX              "},\"version\":\"" DECADA_PROTOCOL_VERSION "\"}"
+
+/** Length of a string literal, at compile time */
+template <size_t N>
+constexpr size_t LiteralLength(const char (&)[N])
+{
+    return N - 1;
+}
+
+/* Buffer sizes, including the terminator */
+#define DECADA_DEVICE_TOPIC_SIZE(suffix)    (LiteralLength(DECADA_TOPIC_PREFIX) + DEVICE_UUID_MAX_LENGTH + LiteralLength(suffix) + 1)
+#define DECADA_SERVICE_TOPIC_SIZE           (DECADA_DEVICE_TOPIC_SIZE(DECADA_SERVICE_TOPIC_SUFFIX) + DECADA_SERVICE_ID_MAX + LiteralLength(DECADA_REPLY_TOPIC_SUFFIX))
+#define DECADA_ENVELOPE_PREFIX_SIZE         (LiteralLength(DECADA_ENVELOPE_ID) + DEVICE_UUID_MAX_LENGTH + LiteralLength(DECADA_ENVELOPE_METHOD) + 1)
+
+/*
+ *  Topics and packet envelope of this device, assembled once into fixed buffers. DecadaEndpointsInit() is
+ *  called at boot, before the application threads start; the accessors build them on first use otherwise.
+ */
+void DecadaEndpointsInit(const std::string& uuid);
+const char* DecadaMeasurePointTopic(void);
+size_t DecadaServiceTopic(char* topic, size_t size, const char* service_id, bool reply);
+const char* DecadaEnvelopePrefix(size_t& length);
+
+#endif  // DECADA_ENDPOINTS_H
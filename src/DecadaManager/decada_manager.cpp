@@ -8,17 +8,58 @@
 #include "mbedtls/sha1.h"
 #include "mbed_trace.h"
 #include "https_request.h"
-#include "json.h"
+#include "json_stream.h"
 #include "conversions.h"
 #include "crypto_engine.h"
 #include "device_uid.h"
 #include "persist_store.h"
 #include "subscription_callback.h"
 #include "time_engine.h"
+#include "watchdog_supervisor.h"
+#include "communications_network.h"
+#include "dns_cache.h"
 
 #undef TRACE_GROUP
 #define TRACE_GROUP  "DecadaManager"
 
+#define REQUEST_BODY_SIZE   512     // longest provisioning request json besides the CSR, terminator included
+
+/**
+ *  @brief  Extracts the host of a URL.
+ *  @author Lee Tze Han
+ *  @param  url URL
+ *  @return Host, without the port
+ */
+static std::string UrlHost(const std::string& url)
+{
+    size_t start = url.find("://");
+    start = (start == std::string::npos) ? 0 : start + 3;
+    size_t end = url.find_first_of(":/", start);
+
+    return url.substr(start, (end == std::string::npos) ? std::string::npos : end - start);
+}
+
+/**
+ *  @brief  Creates a request to the DECADA API, connecting on the cached address of its host.
+ *  @author Lee Tze Han
+ *  @param  network Network interface
+ *  @param  method  HTTP method
+ *  @param  url     URL of the resource
+ *  @return Request; the caller deletes it
+ */
+static HttpsRequest* NewApiRequest(NetworkInterface* network, http_method method, const std::string& url)
+{
+    HttpsRequest* request = new HttpsRequest(network, ROOT_CA_PEM, method, url.c_str());
+
+    SocketAddress address;
+    if (DnsCacheResolve(network, UrlHost(url).c_str(), &address) == NSAPI_ERROR_OK)
+    {
+        request->set_address(address);
+    }
+
+    return request;
+}
+
 /**
  *  @brief      RESTful call to DECADA for issuing a client certificate from the certificate signing request.
  *  @details    The client certificate is required for client authentication over TLS.
@@ -28,24 +69,31 @@
  */
 csr_sign_resp DecadaManager::SignCertificateSigningRequest(std::string csr)
 {
-    const std::string timestamp_ms = MsPaddingIntToString(RawRtcTimeNow());
+    const std::string timestamp_ms = EpochMsNowToString();
     const std::string access_token = GetAccessToken();
     const std::string http_post_frame = "actionapply";
     
-    Watchdog &watchdog = Watchdog::get_instance();
-    watchdog.kick();
-
-    Json::Value message_content;
-    message_content["csr"] = csr;
-    message_content["validDay"] = 365;
+    SupervisorHeartbeatWithin(SUPERVISOR_LONG_DEADLINE_MS);
+
+    /* Members in ASCII order, as they are signed; the CSR only escapes its line breaks */
+    std::string body(REQUEST_BODY_SIZE + 2 * csr.size(), '\0');
+    JsonWriter writer(&body[0], body.size());
+    writer.BeginObject();
+    writer.Key("csr");
+    writer.String(csr);
 #if defined(MBED_CONF_APP_USE_SECURE_ELEMENT) && (MBED_CONF_APP_USE_SECURE_ELEMENT == 1)
-    message_content["issueAuthority"] = "ECC";
+    writer.Key("issueAuthority");
+    writer.String("ECC");
 #endif  // MBED_CONF_APP_USE_SECURE_ELEMENT
-
-    Json::StreamWriterBuilder builder;
-    builder["indentation"] = "";
-    std::string body = Json::writeString(builder, message_content);
-    const char* body_sanitized = (char*)body.c_str();
+    writer.Key("validDay");
+    writer.Int(365);
+    writer.EndObject();
+    if (!writer.Ok())
+    {
+        tr_err("CSR request does not fit");
+        return {"invalid", "invalid"};
+    }
+    const char* body_sanitized = body.c_str();
 
     /* Sort parameters in ASCII order */
     const std::string parameters = http_post_frame + "deviceKey" + GetDeviceUid() + "orgId" + decada_ou_id_ + "productKey" + decada_product_key_+ body_sanitized;
@@ -55,7 +103,7 @@ csr_sign_resp DecadaManager::SignCertificateSigningRequest(std::string csr)
     const std::string request_uri = "/connect-service/v2.0/certificates?action=apply&orgId=" + decada_ou_id_
                                     + "&productKey=" + decada_product_key_
                                     + "&deviceKey=" + GetDeviceUid();
-    HttpsRequest* request = new HttpsRequest(network_, ROOT_CA_PEM, HTTP_POST, (api_url_ + request_uri).c_str());
+    HttpsRequest* request = NewApiRequest(network_, HTTP_POST, api_url_ + request_uri);
     request->set_header("Content-Type", "application/json;charset=UTF-8");
     request->set_header("apim-accesstoken", access_token);
     request->set_header("apim-signature", signature);
@@ -65,7 +113,8 @@ csr_sign_resp DecadaManager::SignCertificateSigningRequest(std::string csr)
 
     if (!response) 
     {
-        tr_warn("Failed to sign CSR (status code %d)", response->get_status_code());
+        tr_warn("Failed to sign CSR (error %d)", request->get_error());
+        DnsCacheInvalidate(UrlHost(api_url_).c_str());
         delete request;
 
         return {"invalid", "invalid"};
@@ -75,14 +124,8 @@ csr_sign_resp DecadaManager::SignCertificateSigningRequest(std::string csr)
         std::string res_string = response->get_body_as_string();
         tr_debug("CSR Sign return: %s", res_string.c_str());
 
-        Json::Reader reader;
-        Json::Value root;
-        Json::Value sub_root;
-        reader.parse(res_string, root, false);
-        sub_root = root.get("data", "invalid");
-
-        std::string decada_cert = sub_root.get("cert", "invalid").asString();
-        std::string decada_cert_serial_number = sub_root.get("certSN", "invalid").asString();
+        std::string decada_cert = JsonGetString(res_string, "data", "cert", "invalid");
+        std::string decada_cert_serial_number = JsonGetString(res_string, "data", "certSN", "invalid");
 
         delete request;
 
@@ -124,11 +167,21 @@ std::string DecadaManager::CheckDeviceCreation(void)
  */
 bool DecadaManager::Connect(void)
 {
-    /* Store device secret used to communicate with API */
-    device_secret_ = CheckDeviceCreation();
+    /* Store device secret used to communicate with API; it is only fetched from DECADA until it is persisted */
+    device_secret_ = ReadDeviceSecret();
+    if (device_secret_.empty())
+    {
+        device_secret_ = CheckDeviceCreation();
+        WriteDeviceSecret(device_secret_);
+    }
+
+    /* Establish MQTT Connection over the link brought up by ConfigNetworkInterface() */
+    mqtt_mutex.lock();
+    connection_.Up(CONN_LAYER_LINK);
+    bool connected = ReconnectMqttService();
+    mqtt_mutex.unlock();
 
-    /* Establish MQTT Connection */
-    return ConnectMqttNetwork() && ConnectMqttClient();
+    return connected;
 }
 
 /**
@@ -139,18 +192,37 @@ bool DecadaManager::Connect(void)
  *  @return Successful(1)/unsuccessful(0) mqtt publish
  */
 bool DecadaManager::Publish(const char* topic, std::string payload)
-{   
-    stdio_mutex.lock();
+{
+    return Publish(topic, payload.c_str(), payload.length());
+}
 
-    char* mqtt_payload = (char*) payload.c_str();
+/**
+ *  @brief  Publish payload via MQTT, from a buffer.
+ *  @author Lee Tze Han
+ *  @param  topic       MQTT publish topic
+ *  @param  payload     Outgoing MQTT message
+ *  @param  length      Length of payload
+ *  @return Successful(1)/unsuccessful(0) mqtt publish
+ */
+bool DecadaManager::Publish(const char* topic, const char* payload, size_t length)
+{
+    if (!IsConnected())
+    {
+        /* The subscription manager thread is reconnecting */
+        tr_debug("MQTT client offline, dropped publish to %s", topic);
+
+        return false;
+    }
+
+    stdio_mutex.lock();
 
     /* Publish MQTT message */
     MQTT::Message message;
     message.retained = false;
     message.dup = false;
-    message.payload = mqtt_payload;
+    message.payload = const_cast<char*>(payload);
     message.qos = MQTT::QOS0;
-    message.payloadlen = (payload.length());
+    message.payloadlen = length;
         
     int rc = mqtt_client_->publish(topic, message);
 
@@ -179,9 +251,15 @@ bool DecadaManager::Publish(const char* topic, std::string payload)
  */
 bool DecadaManager::Subscribe(const char* topic)
 {
-    sub_topics_.insert(topic);
+    /* The client keeps the topic filter pointer, so hand it the copy owned by sub_topics_ */
+    const std::string& sub_topic = *sub_topics_.insert(topic).first;
+    if ((mqtt_client_ == NULL) || !mqtt_client_->isConnected())
+    {
+        /* Subscribed once the client reconnects */
+        return false;
+    }
 
-    int rc = mqtt_client_->subscribe(topic, MQTT::QOS1, SubscriptionMessageArrivalCallback);
+    int rc = mqtt_client_->subscribe(sub_topic.c_str(), MQTT::QOS1, SubscriptionMessageArrivalCallback);
     
     if (rc != MQTT::SUCCESS) 
     {
@@ -198,13 +276,57 @@ bool DecadaManager::Subscribe(const char* topic)
 }
 
 /**
- *  @brief  Attempt to re-establish connection to DECADA. 
- *  @author Lau Lee Hong
- *  @return Successful(1)/unsuccessful(0)
+ *  @brief  Attempt to re-establish connection to DECADA, once the backoff of the last failed attempt has passed.
+ *  @details Only the subscription manager thread reconnects, as it owns the reads of the MQTT client. mqtt_mutex is
+ *           held for the whole attempt, so publishers skip rather than wait on it.
+ *           A system reset is the last resort, after reconnect-reset-after failed attempts in a row.
+ *  @author Lau Lee Hong, Lee Tze Han
+ *  @return Whether connected
  */
 bool DecadaManager::Reconnect(void)
 {
-    return ReconnectMqttService();
+    mqtt_mutex.lock();
+    if (connection_.IsConnected() && !((mqtt_client_ != NULL) && mqtt_client_->isConnected()))
+    {
+        /* A lost MQTT session means the broker or the network closed the TCP connection */
+        connection_.Down(LinkIsUp() ? CONN_LAYER_TRANSPORT : CONN_LAYER_LINK);
+        tr_warn("Lost connection to DECADA at %s", ConnectionManager::LayerName(connection_.GetBrokenLayer()));
+    }
+
+    bool connected = connection_.IsConnected();
+    if (!connected && connection_.Due(Kernel::get_ms_count()))
+    {
+        connected = ReconnectMqttService();
+    }
+    mqtt_mutex.unlock();
+
+    if (!connected && connection_.ResetDue())
+    {
+        tr_err("Could not reconnect to DECADA after %d attempts, resetting", MBED_CONF_APP_RECONNECT_RESET_AFTER);
+        NVIC_SystemReset();
+    }
+
+    return connected;
+}
+
+/**
+ *  @brief  Whether the MQTT client is connected to DECADA.
+ *  @author Lee Tze Han
+ *  @return Whether connected
+ */
+bool DecadaManager::IsConnected(void)
+{
+    return connection_.IsConnected() && (mqtt_client_ != NULL) && mqtt_client_->isConnected();
+}
+
+/**
+ *  @brief  Time the next reconnection attempt is due.
+ *  @author Lee Tze Han
+ *  @return Kernel time in ms; 0 when due at once
+ */
+uint64_t DecadaManager::GetNextReconnect(void) const
+{
+    return connection_.NextAttempt();
 }
 
 /// TODO: Test with SE when server upgrade completes
@@ -260,28 +382,36 @@ mqtt_stack* DecadaManager::GetMqttStackPointer(void)
  */
 std::string DecadaManager::GetAccessToken(void)
 {   
-    const std::string timestamp_ms = MsPaddingIntToString(RawRtcTimeNow());
+    const std::string timestamp_ms = EpochMsNowToString();
     const std::string signing_params = decada_access_key_ + timestamp_ms + decada_access_secret_;
     const std::string signature = ToLowerCase(CryptoEngine::GenericSHA256Generator(signing_params));
 
-    Json::Value message_content;
-    message_content["appKey"] = decada_access_key_;
-    message_content["encryption"] = signature;
-    message_content["timestamp"] = timestamp_ms;
-    Json::StreamWriterBuilder builder;
-    builder["indentation"] = "";
-    std::string body = Json::writeString(builder, message_content);
-    const char* body_sanitized = (char*)body.c_str();
+    char body_sanitized[REQUEST_BODY_SIZE];
+    JsonWriter writer(body_sanitized, sizeof(body_sanitized));
+    writer.BeginObject();
+    writer.Key("appKey");
+    writer.String(decada_access_key_);
+    writer.Key("encryption");
+    writer.String(signature);
+    writer.Key("timestamp");
+    writer.String(timestamp_ms);
+    writer.EndObject();
+    if (!writer.Ok())
+    {
+        tr_err("Access token request does not fit");
+        return "invalid";
+    }
 
     const std::string request_uri = "/apim-token-service/v2.0/token/get";
-    HttpsRequest* request = new HttpsRequest(network_, ROOT_CA_PEM, HTTP_POST, (api_url_ + request_uri).c_str());
+    HttpsRequest* request = NewApiRequest(network_, HTTP_POST, api_url_ + request_uri);
     request->set_header("Content-Type", "application/json;charset=UTF-8");
  
     HttpResponse* response = request->send(body_sanitized, strlen(body_sanitized));
 
     if (!response) 
     {
-        tr_warn("GetAccessToken failed (status code %d)", response->get_status_code());
+        tr_warn("GetAccessToken failed (error %d)", request->get_error());
+        DnsCacheInvalidate(UrlHost(api_url_).c_str());
         delete request;
 
         return "invalid";  
@@ -289,12 +419,7 @@ std::string DecadaManager::GetAccessToken(void)
     else
     {
         std::string res_string = response->get_body_as_string();
-        Json::Reader reader;
-        Json::Value root;
-        Json::Value sub_root;
-        reader.parse(res_string, root, false);
-        sub_root = root.get("data", "invalid");
-        std::string access_token = sub_root.get("accessToken", "invalid").asString();
+        std::string access_token = JsonGetString(res_string, "data", "accessToken", "invalid");
 
         delete request;
 
@@ -309,7 +434,7 @@ std::string DecadaManager::GetAccessToken(void)
  */
 std::string DecadaManager::GetDeviceSecret(void)
 {
-    const std::string timestamp_ms = MsPaddingIntToString(RawRtcTimeNow());
+    const std::string timestamp_ms = EpochMsNowToString();
     const std::string access_token = GetAccessToken();
     const std::string http_get_frame = "actionget";
 
@@ -322,7 +447,7 @@ std::string DecadaManager::GetDeviceSecret(void)
                                     + "&productKey=" + decada_product_key_
                                     + "&deviceKey=" + GetDeviceUid();
 
-    HttpsRequest* request = new HttpsRequest(network_, ROOT_CA_PEM, HTTP_GET, (api_url_ + request_uri).c_str());
+    HttpsRequest* request = NewApiRequest(network_, HTTP_GET, api_url_ + request_uri);
     request->set_header("apim-accesstoken", access_token);
     request->set_header("apim-signature", signature);
     request->set_header("apim-timestamp", timestamp_ms);
@@ -331,7 +456,8 @@ std::string DecadaManager::GetDeviceSecret(void)
 
     if (!response) 
     {
-        tr_warn("GetDeviceSecret failed (status code %d)", response->get_status_code());
+        tr_warn("GetDeviceSecret failed (error %d)", request->get_error());
+        DnsCacheInvalidate(UrlHost(api_url_).c_str());
         delete request;
 
         return "invalid"; 
@@ -341,12 +467,7 @@ std::string DecadaManager::GetDeviceSecret(void)
         std::string res_string = response->get_body_as_string();
         tr_debug("device secret: %s", res_string.c_str());
 
-        Json::Reader reader;
-        Json::Value root;
-        Json::Value sub_root;
-        reader.parse(res_string, root, false);
-        sub_root = root.get("data", "invalid");
-        std::string device_secret = sub_root.get("deviceSecret", "invalid").asString();
+        std::string device_secret = JsonGetString(res_string, "data", "deviceSecret", "invalid");
 
         delete request;
 
@@ -362,25 +483,33 @@ std::string DecadaManager::GetDeviceSecret(void)
  */
 std::string DecadaManager::CreateDeviceInDecada(const std::string default_name)
 {   
-    const std::string timestamp_ms = MsPaddingIntToString(RawRtcTimeNow());
+    const std::string timestamp_ms = EpochMsNowToString();
     const std::string access_token = GetAccessToken();
     const std::string http_post_frame = "actioncreate";
 
-    Json::Value international_name;
-
-    Json::Value device_name;
-    device_name["defaultValue"] = default_name;
-    device_name["i18nValue"] = international_name;
-
-    Json::Value message_content;
-    message_content["productKey"] = decada_product_key_;
-    message_content["timezone"] = "+08:00";
-    message_content["deviceName"] = device_name;
-    message_content["deviceKey"] = GetDeviceUid();
-    Json::StreamWriterBuilder builder;
-    builder["indentation"] = "";
-    std::string body = Json::writeString(builder, message_content);
-    const char* body_sanitized = (char*)body.c_str();
+    /* Members in ASCII order, as they are signed */
+    char body_sanitized[REQUEST_BODY_SIZE];
+    JsonWriter writer(body_sanitized, sizeof(body_sanitized));
+    writer.BeginObject();
+    writer.Key("deviceKey");
+    writer.String(GetDeviceUid());
+    writer.Key("deviceName");
+    writer.BeginObject();
+    writer.Key("defaultValue");
+    writer.String(default_name);
+    writer.Key("i18nValue");
+    writer.Null();
+    writer.EndObject();
+    writer.Key("productKey");
+    writer.String(decada_product_key_);
+    writer.Key("timezone");
+    writer.String("+08:00");
+    writer.EndObject();
+    if (!writer.Ok())
+    {
+        tr_err("Create device request does not fit");
+        return "invalid";
+    }
 
     /* Sort parameters in ASCII order */
     const std::string parameters = http_post_frame + "orgId" + decada_ou_id_ + body_sanitized;
@@ -388,7 +517,7 @@ std::string DecadaManager::CreateDeviceInDecada(const std::string default_name)
     const std::string signature = ToLowerCase(CryptoEngine::GenericSHA256Generator(signing_params));
 
     const std::string request_uri = "/connect-service/v2.1/devices?action=create&orgId=" + decada_ou_id_;
-    HttpsRequest* request = new HttpsRequest(network_, ROOT_CA_PEM, HTTP_POST, (api_url_ + request_uri).c_str());
+    HttpsRequest* request = NewApiRequest(network_, HTTP_POST, api_url_ + request_uri);
     request->set_header("Content-Type", "application/json;charset=UTF-8");
     request->set_header("apim-accesstoken", access_token);
     request->set_header("apim-signature", signature);
@@ -398,7 +527,8 @@ std::string DecadaManager::CreateDeviceInDecada(const std::string default_name)
 
     if (!response) 
     {
-        tr_warn("CreateDeviceInDecada request failed (status code %d)", response->get_status_code());
+        tr_warn("CreateDeviceInDecada request failed (error %d)", request->get_error());
+        DnsCacheInvalidate(UrlHost(api_url_).c_str());
         delete request;
 
         return "invalid";  
@@ -407,12 +537,7 @@ std::string DecadaManager::CreateDeviceInDecada(const std::string default_name)
     {
         std::string res_string = response->get_body_as_string();
         tr_debug("create device: %s", res_string.c_str());
-        Json::Reader reader;
-        Json::Value root;
-        Json::Value sub_root;
-        reader.parse(res_string, root, false);
-        sub_root = root.get("data", "invalid");
-        std::string device_secret = sub_root.get("deviceSecret", "invalid").asString();
+        std::string device_secret = JsonGetString(res_string, "data", "deviceSecret", "invalid");
 
         delete request;
 
@@ -428,20 +553,20 @@ std::string DecadaManager::CreateDeviceInDecada(const std::string default_name)
  */
 csr_sign_resp DecadaManager::RenewClientCertificate(void)
 {  
-    const std::string timestamp_ms = MsPaddingIntToString(RawRtcTimeNow());
+    const std::string timestamp_ms = EpochMsNowToString();
     const std::string access_token = GetAccessToken();
     const std::string http_post_frame = "actionrenew";
     
-    Watchdog &watchdog = Watchdog::get_instance();
-    watchdog.kick();
+    SupervisorHeartbeatWithin(SUPERVISOR_LONG_DEADLINE_MS);
 
-    Json::Value message_content;
-    message_content["certSn"] = StringToInt(ReadClientCertificateSerialNumber());
-    message_content["validDay"] = 365;
-    Json::StreamWriterBuilder builder;
-    builder["indentation"] = "";
-    std::string body = Json::writeString(builder, message_content);
-    const char* body_sanitized = (char*)body.c_str();
+    char body_sanitized[REQUEST_BODY_SIZE];
+    JsonWriter writer(body_sanitized, sizeof(body_sanitized));
+    writer.BeginObject();
+    writer.Key("certSn");
+    writer.Int(StringToInt(ReadClientCertificateSerialNumber()));
+    writer.Key("validDay");
+    writer.Int(365);
+    writer.EndObject();
 
     /* Sort parameters in ASCII order */
     const std::string parameters = http_post_frame + "deviceKey" + GetDeviceUid() + "orgId" + decada_ou_id_ + "productKey" + decada_product_key_+ body_sanitized;
@@ -451,7 +576,7 @@ csr_sign_resp DecadaManager::RenewClientCertificate(void)
     const std::string request_uri = "/connect-service/v2.0/certificates?action=renew&orgId=" + decada_ou_id_
                                     + "&productKey=" + decada_product_key_
                                     + "&deviceKey=" + GetDeviceUid();
-    HttpsRequest* request = new HttpsRequest(network_, ROOT_CA_PEM, HTTP_POST, (api_url_ + request_uri).c_str());
+    HttpsRequest* request = NewApiRequest(network_, HTTP_POST, api_url_ + request_uri);
     request->set_header("Content-Type", "application/json;charset=UTF-8");
     request->set_header("apim-accesstoken", access_token);
     request->set_header("apim-signature", signature);
@@ -461,7 +586,8 @@ csr_sign_resp DecadaManager::RenewClientCertificate(void)
 
     if (!response) 
     {
-        tr_warn("RenewClientCertificate request failed (status code %d)", response->get_status_code());
+        tr_warn("RenewClientCertificate request failed (error %d)", request->get_error());
+        DnsCacheInvalidate(UrlHost(api_url_).c_str());
         delete request;
 
         return {"invalid", "invalid"};
@@ -470,13 +596,8 @@ csr_sign_resp DecadaManager::RenewClientCertificate(void)
     {
         std::string res_string = response->get_body_as_string();
         tr_debug("renew client cert: %s", res_string.c_str());
-        Json::Reader reader;
-        Json::Value root;
-        Json::Value sub_root;
-        reader.parse(res_string, root, false);
-        sub_root = root.get("data", "invalid");
-        std::string renewed_decada_cert = sub_root.get("cert", "invalid").asString();
-        std::string renewed_decada_cert_serial_number = sub_root.get("certSN", "invalid").asString();
+        std::string renewed_decada_cert = JsonGetString(res_string, "data", "cert", "invalid");
+        std::string renewed_decada_cert_serial_number = JsonGetString(res_string, "data", "certSN", "invalid");
 
         delete request;
 
@@ -484,14 +605,26 @@ csr_sign_resp DecadaManager::RenewClientCertificate(void)
     }
 }
 
+/**
+ *  @brief  Whether the Wi-Fi / Ethernet link is up.
+ *  @author Lee Tze Han
+ *  @return Whether the link is up; interfaces that cannot tell are taken to be up
+ */
+bool DecadaManager::LinkIsUp(void)
+{
+    nsapi_connection_status_t status = network_->get_connection_status();
+
+    return (status != NSAPI_STATUS_DISCONNECTED) && (status != NSAPI_STATUS_CONNECTING);
+}
+
 /**
  *  @brief  Connect to MQTT network (refer to decada_manager.h to set a different hostname/serverport).
  *  @author Lau Lee Hong, Goh Kok Boon, Lee Tze Han
- *  @return Success of opening socket through MQTTNetwork
+ *  @return Layer that failed: CONN_LAYER_DNS or CONN_LAYER_TRANSPORT; CONN_LAYER_COUNT on success
  *  @note There is no way to query if there is an MQTT network behind the socket;
  *        this only checks if the socket is successfully opened.
  */
-bool DecadaManager::ConnectMqttNetwork(void)
+conn_layer_t DecadaManager::ConnectMqttNetwork(void)
 {
     if (!network_)
     {
@@ -500,26 +633,36 @@ bool DecadaManager::ConnectMqttNetwork(void)
 
     mqtt_network_ = new MQTTNetwork(network_);
 
+    SocketAddress broker_address;
+    int rc = DnsCacheResolve(network_, broker_ip_.c_str(), &broker_address);
+    if (rc != NSAPI_ERROR_OK)
+    {
+        tr_err("Failed to resolve %s (rc = %d)", broker_ip_.c_str(), rc);
+
+        return CONN_LAYER_DNS;
+    }
+
 #if defined(MBED_CONF_APP_USE_SECURE_ELEMENT) && (MBED_CONF_APP_USE_SECURE_ELEMENT == 1)
-    int rc = mqtt_network_->connect(broker_ip_.c_str(), mqtt_server_port_, ROOT_CA_PEM,
-                                    ReadClientCertificate().c_str(), pk_ctx_);
+    rc = mqtt_network_->connect(broker_ip_.c_str(), mqtt_server_port_, ROOT_CA_PEM,
+                                ReadClientCertificate().c_str(), pk_ctx_, &broker_address);
 #else
-    int rc = mqtt_network_->connect(broker_ip_.c_str(), mqtt_server_port_, ROOT_CA_PEM,
-                                    ReadClientCertificate().c_str(), ReadClientPrivateKey().c_str());
+    rc = mqtt_network_->connect(broker_ip_.c_str(), mqtt_server_port_, ROOT_CA_PEM,
+                                ReadClientCertificate().c_str(), ReadClientPrivateKey().c_str(), &broker_address);
 #endif  // MBED_CONF_APP_USE_SECURE_ELEMENT
 
     if (rc != 0)
     {
         tr_err("Failed to set-up socket (rc = %d)", rc);
+        DnsCacheInvalidate(broker_ip_.c_str());
 
-        return false;
+        return CONN_LAYER_TRANSPORT;
     }
     else
     {
-        tr_info("Opened socket on %s:%d", broker_ip_.c_str(), mqtt_server_port_);
+        tr_info("Opened socket on %s (%s):%d", broker_ip_.c_str(), broker_address.get_ip_address(), mqtt_server_port_);
     }
     
-    return true;
+    return CONN_LAYER_COUNT;
 }
 
 /**
@@ -535,8 +678,7 @@ bool DecadaManager::ConnectMqttClient(void)
     }
     const std::string decada_device_key = device_uuid;
     const std::string decada_product_key = MBED_CONF_APP_DECADA_PRODUCT_KEY;
-    int rtc_time_ms = RawRtcTimeNow();
-    std::string time_now_milli_sec = MsPaddingIntToString(rtc_time_ms);
+    std::string time_now_milli_sec = EpochMsNowToString();
 
     std::string sha256_input = "clientId" + decada_device_key + "deviceKey" + decada_device_key + "productKey" + decada_product_key +
      "timestamp" + time_now_milli_sec + device_secret_;
@@ -557,7 +699,20 @@ bool DecadaManager::ConnectMqttClient(void)
     mqtt_client_ = new MQTT::Client<MQTTNetwork, Countdown>(*mqtt_network_);
     
     int rc = mqtt_client_->connect(data);
-    if (rc != MQTT::SUCCESS)
+    if ((rc == MQTT_BAD_USERNAME_OR_PASSWORD) || (rc == MQTT_NOT_AUTHORIZED))
+    {
+        /* Persisted device secret may be out of date; fetch it again for the next attempt */
+        tr_warn("MQTT credentials rejected (rc = %d); refreshing device secret", rc);
+        std::string device_secret = GetDeviceSecret();
+        if (device_secret != "invalid")
+        {
+            device_secret_ = device_secret;
+            WriteDeviceSecret(device_secret_);
+        }
+
+        return false;
+    }
+    else if (rc != MQTT::SUCCESS)
     {
         tr_err("rc from MQTT connect is %d", rc);
      
@@ -626,26 +781,6 @@ void DecadaManager::DisconnectMqttClient(void)
     return;        
 }
 
-/**
- *  @brief  Reconnect MQTT network on DECADA.
- *  @author Lau Lee Hong, Ng Tze Yang
- *  @return Successful(1)/unsuccessful(0) MQTT Network Reconnection
- */
-bool DecadaManager::ReconnectMqttNetwork(void)
-{   
-    bool rc = ConnectMqttNetwork();
-    if (rc)
-    {
-        tr_info("Re-established connectivity with MQTT network");
-    }
-    else
-    {
-        tr_err("Could not establish connectivity with MQTT network");
-    }
-    
-    return rc; 
-}
-
 /**
  *  @brief  Reconnect MQTT client on DECADA.
  *  @author Lau Lee Hong, Lee Tze Han
@@ -679,34 +814,57 @@ bool DecadaManager::ReconnectMqttClient(void)
 }
 
 /**
- *  @brief  Disconnect and Reconnect MQTT network & client on DECADA.
- *  @author Ng Tze Yang, Lau Lee Hong
+ *  @brief  One attempt to reconnect the broken layer of the connection to DECADA, and the layers above it.
+ *  @details The MQTT layer is reconnected over a new TCP/TLS connection, as the broker closes it with the session.
+ *           The caller holds mqtt_mutex.
+ *  @author Ng Tze Yang, Lau Lee Hong, Lee Tze Han
  *  @return Successful(1)/unsuccessful(0) MQTT Client Reconnection
  */
 bool DecadaManager::ReconnectMqttService(void)
 {   
-    const uint8_t max_mqtt_failed_reconnections = 5;
-    static uint8_t mqtt_failed_reconnections = 0;
+    const uint64_t now_ms = Kernel::get_ms_count();
 
-    mqtt_mutex.lock();
-    DisconnectMqttNetwork();
-    DisconnectMqttClient();
-    bool network_is_connected = ReconnectMqttNetwork();
-    bool client_is_connected = ReconnectMqttClient();
-    mqtt_mutex.unlock();
-        
-    while (!(network_is_connected && client_is_connected))
+    if (mqtt_client_ != NULL)
     {
-        network_is_connected = ReconnectMqttNetwork();
-        client_is_connected = ReconnectMqttClient();
+        DisconnectMqttClient();
+    }
+    if (mqtt_network_ != NULL)
+    {
+        DisconnectMqttNetwork();
+    }
 
-        mqtt_failed_reconnections++;
-        if (mqtt_failed_reconnections == max_mqtt_failed_reconnections)
+    if (!LinkIsUp())
+    {
+        connection_.Down(CONN_LAYER_LINK);
+    }
+    if (connection_.GetBrokenLayer() == CONN_LAYER_LINK)
+    {
+        network_->disconnect();
+        if (!ConfigNetworkInterface(network_))
         {
-            NVIC_SystemReset();
+            connection_.Fail(CONN_LAYER_LINK, now_ms);
+
+            return false;
         }
+        connection_.Up(CONN_LAYER_LINK);
+    }
+
+    conn_layer_t failed_layer = ConnectMqttNetwork();
+    if (failed_layer != CONN_LAYER_COUNT)
+    {
+        connection_.Fail(failed_layer, now_ms);
+
+        return false;
+    }
+    connection_.Up(CONN_LAYER_TRANSPORT);
+
+    if (!ReconnectMqttClient())
+    {
+        connection_.Fail(CONN_LAYER_MQTT, now_ms);
+
+        return false;
     }
-    mqtt_failed_reconnections = 0;
+    connection_.Up(CONN_LAYER_MQTT);
 
     return true;
 }
@@ -16,9 +16,11 @@
 #ifndef DECADA_MANAGER_H
 #define DECADA_MANAGER_H
 
+#include <functional>
 #include <string>
 #include <unordered_set>
 #include "global_params.h"
+#include "connection_manager.h"
 #include "MQTTNetwork.h"
 #include "MQTTmbed.h"
 #include "MQTTClient.h"
@@ -135,8 +137,11 @@ class DecadaManager : public CryptoEngine
         /* Publish & Subscribe */
         bool Connect(void);
         bool Publish(const char* topic, std::string payload);
+        bool Publish(const char* topic, const char* payload, size_t length);
         bool Subscribe(const char* topic);
         bool Reconnect(void);
+        bool IsConnected(void);
+        uint64_t GetNextReconnect(void) const;
         bool RenewCertificate(void);
         mqtt_stack* GetMqttStackPointer(void);
 
@@ -148,7 +153,8 @@ class DecadaManager : public CryptoEngine
         csr_sign_resp RenewClientCertificate(void);
         
         /* Network Connection */
-        bool ConnectMqttNetwork(void);
+        bool LinkIsUp(void);
+        conn_layer_t ConnectMqttNetwork(void);
         bool ConnectMqttClient(void);
 
         /* Network Disconnection */
@@ -156,7 +162,6 @@ class DecadaManager : public CryptoEngine
         void DisconnectMqttClient(void);
 
         /* Reconnection */
-        bool ReconnectMqttNetwork(void);
         bool ReconnectMqttClient(void);
         bool ReconnectMqttService(void);
 
@@ -181,6 +186,9 @@ class DecadaManager : public CryptoEngine
         mqtt_stack stack_;
 
         std::unordered_set<std::string> sub_topics_;
+
+        /* Jitter is seeded per device, so that devices cut off together do not reconnect together */
+        ConnectionManager connection_{RECONNECT_POLICY_CONFIG, (uint32_t)std::hash<std::string>()(device_uuid)};
 };
 
 #endif  // DECADA_MANAGER_H
\ No newline at end of file
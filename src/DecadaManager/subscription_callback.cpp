@@ -3,18 +3,23 @@
  * @{
  */
 
+#include <cstring>
+#include <string>
 #include "subscription_callback.h"
+#include "json_stream.h"
 #include "mbed_trace.h"
-#include "json.h"
 #include "global_params.h"
-#include "conversions.h"
+#include "param_control.h"
 #include "persist_store.h"
 #include "trace_manager.h"
 #include "trace_macro.h"
+#include "diagnostics.h"
 
 #undef TRACE_GROUP
 #define TRACE_GROUP  "SubscriptionCallback"
 
+#define SERVICE_ERROR_BAD_REQUEST   400     // code replied to a request that cannot be carried out as sent
+
 /**
  *  @brief  Callback when a message has arrived from the broker.
  *  @author Lau Lee Hong, Yap Zi Qi
@@ -23,40 +28,84 @@
 void SubscriptionMessageArrivalCallback(MQTT::MessageData& md)
 {
     MQTT::Message &message = md.message;
-    std::string incoming_payload = (char*)message.payload;
-    
-    incoming_payload = incoming_payload.substr(0, message.payloadlen);
-
-    Json::Reader reader;
-    Json::Value root;
-    reader.parse(incoming_payload, root, false);
-
-    std::vector<std::pair<std::string, std::string>> param_list;
-    std::string msg_id = root.get("id", "invalid").asString();
+    const char* payload = static_cast<const char*>(message.payload);
 
-    std::string endpoint_id = root.get("method", "invalid").asString();
-    std::string const identifier = "thing.service.";
-    std::size_t found = endpoint_id.find(identifier);
-    if (found !=std::string::npos)
+    /* Service identifier is the last level of /sys/<product key>/<uuid>/thing/service/<service id> */
+    const char* service_id = md.topicName.lenstring.data;
+    size_t service_id_length = md.topicName.lenstring.len;
+    if (service_id == NULL)
+    {
+        service_id = md.topicName.cstring;
+        service_id_length = strlen(md.topicName.cstring);
+    }
+    for (size_t i = service_id_length; i > 0; i--)
     {
-        endpoint_id.erase(found, found+identifier.length());     // remove first 14 characters "thing.service." in method
+        if (service_id[i - 1] == '/')
+        {
+            service_id += i;
+            service_id_length -= i;
+            break;
+        }
     }
 
-    Json::Value params = root.get("params", "invalid");
-    if (params != "invalid")
+    /* {"id":..., "version":..., "params":{...}, "method":...} is read in place, checked whole before any param is applied */
+    char msg_id[CONTROL_MSG_ID_SIZE] = "invalid";
+    std::string long_msg_id;        // whole id, kept only if it does not fit in control mail
+    JsonReader reader(payload, message.payloadlen);
+    if (reader.Next() != JSON_OBJECT_BEGIN)
     {
-        Json::Value::Members param_keys = params.getMemberNames();
-        for (int i=0; i<param_keys.size(); i++)
+        tr_err("Service message is not a json object");
+        return;
+    }
+    while (reader.Next() == JSON_KEY)
+    {
+        if (reader.Equals("id"))
         {
-            std::string name = param_keys[i];
-            std::string value = root["params"][name].asString();
-            param_list.push_back(make_pair(name, value));
+            reader.Next();
+            if (reader.CopyString(msg_id, sizeof(msg_id)) >= sizeof(msg_id))
+            {
+                long_msg_id = reader.ToString();
+            }
         }
+        reader.Skip();
+    }
+    if ((reader.Token() != JSON_OBJECT_END) || (reader.Next() != JSON_END))
+    {
+        tr_err("Malformed service message on %.*s", static_cast<int>(service_id_length), service_id);
+        return;
     }
 
-    for (auto& it : param_list)
+    JsonReader params(payload, message.payloadlen);
+    params.Next();
+    if (!params.FindMember("params") || (params.Next() != JSON_OBJECT_BEGIN))
+    {
+        return;
+    }
+    while (params.Next() == JSON_KEY)
     {
-        tr_info("service identifier: %s, message_id: %s, param: %s, value: %s", endpoint_id.c_str(), msg_id.c_str(), it.first.c_str(), it.second.c_str());
+        const char* key = params.Data();
+        const size_t key_length = params.Length();
+        params.Next();
+
+        const control_param_info_t* param = FindControlParam(service_id, service_id_length, key, key_length);
+        int int_value = 0;
+        if ((param == NULL) || !params.ToInt(int_value))
+        {
+            tr_warn("Ignored service identifier: %.*s, param: %.*s, value: %.*s", static_cast<int>(service_id_length), service_id,
+                static_cast<int>(key_length), key, static_cast<int>(params.Length()), params.Data());
+            params.Skip();
+            continue;
+        }
+
+        if (!long_msg_id.empty())
+        {
+            /* A truncated id would be echoed back unmatched; refuse the request under its whole id instead */
+            tr_err("Message id of %s longer than %d characters", param->service_id, CONTROL_MSG_ID_SIZE - 1);
+            DecadaServiceError(param->param, long_msg_id.c_str(), SERVICE_ERROR_BAD_REQUEST, "message id too long");
+            return;
+        }
+
+        tr_info("service identifier: %s, message_id: %s, param: %s, value: %d", param->service_id, msg_id, param->name, int_value);
 
         mqtt_arrived_mail_t *mqtt_arrived_mail = mqtt_arrived_mail_box.try_calloc();
         while (mqtt_arrived_mail == NULL)
@@ -66,14 +115,15 @@ void SubscriptionMessageArrivalCallback(MQTT::MessageData& md)
             ThisThread::sleep_for(500ms);
         }
 
-        mqtt_arrived_mail->endpoint_id = StringToChar(endpoint_id);
-        mqtt_arrived_mail->msg_id = StringToChar(msg_id);
-        mqtt_arrived_mail->param = StringToChar(it.first);
-        mqtt_arrived_mail->value = StringToChar(it.second);
+        mqtt_arrived_mail->param = param->param;
+        mqtt_arrived_mail->value = int_value;
+        memcpy(mqtt_arrived_mail->msg_id, msg_id, sizeof(msg_id));
         mqtt_arrived_mail_box.put(mqtt_arrived_mail);
+        DiagnosticsMailPut(DIAG_MAIL_MQTT_ARRIVED);
+        event_flags.set(FLAG_WAKE_EVENT);
     }
 
     return;
 }
 
- /** @}*/
\ No newline at end of file
+ /** @}*/
@@ -0,0 +1,124 @@
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "diagnostics.h"
+#include "global_params.h"
+
+using namespace utest::v1;
+
+static void busy_worker(void)
+{
+    DiagnosticsBusyBegin();
+    ThisThread::sleep_for(50ms);
+    DiagnosticsBusyEnd();
+}
+
+// Test that no packet is due before the diagnostics interval has elapsed
+static control_t diagnostics_report_test_1(const size_t call_count)
+{
+    DiagnosticsInit();
+    uint32_t now_ms = (uint32_t)Kernel::get_ms_count();
+
+    TEST_ASSERT_FALSE(DiagnosticsReportDue(now_ms));
+    if (MBED_CONF_APP_DIAGNOSTICS_INTERVAL > 0)
+    {
+        TEST_ASSERT_TRUE(DiagnosticsReportDue(now_ms + MBED_CONF_APP_DIAGNOSTICS_INTERVAL * 1000));
+    }
+
+    return CaseNext;
+}
+
+// Test for maximum and 90th percentile mailbox depth in json packet
+static control_t diagnostics_mailbox_test_1(const size_t call_count)
+{
+    // Depths 1, 2, 3: buckets {1} and {2-3}, so the 90th percentile falls in the bucket starting at 2
+    DiagnosticsMailPut(DIAG_MAIL_LLP_SENSOR);
+    DiagnosticsMailPut(DIAG_MAIL_LLP_SENSOR);
+    DiagnosticsMailPut(DIAG_MAIL_LLP_SENSOR);
+    DiagnosticsMailGet(DIAG_MAIL_LLP_SENSOR);
+    DiagnosticsMailGet(DIAG_MAIL_LLP_SENSOR);
+    DiagnosticsMailGet(DIAG_MAIL_LLP_SENSOR);
+    DiagnosticsMailGet(DIAG_MAIL_LLP_SENSOR);       // unmatched get must not underflow
+
+    std::string actual_packet = DiagnosticsCreatePacket(0);
+
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, actual_packet.find("\"diag_mail_llp_max\":3.0"));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, actual_packet.find("\"diag_mail_llp_p90\":2.0"));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, actual_packet.find("\"diag_mail_upstream_max\":0.0"));
+
+    return CaseNext;
+}
+
+// Test that publish latency is reported only for intervals with publishes
+static control_t diagnostics_latency_test_1(const size_t call_count)
+{
+    std::string actual_packet = DiagnosticsCreatePacket(0);
+    TEST_ASSERT_EQUAL(std::string::npos, actual_packet.find("diag_latency_avg_ms"));
+
+    DiagnosticsRecordLatency(DiagnosticsCycles());
+    actual_packet = DiagnosticsCreatePacket(0);
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, actual_packet.find("diag_latency_avg_ms"));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, actual_packet.find("diag_latency_max_ms"));
+
+    actual_packet = DiagnosticsCreatePacket(0);
+    TEST_ASSERT_EQUAL(std::string::npos, actual_packet.find("diag_latency_avg_ms"));
+
+    return CaseNext;
+}
+
+// Test that the time to the first publish is reported once recorded, and not overwritten
+static control_t diagnostics_boot_test_1(const size_t call_count)
+{
+    std::string actual_packet = DiagnosticsCreatePacket(0);
+    TEST_ASSERT_EQUAL(std::string::npos, actual_packet.find("diag_boot_ms"));
+
+    DiagnosticsRecordBoot(2500);
+    DiagnosticsRecordBoot(9000);
+    actual_packet = DiagnosticsCreatePacket(0);
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, actual_packet.find("\"diag_boot_ms\":2500.0"));
+
+    return CaseNext;
+}
+
+// Test for CPU share and stack measure points of a registered thread
+static control_t diagnostics_thread_test_1(const size_t call_count)
+{
+    Thread worker(osPriorityNormal, OS_STACK_SIZE, NULL, "DiagnosticsWorker");
+    DiagnosticsRegisterThread(&worker, "worker");
+    worker.start(busy_worker);
+    worker.join();
+
+    std::string actual_packet = DiagnosticsCreatePacket(0);
+
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, actual_packet.find("\"diag_worker_cpu\""));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, actual_packet.find("\"diag_worker_stack\""));
+    TEST_ASSERT_EQUAL(std::string::npos, actual_packet.find("\"diag_worker_cpu\":0.0"));
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test diagnostics packet not due before interval", diagnostics_report_test_1),
+    Case("Test mailbox maximum and 90th percentile depth", diagnostics_mailbox_test_1),
+    Case("Test publish latency reported per interval", diagnostics_latency_test_1),
+    Case("Test time to first publish", diagnostics_boot_test_1),
+    Case("Test CPU share and stack of registered thread", diagnostics_thread_test_1)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
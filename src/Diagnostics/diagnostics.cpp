@@ -0,0 +1,435 @@
+/**
+ * @defgroup diagnostics Diagnostics
+ * @{
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include "diagnostics.h"
+#include "mbed_trace.h"
+#include "global_params.h"
+#include "sensor_profile.h"
+#include "power_manager.h"
+
+#define TRACE_GROUP "Diagnostics"
+
+typedef struct {
+    Thread* thread;
+    const char* id;                 /// short name used in measure point ids
+    uint32_t busy_start;            /// cycle count at DiagnosticsBusyBegin
+    bool busy;
+    uint64_t busy_cycles;           /// active cycles since boot
+    uint64_t reported_cycles;       /// busy_cycles at the last diagnostics packet
+} thread_stats_t;
+
+typedef struct {
+    uint32_t depth;                                 /// puts less gets
+    uint32_t max_depth;
+    uint32_t histogram[DIAGNOSTICS_DEPTH_BUCKETS];  /// depth after each put
+} mailbox_stats_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t sum_us;
+    uint32_t min_us;
+    uint32_t max_us;
+} latency_stats_t;
+
+static const char* const mailbox_ids[DIAG_MAIL_COUNT] = {
+    "llp", "upstream", "response", "arrived", "sensorctl", "behaviorctl"
+};
+
+static Mutex diag_mutex;
+static thread_stats_t thread_stats[DIAGNOSTICS_MAX_THREADS];
+static size_t num_threads = 0;
+static mailbox_stats_t mailbox_stats[DIAG_MAIL_COUNT];
+static latency_stats_t latency_since_boot;
+static latency_stats_t latency_since_report;
+static uint32_t last_report_ms = 0;
+static uint32_t boot_ms = 0;            /// reset to first published packet; 0 until recorded
+
+/**
+ *  @brief  Returns the stats of the calling thread. diag_mutex must be held.
+ *  @author Lee Tze Han
+ *  @return Pointer to stats, or NULL if the thread is not registered
+ */
+static thread_stats_t* FindThisThread(void)
+{
+    osThreadId_t id = ThisThread::get_id();
+    for (size_t i = 0; i < num_threads; i++)
+    {
+        if (thread_stats[i].thread->get_id() == id)
+        {
+            return &thread_stats[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ *  @brief  Histogram bucket of a mailbox depth: 0, 1, 2-3, 4-7, ..., 128+.
+ *  @author Lee Tze Han
+ *  @param  depth   Mailbox depth
+ *  @return Bucket index
+ */
+static size_t DepthBucket(uint32_t depth)
+{
+    size_t bucket = 0;
+    while (depth != 0 && bucket < DIAGNOSTICS_DEPTH_BUCKETS - 1)
+    {
+        depth >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ *  @brief  Smallest depth of a histogram bucket.
+ *  @author Lee Tze Han
+ *  @param  bucket  Bucket index
+ *  @return Lower bound of the bucket
+ */
+static uint32_t BucketLowerBound(size_t bucket)
+{
+    return (bucket == 0) ? 0 : (1U << (bucket - 1));
+}
+
+/**
+ *  @brief  Depth below which 90% of the puts to a mailbox found it, to bucket resolution.
+ *  @author Lee Tze Han
+ *  @param  stats   Mailbox stats
+ *  @return Lower bound of the bucket holding the 90th percentile
+ */
+static uint32_t DepthPercentile90(const mailbox_stats_t& stats)
+{
+    uint64_t total = 0;
+    for (size_t i = 0; i < DIAGNOSTICS_DEPTH_BUCKETS; i++)
+    {
+        total += stats.histogram[i];
+    }
+
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < DIAGNOSTICS_DEPTH_BUCKETS; i++)
+    {
+        cumulative += stats.histogram[i];
+        if (cumulative * 10 >= total * 9)
+        {
+            return BucketLowerBound(i);
+        }
+    }
+    return 0;
+}
+
+/**
+ *  @brief  Folds a latency into min/max/mean statistics.
+ *  @author Lee Tze Han
+ *  @param  stats       Statistics to update
+ *  @param  latency_us  Latency in microseconds
+ */
+static void AddLatency(latency_stats_t& stats, uint32_t latency_us)
+{
+    if (stats.count == 0 || latency_us < stats.min_us)
+    {
+        stats.min_us = latency_us;
+    }
+    if (latency_us > stats.max_us)
+    {
+        stats.max_us = latency_us;
+    }
+    stats.sum_us += latency_us;
+    stats.count++;
+}
+
+/**
+ *  @brief  Enables the DWT cycle counter and starts the first reporting interval.
+ *  @author Lee Tze Han
+ */
+void DiagnosticsInit(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->LAR = 0xC5ACCE55;          // unlock DWT on the Cortex-M7
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    diag_mutex.lock();
+    last_report_ms = (uint32_t)Kernel::get_ms_count();
+    diag_mutex.unlock();
+}
+
+/**
+ *  @brief  Adds a thread to the CPU share and stack reports.
+ *  @author Lee Tze Han
+ *  @param  thread  Thread, started or not
+ *  @param  id      Short name with static lifetime, used in measure point ids (diag_<id>_cpu)
+ */
+void DiagnosticsRegisterThread(Thread* thread, const char* id)
+{
+    diag_mutex.lock();
+    if (num_threads < DIAGNOSTICS_MAX_THREADS)
+    {
+        thread_stats_t& stats = thread_stats[num_threads++];
+        stats.thread = thread;
+        stats.id = id;
+        stats.busy = false;
+        stats.busy_cycles = 0;
+        stats.reported_cycles = 0;
+    }
+    else
+    {
+        tr_warn("Thread table full, not tracking %s", id);
+    }
+    diag_mutex.unlock();
+}
+
+/**
+ *  @brief  Reads the DWT cycle counter.
+ *  @author Lee Tze Han
+ *  @return Core clock cycles, wrapping at 2^32
+ */
+uint32_t DiagnosticsCycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+/**
+ *  @brief  Marks the start of work in the loop of the calling thread.
+ *  @author Lee Tze Han
+ */
+void DiagnosticsBusyBegin(void)
+{
+    uint32_t now = DiagnosticsCycles();
+
+    diag_mutex.lock();
+    thread_stats_t* stats = FindThisThread();
+    if (stats != NULL)
+    {
+        stats->busy_start = now;
+        stats->busy = true;
+    }
+    diag_mutex.unlock();
+}
+
+/**
+ *  @brief  Marks the end of work in the loop of the calling thread, before it sleeps.
+ *  @author Lee Tze Han
+ */
+void DiagnosticsBusyEnd(void)
+{
+    uint32_t now = DiagnosticsCycles();
+
+    diag_mutex.lock();
+    thread_stats_t* stats = FindThisThread();
+    if (stats != NULL && stats->busy)
+    {
+        stats->busy_cycles += (uint32_t)(now - stats->busy_start);
+        stats->busy = false;
+    }
+    diag_mutex.unlock();
+}
+
+/**
+ *  @brief  Records a put to a mailbox.
+ *  @author Lee Tze Han
+ *  @param  mailbox Mailbox
+ */
+void DiagnosticsMailPut(diag_mailbox_t mailbox)
+{
+    diag_mutex.lock();
+    mailbox_stats_t& stats = mailbox_stats[mailbox];
+    stats.depth++;
+    if (stats.depth > stats.max_depth)
+    {
+        stats.max_depth = stats.depth;
+    }
+    stats.histogram[DepthBucket(stats.depth)]++;
+    diag_mutex.unlock();
+}
+
+/**
+ *  @brief  Records a get from a mailbox.
+ *  @author Lee Tze Han
+ *  @param  mailbox Mailbox
+ */
+void DiagnosticsMailGet(diag_mailbox_t mailbox)
+{
+    diag_mutex.lock();
+    if (mailbox_stats[mailbox].depth > 0)
+    {
+        mailbox_stats[mailbox].depth--;
+    }
+    diag_mutex.unlock();
+}
+
+/**
+ *  @brief  Records the latency of a publish.
+ *  @author Lee Tze Han
+ *  @param  read_cycles DiagnosticsCycles() when the oldest reading in the publish was taken
+ */
+void DiagnosticsRecordLatency(uint32_t read_cycles)
+{
+    uint32_t latency_us = (uint32_t)(DiagnosticsCycles() - read_cycles) / (SystemCoreClock / 1000000);
+
+    diag_mutex.lock();
+    AddLatency(latency_since_boot, latency_us);
+    AddLatency(latency_since_report, latency_us);
+    diag_mutex.unlock();
+}
+
+/**
+ *  @brief  Records the time from reset to the first published packet; later calls are ignored.
+ *  @author Lee Tze Han
+ *  @param  first_publish_ms    Kernel clock when the first packet was published
+ */
+void DiagnosticsRecordBoot(uint32_t first_publish_ms)
+{
+    diag_mutex.lock();
+    if (boot_ms == 0)
+    {
+        boot_ms = (first_publish_ms > 0) ? first_publish_ms : 1;
+    }
+    diag_mutex.unlock();
+}
+
+/**
+ *  @brief  Checks whether a diagnostics packet is due.
+ *  @author Lee Tze Han
+ *  @param  now_ms  Kernel clock in milliseconds
+ *  @return true once diagnostics-interval has elapsed since the last packet; never if the interval is 0
+ */
+bool DiagnosticsReportDue(uint32_t now_ms)
+{
+    const uint32_t interval_ms = MBED_CONF_APP_DIAGNOSTICS_INTERVAL * 1000;
+
+    diag_mutex.lock();
+    bool due = (interval_ms > 0) && ((uint32_t)(now_ms - last_report_ms) >= interval_ms);
+    diag_mutex.unlock();
+
+    return due;
+}
+
+/**
+ *  @brief  Creates a thing.measurepoint.post packet of the statistics, and starts a new reporting interval.
+ *          CPU share and latency cover the interval; stack and mailbox figures cover the time since boot.
+ *  @author Lee Tze Han
+ *  @param  time_stamp  Epoch milliseconds of the packet
+ *  @return DECADA-compliant json packet
+ */
+std::string DiagnosticsCreatePacket(int64_t time_stamp)
+{
+    SensorProfile profile;
+    uint32_t now_ms = (uint32_t)Kernel::get_ms_count();
+    const uint32_t cycles_per_ms = SystemCoreClock / 1000;
+
+    diag_mutex.lock();
+    uint32_t interval_ms = now_ms - last_report_ms;
+    for (size_t i = 0; i < num_threads; i++)
+    {
+        thread_stats_t& stats = thread_stats[i];
+        std::string id = std::string("diag_") + stats.id;
+        uint64_t busy_ms = (stats.busy_cycles - stats.reported_cycles) / cycles_per_ms;
+        float cpu_share = (interval_ms > 0) ? 100.0f * busy_ms / interval_ms : 0.0f;
+
+        profile.UpdateValue(id + "_cpu", cpu_share, time_stamp);
+        profile.UpdateValue(id + "_stack", (float)stats.thread->max_stack(), time_stamp);
+        stats.reported_cycles = stats.busy_cycles;
+    }
+
+    for (size_t i = 0; i < DIAG_MAIL_COUNT; i++)
+    {
+        std::string id = std::string("diag_mail_") + mailbox_ids[i];
+        profile.UpdateValue(id + "_max", (float)mailbox_stats[i].max_depth, time_stamp);
+        profile.UpdateValue(id + "_p90", (float)DepthPercentile90(mailbox_stats[i]), time_stamp);
+    }
+
+    if (latency_since_report.count > 0)
+    {
+        profile.UpdateValue("diag_latency_avg_ms", (float)(latency_since_report.sum_us / latency_since_report.count) / 1000.0f, time_stamp);
+        profile.UpdateValue("diag_latency_max_ms", (float)latency_since_report.max_us / 1000.0f, time_stamp);
+    }
+    latency_since_report = latency_stats_t();
+    last_report_ms = now_ms;
+    if (boot_ms > 0)
+    {
+        profile.UpdateValue("diag_boot_ms", (float)boot_ms, time_stamp);
+    }
+    diag_mutex.unlock();
+
+#if MBED_CONF_APP_POWER_STATS
+    power_stats_t power;
+    PowerGetStats(power, POWER_SINCE_REPORT);
+    profile.UpdateValue("diag_duty_cycle", power.duty_cycle, time_stamp);
+    profile.UpdateValue("diag_deep_sleep", power.deep_sleep_share, time_stamp);
+    profile.UpdateValue("diag_wakeups_h", power.wakeups_per_hour, time_stamp);
+#endif  // MBED_CONF_APP_POWER_STATS
+
+    return profile.GetNewDecadaPacket();
+}
+
+/**
+ *  @brief  Prints the statistics since boot on the serial console.
+ *  @author Lee Tze Han
+ */
+void DiagnosticsPrint(void)
+{
+    uint64_t uptime_ms = Kernel::get_ms_count();
+    const uint32_t cycles_per_ms = SystemCoreClock / 1000;
+
+    /* Snapshot first; stdio_mutex is taken by threads that also record mailbox puts */
+    diag_mutex.lock();
+    size_t threads_count = num_threads;
+    thread_stats_t threads[DIAGNOSTICS_MAX_THREADS];
+    std::copy(thread_stats, thread_stats + num_threads, threads);
+    mailbox_stats_t mailboxes[DIAG_MAIL_COUNT];
+    std::copy(mailbox_stats, mailbox_stats + DIAG_MAIL_COUNT, mailboxes);
+    latency_stats_t latency = latency_since_boot;
+    uint32_t first_publish_ms = boot_ms;
+    diag_mutex.unlock();
+
+    stdio_mutex.lock();
+    printf("\r\n--- Diagnostics (uptime %lu s) ---\r\n", (unsigned long)(uptime_ms / 1000));
+    printf("%-32s %8s %16s\r\n", "Thread", "Active %", "Stack used/size");
+    for (size_t i = 0; i < threads_count; i++)
+    {
+        const thread_stats_t& stats = threads[i];
+        float share = (uptime_ms > 0) ? 100.0f * (stats.busy_cycles / cycles_per_ms) / uptime_ms : 0.0f;
+        const char* name = stats.thread->get_name() ? stats.thread->get_name() : stats.id;
+        printf("%-32s %8.2f %7lu/%-8lu\r\n", name, share, (unsigned long)stats.thread->max_stack(), (unsigned long)stats.thread->stack_size());
+    }
+
+    printf("%-12s %5s %5s  depth at put: 0 1 2-3 4-7 8-15 16-31 32-63 64-127 128+\r\n", "Mailbox", "Depth", "Max");
+    for (size_t i = 0; i < DIAG_MAIL_COUNT; i++)
+    {
+        const mailbox_stats_t& stats = mailboxes[i];
+        printf("%-12s %5lu %5lu ", mailbox_ids[i], (unsigned long)stats.depth, (unsigned long)stats.max_depth);
+        for (size_t j = 0; j < DIAGNOSTICS_DEPTH_BUCKETS; j++)
+        {
+            printf(" %lu", (unsigned long)stats.histogram[j]);
+        }
+        printf("\r\n");
+    }
+
+    if (latency.count > 0)
+    {
+        printf("Sensor read to publish: %lu publishes, avg %.1f ms, min %.1f ms, max %.1f ms\r\n",
+               (unsigned long)latency.count, (latency.sum_us / latency.count) / 1000.0, latency.min_us / 1000.0, latency.max_us / 1000.0);
+    }
+    else
+    {
+        printf("Sensor read to publish: no publishes\r\n");
+    }
+
+    if (first_publish_ms > 0)
+    {
+        printf("Reset to first publish: %lu ms\r\n", (unsigned long)first_publish_ms);
+    }
+
+#if MBED_CONF_APP_POWER_STATS
+    power_stats_t power;
+    PowerGetStats(power, POWER_SINCE_BOOT);
+    printf("Power: duty cycle %.2f %%, deep sleep %.2f %%, %.0f wake-ups/h\r\n", power.duty_cycle, power.deep_sleep_share, power.wakeups_per_hour);
+#endif  // MBED_CONF_APP_POWER_STATS
+    stdio_mutex.unlock();
+}
+
+/** @}*/
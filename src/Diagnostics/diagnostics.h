@@ -0,0 +1,66 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include "mbed.h"
+
+#define DIAGNOSTICS_MAX_THREADS     10      // threads that can be registered
+#define DIAGNOSTICS_DEPTH_BUCKETS   9       // mailbox depth histogram: 0, 1, 2-3, 4-7, ..., 128+
+
+/* Mailboxes of global_params.h whose depth is tracked */
+typedef enum {
+    DIAG_MAIL_LLP_SENSOR = 0,
+    DIAG_MAIL_COMMS_UPSTREAM,
+    DIAG_MAIL_SERVICE_RESPONSE,
+    DIAG_MAIL_MQTT_ARRIVED,
+    DIAG_MAIL_SENSOR_CONTROL,
+    DIAG_MAIL_BEHAVIOR_CONTROL,
+    DIAG_MAIL_COUNT
+} diag_mailbox_t;
+
+/*
+ *  Runtime instrumentation of the application threads.
+ *
+ *  - Active share: each registered thread brackets the work of its loop with DiagnosticsBusyBegin() and
+ *    DiagnosticsBusyEnd(); cycles in between are counted with the DWT cycle counter. Blocking calls made
+ *    inside the bracket (socket reads, mailbox timeouts) count as active.
+ *  - Stack high-water marks from the RTX stack watermark (MBED_STACK_STATS_ENABLED).
+ *  - Mailbox depth, updated by DiagnosticsMailPut()/DiagnosticsMailGet() next to every put and get.
+ *  - Latency from sensor read to MQTT publish, from the cycle count stamped on the reading.
+ *    Latencies must stay below 2^32 cycles (19.8 s at 216 MHz).
+ *  - With power-stats, duty cycle and wake-ups per hour of PowerGetStats().
+ *  - Time from reset to the first published packet, once DiagnosticsRecordBoot() has recorded it.
+ */
+void DiagnosticsInit(void);
+void DiagnosticsRegisterThread(Thread* thread, const char* id);
+uint32_t DiagnosticsCycles(void);
+
+void DiagnosticsBusyBegin(void);
+void DiagnosticsBusyEnd(void);
+void DiagnosticsMailPut(diag_mailbox_t mailbox);
+void DiagnosticsMailGet(diag_mailbox_t mailbox);
+void DiagnosticsRecordLatency(uint32_t read_cycles);
+void DiagnosticsRecordBoot(uint32_t first_publish_ms);
+
+bool DiagnosticsReportDue(uint32_t now_ms);
+std::string DiagnosticsCreatePacket(int64_t time_stamp);
+void DiagnosticsPrint(void);
+
+#endif  // DIAGNOSTICS_H
@@ -0,0 +1,171 @@
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "dns_cache.h"
+#include "persist_store.h"
+
+using namespace utest::v1;
+
+// Network resolving a single host, whose background lookups complete when the test says so
+class FakeNetwork : public NetworkInterface
+{
+    public:
+        nsapi_error_t gethostbyname(const char* host, SocketAddress* address,
+                                    nsapi_version_t version = NSAPI_UNSPEC, const char* interface_name = NULL)
+        {
+            lookups++;
+            if (ip == NULL)
+            {
+                return NSAPI_ERROR_DNS_FAILURE;
+            }
+            address->set_ip_address(ip);
+            return NSAPI_ERROR_OK;
+        }
+
+        nsapi_value_or_error_t gethostbyname_async(const char* host, hostbyname_cb_t callback,
+                                                   nsapi_version_t version = NSAPI_UNSPEC, const char* interface_name = NULL)
+        {
+            if (!async)
+            {
+                return NSAPI_ERROR_UNSUPPORTED;
+            }
+            async_lookups++;
+            pending = callback;
+            return 1;
+        }
+
+        void Complete(void)
+        {
+            SocketAddress address;
+            nsapi_error_t rc = gethostbyname(NULL, &address);
+            pending(rc, (rc == NSAPI_ERROR_OK) ? &address : NULL);
+        }
+
+        const char* ip = NULL;
+        bool async = true;
+        int lookups = 0;
+        int async_lookups = 0;
+        hostbyname_cb_t pending;
+};
+
+// Test that a resolved address is reused without looking the host up again
+static control_t resolve_test_1(const size_t call_count)
+{
+    WriteDnsCache("");
+    DnsCacheInit();
+
+    FakeNetwork network;
+    network.ip = "10.0.0.1";
+    SocketAddress address;
+
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, DnsCacheResolve(&network, "mqtt.decada.gov.sg", &address));
+    TEST_ASSERT_EQUAL_STRING("10.0.0.1", address.get_ip_address());
+    TEST_ASSERT_EQUAL(1, network.lookups);
+
+    network.ip = "10.0.0.2";
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, DnsCacheResolve(&network, "mqtt.decada.gov.sg", &address));
+    TEST_ASSERT_EQUAL_STRING("10.0.0.1", address.get_ip_address());
+    TEST_ASSERT_EQUAL(1, network.lookups);
+    TEST_ASSERT_EQUAL(0, network.async_lookups);
+
+    /* IP addresses need no lookup */
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, DnsCacheResolve(&network, "192.168.1.1", &address));
+    TEST_ASSERT_EQUAL_STRING("192.168.1.1", address.get_ip_address());
+    TEST_ASSERT_EQUAL(1, network.lookups);
+
+    /* Last good address is persisted */
+    TEST_ASSERT_EQUAL_STRING("mqtt.decada.gov.sg 10.0.0.1\n", ReadDnsCache().c_str());
+
+    return CaseNext;
+}
+
+// Test that a persisted address is connected on at once, while it is looked up in the background
+static control_t resolve_test_2(const size_t call_count)
+{
+    WriteDnsCache("mqtt.decada.gov.sg 10.0.0.1\n");
+    DnsCacheInit();
+
+    FakeNetwork network;
+    network.ip = "10.0.0.2";
+    SocketAddress address;
+
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, DnsCacheResolve(&network, "mqtt.decada.gov.sg", &address));
+    TEST_ASSERT_EQUAL_STRING("10.0.0.1", address.get_ip_address());
+    TEST_ASSERT_EQUAL(0, network.lookups);
+    TEST_ASSERT_EQUAL(1, network.async_lookups);
+
+    /* One background lookup at a time */
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, DnsCacheResolve(&network, "mqtt.decada.gov.sg", &address));
+    TEST_ASSERT_EQUAL(1, network.async_lookups);
+
+    network.Complete();
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, DnsCacheResolve(&network, "mqtt.decada.gov.sg", &address));
+    TEST_ASSERT_EQUAL_STRING("10.0.0.2", address.get_ip_address());
+    TEST_ASSERT_EQUAL(1, network.async_lookups);
+    TEST_ASSERT_EQUAL_STRING("mqtt.decada.gov.sg 10.0.0.2\n", ReadDnsCache().c_str());
+
+    /* Without background lookups, a stale address is looked up in line */
+    DnsCacheInit();
+    FakeNetwork blocking_network;
+    blocking_network.async = false;
+    blocking_network.ip = "10.0.0.3";
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, DnsCacheResolve(&blocking_network, "mqtt.decada.gov.sg", &address));
+    TEST_ASSERT_EQUAL_STRING("10.0.0.3", address.get_ip_address());
+    TEST_ASSERT_EQUAL(1, blocking_network.lookups);
+
+    return CaseNext;
+}
+
+// Test the fallback on the last good address, and the lookup after a failed connection
+static control_t resolve_test_3(const size_t call_count)
+{
+    WriteDnsCache("");
+    DnsCacheInit();
+
+    FakeNetwork network;
+    SocketAddress address;
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_DNS_FAILURE, DnsCacheResolve(&network, "mqtt.decada.gov.sg", &address));
+
+    network.ip = "10.0.0.1";
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, DnsCacheResolve(&network, "mqtt.decada.gov.sg", &address));
+
+    /* Connection failed: looked up again */
+    DnsCacheInvalidate("mqtt.decada.gov.sg");
+    network.ip = "10.0.0.2";
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, DnsCacheResolve(&network, "mqtt.decada.gov.sg", &address));
+    TEST_ASSERT_EQUAL_STRING("10.0.0.2", address.get_ip_address());
+    TEST_ASSERT_EQUAL(3, network.lookups);
+
+    /* Lookup failed: the last good address is tried again */
+    DnsCacheInvalidate("mqtt.decada.gov.sg");
+    network.ip = NULL;
+    TEST_ASSERT_EQUAL(NSAPI_ERROR_OK, DnsCacheResolve(&network, "mqtt.decada.gov.sg", &address));
+    TEST_ASSERT_EQUAL_STRING("10.0.0.2", address.get_ip_address());
+    TEST_ASSERT_EQUAL(4, network.lookups);
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test cached resolution", resolve_test_1),
+    Case("Test background refresh of a stale address", resolve_test_2),
+    Case("Test fallback on the last good address", resolve_test_3)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,269 @@
+/**
+ * @defgroup dns_cache DNS Cache
+ * @{
+ */
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include "dns_cache.h"
+#include "mbed_trace.h"
+#include "persist_store.h"
+
+#define TRACE_GROUP "DnsCache"
+
+typedef struct {
+    char host[DNS_CACHE_HOST_SIZE];     /// empty when the slot is free
+    SocketAddress address;              /// last good address
+    uint64_t expires_ms;                /// kernel time the address goes stale; 0 when loaded from the PersistStore
+    bool suspect;                       /// a connection to the address failed; look up before reusing it
+} dns_entry_t;
+
+static dns_entry_t entries[DNS_CACHE_MAX_HOSTS];
+static int refreshing = -1;             /// entry being looked up in the background; one at a time
+static bool dirty = false;              /// addresses changed since they were persisted
+static Mutex cache_mutex;
+
+/**
+ *  @brief  Finds the entry of a host.
+ *  @author Lee Tze Han
+ *  @param  host    Host name
+ *  @return Index of the entry; -1 if the host is not cached
+ */
+static int FindEntry(const char* host)
+{
+    for (int i = 0; i < DNS_CACHE_MAX_HOSTS; i++)
+    {
+        if (entries[i].host[0] != '\0' && strcmp(entries[i].host, host) == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ *  @brief  Records the address of a host, replacing the entry that goes stale first if the cache is full.
+ *  @author Lee Tze Han
+ *  @param  host        Host name
+ *  @param  address     Resolved address
+ *  @param  expires_ms  Kernel time the address goes stale
+ */
+static void StoreEntry(const char* host, const SocketAddress& address, uint64_t expires_ms)
+{
+    if (strlen(host) >= DNS_CACHE_HOST_SIZE)
+    {
+        return;
+    }
+
+    int index = FindEntry(host);
+    if (index < 0)
+    {
+        index = 0;
+        for (int i = 0; i < DNS_CACHE_MAX_HOSTS; i++)
+        {
+            if (entries[i].host[0] == '\0')
+            {
+                index = i;
+                break;
+            }
+            if (entries[i].expires_ms < entries[index].expires_ms)
+            {
+                index = i;
+            }
+        }
+        if (index == refreshing)
+        {
+            refreshing = -1;
+        }
+        strcpy(entries[index].host, host);
+        entries[index].address = SocketAddress();
+    }
+
+    dns_entry_t& entry = entries[index];
+    if (!entry.address || strcmp(entry.address.get_ip_address(), address.get_ip_address()) != 0)
+    {
+        dirty = true;
+    }
+    entry.address = address;
+    entry.address.set_port(0);
+    entry.expires_ms = expires_ms;
+    entry.suspect = false;
+}
+
+/**
+ *  @brief  Writes the cached addresses to the PersistStore if they have changed; background lookups leave it to the next resolution.
+ *  @author Lee Tze Han
+ */
+static void PersistEntries(void)
+{
+    if (!dirty)
+    {
+        return;
+    }
+
+    std::string persisted;
+    for (int i = 0; i < DNS_CACHE_MAX_HOSTS; i++)
+    {
+        if (entries[i].host[0] != '\0' && entries[i].address)
+        {
+            persisted += std::string(entries[i].host) + " " + entries[i].address.get_ip_address() + "\n";
+        }
+    }
+    WriteDnsCache(persisted);
+    dirty = false;
+}
+
+/**
+ *  @brief  Completion of a background lookup; runs in the context of the network stack.
+ *  @author Lee Tze Han
+ *  @param  result  Non-negative on success
+ *  @param  address Resolved address
+ */
+static void RefreshDone(nsapi_value_or_error_t result, SocketAddress* address)
+{
+    cache_mutex.lock();
+    if (refreshing >= 0)
+    {
+        if (result >= 0 && address != NULL)
+        {
+            StoreEntry(entries[refreshing].host, *address, Kernel::get_ms_count() + DNS_CACHE_TTL_MS);
+        }
+        else
+        {
+            tr_warn("Failed to refresh %s (rc = %d)", entries[refreshing].host, result);
+        }
+        refreshing = -1;
+    }
+    cache_mutex.unlock();
+}
+
+/**
+ *  @brief  Loads the last good addresses from the PersistStore; they are stale until looked up again.
+ *  @author Lee Tze Han
+ */
+void DnsCacheInit(void)
+{
+    cache_mutex.lock();
+
+    for (dns_entry_t& entry : entries)
+    {
+        entry = dns_entry_t();
+    }
+    refreshing = -1;
+    dirty = false;
+
+    std::istringstream persisted(ReadDnsCache());
+    std::string host;
+    std::string ip;
+    while (persisted >> host >> ip)
+    {
+        SocketAddress address;
+        if (address.set_ip_address(ip.c_str()))
+        {
+            StoreEntry(host.c_str(), address, 0);
+        }
+    }
+    dirty = false;
+
+    cache_mutex.unlock();
+}
+
+/**
+ *  @brief  Resolves a host, from the cache where possible.
+ *  @author Lee Tze Han
+ *  @param  network Interface to look the host up on
+ *  @param  host    Host name or IP address
+ *  @param  address Resolved address (port 0)
+ *  @return NSAPI_ERROR_OK, or the error of the lookup if there is no address to fall back on
+ */
+nsapi_error_t DnsCacheResolve(NetworkInterface* network, const char* host, SocketAddress* address)
+{
+    if (address->set_ip_address(host))
+    {
+        return NSAPI_ERROR_OK;
+    }
+
+    cache_mutex.lock();
+
+    int index = FindEntry(host);
+    if (index >= 0 && !entries[index].suspect)
+    {
+        if (Kernel::get_ms_count() < entries[index].expires_ms)
+        {
+            *address = entries[index].address;
+            PersistEntries();
+            cache_mutex.unlock();
+            return NSAPI_ERROR_OK;
+        }
+
+        /* Stale: connect on it while it is looked up again */
+        bool started = (refreshing >= 0);
+        if (!started)
+        {
+            refreshing = index;
+            cache_mutex.unlock();
+            nsapi_value_or_error_t rc = network->gethostbyname_async(host, RefreshDone);
+            cache_mutex.lock();
+
+            started = (rc >= 0);
+            if (!started && refreshing == index)
+            {
+                refreshing = -1;
+            }
+        }
+
+        index = FindEntry(host);
+        if (started && index >= 0)
+        {
+            *address = entries[index].address;
+            PersistEntries();
+            cache_mutex.unlock();
+            tr_debug("Using cached address %s of %s", address->get_ip_address(), host);
+            return NSAPI_ERROR_OK;
+        }
+    }
+    cache_mutex.unlock();
+
+    SocketAddress resolved;
+    nsapi_error_t rc = network->gethostbyname(host, &resolved);
+
+    cache_mutex.lock();
+    if (rc == NSAPI_ERROR_OK)
+    {
+        StoreEntry(host, resolved, Kernel::get_ms_count() + DNS_CACHE_TTL_MS);
+        *address = resolved;
+        address->set_port(0);
+    }
+    else if ((index = FindEntry(host)) >= 0)
+    {
+        tr_warn("Failed to look up %s (rc = %d); using last good address %s", host, rc, entries[index].address.get_ip_address());
+        *address = entries[index].address;
+        rc = NSAPI_ERROR_OK;
+    }
+    PersistEntries();
+    cache_mutex.unlock();
+
+    return rc;
+}
+
+/**
+ *  @brief  Reports that a connection to the cached address of a host failed.
+ *  @author Lee Tze Han
+ *  @param  host    Host name
+ */
+void DnsCacheInvalidate(const char* host)
+{
+    cache_mutex.lock();
+
+    int index = FindEntry(host);
+    if (index >= 0)
+    {
+        entries[index].suspect = true;
+    }
+
+    cache_mutex.unlock();
+}
+
+/** @}*/
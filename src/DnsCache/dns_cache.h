@@ -0,0 +1,43 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef DNS_CACHE_H
+#define DNS_CACHE_H
+
+#include <stdint.h>
+#include "mbed.h"
+#include "NetworkInterface.h"
+
+#define DNS_CACHE_MAX_HOSTS     4                                           // hosts with a cached address
+#define DNS_CACHE_HOST_SIZE     64                                          // host name, with terminator
+#define DNS_CACHE_TTL_MS        ((uint64_t)MBED_CONF_APP_DNS_CACHE_TTL * 1000)
+
+/*
+ *  Cache of the resolved addresses of the cloud endpoints (DECADA API and MQTT broker).
+ *
+ *  A cached address is used without a lookup for dns-cache-ttl after it was resolved. Once stale,
+ *  it is still handed out at once, while a lookup refreshes it in the background for the next
+ *  connection; where the interface cannot look up in the background, it is looked up in line and
+ *  the stale address is only used if the lookup fails. The last good addresses are kept in the
+ *  PersistStore, so that the first connection after a reset need not wait for DNS either.
+ *
+ *  A connection that fails on a cached address should report it with DnsCacheInvalidate(); the
+ *  host is then looked up again before its address is reused.
+ */
+void DnsCacheInit(void);
+nsapi_error_t DnsCacheResolve(NetworkInterface* network, const char* host, SocketAddress* address);
+void DnsCacheInvalidate(const char* host);
+
+#endif  // DNS_CACHE_H
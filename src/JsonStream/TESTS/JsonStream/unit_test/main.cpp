@@ -0,0 +1,389 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "json.h"
+#include "json_stream.h"
+
+using namespace utest::v1;
+
+/* Documents of the shapes the device reads and writes */
+static const char* const seed_documents[] =
+{
+    "{\"id\":\"1234\",\"version\":\"1.0\",\"params\":{\"poll_rate\":10,\"enable\":true},\"method\":\"thing.service.poll\"}",
+    "{\"code\":0,\"msg\":\"OK\",\"requestId\":\"r-1\",\"data\":{\"cert\":\"-----BEGIN CERTIFICATE-----\\nMIIB\\u00e9\\n\",\"certSN\":42}}",
+    "{\"id\":\"1\",\"version\":\"1.0\",\"params\":{\"measurepoints\":{\"temperature\":25.5,\"humidity\":-1.25e+2},\"time\":1600000000000},\"method\":\"thing.measurepoint.post\"}",
+    "[[],{},[null,false,\"\\ud83d\\ude00\",0,-0.0,1E5],{\"a\":{\"b\":[1,2,{\"c\":\"\\\"\\\\\\/\\b\\f\\n\\r\\t\"}]}}]"
+};
+
+/* Reads a document to its end; returns the last token */
+static json_token_t ReadAll(const std::string& json)
+{
+    JsonReader reader(json.data(), json.size());
+    json_token_t token;
+    do
+    {
+        token = reader.Next();
+    } while ((token != JSON_END) && (token != JSON_ERROR));
+
+    return token;
+}
+
+static std::string FastWrite(const Json::Value& value)
+{
+    Json::FastWriter fast_writer;
+    std::string json = fast_writer.write(value);
+    json.erase(std::remove(json.begin(), json.end(), '\n'), json.end());
+
+    return json;
+}
+
+// Test that the writer writes as Json::FastWriter, with keys given in sorted order
+static control_t writer_test_1(const size_t call_count)
+{
+    Json::Value expected;
+    expected["array"].append(Json::Value(Json::arrayValue));
+    expected["array"].append(Json::Value(Json::objectValue));
+    expected["array"].append(Json::Value());
+    expected["array"].append(true);
+    expected["array"].append(false);
+    expected["int"] = Json::Int64(-9223372036854775807LL - 1);
+    expected["real"]["integral"] = 20.0;
+    expected["real"]["large"] = 1.5e300;
+    expected["real"]["nan"] = std::nan("");
+    expected["real"]["small"] = -0.1;
+    expected["string"] = "quote \" backslash \\ slash / \b\f\n\r\t \x01\x1f end";
+
+    char buffer[256];
+    JsonWriter writer(buffer, sizeof(buffer));
+    writer.BeginObject();
+    writer.Key("array");
+    writer.BeginArray();
+    writer.BeginArray();
+    writer.EndArray();
+    writer.BeginObject();
+    writer.EndObject();
+    writer.Null();
+    writer.Bool(true);
+    writer.Bool(false);
+    writer.EndArray();
+    writer.Key("int");
+    writer.Int(-9223372036854775807LL - 1);
+    writer.Key("real");
+    writer.BeginObject();
+    writer.Key("integral");
+    writer.Real(20.0);
+    writer.Key("large");
+    writer.Real(1.5e300);
+    writer.Key("nan");
+    writer.Real(std::nan(""));
+    writer.Key("small");
+    writer.Real(-0.1);
+    writer.EndObject();
+    writer.Key(std::string("string"));
+    writer.String(expected["string"].asString());
+    writer.EndObject();
+
+    TEST_ASSERT_TRUE(writer.Ok());
+    TEST_ASSERT_EQUAL_STRING(FastWrite(expected).c_str(), buffer);
+    TEST_ASSERT_EQUAL_UINT32(strlen(buffer), writer.Length());
+
+    return CaseNext;
+}
+
+// Test that output not fitting in the buffer is dropped, leaving the buffer terminated
+static control_t writer_test_2(const size_t call_count)
+{
+    char buffer[13];
+    JsonWriter writer(buffer, sizeof(buffer));
+    writer.BeginObject();
+    writer.Key("id");
+    writer.String("abc");
+    TEST_ASSERT_TRUE(writer.Ok());
+    TEST_ASSERT_EQUAL_STRING("{\"id\":\"abc\"", buffer);
+
+    writer.EndObject();
+    writer.Key("code");
+    writer.Int(200);
+    writer.EndObject();
+    TEST_ASSERT_FALSE(writer.Ok());
+    TEST_ASSERT_EQUAL_STRING("{\"id\":\"abc\"}", buffer);
+    TEST_ASSERT_EQUAL_UINT32(12, writer.Length());
+
+    char real[4];
+    TEST_ASSERT_EQUAL_UINT32(4, JsonFormatReal(real, sizeof(real), 10.0));
+    TEST_ASSERT_EQUAL_STRING("10.", real);
+
+    return CaseNext;
+}
+
+// Test tokens, values and navigation of the reader
+static control_t reader_test_1(const size_t call_count)
+{
+    const std::string json = seed_documents[0];
+    JsonReader reader(json.data(), json.size());
+
+    TEST_ASSERT_EQUAL(JSON_NONE, reader.Token());
+    TEST_ASSERT_EQUAL(JSON_OBJECT_BEGIN, reader.Next());
+    TEST_ASSERT_EQUAL_INT(1, reader.Depth());
+    TEST_ASSERT_EQUAL(JSON_KEY, reader.Next());
+    TEST_ASSERT_TRUE(reader.Equals("id"));
+    TEST_ASSERT_EQUAL(JSON_STRING, reader.Next());
+    int value = 0;
+    TEST_ASSERT_TRUE(reader.ToInt(value));
+    TEST_ASSERT_EQUAL_INT(1234, value);
+
+    TEST_ASSERT_TRUE(reader.FindMember("params"));
+    TEST_ASSERT_EQUAL(JSON_OBJECT_BEGIN, reader.Next());
+    TEST_ASSERT_TRUE(reader.FindMember("enable"));
+    TEST_ASSERT_EQUAL(JSON_TRUE, reader.Next());
+    TEST_ASSERT_TRUE(reader.ToInt(value));
+    TEST_ASSERT_EQUAL_INT(1, value);
+    TEST_ASSERT_FALSE(reader.FindMember("missing"));
+    TEST_ASSERT_EQUAL(JSON_OBJECT_END, reader.Token());
+    TEST_ASSERT_EQUAL_INT(1, reader.Depth());
+
+    TEST_ASSERT_TRUE(reader.FindMember("method"));
+    TEST_ASSERT_EQUAL(JSON_STRING, reader.Next());
+    TEST_ASSERT_EQUAL_STRING("thing.service.poll", reader.ToString().c_str());
+    TEST_ASSERT_FALSE(reader.ToInt(value));
+    TEST_ASSERT_EQUAL(JSON_OBJECT_END, reader.Next());
+
+    /* Integers out of the range of int are rejected, not wrapped */
+    const char* const out_of_range[] = { "[4294967306]", "[2147483648]", "[-2147483649]", "[\"99999999999999999999\"]" };
+    for (const char* json : out_of_range)
+    {
+        JsonReader bounded(json, strlen(json));
+        TEST_ASSERT_EQUAL(JSON_ARRAY_BEGIN, bounded.Next());
+        bounded.Next();
+        value = 10;
+        TEST_ASSERT_FALSE_MESSAGE(bounded.ToInt(value), json);
+        TEST_ASSERT_EQUAL_INT(10, value);
+    }
+    const std::string limits = "[2147483647,-2147483648]";
+    JsonReader bounded(limits.data(), limits.size());
+    TEST_ASSERT_EQUAL(JSON_ARRAY_BEGIN, bounded.Next());
+    TEST_ASSERT_EQUAL(JSON_NUMBER, bounded.Next());
+    TEST_ASSERT_TRUE(bounded.ToInt(value));
+    TEST_ASSERT_EQUAL_INT(2147483647, value);
+    TEST_ASSERT_EQUAL(JSON_NUMBER, bounded.Next());
+    TEST_ASSERT_TRUE(bounded.ToInt(value));
+    TEST_ASSERT_EQUAL_INT(-2147483647 - 1, value);
+    TEST_ASSERT_EQUAL(JSON_END, reader.Next());
+    TEST_ASSERT_EQUAL(JSON_END, reader.Next());
+
+    /* Skip over a nested value */
+    const std::string nested = seed_documents[3];
+    JsonReader skipper(nested.data(), nested.size());
+    TEST_ASSERT_EQUAL(JSON_ARRAY_BEGIN, skipper.Next());
+    TEST_ASSERT_EQUAL(JSON_ARRAY_BEGIN, skipper.Next());
+    TEST_ASSERT_TRUE(skipper.Skip());
+    TEST_ASSERT_EQUAL(JSON_OBJECT_BEGIN, skipper.Next());
+    TEST_ASSERT_TRUE(skipper.Skip());
+    TEST_ASSERT_EQUAL(JSON_ARRAY_BEGIN, skipper.Next());
+    TEST_ASSERT_TRUE(skipper.Skip());
+    TEST_ASSERT_EQUAL(JSON_ARRAY_END, skipper.Token());
+    TEST_ASSERT_EQUAL(JSON_OBJECT_BEGIN, skipper.Next());
+    TEST_ASSERT_TRUE(skipper.Skip());
+    TEST_ASSERT_EQUAL(JSON_ARRAY_END, skipper.Next());
+    TEST_ASSERT_EQUAL_INT(0, skipper.Depth());
+    TEST_ASSERT_EQUAL(JSON_END, skipper.Next());
+
+    return CaseNext;
+}
+
+// Test that strings are unescaped to UTF-8
+static control_t reader_test_2(const size_t call_count)
+{
+    const std::string json = "[\"a\\u00e9\\u20ac\\ud83d\\ude00\\\"\\\\\\/\\n\",\"\\u0069d\"]";
+    JsonReader reader(json.data(), json.size());
+    TEST_ASSERT_EQUAL(JSON_ARRAY_BEGIN, reader.Next());
+    TEST_ASSERT_EQUAL(JSON_STRING, reader.Next());
+
+    const char expected[] = "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\"\\/\n";
+    TEST_ASSERT_EQUAL_STRING(expected, reader.ToString().c_str());
+
+    char str[8];
+    TEST_ASSERT_EQUAL_UINT32(strlen(expected), reader.CopyString(str, sizeof(str)));
+    TEST_ASSERT_EQUAL_INT(0, strncmp(expected, str, sizeof(str) - 1));
+    TEST_ASSERT_EQUAL_UINT8('\0', str[sizeof(str) - 1]);
+
+    TEST_ASSERT_EQUAL(JSON_STRING, reader.Next());
+    TEST_ASSERT_TRUE(reader.Equals("id"));
+    TEST_ASSERT_FALSE(reader.Equals("i"));
+    TEST_ASSERT_FALSE(reader.Equals("idx"));
+    TEST_ASSERT_EQUAL_UINT32(7, reader.Length());
+
+    /* Agrees with JsonCpp */
+    Json::Reader json_reader(Json::Features::strictMode());
+    Json::Value root;
+    TEST_ASSERT_TRUE(json_reader.parse(json, root));
+    TEST_ASSERT_EQUAL_STRING(root[0].asString().c_str(), expected);
+
+    return CaseNext;
+}
+
+// Test that malformed documents are rejected, and well formed ones read to their end
+static control_t reader_test_3(const size_t call_count)
+{
+    const char* const malformed[] =
+    {
+        "", " ", "{", "}", "{\"a\"}", "{\"a\":}", "{\"a\":1,}", "{a:1}", "[1,]", "[1 2]", "[01]", "[1.]", "[.5]", "[-]",
+        "[1e]", "[tru]", "[nul]", "[\"\\x\"]", "[\"\\u12g4\"]", "[\"\\ud800\"]", "[\"\\udc00\"]", "[\"\\ud800\\u0041\"]",
+        "[\"a\nb\"]", "[\"abc]", "{} x", "[]]", "{\"a\":1}}", "[}", "{]",
+        "[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]"
+    };
+    const char* const well_formed[] =
+    {
+        "{}", "[]", " 1 ", "\"\\u00e9\"", "-0.5e+3", "true", "null", "{\"\":\"\"}", "[\"\\ud83d\\ude00\"]",
+        "[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]", " {\n\t\"a\" : [ true , false , null ] \r\n} "
+    };
+
+    for (const char* json : malformed)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(JSON_ERROR, ReadAll(json), json);
+    }
+    for (const char* json : well_formed)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(JSON_END, ReadAll(json), json);
+    }
+    for (const char* json : seed_documents)
+    {
+        TEST_ASSERT_EQUAL_MESSAGE(JSON_END, ReadAll(json), json);
+    }
+
+    return CaseNext;
+}
+
+// Test the reader on mutated documents: it must always end, and accept only what JsonCpp accepts
+static control_t reader_fuzz_test_1(const size_t call_count)
+{
+    static const char alphabet[] = "{}[]:,\"\\ 0123456789.-+eEtrufalsnu\x01\x7f\x80";
+    uint32_t state = 0x9E3779B9;
+    size_t accepted = 0;
+
+    for (int i = 0; i < 20000; i++)
+    {
+        std::string json = seed_documents[i % (sizeof(seed_documents) / sizeof(seed_documents[0]))];
+        const int mutations = 1 + (i % 4);
+        for (int m = 0; m < mutations && !json.empty(); m++)
+        {
+            /* xorshift32 */
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+
+            const size_t position = (state >> 8) % json.size();
+            const char c = ((state & 0x80) != 0) ? alphabet[(state >> 24) % (sizeof(alphabet) - 1)] : static_cast<char>(state >> 24);
+            switch (state % 3)
+            {
+                case 0:     json[position] = c; break;
+                case 1:     json.insert(position, 1, c); break;
+                default:    json.erase(position, 1); break;
+            }
+        }
+
+        JsonReader reader(json.data(), json.size());
+        json_token_t first = reader.Next();
+        json_token_t token = first;
+        size_t tokens = 1;
+        while ((token != JSON_END) && (token != JSON_ERROR))
+        {
+            TEST_ASSERT_TRUE(reader.Depth() >= 0);
+            TEST_ASSERT_TRUE(reader.Depth() <= JSON_MAX_DEPTH);
+            if ((token == JSON_STRING) || (token == JSON_KEY))
+            {
+                char str[16];
+                TEST_ASSERT_EQUAL_UINT32(reader.ToString().size(), reader.CopyString(str, sizeof(str)));
+            }
+            token = reader.Next();
+            TEST_ASSERT_TRUE(++tokens <= json.size() + 1);
+        }
+
+        if (token == JSON_END)
+        {
+            TEST_ASSERT_EQUAL_INT(0, reader.Depth());
+            if ((first == JSON_OBJECT_BEGIN) || (first == JSON_ARRAY_BEGIN))
+            {
+                Json::Reader json_reader(Json::Features::strictMode());
+                Json::Value root;
+                TEST_ASSERT_TRUE_MESSAGE(json_reader.parse(json, root), json.c_str());
+                accepted++;
+            }
+        }
+    }
+
+    /* Single mutations of the seeds leave some documents well formed */
+    TEST_ASSERT_TRUE(accepted > 0);
+
+    return CaseNext;
+}
+
+// Test that JsonGetString() reads provisioning responses as Json::Value::get() and asString() do
+static control_t get_string_test_1(const size_t call_count)
+{
+    const char* const responses[] =
+    {
+        seed_documents[1],
+        "{\"code\":0,\"data\":{\"accessToken\":\"abc\\/def\",\"expire\":7200}}",
+        "{\"code\":0,\"data\":{\"deviceSecret\":null,\"certSN\":true}}",
+        "{\"code\":0,\"data\":{\"cert\":{\"nested\":1}}}",
+        "{\"code\":0,\"data\":{}}",
+        "{\"code\":0}"
+    };
+    const char* const keys[] = {"cert", "certSN", "accessToken", "expire", "deviceSecret"};
+
+    for (const char* response : responses)
+    {
+        Json::Reader reader;
+        Json::Value root;
+        TEST_ASSERT_TRUE(reader.parse(response, root, false));
+        const Json::Value data = root.get("data", Json::Value(Json::objectValue));
+        for (const char* key : keys)
+        {
+            const Json::Value value = data.get(key, "invalid");
+            if (value.isObject() || value.isArray())
+            {
+                TEST_ASSERT_EQUAL_STRING("invalid", JsonGetString(response, "data", key, "invalid").c_str());
+                continue;
+            }
+            TEST_ASSERT_EQUAL_STRING_MESSAGE(value.asString().c_str(), JsonGetString(response, "data", key, "invalid").c_str(), key);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_STRING("invalid", JsonGetString("<html>Bad Gateway</html>", "data", "cert", "invalid").c_str());
+    TEST_ASSERT_EQUAL_STRING("invalid", JsonGetString("", "data", "cert", "invalid").c_str());
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test writer against JsonCpp", writer_test_1),
+    Case("Test writer overflow", writer_test_2),
+    Case("Test reader tokens and navigation", reader_test_1),
+    Case("Test reader string unescaping", reader_test_2),
+    Case("Test reader grammar", reader_test_3),
+    Case("Test reader on mutated documents", reader_fuzz_test_1),
+    Case("Test provisioning response fields", get_string_test_1)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,1024 @@
+/**
+ * @defgroup json_stream Json Stream
+ * @{
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include "json_stream.h"
+#include "conversions.h"
+
+static bool IsWhitespace(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+}
+
+static bool IsDigit(char c)
+{
+    return (c >= '0') && (c <= '9');
+}
+
+static int HexValue(char c)
+{
+    if (IsDigit(c))
+    {
+        return c - '0';
+    }
+    if ((c >= 'a') && (c <= 'f'))
+    {
+        return c - 'a' + 10;
+    }
+    if ((c >= 'A') && (c <= 'F'))
+    {
+        return c - 'A' + 10;
+    }
+
+    return -1;
+}
+
+/**
+ *  @brief  Reads the 4 hex digits of a \\u escape.
+ *  @author Lee Tze Han
+ *  @param  p   First digit
+ *  @param  end End of the string
+ *  @return UTF-16 code unit, or -1 if the digits are malformed
+ */
+static int32_t ReadCodeUnit(const char* p, const char* end)
+{
+    if (end - p < 4)
+    {
+        return -1;
+    }
+
+    int32_t unit = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        const int digit = HexValue(p[i]);
+        if (digit < 0)
+        {
+            return -1;
+        }
+        unit = (unit << 4) | digit;
+    }
+
+    return unit;
+}
+
+/**
+ *  @brief  Decodes one character of a string already checked by JsonReader::ScanString().
+ *  @author Lee Tze Han
+ *  @param  p       Character to decode; advanced past it
+ *  @param  end     End of the string
+ *  @param  utf8    At least 4 bytes for the UTF-8 encoding of the character
+ *  @return Number of bytes written to utf8
+ */
+static size_t DecodeChar(const char*& p, const char* end, char* utf8)
+{
+    if (*p != '\\')
+    {
+        utf8[0] = *p++;
+        return 1;
+    }
+
+    const char escape = p[1];
+    p += 2;
+    switch (escape)
+    {
+        case 'b':   utf8[0] = '\b'; return 1;
+        case 'f':   utf8[0] = '\f'; return 1;
+        case 'n':   utf8[0] = '\n'; return 1;
+        case 'r':   utf8[0] = '\r'; return 1;
+        case 't':   utf8[0] = '\t'; return 1;
+        case 'u':   break;
+        default:    utf8[0] = escape; return 1;
+    }
+
+    uint32_t code_point = ReadCodeUnit(p, end);
+    p += 4;
+    if ((code_point >= 0xD800) && (code_point <= 0xDBFF))
+    {
+        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (ReadCodeUnit(p + 2, end) - 0xDC00);
+        p += 6;
+    }
+
+    if (code_point < 0x80)
+    {
+        utf8[0] = code_point;
+        return 1;
+    }
+    if (code_point < 0x800)
+    {
+        utf8[0] = 0xC0 | (code_point >> 6);
+        utf8[1] = 0x80 | (code_point & 0x3F);
+        return 2;
+    }
+    if (code_point < 0x10000)
+    {
+        utf8[0] = 0xE0 | (code_point >> 12);
+        utf8[1] = 0x80 | ((code_point >> 6) & 0x3F);
+        utf8[2] = 0x80 | (code_point & 0x3F);
+        return 3;
+    }
+    utf8[0] = 0xF0 | (code_point >> 18);
+    utf8[1] = 0x80 | ((code_point >> 12) & 0x3F);
+    utf8[2] = 0x80 | ((code_point >> 6) & 0x3F);
+    utf8[3] = 0x80 | (code_point & 0x3F);
+    return 4;
+}
+
+/**
+ *  @brief  Reads from the start of a document.
+ *  @author Lee Tze Han
+ *  @param  json    Document; it is read in place and must outlive the reader
+ *  @param  length  Length of the document
+ */
+JsonReader::JsonReader(const char* json, size_t length) : p_(json), end_(json + length)
+{
+}
+
+/**
+ *  @brief  Ends the document on malformed input.
+ *  @author Lee Tze Han
+ *  @return JSON_ERROR
+ */
+json_token_t JsonReader::Fail(void)
+{
+    p_ = end_;
+    data_ = NULL;
+    length_ = 0;
+    token_ = JSON_ERROR;
+
+    return token_;
+}
+
+/**
+ *  @brief  Reads the next token.
+ *  @author Lee Tze Han
+ *  @return Token read; JSON_END and JSON_ERROR are repeated once reached
+ */
+json_token_t JsonReader::Next(void)
+{
+    if ((token_ == JSON_END) || (token_ == JSON_ERROR))
+    {
+        return token_;
+    }
+
+    while ((p_ < end_) && IsWhitespace(*p_))
+    {
+        p_++;
+    }
+
+    if (state_ == EXPECT_SEPARATOR)
+    {
+        if (depth_ == 0)
+        {
+            if (p_ != end_)
+            {
+                return Fail();
+            }
+            data_ = NULL;
+            length_ = 0;
+            token_ = JSON_END;
+            return token_;
+        }
+        if (p_ >= end_)
+        {
+            return Fail();
+        }
+
+        const bool object = objects_ & (1UL << (depth_ - 1));
+        if (*p_ == ',')
+        {
+            p_++;
+            while ((p_ < end_) && IsWhitespace(*p_))
+            {
+                p_++;
+            }
+            return object ? ReadKey() : ReadValue();
+        }
+
+        return Close(object ? '}' : ']');
+    }
+    if ((state_ == EXPECT_FIRST_KEY) && (p_ < end_) && (*p_ == '}'))
+    {
+        return Close('}');
+    }
+    if ((state_ == EXPECT_FIRST_VALUE) && (p_ < end_) && (*p_ == ']'))
+    {
+        return Close(']');
+    }
+    if ((state_ == EXPECT_KEY) || (state_ == EXPECT_FIRST_KEY))
+    {
+        return ReadKey();
+    }
+
+    return ReadValue();
+}
+
+/**
+ *  @brief  Reads the end of the current container.
+ *  @author Lee Tze Han
+ *  @param  c   Closing character of the container
+ *  @return JSON_OBJECT_END or JSON_ARRAY_END
+ */
+json_token_t JsonReader::Close(char c)
+{
+    if ((p_ >= end_) || (*p_ != c))
+    {
+        return Fail();
+    }
+
+    data_ = p_++;
+    length_ = 1;
+    depth_--;
+    state_ = EXPECT_SEPARATOR;
+    token_ = (c == '}') ? JSON_OBJECT_END : JSON_ARRAY_END;
+
+    return token_;
+}
+
+/**
+ *  @brief  Reads a member name, and the colon after it.
+ *  @author Lee Tze Han
+ *  @return JSON_KEY
+ */
+json_token_t JsonReader::ReadKey(void)
+{
+    if (!ScanString())
+    {
+        return Fail();
+    }
+    while ((p_ < end_) && IsWhitespace(*p_))
+    {
+        p_++;
+    }
+    if ((p_ >= end_) || (*p_ != ':'))
+    {
+        return Fail();
+    }
+    p_++;
+
+    state_ = EXPECT_VALUE;
+    token_ = JSON_KEY;
+
+    return token_;
+}
+
+/**
+ *  @brief  Reads a scalar value, or the start of a container.
+ *  @author Lee Tze Han
+ *  @return Token read
+ */
+json_token_t JsonReader::ReadValue(void)
+{
+    if (p_ >= end_)
+    {
+        return Fail();
+    }
+
+    switch (*p_)
+    {
+        case '{':
+        case '[':
+            if (depth_ >= JSON_MAX_DEPTH)
+            {
+                return Fail();
+            }
+            if (*p_ == '{')
+            {
+                objects_ |= (1UL << depth_);
+                state_ = EXPECT_FIRST_KEY;
+                token_ = JSON_OBJECT_BEGIN;
+            }
+            else
+            {
+                objects_ &= ~(1UL << depth_);
+                state_ = EXPECT_FIRST_VALUE;
+                token_ = JSON_ARRAY_BEGIN;
+            }
+            data_ = p_++;
+            length_ = 1;
+            depth_++;
+            return token_;
+
+        case '"':
+            if (!ScanString())
+            {
+                return Fail();
+            }
+            token_ = JSON_STRING;
+            break;
+
+        case 't':
+            if (!ScanLiteral("true"))
+            {
+                return Fail();
+            }
+            token_ = JSON_TRUE;
+            break;
+
+        case 'f':
+            if (!ScanLiteral("false"))
+            {
+                return Fail();
+            }
+            token_ = JSON_FALSE;
+            break;
+
+        case 'n':
+            if (!ScanLiteral("null"))
+            {
+                return Fail();
+            }
+            token_ = JSON_NULL;
+            break;
+
+        default:
+            if (!ScanNumber())
+            {
+                return Fail();
+            }
+            token_ = JSON_NUMBER;
+            break;
+    }
+    state_ = EXPECT_SEPARATOR;
+
+    return token_;
+}
+
+/**
+ *  @brief  Scans a string, checking its escapes; raw control characters and unpaired surrogates are malformed.
+ *  @author Lee Tze Han
+ *  @return Whether the string is well formed
+ */
+bool JsonReader::ScanString(void)
+{
+    if ((p_ >= end_) || (*p_ != '"'))
+    {
+        return false;
+    }
+
+    const char* p = p_ + 1;
+    while (p < end_)
+    {
+        const char c = *p;
+        if (c == '"')
+        {
+            data_ = p_ + 1;
+            length_ = p - data_;
+            p_ = p + 1;
+            return true;
+        }
+        if ((unsigned char)c < 0x20)
+        {
+            return false;
+        }
+        if (c != '\\')
+        {
+            p++;
+            continue;
+        }
+
+        if (end_ - p < 2)
+        {
+            return false;
+        }
+        if (p[1] != 'u')
+        {
+            if ((p[1] == '\0') || (std::strchr("\"\\/bfnrt", p[1]) == NULL))
+            {
+                return false;
+            }
+            p += 2;
+            continue;
+        }
+
+        const int32_t unit = ReadCodeUnit(p + 2, end_);
+        if ((unit < 0) || ((unit >= 0xDC00) && (unit <= 0xDFFF)))
+        {
+            return false;
+        }
+        p += 6;
+        if ((unit >= 0xD800) && (unit <= 0xDBFF))
+        {
+            /* High surrogate: must be followed by a low one */
+            if ((end_ - p < 2) || (p[0] != '\\') || (p[1] != 'u'))
+            {
+                return false;
+            }
+            const int32_t low = ReadCodeUnit(p + 2, end_);
+            if ((low < 0xDC00) || (low > 0xDFFF))
+            {
+                return false;
+            }
+            p += 6;
+        }
+    }
+
+    return false;
+}
+
+/**
+ *  @brief  Scans a number: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+ *  @author Lee Tze Han
+ *  @return Whether the number is well formed
+ */
+bool JsonReader::ScanNumber(void)
+{
+    const char* p = p_;
+    if ((p < end_) && (*p == '-'))
+    {
+        p++;
+    }
+    if ((p >= end_) || !IsDigit(*p))
+    {
+        return false;
+    }
+    if (*p++ != '0')
+    {
+        while ((p < end_) && IsDigit(*p))
+        {
+            p++;
+        }
+    }
+    if ((p < end_) && (*p == '.'))
+    {
+        if ((++p >= end_) || !IsDigit(*p))
+        {
+            return false;
+        }
+        while ((p < end_) && IsDigit(*p))
+        {
+            p++;
+        }
+    }
+    if ((p < end_) && ((*p == 'e') || (*p == 'E')))
+    {
+        p++;
+        if ((p < end_) && ((*p == '+') || (*p == '-')))
+        {
+            p++;
+        }
+        if ((p >= end_) || !IsDigit(*p))
+        {
+            return false;
+        }
+        while ((p < end_) && IsDigit(*p))
+        {
+            p++;
+        }
+    }
+
+    data_ = p_;
+    length_ = p - p_;
+    p_ = p;
+
+    return true;
+}
+
+/**
+ *  @brief  Scans true, false or null.
+ *  @author Lee Tze Han
+ *  @param  literal Literal expected
+ *  @return Whether the literal is there
+ */
+bool JsonReader::ScanLiteral(const char* literal)
+{
+    const size_t length = strlen(literal);
+    if (((size_t)(end_ - p_) < length) || (strncmp(p_, literal, length) != 0))
+    {
+        return false;
+    }
+
+    data_ = p_;
+    length_ = length;
+    p_ += length;
+
+    return true;
+}
+
+/**
+ *  @brief  Skips the value starting at the current token, with everything nested in it. On a key, skips its value.
+ *  @author Lee Tze Han
+ *  @return false if the document ended or is malformed
+ */
+bool JsonReader::Skip(void)
+{
+    if (token_ == JSON_KEY)
+    {
+        Next();
+    }
+    if ((token_ == JSON_OBJECT_BEGIN) || (token_ == JSON_ARRAY_BEGIN))
+    {
+        const int depth = depth_ - 1;
+        while (depth_ > depth)
+        {
+            const json_token_t token = Next();
+            if ((token == JSON_ERROR) || (token == JSON_END))
+            {
+                return false;
+            }
+        }
+    }
+
+    return (token_ != JSON_ERROR) && (token_ != JSON_END);
+}
+
+/**
+ *  @brief  Reads on through the current object to a member, skipping the others.
+ *  @author Lee Tze Han
+ *  @param  key Name of the member
+ *  @return true with the key as the current token; false if the object ended without it
+ */
+bool JsonReader::FindMember(const char* key)
+{
+    while (Next() == JSON_KEY)
+    {
+        if (Equals(key))
+        {
+            return true;
+        }
+        if (!Skip())
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+json_token_t JsonReader::Token(void) const
+{
+    return token_;
+}
+
+/**
+ *  @brief  Text of the current token, as written; strings and keys exclude their quotes.
+ *  @author Lee Tze Han
+ *  @return Start of the text in the document, or NULL at the end of the document
+ */
+const char* JsonReader::Data(void) const
+{
+    return data_;
+}
+
+size_t JsonReader::Length(void) const
+{
+    return length_;
+}
+
+/**
+ *  @brief  Nesting level of the current token; a container's own tokens are counted inside it.
+ *  @author Lee Tze Han
+ *  @return 0 at the top level
+ */
+int JsonReader::Depth(void) const
+{
+    return depth_;
+}
+
+/**
+ *  @brief  Compares the current key or string, unescaped, to a C-string; other tokens are compared as written.
+ *  @author Lee Tze Han
+ *  @param  str String to compare
+ *  @return Whether they are equal
+ */
+bool JsonReader::Equals(const char* str) const
+{
+    if (data_ == NULL)
+    {
+        return false;
+    }
+    if ((token_ != JSON_KEY) && (token_ != JSON_STRING))
+    {
+        return (strlen(str) == length_) && (strncmp(data_, str, length_) == 0);
+    }
+
+    const char* p = data_;
+    const char* end = data_ + length_;
+    char utf8[4];
+    while (p < end)
+    {
+        const size_t length = DecodeChar(p, end, utf8);
+        if (strncmp(str, utf8, length) != 0)
+        {
+            return false;
+        }
+        str += length;
+    }
+
+    return *str == '\0';
+}
+
+/**
+ *  @brief  Copies out the current token as ToString() would, truncated to fit.
+ *  @author Lee Tze Han
+ *  @param  str     Destination, always terminated if size is not 0
+ *  @param  size    Size of str
+ *  @return Length of the whole value, as snprintf(); truncated if not less than size
+ */
+size_t JsonReader::CopyString(char* str, size_t size) const
+{
+    if ((token_ != JSON_KEY) && (token_ != JSON_STRING) && (token_ != JSON_NUMBER) && (token_ != JSON_TRUE) && (token_ != JSON_FALSE))
+    {
+        if (size > 0)
+        {
+            str[0] = '\0';
+        }
+        return 0;
+    }
+
+    const bool quoted = (token_ == JSON_KEY) || (token_ == JSON_STRING);
+    const char* p = data_;
+    const char* end = data_ + length_;
+    size_t total = 0;
+    char utf8[4];
+    while (p < end)
+    {
+        size_t length = 1;
+        if (quoted)
+        {
+            length = DecodeChar(p, end, utf8);
+        }
+        else
+        {
+            utf8[0] = *p++;
+        }
+        for (size_t i = 0; i < length; i++, total++)
+        {
+            if (total + 1 < size)
+            {
+                str[total] = utf8[i];
+            }
+        }
+    }
+    if (size > 0)
+    {
+        str[(total < size) ? total : size - 1] = '\0';
+    }
+
+    return total;
+}
+
+/**
+ *  @brief  Value of the current token as a string: keys and strings unescaped, numbers and booleans as written.
+ *  @author Lee Tze Han
+ *  @return Value; empty for null and containers
+ */
+std::string JsonReader::ToString(void) const
+{
+    std::string value;
+    if ((token_ == JSON_KEY) || (token_ == JSON_STRING))
+    {
+        const char* p = data_;
+        const char* end = data_ + length_;
+        char utf8[4];
+        value.reserve(length_);
+        while (p < end)
+        {
+            value.append(utf8, DecodeChar(p, end, utf8));
+        }
+    }
+    else if ((token_ == JSON_NUMBER) || (token_ == JSON_TRUE) || (token_ == JSON_FALSE))
+    {
+        value.assign(data_, length_);
+    }
+
+    return value;
+}
+
+/**
+ *  @brief  Integer value of the current token, given as a number, a numeric string or a boolean.
+ *  @author Lee Tze Han
+ *  @param  value   Integer part of the value; fractions and exponents are dropped
+ *  @return Whether the value is numeric and within the range of int
+ */
+bool JsonReader::ToInt(int& value) const
+{
+    if ((token_ == JSON_TRUE) || (token_ == JSON_FALSE))
+    {
+        value = (token_ == JSON_TRUE);
+        return true;
+    }
+    if ((token_ != JSON_NUMBER) && (token_ != JSON_STRING))
+    {
+        return false;
+    }
+
+    size_t i = 0;
+    const bool negative = (length_ > 0) && (data_[0] == '-');
+    if (negative)
+    {
+        i++;
+    }
+    if ((i >= length_) || !IsDigit(data_[i]))
+    {
+        return false;
+    }
+
+    /* Out of range values are rejected rather than wrapped */
+    const uint64_t limit = negative ? (uint64_t)std::numeric_limits<int>::max() + 1 : (uint64_t)std::numeric_limits<int>::max();
+    uint64_t magnitude = 0;
+    for (; (i < length_) && IsDigit(data_[i]); i++)
+    {
+        const unsigned digit = data_[i] - '0';
+        if (magnitude > (limit - digit) / 10)
+        {
+            return false;
+        }
+        magnitude = magnitude * 10 + digit;
+    }
+    value = negative ? static_cast<int>(-static_cast<int64_t>(magnitude)) : static_cast<int>(magnitude);
+
+    return true;
+}
+
+/**
+ *  @brief  Writes from the start of a buffer, which is kept terminated.
+ *  @author Lee Tze Han
+ *  @param  buffer  Destination
+ *  @param  size    Size of buffer, terminator included
+ */
+JsonWriter::JsonWriter(char* buffer, size_t size) : buffer_(buffer), size_(size)
+{
+    if (size_ > 0)
+    {
+        buffer_[0] = '\0';
+    }
+    else
+    {
+        overflow_ = true;
+    }
+}
+
+void JsonWriter::Put(char c)
+{
+    Append(&c, 1);
+}
+
+void JsonWriter::Append(const char* str, size_t length)
+{
+    if (overflow_)
+    {
+        return;
+    }
+    if (length_ + length >= size_)
+    {
+        overflow_ = true;
+        return;
+    }
+
+    memcpy(buffer_ + length_, str, length);
+    length_ += length;
+    buffer_[length_] = '\0';
+}
+
+/**
+ *  @brief  Puts in the comma before a value or key that follows another at the same level.
+ *  @author Lee Tze Han
+ */
+void JsonWriter::Separate(void)
+{
+    if (need_comma_)
+    {
+        Put(',');
+    }
+    need_comma_ = true;
+}
+
+void JsonWriter::BeginObject(void)
+{
+    Separate();
+    Put('{');
+    need_comma_ = false;
+}
+
+void JsonWriter::EndObject(void)
+{
+    Put('}');
+    need_comma_ = true;
+}
+
+void JsonWriter::BeginArray(void)
+{
+    Separate();
+    Put('[');
+    need_comma_ = false;
+}
+
+void JsonWriter::EndArray(void)
+{
+    Put(']');
+    need_comma_ = true;
+}
+
+/**
+ *  @brief  Writes a member name; the value written next belongs to it.
+ *  @author Lee Tze Han
+ *  @param  key Name of the member
+ */
+void JsonWriter::Key(const char* key)
+{
+    String(key, strlen(key));
+    Put(':');
+    need_comma_ = false;
+}
+
+void JsonWriter::Key(const std::string& key)
+{
+    String(key.data(), key.size());
+    Put(':');
+    need_comma_ = false;
+}
+
+void JsonWriter::String(const char* value)
+{
+    String(value, strlen(value));
+}
+
+void JsonWriter::String(const std::string& value)
+{
+    String(value.data(), value.size());
+}
+
+/**
+ *  @brief  Writes a quoted string, escaped by JsonEscapeChar().
+ *  @author Lee Tze Han
+ *  @param  value   String
+ *  @param  length  Length of value
+ */
+void JsonWriter::String(const char* value, size_t length)
+{
+    Separate();
+    Put('"');
+
+    /* Runs of characters needing no escape are copied at once */
+    const char* run = value;
+    const char* end = value + length;
+    char escape[JSON_ESCAPE_SIZE];
+    for (const char* p = value; p < end; p++)
+    {
+        const size_t escape_length = JsonEscapeChar(*p, escape);
+        if (escape_length > 0)
+        {
+            Append(run, p - run);
+            Append(escape, escape_length);
+            run = p + 1;
+        }
+    }
+    Append(run, end - run);
+
+    Put('"');
+}
+
+void JsonWriter::Int(int64_t value)
+{
+    char str[INT_TO_CHAR_BUFFER_SIZE];
+
+    Separate();
+    Append(str, strlen(IntToChar(str, value)));
+}
+
+void JsonWriter::Real(double value)
+{
+    char str[32];
+
+    Separate();
+    Append(str, JsonFormatReal(str, sizeof(str), value));
+}
+
+void JsonWriter::Bool(bool value)
+{
+    Separate();
+    if (value)
+    {
+        Append("true", 4);
+    }
+    else
+    {
+        Append("false", 5);
+    }
+}
+
+void JsonWriter::Null(void)
+{
+    Separate();
+    Append("null", 4);
+}
+
+/**
+ *  @brief  Length of the json written.
+ *  @author Lee Tze Han
+ *  @return Length, excluding the terminator and anything dropped
+ */
+size_t JsonWriter::Length(void) const
+{
+    return length_;
+}
+
+/**
+ *  @brief  Whether everything written fitted in the buffer.
+ *  @author Lee Tze Han
+ *  @return false if output was dropped
+ */
+bool JsonWriter::Ok(void) const
+{
+    return !overflow_;
+}
+
+/**
+ *  @brief  Escape of a character in a json string, as by JsonCpp. Bytes from 0x80 are left to be copied
+ *          unchanged, so UTF-8 is written as such rather than as \\u escapes.
+ *  @author Lee Tze Han
+ *  @param  c       Character
+ *  @param  escape  At least JSON_ESCAPE_SIZE characters for the escape; not terminated
+ *  @return Length of the escape; 0 if the character is written as it is
+ */
+size_t JsonEscapeChar(char c, char* escape)
+{
+    static const char hex_digits[] = "0123456789abcdef";
+
+    escape[0] = '\\';
+    switch (c)
+    {
+        case '"':   escape[1] = '"'; return 2;
+        case '\\':  escape[1] = '\\'; return 2;
+        case '\b':  escape[1] = 'b'; return 2;
+        case '\f':  escape[1] = 'f'; return 2;
+        case '\n':  escape[1] = 'n'; return 2;
+        case '\r':  escape[1] = 'r'; return 2;
+        case '\t':  escape[1] = 't'; return 2;
+        default:
+            if ((unsigned char)c >= 0x20)
+            {
+                return 0;
+            }
+            memcpy(escape + 1, "u00", 3);
+            escape[4] = hex_digits[(c >> 4) & 0x0F];
+            escape[5] = hex_digits[c & 0x0F];
+            return 6;
+    }
+}
+
+/**
+ *  @brief  Formats a number as Json::FastWriter writes doubles: 15 significant digits, with ".0" added
+ *          to integral values so that they are read back as reals.
+ *  @author Lee Tze Han
+ *  @param  str     Destination, always terminated if size is not 0
+ *  @param  size    Size of str; 32 always suffices
+ *  @param  value   Number
+ *  @return Length of the number, as snprintf(); truncated if not less than size
+ */
+size_t JsonFormatReal(char* str, size_t size, double value)
+{
+    if (!std::isfinite(value))
+    {
+        return snprintf(str, size, "%s", std::isnan(value) ? "null" : ((value < 0) ? "-1e+9999" : "1e+9999"));
+    }
+
+    char buffer[32];
+    int length = snprintf(buffer, sizeof(buffer), "%.15g", value);
+    if (std::strpbrk(buffer, ".e") == NULL)
+    {
+        memcpy(buffer + length, ".0", 3);
+        length += 2;
+    }
+
+    return snprintf(str, size, "%s", buffer);
+}
+
+/**
+ *  @brief  Reads root[object][key] as a string, as Json::Value::get(object).get(key, default_value).asString()
+ *          would once parsed, without building the document.
+ *  @author Lee Tze Han
+ *  @param  json            Document
+ *  @param  object          Member of the root holding the value
+ *  @param  key             Member of object
+ *  @param  default_value   Returned if the member is missing, is not a scalar, or the document is malformed
+ *  @return Strings unescaped, numbers and booleans as written, "" for null
+ */
+std::string JsonGetString(const std::string& json, const char* object, const char* key, const char* default_value)
+{
+    JsonReader reader(json.data(), json.size());
+    if ((reader.Next() != JSON_OBJECT_BEGIN) || !reader.FindMember(object) || (reader.Next() != JSON_OBJECT_BEGIN) || !reader.FindMember(key))
+    {
+        return default_value;
+    }
+
+    switch (reader.Next())
+    {
+        case JSON_STRING:
+        case JSON_NUMBER:
+        case JSON_TRUE:
+        case JSON_FALSE:
+        case JSON_NULL:
+            return reader.ToString();
+
+        default:
+            return default_value;
+    }
+}
+
+/** @}*/
@@ -0,0 +1,187 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#define JSON_MAX_DEPTH      16          // deepest nesting of objects and arrays the reader accepts
+#define JSON_ESCAPE_SIZE    6           // longest escape of a character, \u00XX
+
+typedef enum {
+    JSON_NONE,                          // Next() not yet called
+    JSON_OBJECT_BEGIN,
+    JSON_OBJECT_END,
+    JSON_ARRAY_BEGIN,
+    JSON_ARRAY_END,
+    JSON_KEY,                           // member name; the value is the next token
+    JSON_STRING,
+    JSON_NUMBER,
+    JSON_TRUE,
+    JSON_FALSE,
+    JSON_NULL,
+    JSON_END,                           // whole document read
+    JSON_ERROR                          // malformed, truncated or nested deeper than JSON_MAX_DEPTH
+} json_token_t;
+
+/** JsonReader class.
+ *  @brief  Pull parser reading a json document in place, without allocating
+ *
+ *  Each call to Next() reads one token; strings and numbers are left in the caller's buffer and
+ *  reported by Data() and Length(), escapes and all, until copied out with CopyString(). The grammar
+ *  is that of RFC 8259; anything else, trailing characters included, ends the document with JSON_ERROR.
+ *
+ *  Example:
+ *  @code{.cpp}
+ *  #include "json_stream.h"
+ *
+ *  int main()
+ *  {
+ *      const char payload[] = "{\"id\":\"42\",\"params\":{\"poll_rate\":10}}";
+ *
+ *      JsonReader reader(payload, sizeof(payload) - 1);
+ *      if (reader.Next() == JSON_OBJECT_BEGIN && reader.FindMember("params") && reader.Next() == JSON_OBJECT_BEGIN)
+ *      {
+ *          while (reader.Next() == JSON_KEY)
+ *          {
+ *              std::string name = reader.ToString();
+ *              int value;
+ *              reader.Next();
+ *              if (reader.ToInt(value))
+ *                  printf("%s = %d\n", name.c_str(), value);
+ *              reader.Skip();
+ *          }
+ *      }
+ *  }
+ *  @endcode
+ */
+
+class JsonReader
+{
+    public:
+        JsonReader(const char* json, size_t length);
+
+        json_token_t Next(void);
+        bool Skip(void);
+        bool FindMember(const char* key);
+
+        json_token_t Token(void) const;
+        const char* Data(void) const;
+        size_t Length(void) const;
+        int Depth(void) const;
+
+        bool Equals(const char* str) const;
+        size_t CopyString(char* str, size_t size) const;
+        std::string ToString(void) const;
+        bool ToInt(int& value) const;
+
+    private:
+        typedef enum {
+            EXPECT_VALUE,
+            EXPECT_FIRST_VALUE,                                                             /// value or ']'
+            EXPECT_KEY,
+            EXPECT_FIRST_KEY,                                                               /// key or '}'
+            EXPECT_SEPARATOR                                                                /// ',' or the end of the container
+        } reader_state_t;
+
+        json_token_t Fail(void);
+        json_token_t ReadValue(void);
+        json_token_t ReadKey(void);
+        json_token_t Close(char c);
+        bool ScanString(void);
+        bool ScanNumber(void);
+        bool ScanLiteral(const char* literal);
+
+        const char* p_;                                                                     /// next character to read
+        const char* end_;
+        reader_state_t state_ = EXPECT_VALUE;
+        json_token_t token_ = JSON_NONE;
+        const char* data_ = NULL;                                                           /// text of the token; strings exclude the quotes
+        size_t length_ = 0;
+        int depth_ = 0;
+        uint32_t objects_ = 0;                                                              /// bit n set if level n + 1 is an object
+};
+
+/** JsonWriter class.
+ *  @brief  Push writer of compact json into a fixed buffer
+ *
+ *  Commas and colons are put in as values are written; nesting is left to the caller. Strings and
+ *  reals are written as Json::FastWriter writes them. Output that does not fit is dropped, the buffer
+ *  is left terminated after the last byte that fits, and Ok() turns false.
+ *
+ *  Example:
+ *  @code{.cpp}
+ *  #include "json_stream.h"
+ *
+ *  int main()
+ *  {
+ *      char buffer[128];
+ *
+ *      JsonWriter writer(buffer, sizeof(buffer));
+ *      writer.BeginObject();
+ *      writer.Key("code");
+ *      writer.Int(200);
+ *      writer.Key("id");
+ *      writer.String("42");
+ *      writer.EndObject();
+ *
+ *      if (writer.Ok())
+ *          printf("%s\n", buffer);     // {"code":200,"id":"42"}
+ *  }
+ *  @endcode
+ */
+
+class JsonWriter
+{
+    public:
+        JsonWriter(char* buffer, size_t size);
+
+        void BeginObject(void);
+        void EndObject(void);
+        void BeginArray(void);
+        void EndArray(void);
+        void Key(const char* key);
+        void Key(const std::string& key);
+        void String(const char* value);
+        void String(const char* value, size_t length);
+        void String(const std::string& value);
+        void Int(int64_t value);
+        void Real(double value);
+        void Bool(bool value);
+        void Null(void);
+
+        size_t Length(void) const;
+        bool Ok(void) const;
+
+    private:
+        void Separate(void);
+        void Put(char c);
+        void Append(const char* str, size_t length);
+
+        char* buffer_;
+        size_t size_;
+        size_t length_ = 0;
+        bool overflow_ = false;
+        bool need_comma_ = false;                                                           /// a value precedes at this level
+};
+
+size_t JsonEscapeChar(char c, char* escape);
+size_t JsonFormatReal(char* str, size_t size, double value);
+std::string JsonGetString(const std::string& json, const char* object, const char* key, const char* default_value);
+
+#endif  // JSON_STREAM_H
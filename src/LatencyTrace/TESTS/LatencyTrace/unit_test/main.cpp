@@ -0,0 +1,142 @@
+#include <string>
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "json.h"
+#include "latency_trace.h"
+#include "global_params.h"
+
+using namespace utest::v1;
+
+// Test that trace arguments are evaluated only when the trace is compiled in
+static control_t latency_trace_macro_test_1(const size_t call_count)
+{
+    uint32_t cycle = 0;
+    LATENCY_TRACE(cycle++, LATENCY_STAGE_READ_BEGIN);
+
+    TEST_ASSERT_EQUAL_UINT32(LATENCY_TRACE_ENABLED ? 1 : 0, cycle);
+
+    return CaseNext;
+}
+
+#if LATENCY_TRACE_ENABLED
+static void TraceCycle(uint32_t cycle)
+{
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++)
+    {
+        LatencyTraceRecord(cycle, (latency_stage_t)stage);
+    }
+}
+
+// Test for one row per stage boundary in CSV dump
+static control_t latency_trace_csv_test_1(const size_t call_count)
+{
+    LatencyTraceInit();
+    LatencyTraceClear();
+    TraceCycle(7);
+
+    std::string actual_csv = LatencyTraceCreateCsv();
+
+    TEST_ASSERT_EQUAL_UINT32(LATENCY_STAGE_COUNT, LatencyTraceCount());
+    TEST_ASSERT_EQUAL_UINT32(0, actual_csv.find("cycle,stage,time_us\n7,read_begin,"));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, actual_csv.find("\n7,published,"));
+
+    return CaseNext;
+}
+
+// Test that the ring keeps the latest entries once full
+static control_t latency_trace_ring_test_1(const size_t call_count)
+{
+    LatencyTraceClear();
+    for (uint32_t i = 0; i < MBED_CONF_APP_LATENCY_TRACE_SIZE + 10; i++)
+    {
+        LatencyTraceRecord(i, LATENCY_STAGE_READ_BEGIN);
+    }
+
+    std::string actual_csv = LatencyTraceCreateCsv();
+
+    TEST_ASSERT_EQUAL_UINT32(MBED_CONF_APP_LATENCY_TRACE_SIZE, LatencyTraceCount());
+    TEST_ASSERT_EQUAL_UINT32(0, actual_csv.find("cycle,stage,time_us\n10,read_begin,"));
+
+    return CaseNext;
+}
+
+// Test for span durations and end-to-end cycle in summary
+static control_t latency_trace_summary_test_1(const size_t call_count)
+{
+    LatencyTraceClear();
+    LatencyTraceRecord(1, LATENCY_STAGE_READ_BEGIN);
+    ThisThread::sleep_for(20ms);
+    LatencyTraceRecord(1, LATENCY_STAGE_READ_END);
+    LatencyTraceRecord(2, LATENCY_STAGE_LLP_PUT);        // different cycle: no llp_put span
+
+    std::string actual_summary = LatencyTraceCreateSummary();
+
+    TEST_ASSERT_EQUAL_UINT32(0, actual_summary.find("sensor_read="));
+    TEST_ASSERT_TRUE(std::stoul(actual_summary.substr(12)) >= 20000);
+    TEST_ASSERT_EQUAL(std::string::npos, actual_summary.find("llp_put="));
+
+    LatencyTraceClear();
+    TraceCycle(3);
+    actual_summary = LatencyTraceCreateSummary();
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, actual_summary.find(",publish="));
+    TEST_ASSERT_NOT_EQUAL(std::string::npos, actual_summary.find(",sample_cycle="));
+
+    return CaseNext;
+}
+
+// Test that Chrome trace event dump is valid json with a complete event per span
+static control_t latency_trace_chrome_test_1(const size_t call_count)
+{
+    LatencyTraceClear();
+    TraceCycle(1);
+    TraceCycle(2);
+
+    Json::Reader reader;
+    Json::Value root;
+    bool parsed = reader.parse(LatencyTraceCreateChromeJson(), root, false);
+
+    TEST_ASSERT_TRUE(parsed);
+    TEST_ASSERT_TRUE(root["traceEvents"].isArray());
+
+    int num_spans = 0;
+    for (const Json::Value& event : root["traceEvents"])
+    {
+        if (event["ph"].asString() == "X")
+        {
+            num_spans++;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(2 * LATENCY_STAGE_COUNT, num_spans);       // LATENCY_STAGE_COUNT - 1 spans and the sample cycle
+
+    return CaseNext;
+}
+#endif  // LATENCY_TRACE_ENABLED
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test trace arguments evaluated only when compiled in", latency_trace_macro_test_1),
+#if LATENCY_TRACE_ENABLED
+    Case("Test CSV dump of stage boundaries", latency_trace_csv_test_1),
+    Case("Test ring keeps latest entries", latency_trace_ring_test_1),
+    Case("Test span durations in summary", latency_trace_summary_test_1),
+    Case("Test Chrome trace event dump", latency_trace_chrome_test_1)
+#endif  // LATENCY_TRACE_ENABLED
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,381 @@
+/**
+ * @defgroup latency_trace Latency Trace
+ * @{
+ */
+
+#include "latency_trace.h"
+
+#if LATENCY_TRACE_ENABLED
+
+#include <cstdio>
+#include <string>
+#include "mbed.h"
+#include "global_params.h"
+
+typedef struct {
+    uint64_t time_us;               /// trace_timer at the stage boundary
+    uint32_t cycle;                 /// sample cycle
+    uint8_t stage;                  /// latency_stage_t
+} latency_entry_t;
+
+typedef struct {
+    const char* stage;              /// stage id in the CSV dump
+    const char* span;               /// span from this stage to the next; NULL for the last stage
+    uint8_t tid;                    /// thread of the stage: 1 sensor, 2 behavior coordinator, 3 communications
+} stage_info_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t sum_us;
+    uint64_t max_us;
+} span_stats_t;
+
+/* Callbacks of the dump walkers */
+typedef void (*line_sink_t)(const char* line, void* ctx);
+typedef void (*span_sink_t)(const char* span, uint8_t tid, uint32_t cycle, uint64_t begin_us, uint64_t duration_us, void* ctx);
+
+static const stage_info_t stage_info[LATENCY_STAGE_COUNT] = {
+    {"read_begin",      "sensor_read",      1},
+    {"read_end",        "llp_put",          1},
+    {"llp_put",         "llp_hop",          1},         // mailbox wait and coordinator sleep
+    {"llp_get",         "coordinate",       2},         // filtering, aggregation and deadband
+    {"packet_begin",    "create_packet",    2},
+    {"packet_end",      "upstream_put",     2},
+    {"upstream_put",    "upstream_hop",     2},         // mailbox wait and communications thread sleep
+    {"upstream_get",    "publish",          3},
+    {"published",       NULL,               3}
+};
+
+#define LATENCY_TRACE_IN_FLIGHT     4       // overlapping sample cycles that spans are paired across
+
+static const char* const cycle_span = "sample_cycle";   // read_begin to published, on tid 0
+
+static latency_entry_t trace_ring[MBED_CONF_APP_LATENCY_TRACE_SIZE];
+static uint32_t trace_total = 0;                        // entries recorded since the last clear
+static Timer trace_timer;
+
+/**
+ *  @brief  Copies an entry out of the ring.
+ *  @author Lee Tze Han
+ *  @param  seq     Sequence number of the entry since the last clear
+ *  @param  entry   Destination
+ *  @return false if the entry has been overwritten, or not yet recorded
+ */
+static bool ReadEntry(uint32_t seq, latency_entry_t& entry)
+{
+    bool valid;
+
+    core_util_critical_section_enter();
+    valid = (seq < trace_total) && (trace_total - seq <= MBED_CONF_APP_LATENCY_TRACE_SIZE);
+    if (valid)
+    {
+        entry = trace_ring[seq % MBED_CONF_APP_LATENCY_TRACE_SIZE];
+    }
+    core_util_critical_section_exit();
+
+    return valid;
+}
+
+/**
+ *  @brief  Sequence numbers of the entries held in the ring.
+ *  @author Lee Tze Han
+ *  @param  begin   First entry
+ *  @param  end     One past the last entry
+ */
+static void EntryRange(uint32_t& begin, uint32_t& end)
+{
+    core_util_critical_section_enter();
+    end = trace_total;
+    core_util_critical_section_exit();
+
+    begin = (end > MBED_CONF_APP_LATENCY_TRACE_SIZE) ? end - MBED_CONF_APP_LATENCY_TRACE_SIZE : 0;
+}
+
+/**
+ *  @brief  Looks up the boundary of a cycle among the latest boundaries of a stage.
+ *  @author Lee Tze Han
+ *  @param  recent      Latest boundaries of the stage
+ *  @param  num_recent  Boundaries of the stage seen so far
+ *  @param  cycle       Sample cycle
+ *  @return Boundary of the cycle, or NULL
+ */
+static const latency_entry_t* FindRecent(const latency_entry_t* recent, uint32_t num_recent, uint32_t cycle)
+{
+    uint32_t count = (num_recent < LATENCY_TRACE_IN_FLIGHT) ? num_recent : LATENCY_TRACE_IN_FLIGHT;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (recent[i].cycle == cycle)
+        {
+            return &recent[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ *  @brief  Pairs each stage boundary with the preceding stage of the same cycle, oldest first. Up to
+ *          LATENCY_TRACE_IN_FLIGHT cycles may overlap, e.g. while readings queue up in llp_sensor_mail_box.
+ *          Entries are copied one at a time, so recording is never held up by a dump; entries overwritten
+ *          meanwhile are skipped.
+ *  @author Lee Tze Han
+ *  @param  sink    Called for every span, and for every cycle traced from read_begin to published
+ *  @param  ctx     Passed to sink
+ */
+static void WalkSpans(span_sink_t sink, void* ctx)
+{
+    /* Ring of the latest LATENCY_TRACE_IN_FLIGHT boundaries of each stage */
+    latency_entry_t recent[LATENCY_STAGE_COUNT][LATENCY_TRACE_IN_FLIGHT];
+    uint32_t num_recent[LATENCY_STAGE_COUNT] = {0};
+
+    uint32_t begin, end;
+    EntryRange(begin, end);
+    for (uint32_t seq = begin; seq < end; seq++)
+    {
+        latency_entry_t entry;
+        if (!ReadEntry(seq, entry))
+        {
+            continue;
+        }
+
+        size_t stage = entry.stage;
+        const latency_entry_t* previous = (stage > 0) ? FindRecent(recent[stage - 1], num_recent[stage - 1], entry.cycle) : NULL;
+        if (previous)
+        {
+            sink(stage_info[stage - 1].span, stage_info[stage - 1].tid, entry.cycle, previous->time_us, entry.time_us - previous->time_us, ctx);
+        }
+        const latency_entry_t* first = (stage == LATENCY_STAGE_PUBLISHED) ? FindRecent(recent[0], num_recent[0], entry.cycle) : NULL;
+        if (first)
+        {
+            sink(cycle_span, 0, entry.cycle, first->time_us, entry.time_us - first->time_us, ctx);
+        }
+
+        recent[stage][num_recent[stage] % LATENCY_TRACE_IN_FLIGHT] = entry;
+        num_recent[stage]++;
+    }
+}
+
+/**
+ *  @brief  Writes the ring as CSV, one stage boundary per row, oldest first.
+ *  @author Lee Tze Han
+ *  @param  sink    Called for every line, without line terminator
+ *  @param  ctx     Passed to sink
+ */
+static void WriteCsv(line_sink_t sink, void* ctx)
+{
+    char line[64];
+
+    sink("cycle,stage,time_us", ctx);
+
+    uint32_t begin, end;
+    EntryRange(begin, end);
+    for (uint32_t seq = begin; seq < end; seq++)
+    {
+        latency_entry_t entry;
+        if (ReadEntry(seq, entry))
+        {
+            snprintf(line, sizeof(line), "%lu,%s,%llu", (unsigned long)entry.cycle, stage_info[entry.stage].stage, (unsigned long long)entry.time_us);
+            sink(line, ctx);
+        }
+    }
+}
+
+typedef struct {
+    line_sink_t sink;
+    void* ctx;
+} chrome_ctx_t;
+
+static void ChromeSpan(const char* span, uint8_t tid, uint32_t cycle, uint64_t begin_us, uint64_t duration_us, void* ctx)
+{
+    chrome_ctx_t* chrome = (chrome_ctx_t*)ctx;
+    char line[160];
+
+    snprintf(line, sizeof(line), ",{\"name\":\"%s\",\"cat\":\"sample\",\"ph\":\"X\",\"ts\":%llu,\"dur\":%llu,\"pid\":1,\"tid\":%u,\"args\":{\"cycle\":%lu}}",
+             span, (unsigned long long)begin_us, (unsigned long long)duration_us, (unsigned)tid, (unsigned long)cycle);
+    chrome->sink(line, chrome->ctx);
+}
+
+/**
+ *  @brief  Writes the spans in the Chrome trace event format, for chrome://tracing or Perfetto.
+ *  @author Lee Tze Han
+ *  @param  sink    Called for every line, without line terminator
+ *  @param  ctx     Passed to sink
+ */
+static void WriteChromeJson(line_sink_t sink, void* ctx)
+{
+    static const char* const thread_names[] = {"SampleCycle", "SensorThread", "BehaviorCoordinatorThread", "CommunicationsControllerThread"};
+    char line[128];
+
+    sink("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", ctx);
+    for (size_t tid = 0; tid < sizeof(thread_names) / sizeof(thread_names[0]); tid++)
+    {
+        snprintf(line, sizeof(line), "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                 (tid == 0) ? "" : ",", (unsigned)tid, thread_names[tid]);
+        sink(line, ctx);
+    }
+
+    chrome_ctx_t chrome = {sink, ctx};
+    WalkSpans(ChromeSpan, &chrome);
+    sink("]}", ctx);
+}
+
+static void AppendLine(const char* line, void* ctx)
+{
+    std::string* out = (std::string*)ctx;
+    out->append(line);
+    out->push_back('\n');
+}
+
+static void PrintLine(const char* line, void* ctx)
+{
+    printf("%s\r\n", line);
+}
+
+static void AddSpan(const char* span, uint8_t tid, uint32_t cycle, uint64_t begin_us, uint64_t duration_us, void* ctx)
+{
+    span_stats_t* stats = (span_stats_t*)ctx;
+    size_t index = LATENCY_STAGE_COUNT - 1;         // the last stage has no span of its own; its slot holds the cycles
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT - 1; i++)
+    {
+        if (stage_info[i].span == span)
+        {
+            index = i;
+            break;
+        }
+    }
+
+    span_stats_t& s = stats[index];
+    s.count++;
+    s.sum_us += duration_us;
+    if (duration_us > s.max_us)
+    {
+        s.max_us = duration_us;
+    }
+}
+
+/**
+ *  @brief  Starts the trace clock.
+ *  @author Lee Tze Han
+ */
+void LatencyTraceInit(void)
+{
+    trace_timer.start();
+}
+
+/**
+ *  @brief  Stamps a stage boundary of a sample cycle. Use LATENCY_TRACE(), which is compiled out with the trace.
+ *  @author Lee Tze Han
+ *  @param  cycle   Sample cycle, numbered by the sensor thread
+ *  @param  stage   Stage boundary
+ */
+void LatencyTraceRecord(uint32_t cycle, latency_stage_t stage)
+{
+    uint64_t now_us = trace_timer.elapsed_time().count();
+
+    core_util_critical_section_enter();
+    latency_entry_t& entry = trace_ring[trace_total % MBED_CONF_APP_LATENCY_TRACE_SIZE];
+    entry.time_us = now_us;
+    entry.cycle = cycle;
+    entry.stage = (uint8_t)stage;
+    trace_total++;
+    core_util_critical_section_exit();
+}
+
+/**
+ *  @brief  Empties the trace ring.
+ *  @author Lee Tze Han
+ */
+void LatencyTraceClear(void)
+{
+    core_util_critical_section_enter();
+    trace_total = 0;
+    core_util_critical_section_exit();
+}
+
+/**
+ *  @brief  Number of stage boundaries held in the trace ring.
+ *  @author Lee Tze Han
+ *  @return Entry count, at most latency-trace-size
+ */
+size_t LatencyTraceCount(void)
+{
+    uint32_t begin, end;
+    EntryRange(begin, end);
+    return end - begin;
+}
+
+/**
+ *  @brief  Dumps the trace ring as CSV with columns cycle, stage and time_us.
+ *  @author Lee Tze Han
+ *  @return CSV text, oldest entry first
+ */
+std::string LatencyTraceCreateCsv(void)
+{
+    std::string csv;
+    WriteCsv(AppendLine, &csv);
+    return csv;
+}
+
+/**
+ *  @brief  Dumps the spans between stage boundaries in the Chrome trace event format.
+ *  @author Lee Tze Han
+ *  @return JSON text for chrome://tracing or Perfetto
+ */
+std::string LatencyTraceCreateChromeJson(void)
+{
+    std::string json;
+    WriteChromeJson(AppendLine, &json);
+    return json;
+}
+
+/**
+ *  @brief  Summarises the spans in the trace ring; short enough for a DECADA service response.
+ *  @author Lee Tze Han
+ *  @return "<span>=<avg>/<max>" in microseconds for every span seen, comma separated
+ */
+std::string LatencyTraceCreateSummary(void)
+{
+    span_stats_t stats[LATENCY_STAGE_COUNT] = {};
+    WalkSpans(AddSpan, stats);
+
+    std::string summary;
+    char field[48];
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; i++)
+    {
+        if (stats[i].count == 0)
+        {
+            continue;
+        }
+        const char* span = (i < LATENCY_STAGE_COUNT - 1) ? stage_info[i].span : cycle_span;
+        snprintf(field, sizeof(field), "%s%s=%llu/%llu", summary.empty() ? "" : ",", span,
+                 (unsigned long long)(stats[i].sum_us / stats[i].count), (unsigned long long)stats[i].max_us);
+        summary += field;
+    }
+
+    return summary;
+}
+
+/**
+ *  @brief  Prints the trace ring as CSV on the serial console.
+ *  @author Lee Tze Han
+ */
+void LatencyTracePrintCsv(void)
+{
+    stdio_mutex.lock();
+    WriteCsv(PrintLine, NULL);
+    stdio_mutex.unlock();
+}
+
+/**
+ *  @brief  Prints the trace ring as Chrome trace event JSON on the serial console.
+ *  @author Lee Tze Han
+ */
+void LatencyTracePrintChromeJson(void)
+{
+    stdio_mutex.lock();
+    WriteChromeJson(PrintLine, NULL);
+    stdio_mutex.unlock();
+}
+
+#endif  // LATENCY_TRACE_ENABLED
+
+/** @}*/
@@ -0,0 +1,66 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef LATENCY_TRACE_H
+#define LATENCY_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+#ifndef MBED_CONF_APP_LATENCY_TRACE_SIZE
+#define MBED_CONF_APP_LATENCY_TRACE_SIZE    0
+#endif  // MBED_CONF_APP_LATENCY_TRACE_SIZE
+
+#define LATENCY_TRACE_ENABLED   (MBED_CONF_APP_LATENCY_TRACE_SIZE > 0)
+
+/* Stage boundaries of a sample cycle, in pipeline order. Each stage opens the span up to the next one. */
+typedef enum {
+    LATENCY_STAGE_READ_BEGIN = 0,       // sensor thread: start of sensor reads
+    LATENCY_STAGE_READ_END,             // sensor thread: readings available
+    LATENCY_STAGE_LLP_PUT,              // sensor thread: end of stream put to llp_sensor_mail_box
+    LATENCY_STAGE_LLP_GET,              // behavior coordinator: end of stream taken from llp_sensor_mail_box
+    LATENCY_STAGE_PACKET_BEGIN,         // behavior coordinator: CreateDecadaPacket called
+    LATENCY_STAGE_PACKET_END,           // behavior coordinator: packet created
+    LATENCY_STAGE_UPSTREAM_PUT,         // behavior coordinator: packet put to comms_upstream_mail_box
+    LATENCY_STAGE_UPSTREAM_GET,         // communications thread: packet taken from comms_upstream_mail_box
+    LATENCY_STAGE_PUBLISHED,            // communications thread: DecadaManager::Publish returned
+    LATENCY_STAGE_COUNT
+} latency_stage_t;
+
+/*
+ *  Stamps a stage boundary of sample cycle <cycle> with the monotonic time in microseconds. Arguments are
+ *  not evaluated when latency-trace-size is 0, and the trace ring and its dumps are compiled out.
+ */
+#if LATENCY_TRACE_ENABLED
+#define LATENCY_TRACE(cycle, stage)     LatencyTraceRecord((cycle), (stage))
+#else
+#define LATENCY_TRACE(cycle, stage)     do {} while (0)
+#endif  // LATENCY_TRACE_ENABLED
+
+#if LATENCY_TRACE_ENABLED
+void LatencyTraceInit(void);
+void LatencyTraceRecord(uint32_t cycle, latency_stage_t stage);
+void LatencyTraceClear(void);
+size_t LatencyTraceCount(void);
+
+std::string LatencyTraceCreateCsv(void);
+std::string LatencyTraceCreateChromeJson(void);
+std::string LatencyTraceCreateSummary(void);
+void LatencyTracePrintCsv(void);
+void LatencyTracePrintChromeJson(void);
+#endif  // LATENCY_TRACE_ENABLED
+
+#endif  // LATENCY_TRACE_H
@@ -1,5 +1,6 @@
 #include "cmsis_os.h"
 #include "mbed.h"
+#include <cstring>
 #include "utest/utest.h"
 #include "unity/unity.h"
 #include "greentea-client/test_env.h"
@@ -11,35 +12,28 @@ using namespace utest::v1;
 // Test receive of control message - sensor thread endpoint
 static control_t distribute_control_message_test_1(const size_t call_count) 
 {
-    const std::string expected_param = "sensor_poll_rate";
+    const ControlParam expected_param = PARAM_SENSOR_POLL_RATE;
     const int expected_value = 1000;
     const std::string expected_msg_id = "foo123";
-    const std::string expected_endpoint_id = "123";
 
-    std::string actual_param;
-    int actual_value;
+    ControlParam actual_param = PARAM_COUNT;
+    int actual_value = 0;
     std::string actual_msg_id;
-    std::string actual_endpoint_id;
 
-    DistributeControlMessage(expected_param, expected_value, expected_msg_id, expected_endpoint_id);
+    DistributeControlMessage(expected_param, expected_value, expected_msg_id.c_str());
 
     sensor_control_mail_t *sensor_control_mail = sensor_control_mail_box.try_get_for(1s);
     if (sensor_control_mail)
     {
         actual_param = sensor_control_mail->param;
-        free(sensor_control_mail->param);
         actual_value = sensor_control_mail->value;
-        sensor_control_mail_box.free(sensor_control_mail);
         actual_msg_id = sensor_control_mail->msg_id;
-        free(sensor_control_mail->msg_id);
-        actual_endpoint_id = sensor_control_mail->endpoint_id;
-        free(sensor_control_mail->endpoint_id);
+        sensor_control_mail_box.free(sensor_control_mail);
     }
 
-    TEST_ASSERT_EQUAL_STRING(expected_param.c_str(), actual_param.c_str());
+    TEST_ASSERT_EQUAL_INT(expected_param, actual_param);
     TEST_ASSERT_EQUAL_INT(expected_value, actual_value);
     TEST_ASSERT_EQUAL_STRING(expected_msg_id.c_str(), actual_msg_id.c_str());
-    TEST_ASSERT_EQUAL_STRING(expected_endpoint_id.c_str(), actual_endpoint_id.c_str());
 
     return CaseNext;
 }
@@ -47,35 +41,67 @@ static control_t distribute_control_message_test_1(const size_t call_count)
 // Test receive of control message - invalid endpoint
 static control_t distribute_control_message_test_2(const size_t call_count) 
 {
-    const std::string expected_param = "foo_bar";
-    const int expected_value = 1000;
-    const std::string expected_msg_id = "foo123";
-    const std::string expected_endpoint_id = "123";
+    const std::string service_id = "sensorpollrate";
+    const std::string param = "foo_bar";
 
-    std::string actual_param;
-    int actual_value;
-    std::string actual_msg_id;
-    std::string actual_endpoint_id;
+    TEST_ASSERT_NULL(FindControlParam(service_id.c_str(), service_id.length(), param.c_str(), param.length()));
 
-    DistributeControlMessage(expected_param, expected_value, expected_msg_id, expected_endpoint_id);
+    DistributeControlMessage(PARAM_COUNT, 1000, "foo123");
 
     sensor_control_mail_t *sensor_control_mail = sensor_control_mail_box.try_get_for(1s);
-    if (sensor_control_mail)
+    behavior_control_mail_t *behavior_control_mail = behavior_control_mail_box.try_get_for(1ms);
+    TEST_ASSERT_NULL(sensor_control_mail);
+    TEST_ASSERT_NULL(behavior_control_mail);
+
+    return CaseNext;
+}
+
+// Test receive of control message - behavior coordinator thread endpoint
+static control_t distribute_control_message_test_3(const size_t call_count) 
+{
+    const ControlParam expected_param = PARAM_AGGREGATION_WINDOW;
+    const int expected_value = 300;
+    const std::string expected_msg_id = "foo456";
+
+    ControlParam actual_param = PARAM_COUNT;
+    int actual_value = 0;
+    std::string actual_msg_id;
+
+    DistributeControlMessage(expected_param, expected_value, expected_msg_id.c_str());
+
+    behavior_control_mail_t *behavior_control_mail = behavior_control_mail_box.try_get_for(1s);
+    if (behavior_control_mail)
     {
-        actual_param = sensor_control_mail->param;
-        free(sensor_control_mail->param);
-        actual_value = sensor_control_mail->value;
-        sensor_control_mail_box.free(sensor_control_mail);
-        actual_msg_id = sensor_control_mail->msg_id;
-        free(sensor_control_mail->msg_id);
-        actual_endpoint_id = sensor_control_mail->endpoint_id;
-        free(sensor_control_mail->endpoint_id);
+        actual_param = behavior_control_mail->param;
+        actual_value = behavior_control_mail->value;
+        actual_msg_id = behavior_control_mail->msg_id;
+        behavior_control_mail_box.free(behavior_control_mail);
+    }
+
+    TEST_ASSERT_EQUAL_INT(expected_param, actual_param);
+    TEST_ASSERT_EQUAL_INT(expected_value, actual_value);
+    TEST_ASSERT_EQUAL_STRING(expected_msg_id.c_str(), actual_msg_id.c_str());
+
+    return CaseNext;
+}
+
+// Test lookup of registered parameters by service identifier and name
+static control_t find_control_param_test_1(const size_t call_count) 
+{
+    for (size_t i = 0; i < PARAM_COUNT; i++)
+    {
+        const control_param_info_t& expected = GetControlParam(static_cast<ControlParam>(i));
+        const control_param_info_t* actual = FindControlParam(expected.service_id, strlen(expected.service_id), expected.name, strlen(expected.name));
+
+        TEST_ASSERT_TRUE(actual == &expected);
+        TEST_ASSERT_EQUAL_INT(i, actual->param);
     }
 
-    TEST_ASSERT_NOT_EQUAL(expected_param.c_str(), actual_param.c_str());
-    TEST_ASSERT_NOT_EQUAL(expected_value, actual_value);
-    TEST_ASSERT_NOT_EQUAL(expected_msg_id.c_str(), actual_msg_id.c_str());
-    TEST_ASSERT_NOT_EQUAL(expected_endpoint_id.c_str(), actual_endpoint_id.c_str());
+    /* Parameter registered under another service */
+    const std::string service_id = "aggregationwindow";
+    const std::string param = "sensor_poll_rate";
+    TEST_ASSERT_NULL(FindControlParam(service_id.c_str(), service_id.length(), param.c_str(), param.length()));
+    TEST_ASSERT_NULL(FindControlParam(service_id.c_str(), service_id.length(), param.c_str(), param.length() - 1));
 
     return CaseNext;
 }
@@ -92,7 +118,9 @@ utest::v1::status_t greentea_setup(const size_t number_of_cases)
 Case cases[] = 
 {
     Case("Test distribution of control message - sensor thread", distribute_control_message_test_1),
-    Case("Test receive of control message - invalid endpoint", distribute_control_message_test_2)
+    Case("Test receive of control message - invalid endpoint", distribute_control_message_test_2),
+    Case("Test distribution of control message - behavior coordinator thread", distribute_control_message_test_3),
+    Case("Test lookup of control parameter", find_control_param_test_1)
 };
 
 Specification specification(greentea_setup, cases);
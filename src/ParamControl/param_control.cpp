@@ -3,40 +3,267 @@
  * @{
  */
  
+#include <cstring>
 #include "mbed.h"
 #include "mbed-trace/mbed_trace.h"
 #include "param_control.h"
 #include "global_params.h"
-#include "conversions.h"
+#include "diagnostics.h"
+#include "latency_trace.h"
+#if LATENCY_TRACE_ENABLED
+#include "trace_macro.h"
+#include "trace_manager.h"
+#endif  // LATENCY_TRACE_ENABLED
 
 #define TRACE_GROUP  "ParamControl"
 
+#define CONTROL_TABLE_SIZE  16      // power of two, at least the number of parameters
+#define CONTROL_SLOT_EMPTY  0xFF
+#define CONTROL_SEED_LIMIT  4096
+
+#define X(code, service_id, name, target) {code, service_id, name, target},
+static constexpr control_param_info_t control_params[] =
+{
+    CONTROL_PARAMS
+};
+#undef X
+
+static_assert(sizeof(control_params) / sizeof(control_params[0]) == PARAM_COUNT, "control_params must follow ControlParam");
+static_assert((CONTROL_TABLE_SIZE & (CONTROL_TABLE_SIZE - 1)) == 0, "CONTROL_TABLE_SIZE must be a power of two");
+static_assert(PARAM_COUNT <= CONTROL_TABLE_SIZE, "Increase CONTROL_TABLE_SIZE");
+
+typedef struct {
+    uint8_t index[CONTROL_TABLE_SIZE];     // index into control_params, or CONTROL_SLOT_EMPTY
+} control_slots_t;
+
+/**
+ *  @brief  FNV-1a hash of "<service_id>/<name>", perturbed by seed.
+ *  @author Lee Tze Han
+ *  @param  service_id          Service identifier (not terminated)
+ *  @param  service_id_length   Length of service_id
+ *  @param  name                Parameter name (not terminated)
+ *  @param  name_length         Length of name
+ *  @param  seed                Seed found by FindControlSeed()
+ *  @return 32-bit hash
+ */
+static constexpr uint32_t ControlHash(const char* service_id, size_t service_id_length, const char* name, size_t name_length, uint32_t seed)
+{
+    uint32_t hash = 2166136261u ^ seed;
+    for (size_t i = 0; i < service_id_length; i++)
+    {
+        hash = (hash ^ static_cast<uint8_t>(service_id[i])) * 16777619u;
+    }
+    hash = (hash ^ static_cast<uint8_t>('/')) * 16777619u;
+    for (size_t i = 0; i < name_length; i++)
+    {
+        hash = (hash ^ static_cast<uint8_t>(name[i])) * 16777619u;
+    }
+
+    return hash;
+}
+
+static constexpr size_t ConstLength(const char* str)
+{
+    size_t length = 0;
+    while (str[length] != '\0')
+    {
+        length++;
+    }
+
+    return length;
+}
+
+static constexpr size_t ControlSlot(const control_param_info_t& info, uint32_t seed)
+{
+    return ControlHash(info.service_id, ConstLength(info.service_id), info.name, ConstLength(info.name), seed) & (CONTROL_TABLE_SIZE - 1);
+}
+
+/**
+ *  @brief  Find the first seed for which every parameter hashes to its own slot.
+ *  @author Lee Tze Han
+ *  @return Seed of the perfect hash, or CONTROL_SEED_LIMIT if none was found
+ */
+static constexpr uint32_t FindControlSeed(void)
+{
+    for (uint32_t seed = 0; seed < CONTROL_SEED_LIMIT; seed++)
+    {
+        bool used[CONTROL_TABLE_SIZE] = {};
+        bool perfect = true;
+        for (size_t i = 0; (i < PARAM_COUNT) && perfect; i++)
+        {
+            const size_t slot = ControlSlot(control_params[i], seed);
+            perfect = !used[slot];
+            used[slot] = true;
+        }
+        if (perfect)
+        {
+            return seed;
+        }
+    }
+
+    return CONTROL_SEED_LIMIT;
+}
+
+static constexpr uint32_t control_seed = FindControlSeed();
+static_assert(control_seed < CONTROL_SEED_LIMIT, "No perfect hash for CONTROL_PARAMS; increase CONTROL_TABLE_SIZE");
+
+static constexpr control_slots_t BuildControlSlots(void)
+{
+    control_slots_t slots = {};
+    for (size_t slot = 0; slot < CONTROL_TABLE_SIZE; slot++)
+    {
+        slots.index[slot] = CONTROL_SLOT_EMPTY;
+    }
+    for (size_t i = 0; i < PARAM_COUNT; i++)
+    {
+        slots.index[ControlSlot(control_params[i], control_seed)] = static_cast<uint8_t>(i);
+    }
+
+    return slots;
+}
+
+static constexpr control_slots_t control_slots = BuildControlSlots();
+
+/**
+ *  @brief  Look up a service parameter received from DECADAcloud.
+ *  @author Lee Tze Han
+ *  @param  service_id          Service identifier from the topic (not terminated)
+ *  @param  service_id_length   Length of service_id
+ *  @param  name                Parameter name from "params" (not terminated)
+ *  @param  name_length         Length of name
+ *  @return Registered parameter, or NULL if it is not in CONTROL_PARAMS
+ */
+const control_param_info_t* FindControlParam(const char* service_id, size_t service_id_length, const char* name, size_t name_length)
+{
+    const uint32_t hash = ControlHash(service_id, service_id_length, name, name_length, control_seed);
+    const uint8_t index = control_slots.index[hash & (CONTROL_TABLE_SIZE - 1)];
+    if (index == CONTROL_SLOT_EMPTY)
+    {
+        return NULL;
+    }
+
+    /* Any other string may share the slot */
+    const control_param_info_t& info = control_params[index];
+    if ((strlen(info.service_id) != service_id_length) || (strncmp(info.service_id, service_id, service_id_length) != 0) ||
+        (strlen(info.name) != name_length) || (strncmp(info.name, name, name_length) != 0))
+    {
+        return NULL;
+    }
+
+    return &info;
+}
+
+/**
+ *  @brief  Registered service identifier, name and target of a parameter.
+ *  @author Lee Tze Han
+ *  @param  param   Parameter code (below PARAM_COUNT)
+ *  @return Registered parameter
+ */
+const control_param_info_t& GetControlParam(ControlParam param)
+{
+    return control_params[param];
+}
+
+/**
+ *  @brief  Copy a message id into a fixed mail field.
+ *  @author Lee Tze Han
+ *  @param  dest    CONTROL_MSG_ID_SIZE field of the mail
+ *  @param  msg_id  Terminated message id
+ */
+static void CopyMsgId(char* dest, const char* msg_id)
+{
+    if (strlen(msg_id) >= CONTROL_MSG_ID_SIZE)
+    {
+        tr_warn("Message id %s truncated", msg_id);
+    }
+    strncpy(dest, msg_id, CONTROL_MSG_ID_SIZE - 1);
+    dest[CONTROL_MSG_ID_SIZE - 1] = '\0';
+}
+
+/**
+ *  @brief  Act on a parameter owned by the event manager thread.
+ *  @author Lee Tze Han
+ *  @param  param   parameter to be modified
+ *  @param  value   value of parameter to be modified
+ *  @param  msg_id  message id to reply to
+ */
+static void ExecuteEventControl(ControlParam param, int value, const char* msg_id)
+{
+    switch (param)
+    {
+#if LATENCY_TRACE_ENABLED
+        case PARAM_LATENCY_TRACE:
+            /* Answered here, as no thread owns the trace ring; a non-zero value also empties the ring */
+            DecadaServiceResponse(param, msg_id, LATENCY_TRACE_SUMMARY, LatencyTraceCreateSummary().c_str());
+            if (value != 0)
+            {
+                LatencyTraceClear();
+            }
+            break;
+#endif  // LATENCY_TRACE_ENABLED
+        default:
+            tr_warn("Unhandled parameter %s (%d, %s)", control_params[param].name, value, msg_id);
+            break;
+    }
+}
+
 /**
  *  @brief  Fan-out the control message from MQTT subscribe to respective thread
  *  @author Lau Lee Hong
  *  @param  param   parameter to be modified
  *  @param  value   value of parameter to be modified
+ *  @param  msg_id  message id to reply to
  */
-void DistributeControlMessage (std::string param, int value, std::string msg_id, std::string endpoint_id)
+void DistributeControlMessage(ControlParam param, int value, const char* msg_id)
 {
-    if (param.find("sensor") != std::string::npos)
+    if (param >= PARAM_COUNT)
+    {
+        tr_warn("Invalid parameter %u", static_cast<unsigned int>(param));
+        return;
+    }
+
+    switch (control_params[param].target)
     {
-        sensor_control_mail_t *sensor_control_mail = sensor_control_mail_box.try_calloc();
-        while (sensor_control_mail == NULL)
+        case CONTROL_TARGET_SENSOR:
         {
-            sensor_control_mail = sensor_control_mail_box.try_calloc();
-            tr_warn("Memory full. NULL pointer allocated");
-            ThisThread::sleep_for(500ms);
+            sensor_control_mail_t *sensor_control_mail = sensor_control_mail_box.try_calloc();
+            while (sensor_control_mail == NULL)
+            {
+                sensor_control_mail = sensor_control_mail_box.try_calloc();
+                tr_warn("Memory full. NULL pointer allocated");
+                ThisThread::sleep_for(500ms);
+            }
+
+            sensor_control_mail->param = param;
+            sensor_control_mail->value = value;
+            CopyMsgId(sensor_control_mail->msg_id, msg_id);
+            sensor_control_mail_box.put(sensor_control_mail);
+            DiagnosticsMailPut(DIAG_MAIL_SENSOR_CONTROL);
+            event_flags.set(FLAG_WAKE_SENSOR);
+            break;
+        }
+        case CONTROL_TARGET_BEHAVIOR:
+        {
+            behavior_control_mail_t *behavior_control_mail = behavior_control_mail_box.try_calloc();
+            while (behavior_control_mail == NULL)
+            {
+                behavior_control_mail = behavior_control_mail_box.try_calloc();
+                tr_warn("Memory full. NULL pointer allocated");
+                ThisThread::sleep_for(500ms);
+            }
+
+            behavior_control_mail->param = param;
+            behavior_control_mail->value = value;
+            CopyMsgId(behavior_control_mail->msg_id, msg_id);
+            behavior_control_mail_box.put(behavior_control_mail);
+            DiagnosticsMailPut(DIAG_MAIL_BEHAVIOR_CONTROL);
+            event_flags.set(FLAG_WAKE_BEHAVIOR);
+            break;
         }
-        
-        sensor_control_mail->param = StringToChar(param);
-        sensor_control_mail->value = value;
-        sensor_control_mail->msg_id = StringToChar(msg_id);
-        sensor_control_mail->endpoint_id = StringToChar(endpoint_id);
-        sensor_control_mail_box.put(sensor_control_mail);
-        
-        ThisThread::sleep_for(100ms);
+        case CONTROL_TARGET_EVENT:
+            ExecuteEventControl(param, value, msg_id);
+            break;
     }
 }
 
-/** @}*/
\ No newline at end of file
+/** @}*/
@@ -16,8 +16,57 @@
 #ifndef PARAM_CONTROL_H
 #define PARAM_CONTROL_H
 
-#include <string>
+#include <stddef.h>
+#include "latency_trace.h"
 
-void DistributeControlMessage (std::string param, int value, std::string msg_id, std::string endpoint_id);
+/* Size of the message id carried by control mail; service requests with longer ids are refused with an error reply */
+#define CONTROL_MSG_ID_SIZE 32
 
-#endif  // PARAM_CONTROL_H
\ No newline at end of file
+/* Thread that acts on a control parameter */
+enum ControlTarget
+{
+    CONTROL_TARGET_SENSOR,      // sensor_control_mail_box
+    CONTROL_TARGET_BEHAVIOR,    // behavior_control_mail_box
+    CONTROL_TARGET_EVENT        // answered by the event manager thread
+};
+
+#if LATENCY_TRACE_ENABLED
+#define CONTROL_PARAMS_LATENCY_TRACE \
+X(PARAM_LATENCY_TRACE, "latencytrace", "latency_trace", CONTROL_TARGET_EVENT)
+#else
+#define CONTROL_PARAMS_LATENCY_TRACE
+#endif  // LATENCY_TRACE_ENABLED
+
+/* Service parameters accepted from DECADAcloud: X(code, service identifier, parameter name, target thread)
+ * Every service identifier listed here is subscribed to by the communications thread */
+#define CONTROL_PARAMS \
+\
+\
+/* Sensor Thread*/ \
+X(PARAM_SENSOR_POLL_RATE, "sensorpollrate", "sensor_poll_rate", CONTROL_TARGET_SENSOR) \
+/* Behavior Coordinator Thread*/ \
+X(PARAM_AGGREGATION_WINDOW, "aggregationwindow", "aggregation_window", CONTROL_TARGET_BEHAVIOR) \
+/* Event Manager Thread*/ \
+CONTROL_PARAMS_LATENCY_TRACE
+/* --------------------------------------- */
+#define X(code, service_id, name, target) code,
+enum ControlParam : size_t
+{
+    CONTROL_PARAMS
+    PARAM_COUNT
+};
+#undef X
+/* --------------------------------------- */
+
+typedef struct {
+    ControlParam param;
+    const char* service_id;     // service identifier, as in the topic /sys/<product key>/<uuid>/thing/service/<service_id>
+    const char* name;           // key of the parameter in "params"
+    ControlTarget target;
+} control_param_info_t;
+
+const control_param_info_t* FindControlParam(const char* service_id, size_t service_id_length, const char* name, size_t name_length);
+const control_param_info_t& GetControlParam(ControlParam param);
+void DistributeControlMessage(ControlParam param, int value, const char* msg_id);
+
+#endif  // PARAM_CONTROL_H
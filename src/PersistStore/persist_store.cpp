@@ -32,6 +32,15 @@ namespace PersistKey
     /* Poll Rate */
     KeyName CYCLE_INTERVAL =                {"scheduler_cycle_interval"};    
 
+    /* Aggregation */
+    KeyName AGGREGATION_WINDOW =            {"aggregation_window"};
+
+    /* Last good addresses of the cloud endpoints */
+    KeyName DNS_CACHE =                     {"dns_cache"};
+
+    /* DECADA device secret, issued when the device is created */
+    KeyName DEVICE_SECRET =                 {"device_secret"};
+
     /* SSL Certificate Storage */
     KeyName CLIENT_CERTIFICATE =            {"client_certificate"};
     KeyName CLIENT_CERTIFICATE_SN =         {"client_certificate_sn"};
@@ -151,6 +160,19 @@ void WriteCycleInterval(const std::string interval)
     );
 }
 
+/**
+ *  @brief  Writes aggregation window length to flash memory.
+ *  @author Lee Tze Han
+ *  @param  window  aggregation window in milliseconds (0 disables aggregation)
+ */
+void WriteAggregationWindow(const std::string window)
+{
+    WriteKey(
+        PersistKey::AGGREGATION_WINDOW,
+        window
+    );
+}
+
 /**
  *  @brief  Writes client certificate to flash memory.
  *  @author Goh Kok Boon
@@ -177,6 +199,32 @@ void WriteClientCertificateSerialNumber(const std::string cert_sn)
     );
 }
 
+/**
+ *  @brief  Writes the last good addresses of the cloud endpoints to flash memory.
+ *  @author Lee Tze Han
+ *  @param  entries "<host> <address>" lines of the DNS cache
+ */
+void WriteDnsCache(const std::string entries)
+{
+    WriteKey(
+        PersistKey::DNS_CACHE,
+        entries
+    );
+}
+
+/**
+ *  @brief  Writes the DECADA device secret to flash memory.
+ *  @author Lee Tze Han
+ *  @param  secret  device secret; empty to have it fetched from DECADA again
+ */
+void WriteDeviceSecret(const std::string secret)
+{
+    WriteKey(
+        PersistKey::DEVICE_SECRET,
+        secret
+    );
+}
+
 #if defined(MBED_CONF_APP_USE_SECURE_ELEMENT) && (MBED_CONF_APP_USE_SECURE_ELEMENT == 0)
 /**
  *  @brief  Writes client private key (PEM) to flash memory.
@@ -280,6 +328,17 @@ std::string ReadCycleInterval(void)
     return cycle_interval;
 }
 
+/**
+ *  @brief  Reads the aggregation window length from flash memory.
+ *  @author Lee Tze Han
+ *  @return aggregation window in milliseconds
+ */
+std::string ReadAggregationWindow(void)
+{
+    string aggregation_window = ReadKey(PersistKey::AGGREGATION_WINDOW);
+    return aggregation_window;
+}
+
 /**
  *  @brief  Reads the client certificate from flash memory.
  *  @author Goh Kok Boon
@@ -302,6 +361,28 @@ std::string ReadClientCertificateSerialNumber(void)
     return client_cert_serial_number;
 }
 
+/**
+ *  @brief  Reads the last good addresses of the cloud endpoints from flash memory.
+ *  @author Lee Tze Han
+ *  @return "<host> <address>" lines of the DNS cache
+ */
+std::string ReadDnsCache(void)
+{
+    std::string dns_cache = ReadKey(PersistKey::DNS_CACHE);
+    return dns_cache;
+}
+
+/**
+ *  @brief  Reads the DECADA device secret from flash memory.
+ *  @author Lee Tze Han
+ *  @return device secret; empty if it has not been fetched
+ */
+std::string ReadDeviceSecret(void)
+{
+    std::string device_secret = ReadKey(PersistKey::DEVICE_SECRET);
+    return device_secret;
+}
+
 #if defined(MBED_CONF_APP_USE_SECURE_ELEMENT) && (MBED_CONF_APP_USE_SECURE_ELEMENT == 0)
 /**
  *  @brief  Reads the client private key (PEM) from flash memory.
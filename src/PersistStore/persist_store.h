@@ -27,8 +27,11 @@ void WriteInitFlag(const std::string flag);
 void WriteWifiSsid(const std::string ssid);
 void WriteWifiPass(const std::string pass);
 void WriteCycleInterval(const std::string interval);
+void WriteAggregationWindow(const std::string window);
 void WriteClientCertificate(const std::string cert);
 void WriteClientCertificateSerialNumber(const std::string cert_sn);
+void WriteDnsCache(const std::string entries);
+void WriteDeviceSecret(const std::string secret);
 #if defined(MBED_CONF_APP_USE_SECURE_ELEMENT) && (MBED_CONF_APP_USE_SECURE_ELEMENT == 0)
 void WriteClientPrivateKey(const std::string private_key);
 #endif  // MBED_CONF_APP_USE_SECURE_ELEMENT
@@ -40,8 +43,11 @@ std::string ReadInitFlag(void);
 std::string ReadWifiSsid(void);
 std::string ReadWifiPass(void);
 std::string ReadCycleInterval(void);
+std::string ReadAggregationWindow(void);
 std::string ReadClientCertificate(void);
 std::string ReadClientCertificateSerialNumber(void);
+std::string ReadDnsCache(void);
+std::string ReadDeviceSecret(void);
 #if defined(MBED_CONF_APP_USE_SECURE_ELEMENT) && (MBED_CONF_APP_USE_SECURE_ELEMENT == 0)
 std::string ReadClientPrivateKey(void);
 #endif  // MBED_CONF_APP_USE_SECURE_ELEMENT
@@ -0,0 +1,83 @@
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "global_params.h"
+#include "power_manager.h"
+
+using namespace utest::v1;
+
+// Test that the default idle policy sleeps for the fixed tick while no wake flag is set, whatever the deadline
+static control_t power_idle_test_1(const size_t call_count)
+{
+    Timer timer;
+    timer.start();
+    PowerIdle(0x1, 100ms, Kernel::get_ms_count(), true);
+    TEST_ASSERT_TRUE(timer.elapsed_time() >= 100ms);
+
+    return CaseNext;
+}
+
+// Test that a wake flag set with mail cuts the idle short, and is cleared
+static control_t power_idle_test_2(const size_t call_count)
+{
+    Timer timer;
+    timer.start();
+    event_flags.set(0x1);
+    PowerIdle(0x1, 1000ms);
+    TEST_ASSERT_TRUE(timer.elapsed_time() < 100ms);
+    TEST_ASSERT_EQUAL_UINT32(0, event_flags.get() & 0x1);
+
+    return CaseNext;
+}
+
+// Test that the statistics count wake-ups over the report window, and start a new window
+static control_t power_stats_test_1(const size_t call_count)
+{
+    power_stats_t stats;
+    PowerInit();
+
+    for (size_t i = 0; i < 5; i++)
+    {
+        PowerIdle(0, 20ms);
+    }
+    PowerGetStats(stats, POWER_SINCE_REPORT);
+
+    /* 5 wake-ups in at least 100 ms */
+    TEST_ASSERT_TRUE(stats.wakeups_per_hour > 0.0f);
+    TEST_ASSERT_TRUE(stats.wakeups_per_hour <= 5 * 36000.0f);
+    TEST_ASSERT_TRUE(stats.duty_cycle >= 0.0f);
+    TEST_ASSERT_TRUE(stats.duty_cycle <= 100.0f);
+
+    ThisThread::sleep_for(20ms);
+    PowerGetStats(stats, POWER_SINCE_REPORT);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.wakeups_per_hour);
+
+    PowerGetStats(stats, POWER_SINCE_BOOT);
+    TEST_ASSERT_TRUE(stats.wakeups_per_hour > 0.0f);
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test fixed tick idle", power_idle_test_1),
+    Case("Test idle cut short by a wake flag", power_idle_test_2),
+    Case("Test duty cycle and wake-up statistics", power_stats_test_1)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,135 @@
+/**
+ * @defgroup power_manager Power Manager
+ * @{
+ */
+
+#include "power_manager.h"
+#include "mbed_trace.h"
+#include "global_params.h"
+
+#define TRACE_GROUP "PowerManager"
+
+#if MBED_CONF_APP_LOW_POWER && !defined(MBED_TICKLESS)
+#warning "low-power without MBED_TICKLESS: the kernel tick still wakes the core every millisecond"
+#endif  // MBED_CONF_APP_LOW_POWER
+
+typedef struct {
+    uint64_t uptime_us;
+    uint64_t sleep_us;              /// sleep and deep sleep
+    uint64_t deep_sleep_us;
+    uint32_t wakeups;
+} power_snapshot_t;
+
+static Mutex power_mutex;
+static uint32_t wakeups = 0;
+static power_snapshot_t report_snapshot;
+
+/**
+ *  @brief  Reads the CPU statistics and the wake-up count.
+ *  @author Lee Tze Han
+ *  @param  snapshot    Snapshot to fill
+ */
+static void TakeSnapshot(power_snapshot_t& snapshot)
+{
+    mbed_stats_cpu_t cpu_stats;
+    mbed_stats_cpu_get(&cpu_stats);
+
+    snapshot.uptime_us = cpu_stats.uptime;
+    snapshot.sleep_us = cpu_stats.sleep_time + cpu_stats.deep_sleep_time;
+    snapshot.deep_sleep_us = cpu_stats.deep_sleep_time;
+    power_mutex.lock();
+    snapshot.wakeups = wakeups;
+    power_mutex.unlock();
+}
+
+/**
+ *  @brief  Starts the first power statistics window.
+ *  @author Lee Tze Han
+ */
+void PowerInit(void)
+{
+    TakeSnapshot(report_snapshot);
+
+#if MBED_CONF_APP_LOW_POWER
+    tr_info("Low-power idle, sleeping up to %d s", MBED_CONF_APP_LOW_POWER_MAX_SLEEP);
+#endif  // MBED_CONF_APP_LOW_POWER
+}
+
+/**
+ *  @brief  Sleeps the calling thread between iterations of its loop.
+ *  @author Lee Tze Han
+ *  @param  wake_flags  Flags of event_flags that wake the thread; cleared on waking
+ *  @param  tick        Fixed sleep of the default mode
+ *  @param  deadline_ms Kernel time in ms of the next work of the thread in low-power mode
+ *  @param  pending     Low-power mode: the thread has more mail to process, and does not sleep
+ */
+void PowerIdle(uint32_t wake_flags, Kernel::Clock::duration_u32 tick, uint64_t deadline_ms, bool pending)
+{
+#if MBED_CONF_APP_LOW_POWER
+    if (pending)
+    {
+        return;
+    }
+
+    const uint64_t now_ms = Kernel::get_ms_count();
+    uint64_t until_ms = now_ms + MBED_CONF_APP_LOW_POWER_MAX_SLEEP * 1000ULL;
+    if (deadline_ms < until_ms)
+    {
+        until_ms = deadline_ms;
+    }
+    const Kernel::Clock::duration_u32 sleep_ms((until_ms > now_ms) ? (uint32_t)(until_ms - now_ms) : 0);
+
+    if (wake_flags != 0)
+    {
+        event_flags.wait_any_for(wake_flags, sleep_ms);
+    }
+    else
+    {
+        ThisThread::sleep_for(sleep_ms);
+    }
+#else
+    /* Mail cuts the tick short, so a thread down a chain of mailboxes does not add its whole tick */
+    if (wake_flags != 0)
+    {
+        event_flags.wait_any_for(wake_flags, tick);
+    }
+    else
+    {
+        ThisThread::sleep_for(tick);
+    }
+#endif  // MBED_CONF_APP_LOW_POWER
+
+    power_mutex.lock();
+    wakeups++;
+    power_mutex.unlock();
+}
+
+/**
+ *  @brief  Computes duty cycle and wake-up rate over a window.
+ *  @author Lee Tze Han
+ *  @param  stats   Statistics to fill
+ *  @param  window  POWER_SINCE_BOOT, or POWER_SINCE_REPORT to also start a new report window
+ */
+void PowerGetStats(power_stats_t& stats, power_window_t window)
+{
+    power_snapshot_t now;
+    TakeSnapshot(now);
+
+    power_snapshot_t start = {0, 0, 0, 0};
+    if (window == POWER_SINCE_REPORT)
+    {
+        power_mutex.lock();
+        start = report_snapshot;
+        report_snapshot = now;
+        power_mutex.unlock();
+    }
+
+    const uint64_t elapsed_us = now.uptime_us - start.uptime_us;
+    const uint64_t sleep_us = now.sleep_us - start.sleep_us;
+    stats.elapsed_s = (uint32_t)(elapsed_us / 1000000);
+    stats.duty_cycle = (elapsed_us > 0) ? 100.0f * (float)(elapsed_us - ((sleep_us < elapsed_us) ? sleep_us : elapsed_us)) / elapsed_us : 0.0f;
+    stats.deep_sleep_share = (elapsed_us > 0) ? 100.0f * (float)(now.deep_sleep_us - start.deep_sleep_us) / elapsed_us : 0.0f;
+    stats.wakeups_per_hour = (elapsed_us > 0) ? (float)(now.wakeups - start.wakeups) * 3600e6f / elapsed_us : 0.0f;
+}
+
+/** @}*/
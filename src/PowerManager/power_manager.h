@@ -0,0 +1,55 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <stdint.h>
+#include "mbed.h"
+#include "rtos.h"
+
+#define POWER_NO_DEADLINE   UINT64_MAX      // PowerIdle() deadline of a thread woken by its flags only
+
+/* Window of PowerGetStats() */
+typedef enum {
+    POWER_SINCE_BOOT = 0,
+    POWER_SINCE_REPORT              // since the previous POWER_SINCE_REPORT call, which starts a new window
+} power_window_t;
+
+typedef struct {
+    uint32_t elapsed_s;             /// length of the window
+    float duty_cycle;               /// percent of the window the core was awake
+    float deep_sleep_share;         /// percent of the window spent in deep sleep
+    float wakeups_per_hour;         /// returns from PowerIdle() of all threads
+} power_stats_t;
+
+/*
+ *  Idle policy of the application threads, between the iterations of their loops.
+ *
+ *  - Default: each thread sleeps for its fixed tick, cut short when one of its wake flags is set with the
+ *    mail it consumes.
+ *  - low-power: each thread blocks until one of its wake flags is set with the mail it consumes, or until
+ *    its next deadline, but never longer than low-power-max-sleep. A thread with mail left is not put to
+ *    sleep. Built with MBED_TICKLESS (not set by mbed_app.json, as it also changes the timing of default
+ *    builds), the core sleeps through the gaps; the watchdog supervisor allows for low-power-max-sleep in
+ *    the deadline of each thread.
+ *  - power-stats: duty cycle and wake-ups per hour are added to the diagnostics packet and printout.
+ *    Duty cycle comes from the mbed-os CPU statistics (platform.cpu-stats-enabled).
+ */
+void PowerInit(void);
+void PowerIdle(uint32_t wake_flags, Kernel::Clock::duration_u32 tick, uint64_t deadline_ms = POWER_NO_DEADLINE, bool pending = false);
+void PowerGetStats(power_stats_t& stats, power_window_t window);
+
+#endif  // POWER_MANAGER_H
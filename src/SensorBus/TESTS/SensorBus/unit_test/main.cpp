@@ -0,0 +1,166 @@
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "sensor_bus.h"
+
+using namespace utest::v1;
+
+// Sensor taking a fixed time to read, giving a single reading
+class FakeSensor : public SensorType
+{
+    public:
+        FakeSensor(const char* measure_point_id, float value, uint32_t read_ms) : measure_point_id_(measure_point_id), value_(value), read_ms_(read_ms) {}
+
+        std::string GetName() { return "fake"; }
+        using SensorType::GetData;
+        int GetData(sensor_reading_t* readings, size_t capacity, size_t& count)
+        {
+            ThisThread::sleep_for(read_ms_);
+            count = 0;
+            if (capacity > 0)
+            {
+                readings[count++] = {measure_point_id_, value_, READING_OK};
+            }
+            return DATA_OK;
+        }
+        void Enable() {}
+        void Disable() {}
+        void Reset() {}
+
+    private:
+        const char* measure_point_id_;
+        float value_;
+        uint32_t read_ms_;
+};
+
+// Test that sensors on separate buses are read concurrently
+static control_t acquire_test_1(const size_t call_count)
+{
+    FakeSensor sensor_a("a", 1.0f, 100);
+    FakeSensor sensor_b("b", 2.0f, 100);
+    FakeSensor sensor_c("c", 3.0f, 100);
+
+    SensorBusGroup buses;
+    TEST_ASSERT_TRUE(buses.Attach(&sensor_a, PB_9));
+    TEST_ASSERT_TRUE(buses.Attach(&sensor_b, PF_15));
+    TEST_ASSERT_TRUE(buses.Attach(&sensor_c, PC_9));
+    buses.Start();
+    TEST_ASSERT_EQUAL_UINT32(3, buses.GetBusCount());
+
+    sensor_cycle_t record;
+    size_t count = buses.Acquire(1, 1000ms, record);
+
+    TEST_ASSERT_EQUAL_UINT32(3, count);
+    TEST_ASSERT_EQUAL_UINT32(0, record.missed);
+    TEST_ASSERT_EQUAL_STRING("a", record.readings[0].measure_point_id);
+    TEST_ASSERT_EQUAL_STRING("b", record.readings[1].measure_point_id);
+    TEST_ASSERT_EQUAL_STRING("c", record.readings[2].measure_point_id);
+    TEST_ASSERT_TRUE(record.elapsed_us >= 100000);
+    TEST_ASSERT_TRUE(record.elapsed_us < 200000);       // 300 ms when read one after another
+
+    return CaseNext;
+}
+
+// Test that sensors on the same bus share its worker and are read one after another
+static control_t acquire_test_2(const size_t call_count)
+{
+    FakeSensor sensor_a("a", 1.0f, 50);
+    FakeSensor sensor_b("b", 2.0f, 50);
+
+    SensorBusGroup buses;
+    TEST_ASSERT_TRUE(buses.Attach(&sensor_a, PB_9));
+    TEST_ASSERT_TRUE(buses.Attach(&sensor_b, PB_9));
+    buses.Start();
+    TEST_ASSERT_EQUAL_UINT32(1, buses.GetBusCount());
+
+    sensor_cycle_t record;
+    size_t count = buses.Acquire(1, 1000ms, record);
+
+    TEST_ASSERT_EQUAL_UINT32(2, count);
+    TEST_ASSERT_EQUAL_STRING("a", record.readings[0].measure_point_id);
+    TEST_ASSERT_EQUAL_STRING("b", record.readings[1].measure_point_id);
+    TEST_ASSERT_TRUE(record.elapsed_us >= 100000);
+
+    return CaseNext;
+}
+
+// Test that a bus missing the deadline is left out until it has finished, and its late readings are dropped
+static control_t acquire_test_3(const size_t call_count)
+{
+    FakeSensor fast_sensor("fast", 1.0f, 10);
+    FakeSensor slow_sensor("slow", 2.0f, 300);
+
+    SensorBusGroup buses;
+    TEST_ASSERT_TRUE(buses.Attach(&fast_sensor, PB_9));
+    TEST_ASSERT_TRUE(buses.Attach(&slow_sensor, PF_15));
+    buses.Start();
+
+    sensor_cycle_t record;
+    size_t count = buses.Acquire(1, 100ms, record);
+    TEST_ASSERT_EQUAL_UINT32(1, count);
+    TEST_ASSERT_EQUAL_STRING("fast", record.readings[0].measure_point_id);
+    TEST_ASSERT_EQUAL_UINT32(0x2, record.missed);
+    TEST_ASSERT_TRUE(record.elapsed_us < 200000);
+
+    /* Slow bus is still reading cycle 1 */
+    count = buses.Acquire(2, 50ms, record);
+    TEST_ASSERT_EQUAL_UINT32(1, count);
+    TEST_ASSERT_EQUAL_UINT32(0x2, record.missed);
+
+    /* Readings of cycle 1 are not reported for cycle 3 */
+    ThisThread::sleep_for(300ms);
+    count = buses.Acquire(3, 1000ms, record);
+    TEST_ASSERT_EQUAL_UINT32(2, count);
+    TEST_ASSERT_EQUAL_UINT32(0, record.missed);
+    TEST_ASSERT_EQUAL_UINT32(3, record.cycle);
+
+    return CaseNext;
+}
+
+// Test the limit on sensors per bus and on buses
+static control_t attach_test_1(const size_t call_count)
+{
+    FakeSensor sensor("a", 1.0f, 0);
+    const PinName sda_pins[SENSOR_BUS_MAX_BUSES + 1] = {PB_9, PF_15, PC_9, PF_0, PB_7};
+
+    SensorBusGroup buses;
+    for (size_t i = 0; i < SENSOR_BUS_MAX_SENSORS; i++)
+    {
+        TEST_ASSERT_TRUE(buses.Attach(&sensor, PB_9));
+    }
+    TEST_ASSERT_FALSE(buses.Attach(&sensor, PB_9));
+
+    for (size_t i = 1; i < SENSOR_BUS_MAX_BUSES; i++)
+    {
+        TEST_ASSERT_TRUE(buses.Attach(&sensor, sda_pins[i]));
+    }
+    TEST_ASSERT_FALSE(buses.Attach(&sensor, sda_pins[SENSOR_BUS_MAX_BUSES]));
+    TEST_ASSERT_EQUAL_UINT32(SENSOR_BUS_MAX_BUSES, buses.GetBusCount());
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test parallel acquisition across buses", acquire_test_1),
+    Case("Test sequential acquisition on one bus", acquire_test_2),
+    Case("Test acquisition deadline", acquire_test_3),
+    Case("Test bus and sensor limits", attach_test_1)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,453 @@
+/**
+ * @defgroup sensor_bus Sensor Bus
+ * @{
+ */
+
+#include <algorithm>
+#include "sensor_bus.h"
+#include "mbed_trace.h"
+#include "diagnostics.h"
+
+#define TRACE_GROUP  "SensorBus"
+
+SensorBus::SensorBus() : thread_(osPriorityNormal, SENSOR_BUS_STACK_SIZE, NULL, "SensorBusThread")
+{
+}
+
+/**
+ *  @brief  Stops the worker after any read in progress.
+ *  @author Lee Tze Han
+ */
+SensorBus::~SensorBus()
+{
+    if (thread_.get_state() == Thread::Inactive)
+    {
+        return;
+    }
+
+    mutex_.lock();
+    stopping_ = true;
+    mutex_.unlock();
+    trigger_.release();
+    thread_.join();
+}
+
+/**
+ *  @brief  Adds a sensor to the bus on sda; the first sensor sets the bus.
+ *  @author Lee Tze Han
+ *  @param  sensor  Enabled sensor, read by the worker from then on
+ *  @param  sda     SDA pin the sensor is wired to
+ *  @return Whether the sensor was added (same bus and a free slot)
+ */
+bool SensorBus::Attach(SensorType* sensor, PinName sda)
+{
+    if ((sensor_count_ >= SENSOR_BUS_MAX_SENSORS) || ((sensor_count_ > 0) && (sda != sda_)))
+    {
+        return false;
+    }
+
+    sda_ = sda;
+    sensors_[sensor_count_++] = sensor;
+
+    return true;
+}
+
+/**
+ *  @brief  Starts the worker thread.
+ *  @author Lee Tze Han
+ *  @param  id  Thread id in the diagnostics packet
+ *  @return Status of Thread::start
+ */
+osStatus SensorBus::Start(const char* id)
+{
+    DiagnosticsRegisterThread(&thread_, id);
+
+    return thread_.start(callback(this, &SensorBus::Worker));
+}
+
+/**
+ *  @brief  Sets the sampling policy of every sensor of the bus.
+ *  @author Lee Tze Han
+ *  @param  policy              Sampling policy
+ *  @param  base_interval_ms    Interval of the fixed policy
+ */
+void SensorBus::SetPolicy(const sampling_policy_t& policy, uint32_t base_interval_ms)
+{
+    mutex_.lock();
+    for (size_t i = 0; i < SENSOR_BUS_MAX_SENSORS; i++)
+    {
+        samplers_[i].SetPolicy(policy, base_interval_ms);
+    }
+    mutex_.unlock();
+}
+
+/**
+ *  @brief  Sets the interval of the fixed policy of every sensor of the bus.
+ *  @author Lee Tze Han
+ *  @param  base_interval_ms    Interval of the fixed policy
+ */
+void SensorBus::SetBaseInterval(uint32_t base_interval_ms)
+{
+    mutex_.lock();
+    for (size_t i = 0; i < SENSOR_BUS_MAX_SENSORS; i++)
+    {
+        samplers_[i].SetBaseInterval(base_interval_ms);
+    }
+    mutex_.unlock();
+}
+
+/**
+ *  @brief  Finds the sensors due to be read.
+ *  @author Lee Tze Han
+ *  @param  now_ms  Kernel time in ms
+ *  @return Bitmask of the due sensors, in attach order
+ */
+uint32_t SensorBus::DueSensors(uint64_t now_ms)
+{
+    uint32_t due = 0;
+
+    mutex_.lock();
+    for (size_t i = 0; i < sensor_count_; i++)
+    {
+        if (samplers_[i].Due(now_ms))
+        {
+            due |= 1UL << i;
+        }
+    }
+    mutex_.unlock();
+
+    return due;
+}
+
+/**
+ *  @brief  Time the first sensor of the bus is next due.
+ *  @author Lee Tze Han
+ *  @return Kernel time in ms; UINT64_MAX without sensors
+ */
+uint64_t SensorBus::NextDue(void)
+{
+    uint64_t next_due_ms = UINT64_MAX;
+
+    mutex_.lock();
+    for (size_t i = 0; i < sensor_count_; i++)
+    {
+        next_due_ms = std::min(next_due_ms, samplers_[i].NextDue());
+    }
+    mutex_.unlock();
+
+    return next_due_ms;
+}
+
+/**
+ *  @brief  Starts reading sensors of the bus for a cycle.
+ *  @author Lee Tze Han
+ *  @param  cycle   Sample cycle the readings belong to
+ *  @param  sensors Bitmask of the sensors to read, from DueSensors
+ *  @param  now_ms  Kernel time in ms the sensors are read at
+ *  @param  done    Event flags to set when the readings are complete
+ *  @param  flag    Flag of this bus in done; cleared here
+ *  @return Whether the read was started; false while the read of an earlier cycle is still in progress
+ */
+bool SensorBus::Trigger(uint32_t cycle, uint32_t sensors, uint64_t now_ms, EventFlags* done, uint32_t flag)
+{
+    mutex_.lock();
+    if (busy_)
+    {
+        mutex_.unlock();
+        return false;
+    }
+    busy_ = true;
+    cycle_ = cycle;
+    due_ = sensors;
+    due_ms_ = now_ms;
+    done_ = done;
+    flag_ = flag;
+    reading_count_ = 0;
+    mutex_.unlock();
+
+    done->clear(flag);
+    trigger_.release();
+
+    return true;
+}
+
+/**
+ *  @brief  Appends the readings of a completed cycle to the cycle record.
+ *  @author Lee Tze Han
+ *  @param  cycle   Sample cycle of the record
+ *  @param  record  Cycle record; readings beyond its capacity are dropped
+ *  @return Whether readings of this cycle were available
+ */
+bool SensorBus::Collect(uint32_t cycle, sensor_cycle_t& record)
+{
+    mutex_.lock();
+    bool complete = !busy_ && (cycle_ == cycle);
+    if (complete)
+    {
+        for (size_t i = 0; (i < reading_count_) && (record.count < SENSOR_CYCLE_MAX_READINGS); i++)
+        {
+            record.readings[record.count++] = readings_[i];
+        }
+    }
+    mutex_.unlock();
+
+    return complete;
+}
+
+PinName SensorBus::GetSda(void) const
+{
+    return sda_;
+}
+
+size_t SensorBus::GetSensorCount(void) const
+{
+    return sensor_count_;
+}
+
+/**
+ *  @brief  Worker loop: reads the due sensors in attach order on each trigger, reschedules them, then sets the done flag.
+ *  @author Lee Tze Han
+ */
+void SensorBus::Worker(void)
+{
+    while (1)
+    {
+        trigger_.acquire();
+
+        mutex_.lock();
+        bool stopping = stopping_;
+        const uint32_t due = due_;
+        const uint64_t due_ms = due_ms_;
+        mutex_.unlock();
+        if (stopping)
+        {
+            return;
+        }
+
+        DiagnosticsBusyBegin();
+
+        /* readings_ is owned by the worker until busy_ is cleared */
+        size_t count = 0;
+        for (size_t i = 0; i < sensor_count_; i++)
+        {
+            if (!(due & (1UL << i)))
+            {
+                continue;
+            }
+
+            size_t sensor_count = 0;
+            int stat = sensors_[i]->GetData(readings_ + count, SENSOR_MAX_READINGS - count, sensor_count);
+            if (stat == SensorType::DATA_NOT_RDY || stat == SensorType::DATA_CRC_ERR)
+            {
+                tr_warn("Sensor data error");
+            }
+            if (stat != SensorType::DATA_OK)
+            {
+                sensor_count = 0;
+            }
+
+            mutex_.lock();
+            samplers_[i].Update(readings_ + count, sensor_count, due_ms);
+            mutex_.unlock();
+            count += sensor_count;
+        }
+
+        mutex_.lock();
+        reading_count_ = count;
+        busy_ = false;
+        EventFlags* done = done_;
+        uint32_t flag = flag_;
+        mutex_.unlock();
+
+        done->set(flag);
+
+        DiagnosticsBusyEnd();
+    }
+}
+
+/**
+ *  @brief  Attaches a sensor to the bus of its SDA pin, taking a new bus for a new pin.
+ *  @author Lee Tze Han
+ *  @param  sensor  Enabled sensor
+ *  @param  sda     SDA pin the sensor is wired to
+ *  @return Whether the sensor was attached
+ */
+bool SensorBusGroup::Attach(SensorType* sensor, PinName sda)
+{
+    for (size_t i = 0; i < bus_count_; i++)
+    {
+        if (buses_[i].GetSda() == sda)
+        {
+            return buses_[i].Attach(sensor, sda);
+        }
+    }
+
+    if (bus_count_ >= SENSOR_BUS_MAX_BUSES)
+    {
+        tr_err("No free sensor bus");
+        return false;
+    }
+
+    return buses_[bus_count_++].Attach(sensor, sda);
+}
+
+/**
+ *  @brief  Starts the worker of every bus with attached sensors.
+ *  @author Lee Tze Han
+ */
+void SensorBusGroup::Start(void)
+{
+    static const char* const bus_ids[SENSOR_BUS_MAX_BUSES] = {"bus0", "bus1", "bus2", "bus3"};
+
+    for (size_t i = 0; i < bus_count_; i++)
+    {
+        if (buses_[i].Start(bus_ids[i]) != osOK)
+        {
+            tr_err("Failed to start %s", bus_ids[i]);
+        }
+    }
+}
+
+/**
+ *  @brief  Sets the sampling policy of every sensor; call before Start.
+ *  @author Lee Tze Han
+ *  @param  policy              Sampling policy
+ *  @param  base_interval_ms    Interval of the fixed policy (sensorpollrate)
+ */
+void SensorBusGroup::SetPolicy(const sampling_policy_t& policy, uint32_t base_interval_ms)
+{
+    for (size_t i = 0; i < SENSOR_BUS_MAX_BUSES; i++)
+    {
+        buses_[i].SetPolicy(policy, base_interval_ms);
+    }
+}
+
+/**
+ *  @brief  Sets the interval of the fixed policy of every sensor.
+ *  @author Lee Tze Han
+ *  @param  base_interval_ms    Interval of the fixed policy (sensorpollrate)
+ */
+void SensorBusGroup::SetBaseInterval(uint32_t base_interval_ms)
+{
+    for (size_t i = 0; i < SENSOR_BUS_MAX_BUSES; i++)
+    {
+        buses_[i].SetBaseInterval(base_interval_ms);
+    }
+}
+
+/**
+ *  @brief  Whether any sensor is due to be read.
+ *  @author Lee Tze Han
+ *  @return Whether a sample cycle is due
+ */
+bool SensorBusGroup::Due(void)
+{
+    const uint64_t now_ms = Kernel::get_ms_count();
+
+    for (size_t i = 0; i < bus_count_; i++)
+    {
+        if (buses_[i].DueSensors(now_ms) != 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ *  @brief  Time the first sensor is next due, for the sensor thread to sleep until.
+ *  @author Lee Tze Han
+ *  @return Kernel time in ms; UINT64_MAX without sensors
+ */
+uint64_t SensorBusGroup::NextDue(void)
+{
+    uint64_t next_due_ms = UINT64_MAX;
+
+    for (size_t i = 0; i < bus_count_; i++)
+    {
+        next_due_ms = std::min(next_due_ms, buses_[i].NextDue());
+    }
+
+    return next_due_ms;
+}
+
+/**
+ *  @brief  Reads one sample cycle: triggers every bus with due sensors at once, then gathers the buses done by the deadline.
+ *  @author Lee Tze Han
+ *  @param  cycle       Sample cycle number
+ *  @param  deadline    Longest wait for the buses
+ *  @param  record      Cycle record to fill
+ *  @return Number of readings gathered
+ */
+size_t SensorBusGroup::Acquire(uint32_t cycle, Kernel::Clock::duration_u32 deadline, sensor_cycle_t& record)
+{
+    Timer timer;
+    timer.start();
+
+    record.cycle = cycle;
+    record.count = 0;
+    record.missed = 0;
+
+    /* Scatter; a bus still reading an earlier cycle sits this one out */
+    const uint64_t now_ms = Kernel::get_ms_count();
+    uint32_t triggered = 0;
+    for (size_t i = 0; i < bus_count_; i++)
+    {
+        const uint32_t due = buses_[i].DueSensors(now_ms);
+        if (due == 0)
+        {
+            continue;
+        }
+        if (buses_[i].Trigger(cycle, due, now_ms, &done_, 1UL << i))
+        {
+            triggered |= 1UL << i;
+        }
+        else
+        {
+            record.missed |= 1UL << i;
+        }
+    }
+
+    /* Gather */
+    const Kernel::Clock::time_point expiry = Kernel::Clock::now() + deadline;
+    uint32_t pending = triggered;
+    while (pending != 0)
+    {
+        const Kernel::Clock::time_point now = Kernel::Clock::now();
+        if (now >= expiry)
+        {
+            break;
+        }
+
+        uint32_t flags = done_.wait_any_for(pending, std::chrono::duration_cast<Kernel::Clock::duration_u32>(expiry - now));
+        if (flags & osFlagsError)
+        {
+            break;
+        }
+        pending &= ~flags;
+    }
+
+    for (size_t i = 0; i < bus_count_; i++)
+    {
+        if ((triggered & (1UL << i)) && !buses_[i].Collect(cycle, record))
+        {
+            record.missed |= 1UL << i;
+        }
+    }
+    if (record.missed != 0)
+    {
+        tr_warn("Sensor buses 0x%lx missed cycle %lu", (unsigned long)record.missed, (unsigned long)cycle);
+    }
+
+    record.elapsed_us = timer.elapsed_time().count();
+
+    return record.count;
+}
+
+size_t SensorBusGroup::GetBusCount(void) const
+{
+    return bus_count_;
+}
+
+/** @}*/
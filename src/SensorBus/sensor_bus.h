@@ -0,0 +1,135 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef SENSOR_BUS_H
+#define SENSOR_BUS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mbed.h"
+#include "rtos.h"
+#include "sensor_type.h"
+#include "adaptive_sampling.h"
+
+#define SENSOR_BUS_MAX_SENSORS      4                                       // sensors attached to one bus
+#define SENSOR_BUS_MAX_BUSES        4                                       // buses read in parallel
+#define SENSOR_BUS_STACK_SIZE       2048                                    // stack of each bus worker
+#define SENSOR_CYCLE_MAX_READINGS   (SENSOR_BUS_MAX_BUSES * SENSOR_MAX_READINGS)
+
+/** Readings gathered from every bus in one sample cycle */
+typedef struct {
+    uint32_t cycle;                                         /// sample cycle number
+    sensor_reading_t readings[SENSOR_CYCLE_MAX_READINGS];   /// readings of the buses that completed, in bus order
+    size_t count;                                           /// number of readings
+    uint32_t missed;                                        /// bitmask of due buses that did not complete before the deadline
+    uint32_t elapsed_us;                                    /// time from triggering the buses to gathering them
+} sensor_cycle_t;
+
+/** SensorBus class.
+ *  @brief  Worker thread reading the sensors of one I2C bus, one after another, when triggered
+ *
+ *  Sensors on separate buses are read concurrently by their own workers, so a sample cycle takes as long
+ *  as its slowest bus rather than the sum of all sensors. SensorBusGroup triggers the workers and gathers
+ *  their readings. Each sensor keeps its own sampling schedule; a trigger reads only the sensors due.
+ */
+class SensorBus
+{
+    public:
+        SensorBus();
+        ~SensorBus();
+
+        bool Attach(SensorType* sensor, PinName sda);
+        osStatus Start(const char* id);
+        void SetPolicy(const sampling_policy_t& policy, uint32_t base_interval_ms);
+        void SetBaseInterval(uint32_t base_interval_ms);
+        uint32_t DueSensors(uint64_t now_ms);
+        uint64_t NextDue(void);
+        bool Trigger(uint32_t cycle, uint32_t sensors, uint64_t now_ms, EventFlags* done, uint32_t flag);
+        bool Collect(uint32_t cycle, sensor_cycle_t& record);
+        PinName GetSda(void) const;
+        size_t GetSensorCount(void) const;
+
+    private:
+        void Worker(void);
+
+        Thread thread_;
+        Semaphore trigger_;                                                                 /// released once per triggered cycle
+        Mutex mutex_;                                                                       /// guards the state shared with the worker
+        PinName sda_ = NC;
+        SensorType* sensors_[SENSOR_BUS_MAX_SENSORS];
+        AdaptiveSampler samplers_[SENSOR_BUS_MAX_SENSORS];                                  /// schedule of each sensor
+        size_t sensor_count_ = 0;
+
+        bool busy_ = false;                                                                 /// worker is reading; readings_ belong to it
+        bool stopping_ = false;
+        uint32_t cycle_ = 0;                                                                /// cycle of the last trigger
+        uint32_t due_ = 0;                                                                  /// bitmask of the sensors to read
+        uint64_t due_ms_ = 0;                                                               /// time of the last trigger
+        EventFlags* done_ = NULL;                                                           /// set with flag_ when the worker is done
+        uint32_t flag_ = 0;
+        sensor_reading_t readings_[SENSOR_MAX_READINGS];
+        size_t reading_count_ = 0;
+};
+
+/** SensorBusGroup class.
+ *  @brief  Scatter/gather of one sample cycle over the buses of the attached sensors
+ *
+ *  Under the default fixed policy, every sensor is due once per base interval. Under the adaptive policy,
+ *  each sensor follows the activity of its own readings (see AdaptiveSampler), and a cycle reads only the
+ *  sensors due.
+ *
+ *  Example:
+ *  @code{.cpp}
+ *  #include "mbed.h"
+ *  #include "sensor_bus.h"
+ *
+ *  int main()
+ *  {
+ *      Tmp75 onboard_temp_sensor(PB_9, PB_6);
+ *      onboard_temp_sensor.Enable();
+ *
+ *      SensorBusGroup sensor_buses;
+ *      sensor_buses.Attach(&onboard_temp_sensor, PB_9);
+ *      sensor_buses.SetPolicy({false, 0, 0, 0.0f, 0.0f}, 60000);
+ *      sensor_buses.Start();
+ *
+ *      sensor_cycle_t record;
+ *      if (sensor_buses.Due())
+ *      {
+ *          sensor_buses.Acquire(1, 500ms, record);
+ *          printf("%u readings in %lu us\r\n", record.count, record.elapsed_us);
+ *      }
+ *  }
+ *  @endcode
+ */
+class SensorBusGroup
+{
+    public:
+        bool Attach(SensorType* sensor, PinName sda);
+        void Start(void);
+        void SetPolicy(const sampling_policy_t& policy, uint32_t base_interval_ms);
+        void SetBaseInterval(uint32_t base_interval_ms);
+        bool Due(void);
+        uint64_t NextDue(void);
+        size_t Acquire(uint32_t cycle, Kernel::Clock::duration_u32 deadline, sensor_cycle_t& record);
+        size_t GetBusCount(void) const;
+
+    private:
+        EventFlags done_;                                                                   /// bit i set when bus i completes; outlives the workers
+        SensorBus buses_[SENSOR_BUS_MAX_BUSES];
+        size_t bus_count_ = 0;
+};
+
+#endif  // SENSOR_BUS_H
@@ -2,6 +2,7 @@
 #include "utest/utest.h"
 #include "unity/unity.h"
 #include "greentea-client/test_env.h"
+#include "json.h"
 #include "sensor_profile.h"
 #include "global_params.h"
 
@@ -160,6 +161,126 @@ static control_t update_value_test_9(const size_t call_count)
     return CaseNext;
 }
 
+// Test for update of member variable with a numeric reading, and getting json packet
+static control_t update_value_test_10(const size_t call_count) 
+{
+    std::string expected_packet, actual_packet;
+    SensorProfile pm_profile;
+    pm_profile.UpdateValue("PM2.5_mass", 0.52f, 5);
+    pm_profile.UpdateValue("PM10_mass", 23.45f, 5);
+
+    // {"id":"<replace with actual uuid>","method":"thing.measurepoint.post","params":{"measurepoints":{"PM10_mass":23.45,"PM2.5_mass":0.52}},"version":"1.0"}
+    expected_packet = "{\"id\":\"" + device_uuid + "\",\"method\":\"thing.measurepoint.post\",\"params\":{\"measurepoints\":{\"PM10_mass\":23.45,\"PM2.5_mass\":0.52}},\"version\":\"1.0\"}";
+    actual_packet = pm_profile.GetNewDecadaPacket();
+
+    TEST_ASSERT_EQUAL_STRING(expected_packet.c_str(), actual_packet.c_str());
+
+    return CaseNext;
+}
+
+// Test for suppression of unchanged measure point by deadband filter
+static control_t deadband_filter_test_1(const size_t call_count) 
+{
+    SensorProfile temperature_profile;
+    temperature_profile.SetDefaultDeadband(0.5, 0.0, 0);
+
+    temperature_profile.UpdateValue("temperature", 25.00f, 5);
+    temperature_profile.ApplyDeadbandFilter(5);
+    TEST_ASSERT_TRUE(temperature_profile.CheckEntityAvailability());
+
+    temperature_profile.ClearEntityList();
+    temperature_profile.UpdateValue("temperature", 25.40f, 10);
+    temperature_profile.ApplyDeadbandFilter(10);
+    TEST_ASSERT_FALSE(temperature_profile.CheckEntityAvailability());
+
+    temperature_profile.ClearEntityList();
+    temperature_profile.UpdateValue("temperature", 25.60f, 15);
+    temperature_profile.ApplyDeadbandFilter(15);
+    TEST_ASSERT_TRUE(temperature_profile.CheckEntityAvailability());
+
+    TEST_ASSERT_EQUAL_UINT32(2, temperature_profile.GetSentCount());
+    TEST_ASSERT_EQUAL_UINT32(1, temperature_profile.GetSuppressedCount());
+
+    return CaseNext;
+}
+
+// Test for only changed measure points being kept in json packet, with per-entity relative deadband
+static control_t deadband_filter_test_2(const size_t call_count) 
+{
+    std::string expected_packet, actual_packet;
+    SensorProfile co2_profile;
+    co2_profile.SetDefaultDeadband(0.0, 0.0, 0);
+    co2_profile.SetDeadband("co2", 0.0, 0.05);
+
+    co2_profile.UpdateValue("co2", 400.00f, 5);
+    co2_profile.UpdateValue("humidity", 55.00f, 5);
+    co2_profile.ApplyDeadbandFilter(5);
+
+    co2_profile.ClearEntityList();
+    co2_profile.UpdateValue("co2", 410.00f, 10);
+    co2_profile.UpdateValue("humidity", 55.10f, 10);
+    co2_profile.ApplyDeadbandFilter(10);
+
+    // {"id":"<replace with actual uuid>","method":"thing.measurepoint.post","params":{"measurepoints":{"humidity":55.1}},"version":"1.0"}
+    expected_packet = "{\"id\":\"" + device_uuid + "\",\"method\":\"thing.measurepoint.post\",\"params\":{\"measurepoints\":{\"humidity\":55.1}},\"version\":\"1.0\"}";
+    actual_packet = co2_profile.GetNewDecadaPacket();
+
+    TEST_ASSERT_EQUAL_STRING(expected_packet.c_str(), actual_packet.c_str());
+
+    return CaseNext;
+}
+
+// Test for heartbeat publish of unchanged measure point after max silence
+static control_t deadband_filter_test_3(const size_t call_count) 
+{
+    SensorProfile temperature_profile;
+    temperature_profile.SetDefaultDeadband(1.0, 0.0, 600);
+
+    temperature_profile.UpdateValue("temperature", 25.00f, 0);
+    temperature_profile.ApplyDeadbandFilter(0);
+
+    temperature_profile.ClearEntityList();
+    temperature_profile.UpdateValue("temperature", 25.00f, 599999);
+    temperature_profile.ApplyDeadbandFilter(599999);
+    TEST_ASSERT_FALSE(temperature_profile.CheckEntityAvailability());
+
+    temperature_profile.ClearEntityList();
+    temperature_profile.UpdateValue("temperature", 25.00f, 600000);
+    temperature_profile.ApplyDeadbandFilter(600000);
+    TEST_ASSERT_TRUE(temperature_profile.CheckEntityAvailability());
+
+    return CaseNext;
+}
+
+// Test that packet written from prebuilt envelope matches JsonCpp FastWriter, for several measure points
+static control_t create_packet_test_1(const size_t call_count) 
+{
+    const char* ids[] = {"pm10_mass", "co2", "ambient_temp", "tab\tid", "quote\"id", "large", "negative"};
+    const std::string values[] = {"12.34", "400", "-0.05", "1e-7", "3", "123456789012345678", "-1234.5"};
+    SensorProfile profile;
+    Json::Value measure_points;
+    for (size_t i = 0; i < sizeof(ids) / sizeof(ids[0]); i++)
+    {
+        profile.UpdateValue(ids[i], values[i], 5);
+        measure_points[ids[i]] = std::stod(values[i]);
+    }
+
+    Json::Value message_content;
+    message_content["id"] = device_uuid;
+    message_content["version"] = "1.0";
+    message_content["params"]["measurepoints"] = measure_points;
+    message_content["method"] = "thing.measurepoint.post";
+    Json::FastWriter fast_writer;
+    std::string expected_packet = fast_writer.write(message_content);
+    expected_packet.erase(expected_packet.find_last_not_of('\n') + 1);
+
+    std::string actual_packet = profile.GetNewDecadaPacket();
+
+    TEST_ASSERT_EQUAL_STRING(expected_packet.c_str(), actual_packet.c_str());
+
+    return CaseNext;
+}
+
 utest::v1::status_t greentea_setup(const size_t number_of_cases) 
 {
     // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
@@ -179,7 +300,12 @@ Case cases[] =
     Case("Test for update of member variable, and getting snon-style json packet - invalid", update_value_test_6),
     Case("Test for update of member variable, and getting snon-style json packet after updating entity list with new timestamp", update_value_test_7),
     Case("Test for checking of data availability, after update of member variable", update_value_test_8),
-    Case("Test for checking of data availability, after update of entity list with new timestamp without new data", update_value_test_9)
+    Case("Test for checking of data availability, after update of entity list with new timestamp without new data", update_value_test_9),
+    Case("Test for update of member variable with numeric reading, and getting snon-style json packet", update_value_test_10),
+    Case("Test for suppression of unchanged measure point by deadband filter", deadband_filter_test_1),
+    Case("Test for per-entity relative deadband, and getting snon-style json packet", deadband_filter_test_2),
+    Case("Test for heartbeat publish after max silence", deadband_filter_test_3),
+    Case("Test for packet from prebuilt envelope matching JsonCpp", create_packet_test_1)
 };
 
 Specification specification(greentea_setup, cases);
@@ -2,16 +2,57 @@
  * @defgroup sensor_profile Sensor Profile
  * @{
  */
+#include <algorithm>
+#include <cmath>
 #include "sensor_profile.h"
 #include "mbed.h"
 #include "mbed_trace.h"
-#include "json.h"
 #include "conversions.h"
+#include "decada_endpoints.h"
 #include "time_engine.h"
 #include "global_params.h"
+#include "json_stream.h"
 
 #define TRACE_GROUP "SensorProfile"
 
+/**
+ *  @brief  Appends a quoted json string, escaped as by JsonWriter.
+ *  @author Lee Tze Han
+ *  @param  out     Destination
+ *  @param  value   String to quote
+ */
+static void AppendJsonString(std::string& out, const std::string& value)
+{
+    char escape[JSON_ESCAPE_SIZE];
+
+    out += '"';
+    for (char c : value)
+    {
+        const size_t length = JsonEscapeChar(c, escape);
+        if (length > 0)
+        {
+            out.append(escape, length);
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+/**
+ *  @brief  Appends a json number as JsonWriter writes reals.
+ *  @author Lee Tze Han
+ *  @param  out     Destination
+ *  @param  value   Number
+ */
+static void AppendJsonReal(std::string& out, double value)
+{
+    char buffer[32];
+    out.append(buffer, JsonFormatReal(buffer, sizeof(buffer), value));
+}
+
 /**
  *  @brief  Public method that would return boolean of entity availability in entity_value_pairs_
  *  @author Yap Zi Qi
@@ -34,11 +75,25 @@ bool SensorProfile::CheckEntityAvailability()
  *  @author Yap Zi Qi
  *  @param  entity_name Name of data entity
  *  @param  value       New sensor value
- *  @param  time_stamp  Raw system timestamp of sensor value
+ *  @param  time_stamp  Epoch milliseconds of sensor value
  */
-void SensorProfile::UpdateValue(std::string entity_name, std::string value, int time_stamp)
+void SensorProfile::UpdateValue(std::string entity_name, std::string value, int64_t time_stamp)
 {
-    entity_value_pairs_[entity_name] = make_pair(value, time_stamp); 
+    entity_value_pairs_[entity_name] = make_pair(StringToDouble(value), time_stamp); 
+    return;
+}
+
+/**
+ *  @brief  Update hashmap of entity with its numeric value and timestamp, rounded to 2 decimal places.
+ *  @author Lee Tze Han
+ *  @param  entity_name Name of data entity
+ *  @param  value       New sensor value
+ *  @param  time_stamp  Epoch milliseconds of sensor value
+ */
+void SensorProfile::UpdateValue(const std::string& entity_name, float value, int64_t time_stamp)
+{
+    double rounded_value = std::round(value * measure_point_scale_) / measure_point_scale_;
+    entity_value_pairs_[entity_name] = make_pair(rounded_value, time_stamp);
     return;
 }
 
@@ -54,16 +109,20 @@ void SensorProfile::ClearEntityList(void)
 /**
  *  @brief  Public method that updates entity_value_pairs_ by removing any entity that has not been updated
  *  @author Yap Zi Qi
- *  @param  time_stamp  Raw system timestamp of the start of data stream from sensor thread
+ *  @param  time_stamp  Epoch milliseconds of the start of data stream from sensor thread
  */
-void SensorProfile::UpdateEntityList(int time_stamp)
+void SensorProfile::UpdateEntityList(int64_t time_stamp)
 {
-    for (auto& it : entity_value_pairs_)
+    for (auto it = entity_value_pairs_.begin(); it != entity_value_pairs_.end();)
     {
-        int entity_timestamp = it.second.second;
+        int64_t entity_timestamp = it->second.second;
         if (entity_timestamp < time_stamp)
         {
-            entity_value_pairs_.erase(it.first);
+            it = entity_value_pairs_.erase(it);
+        }
+        else
+        {
+            ++it;
         }
     }
 }
@@ -80,35 +139,120 @@ std::string SensorProfile::GetNewDecadaPacket(void)
     return decada_packet;
 }
 
+/**
+ *  @brief  Sets the deadband used by entities without their own deadband, and the heartbeat interval.
+ *  @author Lee Tze Han
+ *  @param  absolute        Minimum absolute change for an entity to be published
+ *  @param  relative        Minimum change as a fraction of the last published value
+ *  @param  max_silence_s   Entities not published for this many seconds are always published (0 to disable)
+ */
+void SensorProfile::SetDefaultDeadband(double absolute, double relative, int max_silence_s)
+{
+    default_deadband_ = {absolute, relative};
+    max_silence_s_ = max_silence_s;
+}
+
+/**
+ *  @brief  Overrides the deadband of a single entity.
+ *  @author Lee Tze Han
+ *  @param  entity_name Name of data entity
+ *  @param  absolute    Minimum absolute change for the entity to be published
+ *  @param  relative    Minimum change as a fraction of the last published value
+ */
+void SensorProfile::SetDeadband(const std::string& entity_name, double absolute, double relative)
+{
+    deadbands_[entity_name] = {absolute, relative};
+}
+
+/**
+ *  @brief  Removes entities whose value has not moved beyond their deadband since they were last published,
+ *          unless the heartbeat interval has elapsed. Entities that remain are recorded as published.
+ *  @author Lee Tze Han
+ *  @param  time_stamp  Epoch milliseconds of the publish
+ */
+void SensorProfile::ApplyDeadbandFilter(int64_t time_stamp)
+{
+    for (auto it = entity_value_pairs_.begin(); it != entity_value_pairs_.end(); )
+    {
+        double value = it->second.first;
+        auto last = last_published_.find(it->first);
+        if (last != last_published_.end())
+        {
+            auto band = deadbands_.find(it->first);
+            const deadband_t& deadband = (band != deadbands_.end()) ? band->second : default_deadband_;
+
+            double threshold = std::max(deadband.absolute, deadband.relative * std::fabs(last->second.value));
+            bool changed = std::fabs(value - last->second.value) > threshold;
+            bool heartbeat = (max_silence_s_ > 0) && (time_stamp - last->second.time_stamp >= max_silence_s_ * 1000LL);
+            if (!changed && !heartbeat)
+            {
+                suppressed_count_++;
+                it = entity_value_pairs_.erase(it);
+                continue;
+            }
+        }
+
+        last_published_[it->first] = {value, time_stamp};
+        sent_count_++;
+        ++it;
+    }
+}
+
+/**
+ *  @brief  Number of measure points passed by the deadband filter since construction.
+ *  @author Lee Tze Han
+ *  @return count of measure points sent
+ */
+uint32_t SensorProfile::GetSentCount(void) const
+{
+    return sent_count_;
+}
+
+/**
+ *  @brief  Number of measure points removed by the deadband filter since construction.
+ *  @author Lee Tze Han
+ *  @return count of measure points suppressed
+ */
+uint32_t SensorProfile::GetSuppressedCount(void) const
+{
+    return suppressed_count_;
+}
+
 /**
  *  @brief  Create and populate json using DECADAcloud-compliant styling; Used for sensor messages.
- *  @author Lau Lee Hong, Yap Zi Qi
- *  @param  time_stamp   Raw system timestamp (in miliseconds) of the start of data stream from sensor thread
+ *          The envelope is prebuilt at boot (decada_endpoints.h); only the measure points are written here,
+ *          byte for byte as Json::FastWriter would.
+ *  @author Lau Lee Hong, Yap Zi Qi, Lee Tze Han
  *  @return String of DECADAcloud-compliant json packet for sensor messages
  */
 std::string SensorProfile::CreateDecadaPacket(void)
 {
-    Json::Value measure_points;
-    for (auto& it: entity_value_pairs_)
+    size_t prefix_length;
+    const char* prefix = DecadaEnvelopePrefix(prefix_length);
+
+    std::string decada_message;
+    decada_message.reserve(prefix_length + entity_value_pairs_.size() * measure_point_reserve_ + LiteralLength(DECADA_ENVELOPE_SUFFIX));
+    decada_message.append(prefix, prefix_length);
+
+    if (entity_value_pairs_.empty())
     {
-        std::string entity_name = it.first;
-        std::string entity_value = it.second.first;
-        double value_float = StringToDouble(entity_value);
-        measure_points[entity_name] = value_float;
+        decada_message += "null";
     }
-    
-    Json::Value params;
-    params["measurepoints"] = measure_points;
-    
-    Json::Value message_content;
-    message_content["id"] = device_uuid;
-    message_content["version"] = decada_protocol_version_;
-    message_content["params"] = params;
-    message_content["method"] = decada_method_of_device_;
-    
-    Json::FastWriter fast_writer;
-    std::string decada_message = fast_writer.write(message_content);
-    decada_message.erase(std::remove(decada_message.begin(), decada_message.end(), '\n'), decada_message.end());
+    else
+    {
+        char separator = '{';
+        for (auto& it: entity_value_pairs_)
+        {
+            decada_message += separator;
+            separator = ',';
+            AppendJsonString(decada_message, it.first);
+            decada_message += ':';
+            AppendJsonReal(decada_message, it.second.first);
+        }
+        decada_message += '}';
+    }
+
+    decada_message.append(DECADA_ENVELOPE_SUFFIX, LiteralLength(DECADA_ENVELOPE_SUFFIX));
     
     return decada_message;     
 }
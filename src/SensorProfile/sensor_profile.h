@@ -16,8 +16,10 @@
 #ifndef SENSOR_PROFILE_H
 #define SENSOR_PROFILE_H
 
+#include <stdint.h>
 #include <string>
 #include <vector>
+#include <map>
 #include <unordered_map>
 
 /** SensorProfile class.
@@ -32,7 +34,12 @@
  *  {
  *      SensorProfile sensors_profile;     
  *      sensors_profile.UpdateValue("temperature", "23.45", 0);
- *      printf("\r\n %s \r\n", sensors_profile.GetNewPacket());
+ *      sensors_profile.SetDeadband("temperature", 0.5, 0.0);
+ *      sensors_profile.ApplyDeadbandFilter(0);
+ *      if (sensors_profile.CheckEntityAvailability())
+ *      {
+ *          printf("\r\n %s \r\n", sensors_profile.GetNewDecadaPacket().c_str());
+ *      }
  *  }
  *  @endcode
  */
@@ -41,21 +48,45 @@ class SensorProfile
 {
     public:
         /// Public exposed methods
-        void UpdateValue(std::string entity_name, std::string value, int timestamp);        /// mailbox receives from sensor thread; struct { char* sensor_type, char* value, int raw_time_stamp }
+        void UpdateValue(std::string entity_name, std::string value, int64_t timestamp);
+        void UpdateValue(const std::string& entity_name, float value, int64_t timestamp);   /// mailbox receives from sensor thread; struct { const char* sensor_type, float value, uint8_t quality, int64_t time_stamp_ms }
         void ClearEntityList(void);
-        void UpdateEntityList(int time_stamp);
+        void UpdateEntityList(int64_t time_stamp);
         bool CheckEntityAvailability();
         std::string GetNewDecadaPacket();
 
+        void SetDefaultDeadband(double absolute, double relative, int max_silence_s);
+        void SetDeadband(const std::string& entity_name, double absolute, double relative);
+        void ApplyDeadbandFilter(int64_t time_stamp);                                       /// removes entities that have not changed beyond their deadband
+        uint32_t GetSentCount(void) const;
+        uint32_t GetSuppressedCount(void) const;
+
     private:
+        typedef struct {
+            double absolute;                                                                /// minimum absolute change to publish
+            double relative;                                                                /// minimum change as a fraction of the last published value
+        } deadband_t;
+
+        typedef struct {
+            double value;                                                                   /// last published value
+            int64_t time_stamp;                                                             /// epoch milliseconds of last publish
+        } published_point_t;
+
         /// Internal methods used within the class
         std::string CreateDecadaPacket(void);                                               /// putting it altogeter: create json array with nested ojects and arrays that is DECADAcloud-compliant
 
         /// Class member variables
-        const std::string decada_protocol_version_ = "1.0";                                 /// version of decada-compliant json protocol
-        const std::string decada_method_of_device_ = "thing.measurepoint.post";             /// version of decada-compliant json protocol
+        const double measure_point_scale_ = 100.0;                                          /// measure points are published with 2 decimal places
+        const size_t measure_point_reserve_ = 32;                                           /// typical length of "<id>":<value>, for reserving the packet
+
+        std::map<std::string, std::pair<double, int64_t>> entity_value_pairs_;              /// collation of entity and value, timestamp pairs; sorted as JsonCpp writes them
 
-        std::unordered_map<std::string, std::pair<std::string, int>> entity_value_pairs_;   /// collation of entity and value, timestamp pairs
+        deadband_t default_deadband_ = {0.0, 0.0};                                          /// deadband of entities without their own deadband
+        int max_silence_s_ = 0;                                                             /// heartbeat; 0 never forces a publish
+        std::unordered_map<std::string, deadband_t> deadbands_;                             /// per-entity deadband overrides
+        std::unordered_map<std::string, published_point_t> last_published_;                 /// last value sent for each entity
+        uint32_t sent_count_ = 0;                                                           /// measure points passed by the deadband filter
+        uint32_t suppressed_count_ = 0;                                                     /// measure points removed by the deadband filter
 };
 
 #endif  // SENSOR_PROFILE_H
\ No newline at end of file
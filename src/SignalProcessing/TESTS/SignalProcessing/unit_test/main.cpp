@@ -0,0 +1,278 @@
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "signal_processing.h"
+
+#define TRACE_LENGTH            256
+#define BENCHMARK_ITERATIONS    1000
+
+using namespace utest::v1;
+
+/* Deterministic uniform noise in [-1, 1) so traces are reproducible across targets */
+static float Noise(uint32_t& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return (float)(seed >> 8) / (float)(1u << 23) - 1.0f;
+}
+
+/* Synthetic SPS30 PM2.5 mass concentration: 12 ug/m3 with +-1 noise and a spike every 37 samples */
+static void Sps30Trace(float* trace, size_t len)
+{
+    uint32_t seed = 30;
+    for (size_t i = 0; i < len; i++)
+    {
+        trace[i] = 12.0f + Noise(seed);
+        if (i % 37 == 5)
+        {
+            trace[i] += 200.0f;
+        }
+    }
+}
+
+/* Synthetic SCD30 CO2 concentration: ramp from 600 to 856 ppm with +-5 noise */
+static void Scd30Trace(float* trace, size_t len)
+{
+    uint32_t seed = 31;
+    for (size_t i = 0; i < len; i++)
+    {
+        trace[i] = 600.0f + (float)i + 5.0f * Noise(seed);
+    }
+}
+
+// Test that a constant stream passes through unchanged from the first block
+static control_t signal_steady_state_test_1(const size_t call_count)
+{
+    SignalChannel channel;
+    float out[SIGNAL_OUTPUT_BLOCK_SIZE];
+    size_t count = 0;
+
+    for (size_t i = 0; i < SIGNAL_BLOCK_SIZE; i++)
+    {
+        count = channel.PushSample(24.83f, out);
+        if (i < SIGNAL_BLOCK_SIZE - 1)
+        {
+            TEST_ASSERT_EQUAL_UINT32(0, count);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(SIGNAL_OUTPUT_BLOCK_SIZE, count);
+    for (size_t i = 0; i < SIGNAL_OUTPUT_BLOCK_SIZE; i++)
+    {
+        TEST_ASSERT_FLOAT_WITHIN(0.001f, 24.83f, out[i]);
+    }
+
+    return CaseNext;
+}
+
+// Test for replacement of a spike by the block median
+static control_t signal_outlier_test_1(const size_t call_count)
+{
+    float block[SIGNAL_BLOCK_SIZE] = {10.0f, 11.0f, 10.5f, 250.0f, 10.2f, 9.8f, 10.1f, 10.4f};
+
+    size_t actual_count = SignalRejectOutliers(block, SIGNAL_BLOCK_SIZE, 3.0f);
+
+    TEST_ASSERT_EQUAL_UINT32(1, actual_count);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 10.3f, block[3]);
+    TEST_ASSERT_EQUAL_FLOAT(11.0f, block[1]);
+
+    return CaseNext;
+}
+
+// Test that samples within the threshold are left untouched
+static control_t signal_outlier_test_2(const size_t call_count)
+{
+    float block[SIGNAL_BLOCK_SIZE] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+    const float expected[SIGNAL_BLOCK_SIZE] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+
+    size_t actual_count = SignalRejectOutliers(block, SIGNAL_BLOCK_SIZE, 3.0f);
+
+    TEST_ASSERT_EQUAL_UINT32(0, actual_count);
+    TEST_ASSERT_EQUAL_FLOAT_ARRAY(expected, block, SIGNAL_BLOCK_SIZE);
+
+    return CaseNext;
+}
+
+// Test that SPS30 spikes are removed and the noise is smoothed
+static control_t signal_sps30_trace_test_1(const size_t call_count)
+{
+    float trace[TRACE_LENGTH];
+    float out[SIGNAL_OUTPUT_BLOCK_SIZE];
+    SignalChannel channel;
+    size_t num_out = 0;
+
+    Sps30Trace(trace, TRACE_LENGTH);
+    for (size_t i = 0; i < TRACE_LENGTH; i++)
+    {
+        size_t count = channel.PushSample(trace[i], out);
+        for (size_t j = 0; j < count; j++)
+        {
+            TEST_ASSERT_FLOAT_WITHIN(1.0f, 12.0f, out[j]);
+        }
+        num_out += count;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(TRACE_LENGTH / SIGNAL_DECIMATION, num_out);
+
+    return CaseNext;
+}
+
+// Test that the SCD30 ramp is tracked after the filter delay
+static control_t signal_scd30_trace_test_1(const size_t call_count)
+{
+    float trace[TRACE_LENGTH];
+    float out[SIGNAL_OUTPUT_BLOCK_SIZE];
+    SignalChannel channel;
+    float last = 0.0f;
+
+    Scd30Trace(trace, TRACE_LENGTH);
+    for (size_t i = 0; i < TRACE_LENGTH; i++)
+    {
+        if (channel.PushSample(trace[i], out) > 0)
+        {
+            last = out[SIGNAL_OUTPUT_BLOCK_SIZE - 1];
+        }
+    }
+
+    /* Biquad group delay (~2 samples) and FIR delay (~7 samples) lag the ramp by about 10 ppm */
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, 600.0f + TRACE_LENGTH - 10.0f, last);
+
+    return CaseNext;
+}
+
+// Test that each measure point is filtered by its own channel
+static control_t signal_processor_test_1(const size_t call_count)
+{
+    static const char* pm_id = "PM2.5_mass";
+    static const char* co2_id = "co2";
+    float out[SIGNAL_OUTPUT_BLOCK_SIZE];
+    SignalProcessor processor;
+    size_t pm_count = 0, co2_count = 0;
+    float pm_out = 0.0f, co2_out = 0.0f;
+
+    for (size_t i = 0; i < SIGNAL_BLOCK_SIZE; i++)
+    {
+        pm_count = processor.PushSample(pm_id, 4.02f, out);
+        if (pm_count > 0)
+        {
+            pm_out = out[0];
+        }
+        co2_count = processor.PushSample(co2_id, 612.47f, out);
+        if (co2_count > 0)
+        {
+            co2_out = out[0];
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(SIGNAL_OUTPUT_BLOCK_SIZE, pm_count);
+    TEST_ASSERT_EQUAL_UINT32(SIGNAL_OUTPUT_BLOCK_SIZE, co2_count);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 4.02f, pm_out);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 612.47f, co2_out);
+
+    return CaseNext;
+}
+
+// Test that the scalar path matches the configured (CMSIS-DSP or scalar) path
+static control_t signal_scalar_match_test_1(const size_t call_count)
+{
+    float trace[TRACE_LENGTH];
+    float block_a[SIGNAL_BLOCK_SIZE], block_b[SIGNAL_BLOCK_SIZE];
+    float out_a[SIGNAL_OUTPUT_BLOCK_SIZE], out_b[SIGNAL_OUTPUT_BLOCK_SIZE];
+    SignalChannel channel_a, channel_b;
+
+    Scd30Trace(trace, TRACE_LENGTH);
+    for (size_t i = 0; i < TRACE_LENGTH; i += SIGNAL_BLOCK_SIZE)
+    {
+        std::memcpy(block_a, &trace[i], sizeof(block_a));
+        std::memcpy(block_b, &trace[i], sizeof(block_b));
+        channel_a.ProcessBlock(block_a, out_a);
+        channel_b.ProcessBlockScalar(block_b, out_b);
+
+        for (size_t j = 0; j < SIGNAL_OUTPUT_BLOCK_SIZE; j++)
+        {
+            TEST_ASSERT_FLOAT_WITHIN(0.01f, out_b[j], out_a[j]);
+        }
+    }
+
+    return CaseNext;
+}
+
+static control_t signal_benchmark_test_1(const size_t call_count)
+{
+    float sps30[TRACE_LENGTH], scd30[TRACE_LENGTH];
+    float block[SIGNAL_BLOCK_SIZE];
+    float out[SIGNAL_OUTPUT_BLOCK_SIZE];
+    SignalChannel channel;
+    Timer timer;
+    volatile float sink = 0.0f;
+
+    Sps30Trace(sps30, TRACE_LENGTH);
+    Scd30Trace(scd30, TRACE_LENGTH);
+
+    /* Scalar path */
+    timer.start();
+    for (int n = 0; n < BENCHMARK_ITERATIONS; n++)
+    {
+        const float* trace = (n % 2) ? scd30 : sps30;
+        for (size_t i = 0; i < TRACE_LENGTH; i += SIGNAL_BLOCK_SIZE)
+        {
+            std::memcpy(block, &trace[i], sizeof(block));
+            channel.ProcessBlockScalar(block, out);
+            sink += out[0];
+        }
+    }
+    timer.stop();
+    auto scalar_us = timer.elapsed_time().count();
+
+    /* Configured path; CMSIS-DSP if signal-processing.use-cmsis-dsp is enabled */
+    channel.Reset();
+    timer.reset();
+    timer.start();
+    for (int n = 0; n < BENCHMARK_ITERATIONS; n++)
+    {
+        const float* trace = (n % 2) ? scd30 : sps30;
+        for (size_t i = 0; i < TRACE_LENGTH; i += SIGNAL_BLOCK_SIZE)
+        {
+            std::memcpy(block, &trace[i], sizeof(block));
+            channel.ProcessBlock(block, out);
+            sink += out[0];
+        }
+    }
+    timer.stop();
+    auto configured_us = timer.elapsed_time().count();
+
+    printf("SPS30/SCD30 traces x%d: scalar %lld us, %s %lld us\r\n", BENCHMARK_ITERATIONS, (long long)scalar_us,
+           MBED_CONF_SIGNAL_PROCESSING_USE_CMSIS_DSP ? "cmsis-dsp" : "scalar", (long long)configured_us);
+
+    TEST_ASSERT_TRUE(sink == sink);
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test constant stream in steady state", signal_steady_state_test_1),
+    Case("Test spike replaced by block median", signal_outlier_test_1),
+    Case("Test samples within threshold kept", signal_outlier_test_2),
+    Case("Test SPS30 trace spike rejection and smoothing", signal_sps30_trace_test_1),
+    Case("Test SCD30 trace ramp tracking", signal_scd30_trace_test_1),
+    Case("Test separate channel per measure point", signal_processor_test_1),
+    Case("Test scalar path matches configured path", signal_scalar_match_test_1),
+    Case("Benchmark scalar vs configured path on SPS30/SCD30 traces", signal_benchmark_test_1)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
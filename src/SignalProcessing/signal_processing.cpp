@@ -0,0 +1,303 @@
+/**
+ * @defgroup signal_processing Signal Processing
+ * @{
+ */
+
+#include <cmath>
+#include <cstring>
+#include "signal_processing.h"
+#include "mbed.h"
+#include "mbed_trace.h"
+
+#define TRACE_GROUP "SignalProcessing"
+
+#define SIGNAL_MAD_SCALE    1.4826f     // MAD to standard deviation for normally distributed samples
+
+/* 2nd order Butterworth low-pass, fc = 0.1 fs; {b0, b1, b2, a1, a2} with a1/a2 negated as expected by CMSIS-DSP */
+static const float biquad_coeffs[5 * SIGNAL_BIQUAD_STAGES] = {
+    0.067455274f, 0.134910548f, 0.067455274f, 1.142980503f, -0.412801598f
+};
+
+/* Hamming windowed sinc, fc = 0.125 fs, unity DC gain; symmetric so already in the time-reversed order of CMSIS-DSP */
+static const float fir_coeffs[SIGNAL_FIR_TAPS] = {
+    0.003560173f, 0.038083723f, 0.161031852f, 0.297324252f, 0.297324252f, 0.161031852f, 0.038083723f, 0.003560173f
+};
+
+/**
+ *  @brief  Cascade of direct form I biquads; same arithmetic as arm_biquad_cascade_df1_f32.
+ *  @author Lee Tze Han
+ *  @param  coeffs      {b0, b1, b2, a1, a2} per stage, a1/a2 negated
+ *  @param  num_stages  Number of 2nd order stages
+ *  @param  state       {x[n-1], x[n-2], y[n-1], y[n-2]} per stage
+ *  @param  in          Input samples
+ *  @param  out         Output samples; may alias in
+ *  @param  len         Number of samples
+ */
+void SignalBiquadDf1(const float* coeffs, size_t num_stages, float* state, const float* in, float* out, size_t len)
+{
+    const float* src = in;
+    for (size_t stage = 0; stage < num_stages; stage++)
+    {
+        const float* c = &coeffs[5 * stage];
+        float* s = &state[4 * stage];
+        float x1 = s[0], x2 = s[1], y1 = s[2], y2 = s[3];
+
+        for (size_t n = 0; n < len; n++)
+        {
+            float x0 = src[n];
+            float y0 = c[0] * x0 + c[1] * x1 + c[2] * x2 + c[3] * y1 + c[4] * y2;
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+            out[n] = y0;
+        }
+
+        s[0] = x1;
+        s[1] = x2;
+        s[2] = y1;
+        s[3] = y2;
+        src = out;
+    }
+}
+
+/**
+ *  @brief  FIR filter followed by decimation; same arithmetic as arm_fir_decimate_f32.
+ *  @author Lee Tze Han
+ *  @param  coeffs      Filter taps in time-reversed order
+ *  @param  num_taps    Number of taps
+ *  @param  factor      Decimation factor; must divide len
+ *  @param  state       Delay line of num_taps + len - 1 samples
+ *  @param  in          Input samples
+ *  @param  out         Output samples; holds len / factor samples
+ *  @param  len         Number of input samples
+ */
+void SignalFirDecimate(const float* coeffs, size_t num_taps, size_t factor, float* state, const float* in, float* out, size_t len)
+{
+    std::memcpy(&state[num_taps - 1], in, len * sizeof(float));
+
+    for (size_t i = 0; i < len / factor; i++)
+    {
+        const float* x = &state[i * factor];
+        float acc = 0.0f;
+        for (size_t k = 0; k < num_taps; k++)
+        {
+            acc += coeffs[k] * x[k];
+        }
+        out[i] = acc;
+    }
+
+    std::memmove(state, &state[len], (num_taps - 1) * sizeof(float));
+}
+
+/**
+ *  @brief  Insertion sort for the small blocks used by the Hampel filter.
+ *  @author Lee Tze Han
+ *  @param  values  Samples to sort in place
+ *  @param  len     Number of samples
+ */
+static void SortBlock(float* values, size_t len)
+{
+    for (size_t i = 1; i < len; i++)
+    {
+        float v = values[i];
+        size_t j = i;
+        while (j > 0 && values[j - 1] > v)
+        {
+            values[j] = values[j - 1];
+            j--;
+        }
+        values[j] = v;
+    }
+}
+
+/**
+ *  @brief  Median of a sorted block.
+ *  @author Lee Tze Han
+ *  @param  sorted  Sorted samples
+ *  @param  len     Number of samples
+ *  @return Median
+ */
+static float SortedMedian(const float* sorted, size_t len)
+{
+    return (len % 2) ? sorted[len / 2] : 0.5f * (sorted[len / 2 - 1] + sorted[len / 2]);
+}
+
+/**
+ *  @brief  Hampel filter: replaces samples further than threshold scaled MADs from the block median by the median.
+ *  @author Lee Tze Han
+ *  @param  block       Samples to filter in place
+ *  @param  len         Number of samples; at most SIGNAL_BLOCK_SIZE
+ *  @param  threshold   Rejection threshold in standard deviations
+ *  @return Number of samples replaced
+ */
+size_t SignalRejectOutliers(float* block, size_t len, float threshold)
+{
+    float scratch[SIGNAL_BLOCK_SIZE];
+    if (len == 0 || len > SIGNAL_BLOCK_SIZE)
+    {
+        return 0;
+    }
+
+    std::memcpy(scratch, block, len * sizeof(float));
+    SortBlock(scratch, len);
+    float median = SortedMedian(scratch, len);
+
+    for (size_t i = 0; i < len; i++)
+    {
+        scratch[i] = std::fabs(block[i] - median);
+    }
+    SortBlock(scratch, len);
+    float limit = threshold * SIGNAL_MAD_SCALE * SortedMedian(scratch, len);
+
+    size_t num_rejected = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (std::fabs(block[i] - median) > limit)
+        {
+            block[i] = median;
+            num_rejected++;
+        }
+    }
+
+    return num_rejected;
+}
+
+/**
+ *  @brief  Constructs a signal channel with empty filter state.
+ *  @author Lee Tze Han
+ */
+SignalChannel::SignalChannel()
+{
+#if MBED_CONF_SIGNAL_PROCESSING_USE_CMSIS_DSP
+    arm_biquad_cascade_df1_init_f32(&biquad_, SIGNAL_BIQUAD_STAGES, (float32_t*)biquad_coeffs, biquad_state_);
+    arm_fir_decimate_init_f32(&fir_, SIGNAL_FIR_TAPS, SIGNAL_DECIMATION, (float32_t*)fir_coeffs, fir_state_, SIGNAL_BLOCK_SIZE);
+#endif  // MBED_CONF_SIGNAL_PROCESSING_USE_CMSIS_DSP
+
+    Reset();
+}
+
+/**
+ *  @brief  Discards collected samples; filter state is re-seeded from the next sample.
+ *  @author Lee Tze Han
+ */
+void SignalChannel::Reset(void)
+{
+    fill_ = 0;
+    primed_ = false;
+    std::memset(biquad_state_, 0, sizeof(biquad_state_));
+    std::memset(fir_state_, 0, sizeof(fir_state_));
+}
+
+/**
+ *  @brief  Adds a sample to the current block and processes the block once it is full.
+ *  @author Lee Tze Han
+ *  @param  value   Raw sample
+ *  @param  out     Holds SIGNAL_OUTPUT_BLOCK_SIZE filtered samples
+ *  @return Number of filtered samples written to out; 0 while the block is being collected
+ */
+size_t SignalChannel::PushSample(float value, float* out)
+{
+    if (!primed_)
+    {
+        Prime(value);
+    }
+
+    block_[fill_++] = value;
+    if (fill_ < SIGNAL_BLOCK_SIZE)
+    {
+        return 0;
+    }
+
+    fill_ = 0;
+    ProcessBlock(block_, out);
+
+    return SIGNAL_OUTPUT_BLOCK_SIZE;
+}
+
+/**
+ *  @brief  Rejects outliers, smooths and decimates a block of SIGNAL_BLOCK_SIZE samples.
+ *  @author Lee Tze Han
+ *  @param  block   Raw samples; overwritten with the smoothed samples
+ *  @param  out     Holds SIGNAL_OUTPUT_BLOCK_SIZE filtered samples
+ */
+void SignalChannel::ProcessBlock(float* block, float* out)
+{
+#if MBED_CONF_SIGNAL_PROCESSING_USE_CMSIS_DSP
+    SignalRejectOutliers(block, SIGNAL_BLOCK_SIZE, MBED_CONF_SIGNAL_PROCESSING_OUTLIER_THRESHOLD);
+    arm_biquad_cascade_df1_f32(&biquad_, block, block, SIGNAL_BLOCK_SIZE);
+    arm_fir_decimate_f32(&fir_, block, out, SIGNAL_BLOCK_SIZE);
+#else
+    ProcessBlockScalar(block, out);
+#endif  // MBED_CONF_SIGNAL_PROCESSING_USE_CMSIS_DSP
+}
+
+/**
+ *  @brief  Portable implementation of ProcessBlock; shares filter state with the CMSIS-DSP path.
+ *  @author Lee Tze Han
+ *  @param  block   Raw samples; overwritten with the smoothed samples
+ *  @param  out     Holds SIGNAL_OUTPUT_BLOCK_SIZE filtered samples
+ */
+void SignalChannel::ProcessBlockScalar(float* block, float* out)
+{
+    SignalRejectOutliers(block, SIGNAL_BLOCK_SIZE, MBED_CONF_SIGNAL_PROCESSING_OUTLIER_THRESHOLD);
+    SignalBiquadDf1(biquad_coeffs, SIGNAL_BIQUAD_STAGES, biquad_state_, block, block, SIGNAL_BLOCK_SIZE);
+    SignalFirDecimate(fir_coeffs, SIGNAL_FIR_TAPS, SIGNAL_DECIMATION, fir_state_, block, out, SIGNAL_BLOCK_SIZE);
+}
+
+/**
+ *  @brief  Seeds the filter state with the steady-state response to value, so the output does not ramp up from zero.
+ *  @author Lee Tze Han
+ *  @param  value   First sample of the stream
+ */
+void SignalChannel::Prime(float value)
+{
+    for (size_t i = 0; i < 4 * SIGNAL_BIQUAD_STAGES; i++)
+    {
+        biquad_state_[i] = value;
+    }
+    for (size_t i = 0; i < SIGNAL_FIR_TAPS - 1; i++)
+    {
+        fir_state_[i] = value;
+    }
+    primed_ = true;
+}
+
+/**
+ *  @brief  Constructs a signal processor with no channels.
+ *  @author Lee Tze Han
+ */
+SignalProcessor::SignalProcessor()
+    : num_channels_(0)
+{
+}
+
+/**
+ *  @brief  Routes a sample to the channel of its measure point, allocating a free channel on first use.
+ *  @author Lee Tze Han
+ *  @param  measure_point_id    Measure point id with static lifetime
+ *  @param  value               Raw sample
+ *  @param  out                 Holds SIGNAL_OUTPUT_BLOCK_SIZE filtered samples
+ *  @return Number of filtered samples written to out; 0 while the block is being collected or if the channel table is full
+ */
+size_t SignalProcessor::PushSample(const char* measure_point_id, float value, float* out)
+{
+    for (size_t i = 0; i < num_channels_; i++)
+    {
+        if (ids_[i] == measure_point_id || std::strcmp(ids_[i], measure_point_id) == 0)
+        {
+            return channels_[i].PushSample(value, out);
+        }
+    }
+
+    if (num_channels_ >= SIGNAL_MAX_CHANNELS)
+    {
+        tr_warn("Signal channel table full, dropping %s", measure_point_id);
+        return 0;
+    }
+
+    ids_[num_channels_] = measure_point_id;
+    return channels_[num_channels_++].PushSample(value, out);
+}
+
+/** @}*/
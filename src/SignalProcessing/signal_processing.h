@@ -0,0 +1,108 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef SIGNAL_PROCESSING_H
+#define SIGNAL_PROCESSING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if MBED_CONF_SIGNAL_PROCESSING_USE_CMSIS_DSP
+#include "arm_math.h"
+#endif  // MBED_CONF_SIGNAL_PROCESSING_USE_CMSIS_DSP
+
+#ifndef MBED_CONF_SIGNAL_PROCESSING_OUTLIER_THRESHOLD
+#define MBED_CONF_SIGNAL_PROCESSING_OUTLIER_THRESHOLD   3.0
+#endif  // MBED_CONF_SIGNAL_PROCESSING_OUTLIER_THRESHOLD
+
+#define SIGNAL_BLOCK_SIZE           8       // samples per processing block
+#define SIGNAL_DECIMATION           4       // decimation factor; must divide SIGNAL_BLOCK_SIZE
+#define SIGNAL_OUTPUT_BLOCK_SIZE    (SIGNAL_BLOCK_SIZE / SIGNAL_DECIMATION)
+#define SIGNAL_BIQUAD_STAGES        1       // 2nd order sections in the IIR smoothing filter
+#define SIGNAL_FIR_TAPS             8       // taps of the anti-aliasing FIR filter
+#define SIGNAL_MAX_CHANNELS         8       // measure points tracked by SignalProcessor
+
+/* Portable scalar kernels; state and coefficient layout follows CMSIS-DSP so both paths are interchangeable */
+void SignalBiquadDf1(const float* coeffs, size_t num_stages, float* state, const float* in, float* out, size_t len);
+void SignalFirDecimate(const float* coeffs, size_t num_taps, size_t factor, float* state, const float* in, float* out, size_t len);
+size_t SignalRejectOutliers(float* block, size_t len, float threshold);
+
+/** SignalChannel class.
+ *  @brief  Block-based outlier rejection, IIR smoothing and FIR decimation of a single sensor stream
+ *
+ *  Samples are collected in a fixed block. When the block is full, outliers are replaced by the block median
+ *  (Hampel filter), the block is smoothed by a 2nd order Butterworth low-pass (fc = 0.1 fs) and decimated by
+ *  SIGNAL_DECIMATION. CMSIS-DSP is used when signal-processing.use-cmsis-dsp is enabled.
+ *
+ *  Example:
+ *  @code{.cpp}
+ *  #include "signal_processing.h"
+ *
+ *  int main() 
+ *  {
+ *      SignalChannel channel;
+ *      float out[SIGNAL_OUTPUT_BLOCK_SIZE];
+ *      for (int i = 0; i < SIGNAL_BLOCK_SIZE; i++)
+ *      {
+ *          size_t count = channel.PushSample(23.45f, out);
+ *      }
+ *  }
+ *  @endcode
+ */
+
+class SignalChannel
+{
+    public:
+        SignalChannel();
+
+        void Reset(void);
+        size_t PushSample(float value, float* out);
+        void ProcessBlock(float* block, float* out);
+        void ProcessBlockScalar(float* block, float* out);
+
+    private:
+        float block_[SIGNAL_BLOCK_SIZE];                                    /// samples of the block being collected
+        size_t fill_;                                                       /// number of samples in block_
+        bool primed_;                                                       /// filter state seeded from the first sample
+
+        float biquad_state_[4 * SIGNAL_BIQUAD_STAGES];                      /// {x[n-1], x[n-2], y[n-1], y[n-2]} per stage
+        float fir_state_[SIGNAL_FIR_TAPS + SIGNAL_BLOCK_SIZE - 1];          /// FIR delay line
+
+#if MBED_CONF_SIGNAL_PROCESSING_USE_CMSIS_DSP
+        arm_biquad_casd_df1_inst_f32 biquad_;
+        arm_fir_decimate_instance_f32 fir_;
+#endif  // MBED_CONF_SIGNAL_PROCESSING_USE_CMSIS_DSP
+
+        void Prime(float value);
+};
+
+/** SignalProcessor class.
+ *  @brief  Routes samples of each measure point to its own SignalChannel
+ */
+
+class SignalProcessor
+{
+    public:
+        SignalProcessor();
+
+        size_t PushSample(const char* measure_point_id, float value, float* out);
+
+    private:
+        const char* ids_[SIGNAL_MAX_CHANNELS];                              /// static measure point ids from sensor_reading_t
+        SignalChannel channels_[SIGNAL_MAX_CHANNELS];
+        size_t num_channels_;
+};
+
+#endif  // SIGNAL_PROCESSING_H
@@ -0,0 +1,127 @@
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "clock_discipline.h"
+
+using namespace utest::v1;
+
+#define HOUR_MS     (3600 * 1000ULL)
+
+// NTP time at a kernel time, for a kernel clock running 50 ppm slow; truncated to whole seconds as by NTPClient
+static int64_t ReferenceAt(uint64_t tick_ms, int64_t epoch_ms)
+{
+    int64_t reference_ms = epoch_ms + (int64_t)tick_ms + (int64_t)(tick_ms / 20000);
+    return reference_ms / 1000 * 1000 + CLOCK_NTP_RESOLUTION_MS / 2;
+}
+
+// Test that small offsets are slewed out without a jump or a step backwards, and large ones are stepped
+static control_t slew_test_1(const size_t call_count)
+{
+    ClockDiscipline clock(1800000, 86400000);
+    TEST_ASSERT_FALSE(clock.IsAnchored());
+    TEST_ASSERT_EQUAL_UINT64(0, clock.NextSync());
+
+    TEST_ASSERT_TRUE(clock.Sample(1600000000500LL, 1000));
+    TEST_ASSERT_TRUE(clock.IsSynced());
+    TEST_ASSERT_TRUE(clock.Now(1000) == 1600000000500LL);
+    TEST_ASSERT_EQUAL_UINT64(1000 + 1800000, clock.NextSync());
+
+    /* Clock found 1 s fast: slewed out at 500 ppm over 2000 s */
+    TEST_ASSERT_FALSE(clock.Sample(1600000010500LL - 1000, 11000));
+    TEST_ASSERT_TRUE(clock.GetLastOffset() == -1000);
+    int64_t previous_ms = clock.Now(11000);
+    for (uint64_t tick_ms = 11000; tick_ms <= 11000 + 2000000; tick_ms += 7)
+    {
+        int64_t now_ms = clock.Now(tick_ms);
+        TEST_ASSERT_TRUE(now_ms >= previous_ms);
+        previous_ms = now_ms;
+    }
+    TEST_ASSERT_TRUE(clock.Now(11000 + 2000000) == 1600000000500LL + 10000 + 2000000 - 1000);
+
+    /* Clock found 5 s slow: stepped */
+    int64_t reference_ms = clock.Now(3000000) + 5000;
+    TEST_ASSERT_TRUE(clock.Sample(reference_ms, 3000000));
+    TEST_ASSERT_TRUE(clock.Now(3000000) == reference_ms);
+    TEST_ASSERT_EQUAL_UINT32(1800000, clock.GetInterval());
+
+    return CaseNext;
+}
+
+// Test that the frequency error of the kernel clock is measured and corrected between syncs
+static control_t frequency_test_1(const size_t call_count)
+{
+    const int64_t epoch_ms = 1600000000000LL;
+    ClockDiscipline clock(1800000, 86400000);
+
+    uint64_t tick_ms = 0;
+    for (int i = 0; i < 12; i++)
+    {
+        clock.Sample(ReferenceAt(tick_ms, epoch_ms), tick_ms);
+        tick_ms = clock.NextSync();
+    }
+
+    /* 50 ppm, to the 1 s resolution of the samples over the span */
+    TEST_ASSERT_TRUE(clock.GetFrequencyPpb() > 35000);
+    TEST_ASSERT_TRUE(clock.GetFrequencyPpb() < 65000);
+
+    /* Sync interval grown to the maximum, and a day later the clock is still within the sample resolution */
+    TEST_ASSERT_EQUAL_UINT32(86400000, clock.GetInterval());
+    int64_t error_ms = clock.Now(tick_ms) - (epoch_ms + (int64_t)tick_ms + (int64_t)(tick_ms / 20000));
+    TEST_ASSERT_TRUE(error_ms < CLOCK_NTP_RESOLUTION_MS && error_ms > -CLOCK_NTP_RESOLUTION_MS);
+
+    return CaseNext;
+}
+
+// Test the sync interval after failed and unstable syncs
+static control_t interval_test_1(const size_t call_count)
+{
+    ClockDiscipline clock(1800000, 86400000);
+
+    /* Retried soon until the first sync */
+    clock.Anchor(1600000000000LL, 0);
+    clock.SampleFailed(1000);
+    TEST_ASSERT_EQUAL_UINT64(1000 + CLOCK_RETRY_MS, clock.NextSync());
+
+    /* First sample after an RTC anchor is slewed */
+    TEST_ASSERT_FALSE(clock.Sample(1600000031500LL, 31000));
+    TEST_ASSERT_EQUAL_UINT32(3600000, clock.GetInterval());
+    clock.Sample(clock.Now(31000 + 3600000), 31000 + 3600000);
+    TEST_ASSERT_EQUAL_UINT32(7200000, clock.GetInterval());
+
+    /* Offset beyond the NTP resolution halves the interval */
+    uint64_t tick_ms = 31000 + 3600000 + 7200000;
+    clock.Sample(clock.Now(tick_ms) + 1500, tick_ms);
+    TEST_ASSERT_EQUAL_UINT32(3600000, clock.GetInterval());
+
+    /* Failures after the first sync are retried at the minimum interval, without moving the clock */
+    int64_t before_ms = clock.Now(tick_ms + HOUR_MS);
+    clock.SampleFailed(tick_ms + HOUR_MS);
+    TEST_ASSERT_TRUE(clock.Now(tick_ms + HOUR_MS) == before_ms);
+    TEST_ASSERT_EQUAL_UINT64(tick_ms + HOUR_MS + 1800000, clock.NextSync());
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test slewing and stepping of offsets", slew_test_1),
+    Case("Test frequency correction", frequency_test_1),
+    Case("Test sync interval", interval_test_1)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -67,6 +67,46 @@ static control_t get_rtc_test(const size_t call_count)
   return CaseNext;
 }
 
+// Test for validity of rtc across a reset
+static control_t rtc_valid_test(const size_t call_count) 
+{
+    set_time(0);
+    TEST_ASSERT_FALSE(RtcIsValid());
+
+    set_time(1561519234);       // 2019-06-26, before this firmware
+    TEST_ASSERT_FALSE(RtcIsValid());
+
+    set_time(1600000000);
+    TEST_ASSERT_TRUE(RtcIsValid());
+
+    return CaseNext;
+}
+
+// Test for millisecond timestamps carried forward from the real-time clock
+static control_t epoch_ms_test(const size_t call_count) 
+{
+    set_time(1600000000);
+    SyncEpochToRtc();
+    int64_t start_ms = EpochMsNow();
+    TEST_ASSERT_TRUE(start_ms >= 1600000000000LL);
+    TEST_ASSERT_TRUE(start_ms < 1600000001000LL);
+
+    /* Sub-second resolution, and no read of the RTC */
+    set_time(0);
+    ThisThread::sleep_for(250ms);
+    int64_t elapsed_ms = EpochMsNow() - start_ms;
+    TEST_ASSERT_TRUE(elapsed_ms >= 250);
+    TEST_ASSERT_TRUE(elapsed_ms < 350);
+
+    /* Past 2038 */
+    set_time((time_t)4102444800LL);     // 2100-01-01T00:00:00Z
+    SyncEpochToRtc();
+    TEST_ASSERT_TRUE(EpochMsNow() >= 4102444800000LL);
+    TEST_ASSERT_EQUAL_STRING("4102444800", EpochMsNowToString().substr(0, 10).c_str());
+
+    return CaseNext;
+}
+
 // Test for time formatting
 static control_t format_time_test(const size_t call_count) 
 {
@@ -101,6 +141,32 @@ static control_t convert_raw_to_iso_time_test_2(const size_t call_count)
     return CaseNext;
 }
 
+// Test for formatting ISO8601 time with and without milliseconds, across days
+static control_t format_iso8601_test(const size_t call_count) 
+{
+    char buf[ISO8601_BUFFER_SIZE];
+
+    TEST_ASSERT_EQUAL_UINT32(24, FormatIso8601(buf, 1561519234567LL, true));
+    TEST_ASSERT_EQUAL_STRING("2019-06-26T03:20:34.567Z", buf);
+    TEST_ASSERT_EQUAL_UINT32(20, FormatIso8601(buf, 1561519234567LL, false));
+    TEST_ASSERT_EQUAL_STRING("2019-06-26T03:20:34Z", buf);
+
+    /* Leap day, and the cached date replaced at midnight */
+    FormatIso8601(buf, 1583020799999LL, true);
+    TEST_ASSERT_EQUAL_STRING("2020-02-29T23:59:59.999Z", buf);
+    FormatIso8601(buf, 1583020800000LL, true);
+    TEST_ASSERT_EQUAL_STRING("2020-03-01T00:00:00.000Z", buf);
+
+    FormatIso8601(buf, 0, true);
+    TEST_ASSERT_EQUAL_STRING("1970-01-01T00:00:00.000Z", buf);
+    FormatIso8601(buf, -1, true);
+    TEST_ASSERT_EQUAL_STRING("1969-12-31T23:59:59.999Z", buf);
+    FormatIso8601(buf, 4102444800000LL, false);
+    TEST_ASSERT_EQUAL_STRING("2100-01-01T00:00:00Z", buf);
+
+    return CaseNext;
+}
+
 utest::v1::status_t greentea_setup(const size_t number_of_cases) 
 {
     // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
@@ -114,9 +180,12 @@ Case cases[] =
 {
     Case("Check update real-time clock function", update_rtc_test),
     Case("Check get real-time clock function", get_rtc_test),
+    Case("Check real-time clock validity", rtc_valid_test),
+    Case("Check millisecond epoch time", epoch_ms_test),
     Case("Check format time function", format_time_test),
     Case("Check for converting raw to iso time - arbitrary time", convert_raw_to_iso_time_test_1),
-    Case("Check for converting raw to iso time - zero time", convert_raw_to_iso_time_test_2)
+    Case("Check for converting raw to iso time - zero time", convert_raw_to_iso_time_test_2),
+    Case("Check ISO8601 formatting with milliseconds", format_iso8601_test)
 };
 
 Specification specification(greentea_setup, cases);
@@ -0,0 +1,234 @@
+/**
+ * @defgroup clock_discipline Clock Discipline
+ * @{
+ */
+
+#include "clock_discipline.h"
+#include "mbed_trace.h"
+
+#define TRACE_GROUP  "ClockDiscipline"
+
+#define PPB_SCALE   1000000000LL
+
+/**
+ *  @brief  Starts unanchored, with a sync due at once.
+ *  @author Lee Tze Han
+ *  @param  min_interval_ms Shortest interval between syncs
+ *  @param  max_interval_ms Longest interval between syncs, reached while the clock is stable
+ */
+ClockDiscipline::ClockDiscipline(uint32_t min_interval_ms, uint32_t max_interval_ms)
+    : min_interval_ms_(min_interval_ms), max_interval_ms_(max_interval_ms)
+{
+    if (min_interval_ms_ == 0)
+    {
+        min_interval_ms_ = 1;
+    }
+    if (max_interval_ms_ < min_interval_ms_)
+    {
+        tr_warn("NTP interval max below min");
+        max_interval_ms_ = min_interval_ms_;
+    }
+    interval_ms_ = min_interval_ms_;
+}
+
+/**
+ *  @brief  Sets the clock to a time read elsewhere (e.g. the RTC), keeping the frequency correction.
+ *  @author Lee Tze Han
+ *  @param  epoch_ms    Milliseconds since 00:00:00 UTC, January 1, 1970 at tick_ms
+ *  @param  tick_ms     Kernel time
+ */
+void ClockDiscipline::Anchor(int64_t epoch_ms, uint64_t tick_ms)
+{
+    base_epoch_ms_ = epoch_ms;
+    base_tick_ms_ = tick_ms;
+    slew_ms_ = 0;
+    anchored_ = true;
+}
+
+/**
+ *  @brief  Disciplines the clock with an NTP sample, and schedules the next sync.
+ *  @author Lee Tze Han
+ *  @param  reference_ms    NTP time in milliseconds since 00:00:00 UTC, January 1, 1970
+ *  @param  tick_ms         Kernel time the sample was taken
+ *  @return true if the clock was stepped; false if the offset is being slewed out
+ */
+bool ClockDiscipline::Sample(int64_t reference_ms, uint64_t tick_ms)
+{
+    last_offset_ms_ = anchored_ ? reference_ms - Now(tick_ms) : 0;
+
+    const bool step = !anchored_ || (last_offset_ms_ > CLOCK_STEP_THRESHOLD_MS) || (last_offset_ms_ < -CLOCK_STEP_THRESHOLD_MS);
+    if (step)
+    {
+        Anchor(reference_ms, tick_ms);
+        interval_ms_ = min_interval_ms_;
+    }
+    else
+    {
+        Rebase(tick_ms);
+        slew_ms_ = last_offset_ms_;
+
+        /* Frequency error of the kernel clock over the whole span, so the 1 s resolution of the samples averages out */
+        const uint64_t span_ms = tick_ms - first_tick_ms_;
+        if (synced_ && (span_ms >= CLOCK_FREQUENCY_SPAN_MS))
+        {
+            const int64_t drift_ms = (reference_ms - first_reference_ms_) - (int64_t)span_ms;
+            const int64_t frequency_ppb = drift_ms * PPB_SCALE / (int64_t)span_ms;
+            if ((frequency_ppb <= CLOCK_MAX_FREQUENCY_PPM * 1000LL) && (frequency_ppb >= -CLOCK_MAX_FREQUENCY_PPM * 1000LL))
+            {
+                frequency_ppb_ = (int32_t)frequency_ppb;
+            }
+            else
+            {
+                tr_warn("Ignoring frequency error of %ld ppb", (long)frequency_ppb);
+            }
+        }
+
+        if ((last_offset_ms_ < CLOCK_NTP_RESOLUTION_MS) && (last_offset_ms_ > -CLOCK_NTP_RESOLUTION_MS))
+        {
+            interval_ms_ = (interval_ms_ > max_interval_ms_ / 2) ? max_interval_ms_ : interval_ms_ * 2;
+        }
+        else
+        {
+            interval_ms_ = (interval_ms_ / 2 < min_interval_ms_) ? min_interval_ms_ : interval_ms_ / 2;
+        }
+    }
+
+    /* A step restarts the frequency measurement */
+    if (step || !synced_)
+    {
+        first_reference_ms_ = reference_ms;
+        first_tick_ms_ = tick_ms;
+    }
+    synced_ = true;
+    next_sync_ms_ = tick_ms + interval_ms_;
+
+    return step;
+}
+
+/**
+ *  @brief  Records a failed NTP query; the sync is retried after CLOCK_RETRY_MS until one has succeeded, then after the minimum interval.
+ *  @author Lee Tze Han
+ *  @param  tick_ms Kernel time of the failure
+ */
+void ClockDiscipline::SampleFailed(uint64_t tick_ms)
+{
+    if (anchored_)
+    {
+        Rebase(tick_ms);
+    }
+    next_sync_ms_ = tick_ms + (synced_ ? min_interval_ms_ : CLOCK_RETRY_MS);
+}
+
+/**
+ *  @brief  Disciplined time; increases with the kernel clock, at a rate within CLOCK_MAX_FREQUENCY_PPM + CLOCK_SLEW_RATE_PPM of it.
+ *  @author Lee Tze Han
+ *  @param  tick_ms Kernel time
+ *  @return Milliseconds since 00:00:00 UTC, January 1, 1970
+ */
+int64_t ClockDiscipline::Now(uint64_t tick_ms) const
+{
+    const int64_t elapsed_ms = (tick_ms > base_tick_ms_) ? (int64_t)(tick_ms - base_tick_ms_) : 0;
+
+    /* Both corrections in units of 1e-9 ms, truncated once so that the result never decreases */
+    const int64_t slew_limit = elapsed_ms * CLOCK_SLEW_RATE_PPM * 1000LL;
+    int64_t slew = slew_ms_ * PPB_SCALE;
+    if (slew > slew_limit)
+    {
+        slew = slew_limit;
+    }
+    else if (slew < -slew_limit)
+    {
+        slew = -slew_limit;
+    }
+
+    return base_epoch_ms_ + elapsed_ms + (elapsed_ms * frequency_ppb_ + slew) / PPB_SCALE;
+}
+
+/**
+ *  @brief  Whether the clock has been set by Anchor() or an NTP sample.
+ *  @author Lee Tze Han
+ *  @return true once anchored
+ */
+bool ClockDiscipline::IsAnchored(void) const
+{
+    return anchored_;
+}
+
+/**
+ *  @brief  Whether an NTP sample has been taken.
+ *  @author Lee Tze Han
+ *  @return true after the first successful sync
+ */
+bool ClockDiscipline::IsSynced(void) const
+{
+    return synced_;
+}
+
+/**
+ *  @brief  Kernel time the next NTP sample is due.
+ *  @author Lee Tze Han
+ *  @return Kernel time in milliseconds; 0 if due at once
+ */
+uint64_t ClockDiscipline::NextSync(void) const
+{
+    return next_sync_ms_;
+}
+
+/**
+ *  @brief  Current interval between syncs.
+ *  @author Lee Tze Han
+ *  @return Interval in milliseconds
+ */
+uint32_t ClockDiscipline::GetInterval(void) const
+{
+    return interval_ms_;
+}
+
+/**
+ *  @brief  Correction applied to the rate of the kernel clock.
+ *  @author Lee Tze Han
+ *  @return Parts per billion; positive when the kernel clock runs slow
+ */
+int32_t ClockDiscipline::GetFrequencyPpb(void) const
+{
+    return frequency_ppb_;
+}
+
+/**
+ *  @brief  Offset of the clock measured by the last NTP sample.
+ *  @author Lee Tze Han
+ *  @return NTP time less clock time, in milliseconds
+ */
+int64_t ClockDiscipline::GetLastOffset(void) const
+{
+    return last_offset_ms_;
+}
+
+/**
+ *  @brief  Moves the base of the clock to tick_ms without changing its time, keeping the part of the slew still to be applied.
+ *  @author Lee Tze Han
+ *  @param  tick_ms Kernel time
+ */
+void ClockDiscipline::Rebase(uint64_t tick_ms)
+{
+    const int64_t epoch_ms = Now(tick_ms);
+    const int64_t elapsed_ms = (tick_ms > base_tick_ms_) ? (int64_t)(tick_ms - base_tick_ms_) : 0;
+    const int64_t slew_limit_ms = elapsed_ms * CLOCK_SLEW_RATE_PPM / 1000000LL;
+
+    if (slew_ms_ > slew_limit_ms)
+    {
+        slew_ms_ -= slew_limit_ms;
+    }
+    else if (slew_ms_ < -slew_limit_ms)
+    {
+        slew_ms_ += slew_limit_ms;
+    }
+    else
+    {
+        slew_ms_ = 0;
+    }
+    base_epoch_ms_ = epoch_ms;
+    base_tick_ms_ = tick_ms;
+}
+
+/** @}*/
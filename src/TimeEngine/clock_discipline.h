@@ -0,0 +1,107 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef CLOCK_DISCIPLINE_H
+#define CLOCK_DISCIPLINE_H
+
+#include <stdint.h>
+
+#define CLOCK_NTP_RESOLUTION_MS     1000        // NTPClient reports whole seconds
+#define CLOCK_NTP_TIMEOUT_MS        15000       // longest NTPClient query
+#define CLOCK_STEP_THRESHOLD_MS     2000        // larger offsets are stepped instead of slewed
+#define CLOCK_SLEW_RATE_PPM         500         // fastest rate at which an offset is slewed out
+#define CLOCK_MAX_FREQUENCY_PPM     500         // larger frequency errors are taken as bad samples
+#define CLOCK_FREQUENCY_SPAN_MS     (6 * 3600 * 1000ULL)    // shortest baseline of a frequency estimate, for 1 s samples
+#define CLOCK_RETRY_MS              30000       // retry of a failed sync, until the first succeeds
+
+/* Sync intervals of the ntp-interval-* settings in mbed_app.json */
+#define CLOCK_INTERVAL_MIN_MS       (MBED_CONF_APP_NTP_INTERVAL_MIN * 1000UL)
+#define CLOCK_INTERVAL_MAX_MS       (MBED_CONF_APP_NTP_INTERVAL_MAX * 1000UL)
+
+/** ClockDiscipline class.
+ *  @brief  Software clock on the kernel tick, disciplined by NTP samples
+ *
+ *  Epoch time is carried forward from an anchor on the kernel clock. Each NTP sample measures the
+ *  offset of the clock: offsets up to CLOCK_STEP_THRESHOLD_MS are slewed out at CLOCK_SLEW_RATE_PPM,
+ *  so the clock never jumps or runs backwards, and larger ones are stepped. The frequency error of the
+ *  kernel clock is measured over the span since the first sample (at least CLOCK_FREQUENCY_SPAN_MS,
+ *  as samples are whole seconds) and corrected between syncs. The sync interval doubles from
+ *  min_interval_ms up to max_interval_ms while offsets stay within the NTP resolution, and halves
+ *  when they do not.
+ *
+ *  Example:
+ *  @code{.cpp}
+ *  #include "clock_discipline.h"
+ *
+ *  int main()
+ *  {
+ *      ClockDiscipline clock(CLOCK_INTERVAL_MIN_MS, CLOCK_INTERVAL_MAX_MS);
+ *      clock.Anchor((int64_t)time(NULL) * 1000, Kernel::get_ms_count());
+ *
+ *      while (1)
+ *      {
+ *          uint64_t now_ms = Kernel::get_ms_count();
+ *          if (now_ms >= clock.NextSync())
+ *          {
+ *              time_t ntp_time = ntp.get_timestamp();
+ *              if (ntp_time < 0)
+ *                  clock.SampleFailed(now_ms);
+ *              else
+ *                  clock.Sample((int64_t)ntp_time * 1000, now_ms);
+ *          }
+ *          printf("%lld\n", clock.Now(Kernel::get_ms_count()));
+ *      }
+ *  }
+ *  @endcode
+ */
+
+class ClockDiscipline
+{
+    public:
+        ClockDiscipline(uint32_t min_interval_ms, uint32_t max_interval_ms);
+
+        void Anchor(int64_t epoch_ms, uint64_t tick_ms);
+        bool Sample(int64_t reference_ms, uint64_t tick_ms);
+        void SampleFailed(uint64_t tick_ms);
+
+        int64_t Now(uint64_t tick_ms) const;
+        bool IsAnchored(void) const;
+        bool IsSynced(void) const;
+        uint64_t NextSync(void) const;
+        uint32_t GetInterval(void) const;
+        int32_t GetFrequencyPpb(void) const;
+        int64_t GetLastOffset(void) const;
+
+    private:
+        void Rebase(uint64_t tick_ms);
+
+        uint32_t min_interval_ms_;
+        uint32_t max_interval_ms_;
+        uint32_t interval_ms_;                                                              /// current sync interval
+
+        bool anchored_ = false;                                                             /// base_epoch_ms_ is valid
+        bool synced_ = false;                                                               /// an NTP sample has been taken
+        int64_t base_epoch_ms_ = 0;                                                         /// epoch time at base_tick_ms_
+        uint64_t base_tick_ms_ = 0;                                                         /// kernel time of the last rebase
+        int64_t slew_ms_ = 0;                                                               /// offset being slewed out since base_tick_ms_
+        int32_t frequency_ppb_ = 0;                                                         /// correction of the kernel clock rate
+
+        int64_t first_reference_ms_ = 0;                                                    /// NTP time of the first sample since the last step
+        uint64_t first_tick_ms_ = 0;                                                        /// kernel time of that sample
+        int64_t last_offset_ms_ = 0;                                                        /// offset measured by the last sample
+        uint64_t next_sync_ms_ = 0;                                                         /// 0: at once
+};
+
+#endif  // CLOCK_DISCIPLINE_H
@@ -3,12 +3,25 @@
  * @{
  */
 
+#include "mbed.h"
 #include "time_engine.h"
 #include "mbed_trace.h"
 #include "conversions.h"
+#include "clock_discipline.h"
 
 #define TRACE_GROUP  "TimeEngine"
 
+#define RTC_VALID_EPOCH     1577836800      // 2020-01-01T00:00:00Z; earlier than any build of this firmware
+
+#define MS_PER_DAY          86400000LL
+
+/* Date of the day formatted last; times within the same day only format the time of day */
+static int64_t cached_day = INT64_MIN;
+static char cached_date[10];                // "YYYY-MM-DD"
+
+/* Epoch time is carried forward on the kernel clock, so timestamps do not read the RTC; updated in critical sections for concurrent readers */
+static ClockDiscipline epoch_clock(CLOCK_INTERVAL_MIN_MS, CLOCK_INTERVAL_MAX_MS);
+
 /**
  *  @brief  Formats the time component by appending a leading zero if the input string has less than two characters.
  *  @author Lau Lee Hong
@@ -26,66 +39,229 @@ std::string FormatTime(std::string time_component)
 }
 
 /**
- *  @brief  Updates the onboard Real-time Clock.
+ *  @brief  Updates the onboard Real-time Clock, and disciplines EpochMsNow() with the NTP time.
  *  @author Lau Lee Hong, Lee Tze Han
  *  @param  ntp Address of the Network Time Protocol client object
  *  @return success(1) / failure (0)
  */
 bool UpdateRtc(NTPClient& ntp)
 {
-    time_t raw_time = ntp.get_timestamp();
+    time_t raw_time = ntp.get_timestamp(CLOCK_NTP_TIMEOUT_MS);
     
     /* NTPClient returns a negative error code if unsuccessful */
     if (raw_time < 0)
     {
-        tr_warn("NTP update unsuccessful (rc = %d)", raw_time);
+        tr_warn("NTP update unsuccessful (rc = %d)", (int)raw_time);
+        core_util_critical_section_enter();
+        epoch_clock.SampleFailed(Kernel::get_ms_count());
+        core_util_critical_section_exit();
         return false;
     }
     else
     {
         set_time(raw_time);
+
+        /* Whole seconds: the middle of the second is the best estimate */
+        core_util_critical_section_enter();
+        bool stepped = epoch_clock.Sample((int64_t)raw_time * 1000 + CLOCK_NTP_RESOLUTION_MS / 2, Kernel::get_ms_count());
+        const int64_t offset_ms = epoch_clock.GetLastOffset();
+        const int32_t frequency_ppb = epoch_clock.GetFrequencyPpb();
+        const uint32_t interval_ms = epoch_clock.GetInterval();
+        core_util_critical_section_exit();
+
+        tr_info("Clock %s by %ld ms; frequency correction %ld ppb, next sync in %lu s", stepped ? "stepped" : "slewing",
+                (long)offset_ms, (long)frequency_ppb, (unsigned long)(interval_ms / 1000));
         return true;
     }
 }
 
+/**
+ *  @brief  Checks whether the onboard Real-time Clock has been set, e.g. by NTP before a reset.
+ *  @author Lee Tze Han
+ *  @return true if the RTC holds a plausible time; false after a cold boot
+ */
+bool RtcIsValid(void)
+{
+    return time(NULL) >= RTC_VALID_EPOCH;
+}
+
 /**
  *  @brief  Current raw time (in seconds) with reference to the onboard Real-time Clock.
  *  @author Lau Lee Hong
  *  @return Seconds elapsed since 00:00:00 UTC, January 1, 1970
  */
-int RawRtcTimeNow(void)
+time_t RawRtcTimeNow(void)
 {
     time_t raw_rtc_time = time(NULL);
     
     return raw_rtc_time;
 }
 
+/**
+ *  @brief  Re-anchors EpochMsNow() on the onboard Real-time Clock, after it has been set other than by UpdateRtc().
+ *  @author Lee Tze Han
+ */
+void SyncEpochToRtc(void)
+{
+    const time_t raw_time = time(NULL);
+
+    core_util_critical_section_enter();
+    epoch_clock.Anchor((int64_t)raw_time * 1000, Kernel::get_ms_count());
+    core_util_critical_section_exit();
+}
+
+/**
+ *  @brief  Current time in milliseconds, carried forward on the kernel clock and disciplined by UpdateRtc().
+ *          The RTC is only read for the first anchor. Offsets found by NTP are slewed out, and only large ones are stepped.
+ *  @author Lee Tze Han
+ *  @return Milliseconds elapsed since 00:00:00 UTC, January 1, 1970
+ */
+int64_t EpochMsNow(void)
+{
+    core_util_critical_section_enter();
+    const bool anchored = epoch_clock.IsAnchored();
+    core_util_critical_section_exit();
+    if (!anchored)
+    {
+        SyncEpochToRtc();
+    }
+
+    core_util_critical_section_enter();
+    const int64_t epoch_ms = epoch_clock.Now(Kernel::get_ms_count());
+    core_util_critical_section_exit();
+
+    return epoch_ms;
+}
+
+/**
+ *  @brief  Kernel time the next UpdateRtc() is due; the interval lengthens while the clock keeps time.
+ *  @author Lee Tze Han
+ *  @return Kernel time in milliseconds; 0 if due at once
+ */
+uint64_t NextClockSync(void)
+{
+    core_util_critical_section_enter();
+    const uint64_t next_sync_ms = epoch_clock.NextSync();
+    core_util_critical_section_exit();
+
+    return next_sync_ms;
+}
+
+/**
+ *  @brief  Current time in milliseconds as a decimal string, as used by DECADA request signatures.
+ *  @author Lee Tze Han
+ *  @return Milliseconds elapsed since 00:00:00 UTC, January 1, 1970
+ */
+std::string EpochMsNowToString(void)
+{
+    char epoch_ms[INT_TO_CHAR_BUFFER_SIZE];
+
+    return IntToChar(epoch_ms, EpochMsNow());
+}
+
 /**
  *  @brief  Converts raw time to ISO8601-formatted time.
- *  @author Lau Lee Hong
+ *  @author Lau Lee Hong, Lee Tze Han
  *  @param raw_time Seconds elapsed since 00:00:00 UTC, January 1, 1970
  *  @return Current ISO8601-formatted time with reference to the onboard Real-time Clock
  */
 std::string ConvertRawTimeToIso8601Time(time_t raw_time)
 {
-    struct tm *ptm;
-        
-    ptm = localtime(&raw_time);
-    std::string year = IntToString(ptm->tm_year + 1900);
-    std::string month = IntToString(ptm->tm_mon + 1);
-    month = FormatTime(month);
-    std::string day = IntToString(ptm->tm_mday);
-    day = FormatTime(day);
-    std::string hour = IntToString(ptm->tm_hour);
-    hour = FormatTime(hour);
-    std::string min = IntToString(ptm->tm_min);
-    min = FormatTime(min);
-    std::string sec = IntToString(ptm->tm_sec);
-    sec = FormatTime(sec);
-
-    std::string iso8601_timestamp_now = year + "-" + month + "-" + day + 'T' + hour + ":" + min + ":" + sec + "Z";
+    char iso8601_timestamp[ISO8601_BUFFER_SIZE];
+    size_t length = FormatIso8601(iso8601_timestamp, (int64_t)raw_time * 1000, false);
     
-    return iso8601_timestamp_now;
+    return std::string(iso8601_timestamp, length);
+}
+
+/**
+ *  @brief  Writes a zero-padded decimal number of a fixed width.
+ *  @author Lee Tze Han
+ *  @param  str     Output of width characters, not terminated
+ *  @param  v       Value, less than 10^width
+ *  @param  width   Number of digits
+ */
+static void WriteDigits(char* str, uint32_t v, int width)
+{
+    for (int i = width - 1; i >= 0; i--)
+    {
+        str[i] = '0' + (v % 10);
+        v /= 10;
+    }
+}
+
+/**
+ *  @brief  Writes the UTC date of a day as YYYY-MM-DD, in the proleptic Gregorian calendar; replaces localtime(), which is not reentrant.
+ *  @author Lee Tze Han
+ *  @param  str Output of 10 characters, not terminated
+ *  @param  day Days since January 1, 1970; years 0000 to 9999
+ */
+static void WriteDate(char* str, int64_t day)
+{
+    /* Days since March 1, 0000, split into 400-year eras so that leap days fall at the end of each year */
+    day += 719468;
+    const int64_t era = ((day >= 0) ? day : day - 146096) / 146097;
+    const uint32_t day_of_era = (uint32_t)(day - era * 146097);
+    const uint32_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const uint32_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const uint32_t month_from_march = (5 * day_of_year + 2) / 153;
+    const uint32_t day_of_month = day_of_year - (153 * month_from_march + 2) / 5 + 1;
+    const uint32_t month = (month_from_march < 10) ? month_from_march + 3 : month_from_march - 9;
+    const int64_t year = (int64_t)year_of_era + era * 400 + ((month <= 2) ? 1 : 0);
+
+    WriteDigits(str, (uint32_t)year, 4);
+    str[4] = '-';
+    WriteDigits(str + 5, month, 2);
+    str[7] = '-';
+    WriteDigits(str + 8, day_of_month, 2);
+}
+
+/**
+ *  @brief  Writes a UTC time as YYYY-MM-DDTHH:MM:SSZ, or YYYY-MM-DDTHH:MM:SS.mmmZ, without allocating.
+ *          The date is cached and only recomputed when the day changes; safe to call from any thread.
+ *  @author Lee Tze Han
+ *  @param  str             Buffer of at least ISO8601_BUFFER_SIZE characters to store the null-terminated result
+ *  @param  epoch_ms        Milliseconds elapsed since 00:00:00 UTC, January 1, 1970
+ *  @param  milliseconds    Whether to write the milliseconds
+ *  @return Length of the result
+ */
+size_t FormatIso8601(char* str, int64_t epoch_ms, bool milliseconds)
+{
+    int64_t day = epoch_ms / MS_PER_DAY;
+    int64_t ms_of_day = epoch_ms % MS_PER_DAY;
+    if (ms_of_day < 0)
+    {
+        ms_of_day += MS_PER_DAY;
+        day--;
+    }
+
+    core_util_critical_section_enter();
+    if (day != cached_day)
+    {
+        WriteDate(cached_date, day);
+        cached_day = day;
+    }
+    std::memcpy(str, cached_date, sizeof(cached_date));
+    core_util_critical_section_exit();
+
+    const uint32_t ms = (uint32_t)ms_of_day;
+    str[10] = 'T';
+    WriteDigits(str + 11, ms / 3600000, 2);
+    str[13] = ':';
+    WriteDigits(str + 14, ms / 60000 % 60, 2);
+    str[16] = ':';
+    WriteDigits(str + 17, ms / 1000 % 60, 2);
+
+    size_t length = 19;
+    if (milliseconds)
+    {
+        str[length++] = '.';
+        WriteDigits(str + length, ms % 1000, 3);
+        length += 3;
+    }
+    str[length++] = 'Z';
+    str[length] = '\0';
+
+    return length;
 }
 
 /** @}*/
\ No newline at end of file
@@ -16,13 +16,23 @@
 #ifndef TIME_ENGINE_H
 #define TIME_ENGINE_H
 
+#include <stdint.h>
 #include <string>
 #include <time.h>
 #include "NTPClient.h"
 
+/* "YYYY-MM-DDTHH:MM:SS.mmmZ" and terminator */
+#define ISO8601_BUFFER_SIZE 25
+
 std::string FormatTime(std::string time_component);
 bool UpdateRtc(NTPClient& ntp);
-int RawRtcTimeNow(void);
+bool RtcIsValid(void);
+time_t RawRtcTimeNow(void);
+void SyncEpochToRtc(void);
+int64_t EpochMsNow(void);
+uint64_t NextClockSync(void);
+std::string EpochMsNowToString(void);
 std::string ConvertRawTimeToIso8601Time(time_t raw_time);
+size_t FormatIso8601(char* str, int64_t epoch_ms, bool milliseconds);
 
 #endif //TIME_ENGINE_H
\ No newline at end of file
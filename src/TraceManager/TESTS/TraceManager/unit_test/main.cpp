@@ -56,6 +56,75 @@ static control_t create_decada_response_test_3(const size_t call_count)
     return CaseNext;
 }
 
+// Test that responses are written into their mail slot as CreateDecadaResponse() writes them, without holding up the caller
+static control_t service_response_test_1(const size_t call_count)
+{
+    const uint64_t start_ms = Kernel::get_ms_count();
+    DecadaServiceResponse(PARAM_SENSOR_POLL_RATE, "abc", POLL_RATE_UPDATE);
+    DecadaServiceResponse(PARAM_AGGREGATION_WINDOW, "q\"1", AGGREGATION_WINDOW_UPDATE);
+    DecadaServiceResponse(PARAM_SENSOR_POLL_RATE, "xyz", POLL_RATE_UPDATE, "read=12/40");
+    TEST_ASSERT_TRUE(Kernel::get_ms_count() - start_ms < 50);
+
+    const struct {
+        ControlParam param;
+        std::string expected;
+    } responses[] =
+    {
+        {PARAM_SENSOR_POLL_RATE, CreateDecadaResponse(trace_name[POLL_RATE_UPDATE], "abc")},
+        {PARAM_AGGREGATION_WINDOW, CreateDecadaResponse(trace_name[AGGREGATION_WINDOW_UPDATE], "q\"1")},
+        {PARAM_SENSOR_POLL_RATE, CreateDecadaResponse(trace_name[POLL_RATE_UPDATE], "xyz", "read=12/40")}
+    };
+    for (const auto& response : responses)
+    {
+        service_response_mail_t *service_response_mail = service_response_mail_box.try_get();
+        TEST_ASSERT_NOT_NULL(service_response_mail);
+        TEST_ASSERT_EQUAL(response.param, service_response_mail->param);
+        TEST_ASSERT_EQUAL_UINT32(response.expected.size(), service_response_mail->length);
+        TEST_ASSERT_EQUAL_STRING(response.expected.c_str(), service_response_mail->response);
+        service_response_mail_box.free(service_response_mail);
+    }
+    TEST_ASSERT_TRUE(service_response_mail_box.empty());
+
+    return CaseNext;
+}
+
+// Test that responses are dropped, not waited on, while the mail pool is full
+static control_t service_response_test_2(const size_t call_count)
+{
+    for (int i = 0; i < SERVICE_RESPONSE_POOL_SIZE + 1; i++)
+    {
+        DecadaServiceResponse(PARAM_SENSOR_POLL_RATE, "abc", POLL_RATE_UPDATE);
+    }
+
+    int count = 0;
+    service_response_mail_t *service_response_mail;
+    while ((service_response_mail = service_response_mail_box.try_get()) != NULL)
+    {
+        service_response_mail_box.free(service_response_mail);
+        count++;
+    }
+    TEST_ASSERT_EQUAL_INT(SERVICE_RESPONSE_POOL_SIZE, count);
+
+    return CaseNext;
+}
+
+// Test the reply to a refused service request, carrying the whole message id
+static control_t service_error_test(const size_t call_count)
+{
+    const std::string msg_id(CONTROL_MSG_ID_SIZE + 8, '7');
+    DecadaServiceError(PARAM_AGGREGATION_WINDOW, msg_id.c_str(), 400, "message id too long");
+
+    const std::string expected = "{\"code\":400,\"data\":{},\"id\":\"" + msg_id + "\",\"message\":\"message id too long\"}";
+    service_response_mail_t *service_response_mail = service_response_mail_box.try_get();
+    TEST_ASSERT_NOT_NULL(service_response_mail);
+    TEST_ASSERT_EQUAL(PARAM_AGGREGATION_WINDOW, service_response_mail->param);
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), service_response_mail->length);
+    TEST_ASSERT_EQUAL_STRING(expected.c_str(), service_response_mail->response);
+    service_response_mail_box.free(service_response_mail);
+
+    return CaseNext;
+}
+
 utest::v1::status_t greentea_setup(const size_t number_of_cases) 
 {
     // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
@@ -69,7 +138,10 @@ Case cases[] =
 {
     Case("Test decada service response message structure using raw string", create_decada_response_test_1),
     Case("Test decada service response message structure using x-macro", create_decada_response_test_2),
-    Case("Test decada service response message for c++ whitespace characters", create_decada_response_test_3)
+    Case("Test decada service response message for c++ whitespace characters", create_decada_response_test_3),
+    Case("Test service response mail from templates", service_response_test_1),
+    Case("Test service response pool exhaustion", service_response_test_2),
+    Case("Test service error reply", service_error_test)
 };
 
 Specification specification(greentea_setup, cases);
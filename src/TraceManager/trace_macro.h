@@ -20,12 +20,17 @@
 \
 \
 /* Sensor Thread*/ \
-X(POLL_RATE_UPDATE, "poll_rate_updated")
+X(POLL_RATE_UPDATE, "poll_rate_updated") \
+/* Behavior Coordinator Thread*/ \
+X(AGGREGATION_WINDOW_UPDATE, "aggregation_window_updated") \
+/* Event Manager Thread*/ \
+X(LATENCY_TRACE_SUMMARY, "latency_trace")
 /* --------------------------------------- */
 #define X(code, value) code,
 enum Trace : size_t
 {
     TRACE
+    TRACE_COUNT
 };
 #undef X
 
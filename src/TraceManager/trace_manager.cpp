@@ -3,72 +3,204 @@
  * @{
  */
 
+#include <cstring>
 #include "trace_manager.h"
 #include "mbed.h"
 #include "mbed_trace.h"
 #include "global_params.h"
-#include "json.h"
+#include "json_stream.h"
 #include "conversions.h"
 #include "time_engine.h"
 #include "trace_macro.h"
+#include "diagnostics.h"
 
 #define TRACE_GROUP "TraceManager"
 
+#define RESPONSE_TEMPLATE_SIZE  96      // longest response up to the message id, terminator included
+
+typedef struct {
+    char head[RESPONSE_TEMPLATE_SIZE];      /// {"code":200,"data":{"<trace name>":"true"},"id":
+    size_t length;                          /// 0 if the trace name does not fit
+} response_template_t;
+
+/**
+ *  @brief  Writes a service response up to its message id.
+ *  @author Lee Tze Han
+ *  @param  writer  Destination, at the start of the response
+ *  @param  msg     Trace message
+ *  @param  value   Value reported for msg
+ */
+static void WriteResponseHead(JsonWriter& writer, const char* msg, const char* value)
+{
+    /* Members in the order Json::FastWriter sorts them */
+    writer.BeginObject();
+    writer.Key("code");
+    writer.Int(200);
+    writer.Key("data");
+    writer.BeginObject();
+    writer.Key(msg);
+    writer.String(value);
+    writer.EndObject();
+    writer.Key("id");
+}
+
+/**
+ *  @brief  Serialises the response of every trace message reporting "true", leaving out the message id.
+ *  @author Lee Tze Han
+ *  @return Templates, indexed by Trace
+ */
+static const response_template_t* BuildResponseTemplates(void)
+{
+    static response_template_t templates[TRACE_COUNT];
+
+    for (size_t i = 0; i < TRACE_COUNT; i++)
+    {
+        JsonWriter writer(templates[i].head, sizeof(templates[i].head));
+        WriteResponseHead(writer, trace_name[i], "true");
+        templates[i].length = writer.Ok() ? writer.Length() : 0;
+    }
+
+    return templates;
+}
+
+/* Built during static initialisation, before any thread answers a service */
+static const response_template_t* const response_templates = BuildResponseTemplates();
+
+/**
+ *  @brief  Hands a written service response to CommunicationsThread.
+ *  @author Lee Tze Han
+ *  @param  service_response_mail   Slot holding the response
+ *  @param  param                   Service parameter answered
+ *  @param  length                  Length of the response
+ */
+static void PutServiceResponse(service_response_mail_t* service_response_mail, ControlParam param, size_t length)
+{
+    service_response_mail->param = param;
+    service_response_mail->length = length;
+    service_response_mail_box.put(service_response_mail);
+    DiagnosticsMailPut(DIAG_MAIL_SERVICE_RESPONSE);
+    event_flags.set(FLAG_WAKE_COMMS);
+}
+
 /**
  *  @brief  Create and populate json; Used for trace messages in response to a control command with msg_id issued from DECADAcloud.
  *  @author Yap Zi Qi
  *  @param  msg             Trace message (predefined X-Macros in trace_macro.h)
  *  @param  msg_id          Message id from DECADAcloud control command 
+ *  @param  value           Value reported for msg
  *  @return String of decada-compliant json packet
  */
-std::string CreateDecadaResponse(std::string msg, std::string msg_id)
+std::string CreateDecadaResponse(std::string msg, std::string msg_id, std::string value)
 {
-    Json::Value details;
-    details[msg] = "true";
-    
-    Json::Value message_content;
-    message_content["id"] = msg_id;
-    message_content["code"] = 200;
-    message_content["data"] = details;
-    
-    Json::FastWriter fast_writer;
-    std::string decada_message = fast_writer.write(message_content);
-    decada_message.erase(std::remove(decada_message.begin(), decada_message.end(), '\n'), decada_message.end());
-    
-    return decada_message; 
+    char buffer[SERVICE_RESPONSE_SIZE];
+
+    JsonWriter writer(buffer, sizeof(buffer));
+    WriteResponseHead(writer, msg.c_str(), value.c_str());
+    writer.String(msg_id);
+    writer.EndObject();
+
+    if (!writer.Ok())
+    {
+        tr_err("Response to %s does not fit in %d bytes", msg_id.c_str(), SERVICE_RESPONSE_SIZE);
+    }
+
+    return std::string(buffer, writer.Length());
 }
 
 /**
  *  @brief  Sends service response, pegged with its identifier and id, to CommunicationsThread. Used for response message to a service request from DECADAcloud with msg_id issued from endpoint.
- *  @author Yap Zi Qi
- *  @param  service_id      DECADAcloud Service Identifier for service response topic
+ *  @details Responses reporting "true" are copied from a template with only the message id written; the response is
+ *           dropped if the mail pool is full, rather than holding up the calling thread.
+ *  @author Yap Zi Qi, Lee Tze Han
+ *  @param  param           Service parameter answered, whose identifier names the response topic
  *  @param  msg_id          Message Id of the service request from DECADAcloud
- *  @param  msg             Trace message (predefined X-Macros in trace_macro.h)
+ *  @param  trace           Trace message (predefined X-Macros in trace_macro.h)
+ *  @param  value           Value reported for the trace message
  * 
  *  Example:
  *  @code{.cpp}
- *  service_id = "service1"
  *  msg_id = "q1w2e3r4r5";
- *  DecadaServiceResponse(service_id, msg_id, trace_name[SERVICE1]);
+ *  DecadaServiceResponse(PARAM_SENSOR_POLL_RATE, msg_id, POLL_RATE_UPDATE);
  *  @endcode
  */
-void DecadaServiceResponse(std::string service_id, std::string msg_id, std::string msg)
+void DecadaServiceResponse(ControlParam param, const char* msg_id, Trace trace, const char* value)
 {
-    std::string snon = CreateDecadaResponse(msg, msg_id);
-    service_response_mail_t *service_response_mail = service_response_mail_box.try_calloc();
-    while (service_response_mail == NULL)
+    service_response_mail_t *service_response_mail = service_response_mail_box.try_alloc();
+    if (service_response_mail == NULL)
     {
-        service_response_mail = service_response_mail_box.try_calloc();
-        tr_warn("Memory full. NULL pointer allocated");
-        ThisThread::sleep_for(500ms); 
+        tr_warn("Service response pool full; dropped response to %s", msg_id);
+        return;
+    }
+
+    char* response = service_response_mail->response;
+    const response_template_t& response_template = response_templates[trace];
+    size_t length = 0;
+    bool ok = false;
+    if ((response_template.length > 0) && (strcmp(value, "true") == 0))
+    {
+        memcpy(response, response_template.head, response_template.length);
+        JsonWriter writer(response + response_template.length, SERVICE_RESPONSE_SIZE - response_template.length);
+        writer.String(msg_id);
+        writer.EndObject();
+        length = response_template.length + writer.Length();
+        ok = writer.Ok();
+    }
+    else
+    {
+        JsonWriter writer(response, SERVICE_RESPONSE_SIZE);
+        WriteResponseHead(writer, trace_name[trace], value);
+        writer.String(msg_id);
+        writer.EndObject();
+        length = writer.Length();
+        ok = writer.Ok();
+    }
+    if (!ok)
+    {
+        tr_err("Response to %s does not fit in %d bytes", msg_id, SERVICE_RESPONSE_SIZE);
+        service_response_mail_box.free(service_response_mail);
+        return;
+    }
+
+    PutServiceResponse(service_response_mail, param, length);
+}
+
+/**
+ *  @brief  Sends the reply to a service request that was not carried out, to CommunicationsThread.
+ *  @author Lee Tze Han
+ *  @param  param           Service parameter requested, whose identifier names the response topic
+ *  @param  msg_id          Message Id of the service request from DECADAcloud
+ *  @param  code            Error code reported in place of 200
+ *  @param  message         Reason the request was refused
+ */
+void DecadaServiceError(ControlParam param, const char* msg_id, int code, const char* message)
+{
+    service_response_mail_t *service_response_mail = service_response_mail_box.try_alloc();
+    if (service_response_mail == NULL)
+    {
+        tr_warn("Service response pool full; dropped error reply to %s", msg_id);
+        return;
+    }
+
+    JsonWriter writer(service_response_mail->response, SERVICE_RESPONSE_SIZE);
+    writer.BeginObject();
+    writer.Key("code");
+    writer.Int(code);
+    writer.Key("data");
+    writer.BeginObject();
+    writer.EndObject();
+    writer.Key("id");
+    writer.String(msg_id);
+    writer.Key("message");
+    writer.String(message);
+    writer.EndObject();
+    if (!writer.Ok())
+    {
+        tr_err("Error reply to %s does not fit in %d bytes", msg_id, SERVICE_RESPONSE_SIZE);
+        service_response_mail_box.free(service_response_mail);
+        return;
     }
-    
-    service_response_mail->response = StringToChar(snon);
-    service_response_mail->service_id = StringToChar(service_id);
-    service_response_mail_box.put(service_response_mail);
 
-    ThisThread::sleep_for(100ms);
-    return;
+    PutServiceResponse(service_response_mail, param, writer.Length());
 }
 
 /** @}*/
\ No newline at end of file
@@ -17,8 +17,11 @@
 #define TRACE_MANAGER_H
 
 #include <string>
+#include "param_control.h"
+#include "trace_macro.h"
 
-std::string CreateDecadaResponse(std::string msg, std::string);
-void DecadaServiceResponse(std::string trace_level, std::string msg, std::string msg_id);
+std::string CreateDecadaResponse(std::string msg, std::string, std::string value = "true");
+void DecadaServiceResponse(ControlParam param, const char* msg_id, Trace trace, const char* value = "true");
+void DecadaServiceError(ControlParam param, const char* msg_id, int code, const char* message);
 
 #endif  // TRACE_MANAGER_H
\ No newline at end of file
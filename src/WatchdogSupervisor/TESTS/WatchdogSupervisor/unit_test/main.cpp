@@ -0,0 +1,95 @@
+#include "mbed.h"
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "watchdog_supervisor.h"
+
+using namespace utest::v1;
+
+static Thread idle_thread;
+static Thread steady_thread;
+static Thread long_op_thread;
+static uint64_t long_op_start_ms;      // bounds of the heartbeat of long_op_thread
+static uint64_t long_op_end_ms;
+
+static void steady_main(void)
+{
+    SupervisorHeartbeat();
+}
+
+static void long_op_main(void)
+{
+    SupervisorHeartbeatWithin(2000);
+}
+
+// Test that threads are supervised from their first heartbeat, and pass while on time
+static control_t supervisor_check_test_1(const size_t call_count)
+{
+    SupervisorRegisterThread(&idle_thread, "idle", 100);
+    SupervisorRegisterThread(&steady_thread, "steady", 60000);
+    SupervisorRegisterThread(&long_op_thread, "long_op", 100);
+    TEST_ASSERT_TRUE(SupervisorCheck(Kernel::get_ms_count() + 1000));
+
+    steady_thread.start(steady_main);
+    steady_thread.join();
+    TEST_ASSERT_TRUE(SupervisorCheck(Kernel::get_ms_count() + 30000));
+
+    return CaseNext;
+}
+
+// Test that a heartbeat ahead of a long operation extends the deadline of the thread
+static control_t supervisor_check_test_2(const size_t call_count)
+{
+    long_op_start_ms = Kernel::get_ms_count();
+    long_op_thread.start(long_op_main);
+    long_op_thread.join();
+    long_op_end_ms = Kernel::get_ms_count();
+    TEST_ASSERT_TRUE(SupervisorCheck(Kernel::get_ms_count() + 1000));
+
+    return CaseNext;
+}
+
+// Test that a missed deadline stops the kicks for good, and leaves a crash record for the next boot
+static control_t supervisor_check_test_3(const size_t call_count)
+{
+    crash_record_t record;
+    TEST_ASSERT_FALSE(SupervisorGetCrashRecord(record));
+
+    uint64_t now_ms = Kernel::get_ms_count();
+    TEST_ASSERT_FALSE(SupervisorCheck(now_ms + 3000));
+    TEST_ASSERT_FALSE(SupervisorCheck(now_ms));
+
+    /* The record survives in the backup registers; read it back as the next boot would */
+    SupervisorInit();
+    TEST_ASSERT_TRUE(SupervisorGetCrashRecord(record));
+    TEST_ASSERT_EQUAL_STRING("long_op", record.id);
+    /* Overdue by 3000 ms less the 2000 ms deadline, plus the time since the heartbeat */
+    TEST_ASSERT_TRUE(record.overdue_ms >= 1000 + (now_ms - long_op_end_ms));
+    TEST_ASSERT_TRUE(record.overdue_ms <= 1000 + (now_ms - long_op_start_ms));
+    TEST_ASSERT_EQUAL_UINT32(1, record.resets);
+
+    return CaseNext;
+}
+
+utest::v1::status_t greentea_setup(const size_t number_of_cases)
+{
+    // Here, we specify the timeout (60s) and the host test (a built-in host test or the name of our Python file)
+    GREENTEA_SETUP(60, "default_auto");
+
+    return greentea_test_setup_handler(number_of_cases);
+}
+
+// List of test cases in this file
+Case cases[] =
+{
+    Case("Test supervision of threads on time", supervisor_check_test_1),
+    Case("Test extended deadline of a long operation", supervisor_check_test_2),
+    Case("Test crash record of a missed deadline", supervisor_check_test_3)
+};
+
+Specification specification(greentea_setup, cases);
+
+int main()
+{
+    return !Harness::run(specification);
+}
@@ -0,0 +1,201 @@
+/**
+ * @defgroup watchdog_supervisor Watchdog Supervisor
+ * @{
+ */
+
+#include <cstring>
+#include "watchdog_supervisor.h"
+#include "mbed_trace.h"
+
+#define TRACE_GROUP "WatchdogSupervisor"
+
+#define SUPERVISOR_CRASH_MAGIC  0x57445356UL    // "WDSV"; marks a valid crash record
+#define SUPERVISOR_BKP_WORDS    (1 + SUPERVISOR_ID_SIZE / 4 + 3)
+
+typedef struct {
+    Thread* thread;
+    const char* id;                 /// short name with static lifetime
+    uint32_t deadline_ms;           /// longest gap between heartbeats
+    uint64_t due_ms;                /// kernel time of the latest acceptable heartbeat; 0 until the first
+} supervised_thread_t;
+
+static supervised_thread_t supervised[SUPERVISOR_MAX_THREADS];
+static size_t num_supervised = 0;
+static bool tripped = false;                /// a deadline was missed; the watchdog is no longer kicked
+static crash_record_t previous_record;      /// crash record found at boot
+static bool has_previous_record = false;
+static LowPowerTicker supervisor_ticker;
+
+static_assert(sizeof(crash_record_t) == (SUPERVISOR_BKP_WORDS - 1) * sizeof(uint32_t), "Crash record layout");
+static_assert(SUPERVISOR_BKP_FIRST + SUPERVISOR_BKP_WORDS <= 32, "Crash record beyond the RTC backup registers");
+
+/**
+ *  @brief  Returns the RTC backup register of a word of the crash record.
+ *  @author Lee Tze Han
+ *  @param  word    Word of the record; 0 is the magic
+ *  @return Backup register
+ */
+static volatile uint32_t* BackupRegister(size_t word)
+{
+    return &RTC->BKP0R + SUPERVISOR_BKP_FIRST + word;
+}
+
+/**
+ *  @brief  Writes the crash record and its magic to the RTC backup registers.
+ *  @author Lee Tze Han
+ *  @param  record  Crash record
+ */
+static void WriteCrashRecord(const crash_record_t& record)
+{
+    uint32_t words[SUPERVISOR_BKP_WORDS - 1];
+    memcpy(words, &record, sizeof(words));
+
+    for (size_t i = 0; i < SUPERVISOR_BKP_WORDS - 1; i++)
+    {
+        *BackupRegister(i + 1) = words[i];
+    }
+    *BackupRegister(0) = SUPERVISOR_CRASH_MAGIC;
+}
+
+/**
+ *  @brief  Ticker handler: kicks the watchdog while every supervised thread is on time.
+ *  @author Lee Tze Han
+ */
+static void SupervisorTick(void)
+{
+    SupervisorCheck(Kernel::get_ms_count());
+}
+
+/**
+ *  @brief  Reports the crash record of the previous boot, and starts supervising. Call once the watchdog is started.
+ *  @author Lee Tze Han
+ */
+void SupervisorInit(void)
+{
+    HAL_PWR_EnableBkUpAccess();
+
+    if (*BackupRegister(0) == SUPERVISOR_CRASH_MAGIC)
+    {
+        uint32_t words[SUPERVISOR_BKP_WORDS - 1];
+        for (size_t i = 0; i < SUPERVISOR_BKP_WORDS - 1; i++)
+        {
+            words[i] = *BackupRegister(i + 1);
+        }
+        memcpy(&previous_record, words, sizeof(previous_record));
+        previous_record.id[SUPERVISOR_ID_SIZE - 1] = '\0';
+        has_previous_record = true;
+
+        /* Report once; the reset count carries over to the next record */
+        *BackupRegister(0) = 0;
+        tr_warn("Watchdog reset: %s missed its deadline by %lu ms at %lu s uptime (%lu in a row)", previous_record.id,
+                (unsigned long)previous_record.overdue_ms, (unsigned long)previous_record.uptime_s, (unsigned long)previous_record.resets);
+    }
+
+    supervisor_ticker.attach(callback(SupervisorTick), std::chrono::seconds(MBED_CONF_APP_WATCHDOG_KICK_INTERVAL));
+}
+
+/**
+ *  @brief  Adds a thread to the supervision; it is supervised from its first heartbeat.
+ *  @author Lee Tze Han
+ *  @param  thread      Thread, started or not
+ *  @param  id          Short name with static lifetime, kept in the crash record
+ *  @param  deadline_ms Longest gap between heartbeats of the thread
+ */
+void SupervisorRegisterThread(Thread* thread, const char* id, uint32_t deadline_ms)
+{
+    core_util_critical_section_enter();
+    bool added = (num_supervised < SUPERVISOR_MAX_THREADS);
+    if (added)
+    {
+        supervised[num_supervised++] = {thread, id, deadline_ms, 0};
+    }
+    core_util_critical_section_exit();
+
+    if (!added)
+    {
+        tr_warn("Supervisor table full, not supervising %s", id);
+    }
+}
+
+/**
+ *  @brief  Heartbeat of the calling thread; the next one is due within the deadline it was registered with.
+ *  @author Lee Tze Han
+ */
+void SupervisorHeartbeat(void)
+{
+    SupervisorHeartbeatWithin(0);
+}
+
+/**
+ *  @brief  Heartbeat of the calling thread, ahead of a long operation.
+ *  @author Lee Tze Han
+ *  @param  deadline_ms Time until the next heartbeat is due; 0 for the registered deadline
+ */
+void SupervisorHeartbeatWithin(uint32_t deadline_ms)
+{
+    const osThreadId_t id = ThisThread::get_id();
+    const uint64_t now_ms = Kernel::get_ms_count();
+
+    core_util_critical_section_enter();
+    for (size_t i = 0; i < num_supervised; i++)
+    {
+        if (supervised[i].thread->get_id() == id)
+        {
+            supervised[i].due_ms = now_ms + ((deadline_ms != 0) ? deadline_ms : supervised[i].deadline_ms);
+            break;
+        }
+    }
+    core_util_critical_section_exit();
+}
+
+/**
+ *  @brief  Checks the heartbeats, kicking the watchdog if all threads are on time. Runs on the supervisor ticker.
+ *  @author Lee Tze Han
+ *  @param  now_ms  Kernel time in ms
+ *  @return Whether the watchdog was kicked; false from the first missed deadline on
+ */
+bool SupervisorCheck(uint64_t now_ms)
+{
+    core_util_critical_section_enter();
+    for (size_t i = 0; (i < num_supervised) && !tripped; i++)
+    {
+        const supervised_thread_t& thread = supervised[i];
+        if ((thread.due_ms != 0) && (now_ms > thread.due_ms))
+        {
+            crash_record_t record = {};
+            strncpy(record.id, thread.id, SUPERVISOR_ID_SIZE - 1);
+            record.overdue_ms = (uint32_t)(now_ms - thread.due_ms);
+            record.uptime_s = (uint32_t)(now_ms / 1000);
+            record.resets = (has_previous_record ? previous_record.resets : 0) + 1;
+            WriteCrashRecord(record);
+            tripped = true;
+        }
+    }
+    const bool healthy = !tripped;
+    core_util_critical_section_exit();
+
+    if (healthy)
+    {
+        Watchdog::get_instance().kick();
+    }
+
+    return healthy;
+}
+
+/**
+ *  @brief  Crash record found by SupervisorInit().
+ *  @author Lee Tze Han
+ *  @param  record  Crash record of the previous boot
+ *  @return Whether the previous boot ended in a supervised reset
+ */
+bool SupervisorGetCrashRecord(crash_record_t& record)
+{
+    if (has_previous_record)
+    {
+        record = previous_record;
+    }
+
+    return has_previous_record;
+}
+
+/** @}*/
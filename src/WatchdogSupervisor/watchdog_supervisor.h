@@ -0,0 +1,64 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef WATCHDOG_SUPERVISOR_H
+#define WATCHDOG_SUPERVISOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mbed.h"
+#include "rtos.h"
+
+#define SUPERVISOR_MAX_THREADS  8           // threads that can be supervised
+#define SUPERVISOR_ID_SIZE      12          // thread id in the crash record, with terminator
+#define SUPERVISOR_BKP_FIRST    24          // first of the RTC backup registers holding the crash record
+
+/* Deadlines of the application threads; in low-power mode they may sleep for low-power-max-sleep at a time */
+#if MBED_CONF_APP_LOW_POWER
+#define SUPERVISOR_THREAD_DEADLINE_MS   ((MBED_CONF_APP_WATCHDOG_THREAD_DEADLINE + MBED_CONF_APP_LOW_POWER_MAX_SLEEP) * 1000UL)
+#else
+#define SUPERVISOR_THREAD_DEADLINE_MS   (MBED_CONF_APP_WATCHDOG_THREAD_DEADLINE * 1000UL)
+#endif  // MBED_CONF_APP_LOW_POWER
+#define SUPERVISOR_LONG_DEADLINE_MS     (MBED_CONF_APP_WATCHDOG_LONG_DEADLINE * 1000UL)
+
+/** Record of the thread that stopped the watchdog kicks, kept in the RTC backup registers across the reset */
+typedef struct {
+    char id[SUPERVISOR_ID_SIZE];    /// thread that missed its deadline
+    uint32_t overdue_ms;            /// time past the deadline when it was caught
+    uint32_t uptime_s;              /// uptime when it was caught
+    uint32_t resets;                /// supervised resets in a row, this one included
+} crash_record_t;
+
+/*
+ *  Hardware watchdog supervisor.
+ *
+ *  Each supervised thread calls SupervisorHeartbeat() once per iteration of its loop, and must do so
+ *  again within its own deadline. Supervision of a thread starts at its first heartbeat, so threads
+ *  may block freely until then (e.g. waiting for MQTT). A LowPowerTicker checks every thread each
+ *  watchdog-kick-interval and kicks the hardware watchdog only while all of them are on time. The
+ *  first thread to miss its deadline stops the kicks for good and is written to the crash record;
+ *  the watchdog then resets the system, and SupervisorInit() reports the record at the next boot.
+ *
+ *  A thread about to run a long operation (network setup, TLS handshake, key generation) announces
+ *  it with SupervisorHeartbeatWithin(), instead of kicking the watchdog from inside the operation.
+ */
+void SupervisorInit(void);
+void SupervisorRegisterThread(Thread* thread, const char* id, uint32_t deadline_ms);
+void SupervisorHeartbeat(void);
+void SupervisorHeartbeatWithin(uint32_t deadline_ms);
+bool SupervisorCheck(uint64_t now_ms);
+bool SupervisorGetCrashRecord(crash_record_t& record);
+
+#endif  // WATCHDOG_SUPERVISOR_H
@@ -3,6 +3,7 @@
  * @{
  */
 
+#include <cstring>
 #include <string>
 #include "threads.h"
 #include "mbed_trace.h"
@@ -12,7 +13,45 @@
 #include "conversions.h"
 #include "persist_store.h"
 #include "sensor_profile.h"
+#include "aggregation_engine.h"
+#include "signal_processing.h"
 #include "time_engine.h"
+#include "trace_macro.h"
+#include "trace_manager.h"
+#include "diagnostics.h"
+#include "power_manager.h"
+#include "watchdog_supervisor.h"
+
+void execute_behavior_control(AggregationEngine& aggregation)
+{
+    #undef TRACE_GROUP
+    #define TRACE_GROUP "BehaviorCoordinatorThread"
+
+    /* Timeout set to 1 ms */ 
+    behavior_control_mail_t *behavior_control_mail = behavior_control_mail_box.try_get_for(1ms);
+    if (behavior_control_mail)
+    {
+        DiagnosticsMailGet(DIAG_MAIL_BEHAVIOR_CONTROL);
+        const ControlParam param = behavior_control_mail->param;
+        const int value = behavior_control_mail->value;
+
+        if ((param == PARAM_AGGREGATION_WINDOW) && (value >= 0) && (value <= AGGREGATION_MAX_WINDOW_S))     // 0 disables aggregation
+        {
+            const uint32_t window_ms = static_cast<uint32_t>(value) * 1000;     // Convert to miliseconds
+            tr_info("Aggregation window changed to %d", value);
+            DecadaServiceResponse(param, behavior_control_mail->msg_id, AGGREGATION_WINDOW_UPDATE);
+            WriteAggregationWindow(to_string(window_ms));       // Save to persistence
+            aggregation.SetWindow(window_ms);
+        }
+        else if (param == PARAM_AGGREGATION_WINDOW)
+        {
+            tr_warn("Aggregation window %d out of range [0, %d]", value, AGGREGATION_MAX_WINDOW_S);
+        }
+        behavior_control_mail_box.free(behavior_control_mail);
+    }
+
+    return;
+}
 
 /* [rtos: thread_2] BehaviorCoordinatorThread */
 void behavior_coordinator_thread(void) 
@@ -21,9 +60,19 @@ void behavior_coordinator_thread(void)
     #define TRACE_GROUP  "BehaviorCoordinatorThread"
 
     const chrono::milliseconds behav_thread_sleep_ms = 500ms;
-    Watchdog &watchdog = Watchdog::get_instance();
-
     SensorProfile sensors_profile;
+    AggregationEngine aggregation(StringToInt(ReadAggregationWindow()));
+#if MBED_CONF_APP_USE_SIGNAL_PROCESSING
+    SignalProcessor signal_processor;
+#endif  // MBED_CONF_APP_USE_SIGNAL_PROCESSING
+    sensors_profile.SetDefaultDeadband(MBED_CONF_APP_DEADBAND_ABSOLUTE, MBED_CONF_APP_DEADBAND_RELATIVE, MBED_CONF_APP_DEADBAND_MAX_SILENCE);
+#if MBED_CONF_APP_USE_DEADBAND
+    int64_t stream_time_stamp = 0;
+#endif  // MBED_CONF_APP_USE_DEADBAND
+    uint32_t stream_read_cycles = 0;        // first reading of the stream, for publish latency
+#if LATENCY_TRACE_ENABLED
+    uint32_t stream_trace_cycle = 0;
+#endif  // LATENCY_TRACE_ENABLED
 
     bool send_packets = false;
     
@@ -31,30 +80,72 @@ void behavior_coordinator_thread(void)
     {   
         /* Wait for MQTT connection to be up before continuing */
         event_flags.wait_all(FLAG_MQTT_OK, osWaitForever, false);
+        DiagnosticsBusyBegin();
         
         llp_sensor_mail_t *llp_mail = llp_sensor_mail_box.try_get_for(1ms);
         if (llp_mail) 
         {
-            std::string entity = llp_mail->sensor_type;
-            free(llp_mail->sensor_type);
-            std::string new_value = llp_mail->value;
-            free(llp_mail->value);
-            int new_time_stamp = llp_mail->raw_time_stamp;
+            DiagnosticsMailGet(DIAG_MAIL_LLP_SENSOR);
+            const char* entity = llp_mail->sensor_type;
+            int64_t new_time_stamp = llp_mail->time_stamp_ms;
+            uint32_t now_ms = (uint32_t)Kernel::Clock::now().time_since_epoch().count();
 
-            if (entity == "header")
+            if (std::strcmp(entity, LLP_STREAM_START) == 0)      // start of data stream from sensor thread
+            {
+                sensors_profile.ClearEntityList();
+                stream_read_cycles = 0;
+#if LATENCY_TRACE_ENABLED
+                stream_trace_cycle = llp_mail->trace_cycle;
+#endif  // LATENCY_TRACE_ENABLED
+            }
+            else if (std::strcmp(entity, LLP_STREAM_END) == 0)   // end of data stream from sensor thread
             {
-                if (new_value == "start")   // start of data stream from sensor thread
+                LATENCY_TRACE(stream_trace_cycle, LATENCY_STAGE_LLP_GET);
+#if MBED_CONF_APP_USE_DEADBAND
+                stream_time_stamp = new_time_stamp;
+#endif  // MBED_CONF_APP_USE_DEADBAND
+                if (!aggregation.IsEnabled())
                 {
-                    sensors_profile.ClearEntityList();
+                    /* Empty while a signal processing block is still being collected */
+                    send_packets = sensors_profile.CheckEntityAvailability();
                 }
-                else                        // end of data stream from sensor thread
+                else if (aggregation.IsWindowClosed(now_ms))     // publish window statistics instead of raw samples
                 {
+                    aggregation.CloseWindow(sensors_profile, now_ms, new_time_stamp);
                     send_packets = true;
                 }
             }
             else
             {
-                sensors_profile.UpdateValue(entity, new_value, new_time_stamp);
+                if (stream_read_cycles == 0)
+                {
+                    stream_read_cycles = llp_mail->read_cycles;
+                }
+
+#if MBED_CONF_APP_USE_SIGNAL_PROCESSING
+                /* Filtered samples are produced once per block; none are forwarded while the block is being collected */
+                float filtered[SIGNAL_OUTPUT_BLOCK_SIZE];
+                size_t num_filtered = signal_processor.PushSample(entity, llp_mail->value, filtered);
+#else
+                float* filtered = &llp_mail->value;
+                size_t num_filtered = 1;
+#endif  // MBED_CONF_APP_USE_SIGNAL_PROCESSING
+
+                if (aggregation.IsEnabled())
+                {
+                    for (size_t i = 0; i < num_filtered; i++)
+                    {
+                        aggregation.AddSample(entity, filtered[i], now_ms);
+                    }
+                }
+                else if (num_filtered > 0)
+                {
+                    /*
+                     *  A packet holds one value per measure point, so only the newest filtered sample is published:
+                     *  raw publishes are decimated by SIGNAL_BLOCK_SIZE rather than SIGNAL_DECIMATION
+                     */
+                    sensors_profile.UpdateValue(entity, filtered[num_filtered - 1], new_time_stamp);
+                }
             }
 
             llp_sensor_mail_box.free(llp_mail);
@@ -65,6 +156,18 @@ void behavior_coordinator_thread(void)
          *  Examples are Naive Bayes, Support Vector Machine (SVM) and Neural Networks (using CMSIS-NN).
          */
 
+        execute_behavior_control(aggregation);
+
+#if MBED_CONF_APP_USE_DEADBAND
+        if (send_packets)
+        {
+            /* Report on change: drop unchanged measure points, and skip the publish if none are left */
+            sensors_profile.ApplyDeadbandFilter(stream_time_stamp);
+            send_packets = sensors_profile.CheckEntityAvailability();
+            tr_debug("Deadband: %lu sent, %lu suppressed", (unsigned long)sensors_profile.GetSentCount(), (unsigned long)sensors_profile.GetSuppressedCount());
+        }
+#endif  // MBED_CONF_APP_USE_DEADBAND
+
         if (send_packets)
         {
             stdio_mutex.lock();
@@ -75,15 +178,30 @@ void behavior_coordinator_thread(void)
                 tr_warn("Memory full. NULL pointer allocated");
                 ThisThread::sleep_for(500ms);
             }
+            LATENCY_TRACE(stream_trace_cycle, LATENCY_STAGE_PACKET_BEGIN);
             comms_upstream_mail->payload = StringToChar(sensors_profile.GetNewDecadaPacket());
+            LATENCY_TRACE(stream_trace_cycle, LATENCY_STAGE_PACKET_END);
+            comms_upstream_mail->read_cycles = aggregation.IsEnabled() ? 0 : stream_read_cycles;     // aggregates span many reads
+#if LATENCY_TRACE_ENABLED
+            comms_upstream_mail->trace_cycle = stream_trace_cycle;
+#endif  // LATENCY_TRACE_ENABLED
             comms_upstream_mail_box.put(comms_upstream_mail);
+            LATENCY_TRACE(stream_trace_cycle, LATENCY_STAGE_UPSTREAM_PUT);
+            DiagnosticsMailPut(DIAG_MAIL_COMMS_UPSTREAM);
+            event_flags.set(FLAG_WAKE_COMMS);
             stdio_mutex.unlock();
             send_packets = false;
         }
 
-        watchdog.kick();
+        SupervisorHeartbeat();
 
-        ThisThread::sleep_for(behav_thread_sleep_ms);
+        DiagnosticsBusyEnd();
+
+        /* A stream is drained without a tick between its readings, which would hold back its packet */
+        if (llp_mail == NULL)
+        {
+            PowerIdle(FLAG_WAKE_BEHAVIOR, behav_thread_sleep_ms, POWER_NO_DEADLINE);
+        }
     }
 }
 
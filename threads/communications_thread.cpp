@@ -3,8 +3,10 @@
  * @{
  */
 
+#include <cstring>
 #include <string>
-#include <unordered_set>
+#include <algorithm>
+#include <functional>
 #include "rtos.h"
 #include "threads.h"
 #include "mbed_trace.h"
@@ -16,14 +18,58 @@
 #include "persist_store.h"
 #include "se_trustx.h"
 #include "time_engine.h"
-
-std::string const SENSOR_PUB_TOPIC = std::string("/sys/") + MBED_CONF_APP_DECADA_PRODUCT_KEY + "/" + device_uuid + "/thing/measurepoint/post";
-std::string const DECADA_SERVICE_TOPIC = std::string("/sys/") + MBED_CONF_APP_DECADA_PRODUCT_KEY + "/" + device_uuid + "/thing/service/";
-std::string const SENSOR_POLL_RATE_TOPIC = DECADA_SERVICE_TOPIC + "sensorpollrate";
-std::unordered_set<std::string> subscription_topics = {SENSOR_POLL_RATE_TOPIC};
+#include "clock_discipline.h"
+#include "diagnostics.h"
+#include "power_manager.h"
+#include "watchdog_supervisor.h"
+#include "connection_manager.h"
+#include "decada_endpoints.h"
+#include "param_control.h"
 
 /* RTOS Sub-thread Initialization */
 Thread thread_1_1(osPriorityNormal, OS_STACK_SIZE*3, NULL, "SubscriptionManagerThread");
+Thread thread_1_2(osPriorityNormal, OS_STACK_SIZE, NULL, "ClockDisciplineThread");
+
+/* Longest MQTT read of SubscriptionManagerThread */
+#if MBED_CONF_APP_LOW_POWER
+#define SUBMGR_YIELD_MS     (MBED_CONF_APP_LOW_POWER_MAX_SLEEP * 1000UL)
+#else
+#define SUBMGR_YIELD_MS     1000UL
+#endif  // MBED_CONF_APP_LOW_POWER
+
+/* Heartbeats of SubscriptionManagerThread are spaced by an MQTT read, a reconnection attempt and an idle sleep */
+#define SUBMGR_DEADLINE_MS  (SUBMGR_YIELD_MS + SUPERVISOR_LONG_DEADLINE_MS + SUPERVISOR_THREAD_DEADLINE_MS)
+
+/* Heartbeats of ClockDisciplineThread are spaced by the longest sync interval and an NTP query */
+#define CLOCK_DEADLINE_MS   (CLOCK_INTERVAL_MAX_MS + CLOCK_NTP_TIMEOUT_MS + SUPERVISOR_THREAD_DEADLINE_MS)
+
+/**
+ *  @brief  Publishes via MQTT, unless SubscriptionManagerThread holds the client to reconnect it.
+ *  @details A reconnection holds mqtt_mutex through the network, TLS and MQTT handshakes, far beyond the deadline of
+ *           this thread; the publish is dropped instead, as it would be while offline.
+ *  @author Lee Tze Han
+ *  @param  decada      DECADA connection
+ *  @param  topic       MQTT publish topic
+ *  @param  payload     Outgoing MQTT message
+ *  @param  length      Length of payload
+ *  @return Successful(1)/unsuccessful(0) mqtt publish
+ */
+static bool PublishUnlessReconnecting(DecadaManager& decada, const char* topic, const char* payload, size_t length)
+{
+    #undef TRACE_GROUP
+    #define TRACE_GROUP  "CommunicationsControllerThread"
+
+    if (!mqtt_mutex.trylock())
+    {
+        tr_debug("Reconnecting to DECADA, dropped publish to %s", topic);
+
+        return false;
+    }
+    const bool pub_ok = decada.Publish(topic, payload, length);
+    mqtt_mutex.unlock();
+
+    return pub_ok;
+}
 
 /* [rtos: thread_1_1] SubscriptionManagerThread */
 void subscription_manager_thread(DecadaManager* decada_ptr)
@@ -37,15 +83,51 @@ void subscription_manager_thread(DecadaManager* decada_ptr)
     while (1)
     {   
         event_flags.wait_all(FLAG_MQTT_OK, osWaitForever, false);
-        if (*(stack->mqtt_client_ptr) != NULL)
+        DiagnosticsBusyBegin();
+        bool connected = decada_ptr->IsConnected();
+        if (connected)
         {
-            (*(stack->mqtt_client_ptr))->yield();
-            if(!(*(stack->mqtt_client_ptr))->isConnected())
-            {
-                decada_ptr->Reconnect();
-            }
+            (*(stack->mqtt_client_ptr))->yield(SUBMGR_YIELD_MS);
+            connected = (*(stack->mqtt_client_ptr))->isConnected();
+        }
+        if (!connected)
+        {
+            /* Reconnects the broken layer once its backoff has passed */
+            connected = decada_ptr->Reconnect();
+        }
+        SupervisorHeartbeat();
+        DiagnosticsBusyEnd();
+
+        /* Low power: yield() waits on the socket, so sleep only until the next reconnect attempt */
+        const uint64_t now_ms = Kernel::get_ms_count();
+        PowerIdle(0, submgr_thread_sleep_ms, connected ? now_ms : std::max(now_ms, decada_ptr->GetNextReconnect()));
+    }
+}
+
+/* [rtos: thread_1_2] ClockDisciplineThread */
+void clock_discipline_thread(NetworkInterface* network)
+{
+    #undef TRACE_GROUP
+    #define TRACE_GROUP  "ClockDisciplineThread"
+
+    NTPClient ntp(network);
+
+    while (1)
+    {
+        SupervisorHeartbeat();
+
+        /* Syncs are spaced out while the clock keeps time; the blocking NTP query stays off the publish path */
+        const uint64_t now_ms = Kernel::get_ms_count();
+        const uint64_t next_sync_ms = NextClockSync();
+        if (next_sync_ms > now_ms)
+        {
+            ThisThread::sleep_for(chrono::milliseconds(next_sync_ms - now_ms));
+            continue;
         }
-        ThisThread::sleep_for(submgr_thread_sleep_ms);
+
+        DiagnosticsBusyBegin();
+        UpdateRtc(ntp);
+        DiagnosticsBusyEnd();
     }
 }
 
@@ -56,24 +138,37 @@ void communications_controller_thread(void)
     #define TRACE_GROUP  "CommunicationsControllerThread"
 
     const chrono::milliseconds comms_thread_sleep_ms = 500ms;
-    const uint32_t ntp_counter_max = 14400000;      // (comms_thread_sleep_ms)*(ntp_counter_max) = 4 hours 
-    Watchdog &watchdog = Watchdog::get_instance();
 
     NetworkInterface* network = NULL;
     std::string payload = "";
 
+    /* Each step of the setup may take up to the long deadline */
+    SupervisorHeartbeatWithin(SUPERVISOR_LONG_DEADLINE_MS);
+    ConnectionManager link(RECONNECT_POLICY_CONFIG, (uint32_t)std::hash<std::string>()(device_uuid));
     bool is_network_connected= ConfigNetworkInterface(network);
     while (!is_network_connected)
     {
+        link.Fail(CONN_LAYER_LINK, Kernel::get_ms_count());
+        if (link.ResetDue())
+        {
+            NVIC_SystemReset();
+        }
         tr_info("Network Connection Failed...Retrying...");
+
+        const uint32_t backoff_ms = (uint32_t)(link.NextAttempt() - Kernel::get_ms_count());
+        SupervisorHeartbeatWithin(backoff_ms + SUPERVISOR_LONG_DEADLINE_MS);
+        ThisThread::sleep_for(chrono::milliseconds(backoff_ms));
         is_network_connected = ConfigNetworkInterface(network);
     }
-    watchdog.kick();
+    SupervisorHeartbeatWithin(SUPERVISOR_LONG_DEADLINE_MS);
 
-    /* Update RTC before first message is sent */
-    NTPClient ntp(network);
-    UpdateRtc(ntp);
-    watchdog.kick();
+    /* Update RTC before first message is sent; an RTC kept across the reset is synchronised after the first publish */
+    if (!RtcIsValid())
+    {
+        NTPClient ntp(network);
+        UpdateRtc(ntp);
+        SupervisorHeartbeatWithin(SUPERVISOR_LONG_DEADLINE_MS);
+    }
 
 #if defined(MBED_CONF_APP_USE_SECURE_ELEMENT) && (MBED_CONF_APP_USE_SECURE_ELEMENT == 1)
     /* Setup cryptographic utilities */
@@ -88,49 +183,72 @@ void communications_controller_thread(void)
     DecadaManager decada(network);
 #endif  // MBED_CONF_APP_USE_SECURE_ELEMENT
     decada.Connect();
-    watchdog.kick();
+    SupervisorHeartbeat();
 
     /* Signal other threads that MQTT is up */ 
     event_flags.set(FLAG_MQTT_OK);
     
-    uint32_t ntp_counter = ntp_counter_max;
     bool pub_ok = true;
-    bool inital_ntp_update = false;
+    bool first_published = false;
+    bool clock_started = false;
 
-    for(auto& subscription_topic : subscription_topics)
+    const char* const sensor_pub_topic = DecadaMeasurePointTopic();
+    char service_topic[DECADA_SERVICE_TOPIC_SIZE];
+    /* Services of CONTROL_PARAMS, as /sys/<product key>/<uuid>/thing/service/<service id>; once per service */
+    for (size_t i = 0; i < PARAM_COUNT; i++)
     {
-        decada.Subscribe(subscription_topic.c_str());
+        const char* service_id = GetControlParam(static_cast<ControlParam>(i)).service_id;
+        bool subscribed = false;
+        for (size_t j = 0; (j < i) && !subscribed; j++)
+        {
+            subscribed = (strcmp(GetControlParam(static_cast<ControlParam>(j)).service_id, service_id) == 0);
+        }
+        if (!subscribed && (DecadaServiceTopic(service_topic, sizeof(service_topic), service_id, false) > 0))
+        {
+            decada.Subscribe(service_topic);
+        }
     }
 
     DecadaManager* decada_ptr = &decada; 
+    DiagnosticsRegisterThread(&thread_1_1, "submgr");
+    SupervisorRegisterThread(&thread_1_1, "submgr", SUBMGR_DEADLINE_MS);
     thread_1_1.start(callback(subscription_manager_thread, decada_ptr));
 
     while (1)
     {     
-        /* Update HW RTC with NTP Cloud Time */
-        if (ntp_counter == ntp_counter_max)
-        {
-            bool success = UpdateRtc(ntp);
-            if (success || inital_ntp_update)
-            {
-                ntp_counter = 0;
-                inital_ntp_update = true;
-            }
-        }
-        else
+        DiagnosticsBusyBegin();
+
+        /* NTP syncs run on their own thread; a valid RTC waits until the first packet is out */
+        if (!clock_started && (first_published || !RtcIsValid()))
         {
-            ntp_counter++;
+            DiagnosticsRegisterThread(&thread_1_2, "clock");
+            SupervisorRegisterThread(&thread_1_2, "clock", CLOCK_DEADLINE_MS);
+            thread_1_2.start(callback(clock_discipline_thread, network));
+            clock_started = true;
         }
         
         comms_upstream_mail_t *comms_upstream_mail = comms_upstream_mail_box.try_get_for(1ms);
         if (comms_upstream_mail) 
         {
+            DiagnosticsMailGet(DIAG_MAIL_COMMS_UPSTREAM);
+            LATENCY_TRACE(comms_upstream_mail->trace_cycle, LATENCY_STAGE_UPSTREAM_GET);
             payload = comms_upstream_mail->payload;
             free(comms_upstream_mail->payload);
 
-            mqtt_mutex.lock();
-            pub_ok = decada.Publish(SENSOR_PUB_TOPIC.c_str(), payload);
-            mqtt_mutex.unlock();
+            pub_ok = PublishUnlessReconnecting(decada, sensor_pub_topic, payload.c_str(), payload.length());
+            LATENCY_TRACE(comms_upstream_mail->trace_cycle, LATENCY_STAGE_PUBLISHED);
+
+            if (pub_ok && comms_upstream_mail->read_cycles != 0)
+            {
+                DiagnosticsRecordLatency(comms_upstream_mail->read_cycles);
+            }
+            if (pub_ok && !first_published)
+            {
+                const uint32_t boot_ms = (uint32_t)Kernel::get_ms_count();
+                DiagnosticsRecordBoot(boot_ms);
+                tr_info("First packet published %lu ms after reset", (unsigned long)boot_ms);
+                first_published = true;
+            }
 
             comms_upstream_mail_box.free(comms_upstream_mail);
         }
@@ -138,27 +256,26 @@ void communications_controller_thread(void)
         service_response_mail_t *service_response_mail = service_response_mail_box.try_get_for(1ms);
         if (service_response_mail) 
         {
-            payload = service_response_mail->response;
-            free(service_response_mail->response);
-            std::string service_id = service_response_mail->service_id;
-            free(service_response_mail->service_id);
-            std::string response_topic = DECADA_SERVICE_TOPIC + service_id + "_reply";
-            mqtt_mutex.lock();
-            pub_ok = decada.Publish(response_topic.c_str(), payload);
-            mqtt_mutex.unlock();
+            DiagnosticsMailGet(DIAG_MAIL_SERVICE_RESPONSE);
+            const char* service_id = GetControlParam(service_response_mail->param).service_id;
+            if (DecadaServiceTopic(service_topic, sizeof(service_topic), service_id, true) > 0)
+            {
+                pub_ok = PublishUnlessReconnecting(decada, service_topic, service_response_mail->response, service_response_mail->length);
+            }
 
             service_response_mail_box.free(service_response_mail);
         }
 
-        /* MQTT Reconnection: Attempt to reconnect. If fails, restart system. */
-        if (pub_ok == false)
+        if (DiagnosticsReportDue((uint32_t)Kernel::get_ms_count()))
         {
-            watchdog.kick();
-            decada.Reconnect();
+            payload = DiagnosticsCreatePacket(EpochMsNow());
+            pub_ok = PublishUnlessReconnecting(decada, sensor_pub_topic, payload.c_str(), payload.length()) && pub_ok;
         }
-        
-        watchdog.kick();
-        ThisThread::sleep_for(comms_thread_sleep_ms);
+
+        /* MQTT Reconnection is left to the subscription manager thread, which owns the client reads */
+        SupervisorHeartbeat();
+        DiagnosticsBusyEnd();
+        PowerIdle(FLAG_WAKE_COMMS, comms_thread_sleep_ms, POWER_NO_DEADLINE, (comms_upstream_mail != NULL) || (service_response_mail != NULL));
     }
 }
 
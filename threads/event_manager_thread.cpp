@@ -11,6 +11,53 @@
 #include "global_params.h"
 #include "conversions.h"
 #include "param_control.h"
+#include "diagnostics.h"
+#include "latency_trace.h"
+#include "power_manager.h"
+#include "watchdog_supervisor.h"
+
+/**
+ *  @brief  Serves single-key commands typed on the serial console. Does not block.
+ *          'd': diagnostics; 't': latency trace as CSV; 'j': latency trace as Chrome trace event JSON
+ *  @author Lee Tze Han
+ */
+static void PollConsole(void)
+{
+    FileHandle* console = mbed_file_handle(STDIN_FILENO);
+    if (console == NULL)
+    {
+        return;
+    }
+
+    while (console->readable())
+    {
+        char c;
+        if (console->read(&c, 1) != 1)
+        {
+            break;
+        }
+
+        switch (c)
+        {
+            case 'd':
+            case 'D':
+                DiagnosticsPrint();
+                break;
+#if LATENCY_TRACE_ENABLED
+            case 't':
+            case 'T':
+                LatencyTracePrintCsv();
+                break;
+            case 'j':
+            case 'J':
+                LatencyTracePrintChromeJson();
+                break;
+#endif  // LATENCY_TRACE_ENABLED
+            default:
+                break;
+        }
+    }
+}
 
  /* [rtos: thread_4] EventManagerThread */
 void event_manager_thread(void)
@@ -19,33 +66,28 @@ void event_manager_thread(void)
     #define TRACE_GROUP  "EventManagerThread"
    
     const chrono::milliseconds evtmgr_sleep_ms = 5000ms;
-    Watchdog &watchdog = Watchdog::get_instance();
-
     while (1)
     {
         // Wait for MQTT connection to be up before continuing
         event_flags.wait_all(FLAG_MQTT_OK, osWaitForever, false);
+        DiagnosticsBusyBegin();
         
         mqtt_arrived_mail_t *mqtt_arrived_mail = mqtt_arrived_mail_box.try_get_for(1ms); 
         if (mqtt_arrived_mail) 
         {
-            std::string endpoint_id = mqtt_arrived_mail->endpoint_id;
-            free(mqtt_arrived_mail->endpoint_id);
-            std::string msg_id = mqtt_arrived_mail->msg_id;
-            free(mqtt_arrived_mail->msg_id);
-            std::string param = mqtt_arrived_mail->param;
-            free(mqtt_arrived_mail->param);
-            std::string value = mqtt_arrived_mail->value;
-
-            int int_value = StringToInt(value);
-            DistributeControlMessage(param, int_value, msg_id, endpoint_id);
+            DiagnosticsMailGet(DIAG_MAIL_MQTT_ARRIVED);
+            DistributeControlMessage(mqtt_arrived_mail->param, mqtt_arrived_mail->value, mqtt_arrived_mail->msg_id);
 
             mqtt_arrived_mail_box.free(mqtt_arrived_mail);
         }
 
-        watchdog.kick();
+        /* Diagnostics and latency trace on demand from the serial console */
+        PollConsole();
+
+        SupervisorHeartbeat();
 
-        ThisThread::sleep_for(evtmgr_sleep_ms);
+        DiagnosticsBusyEnd();
+        PowerIdle(FLAG_WAKE_EVENT, evtmgr_sleep_ms, POWER_NO_DEADLINE, (mqtt_arrived_mail != NULL));
     }
 }
  
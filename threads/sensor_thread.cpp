@@ -13,10 +13,60 @@
 #include "time_engine.h"
 #include "trace_macro.h"
 #include "trace_manager.h"
+#include "diagnostics.h"
+#include "power_manager.h"
+#include "watchdog_supervisor.h"
+#include "sensor_bus.h"
 #include "tmp75.h"
+#if MBED_CONF_APP_SPS30_ENABLED
+#include "sps30.h"
+#endif  // MBED_CONF_APP_SPS30_ENABLED
+#if MBED_CONF_APP_SCD30_ENABLED
+#include "scd30.h"
+#endif  // MBED_CONF_APP_SCD30_ENABLED
 
 #define TMP75_ADDR      0x4B
 
+/* One worker per I2C bus, and the readings of the last sample cycle gathered from them */
+static SensorBusGroup sensor_buses;
+static sensor_cycle_t cycle_record;
+
+#if LATENCY_TRACE_ENABLED
+static uint32_t trace_cycle = 0;        // sample cycle being read, numbered from 1
+#endif  // LATENCY_TRACE_ENABLED
+
+/**
+ *  @brief  Sends a single reading (or stream marker) to the behavior coordinator, waiting for a free mail slot.
+ *  @author Lee Tze Han
+ *  @param  sensor_type measure point id with static lifetime, or LLP_STREAM_START/LLP_STREAM_END
+ *  @param  value       measured value
+ *  @param  quality     bitmask of SensorType::ReadingQuality
+ */
+static void PutLlpSensorMail(const char* sensor_type, float value, uint8_t quality)
+{
+    #undef TRACE_GROUP
+    #define TRACE_GROUP "SensorThread"
+
+    llp_sensor_mail_t * llp_mail = llp_sensor_mail_box.try_calloc();
+    while (llp_mail == NULL)
+    {
+        llp_mail = llp_sensor_mail_box.try_calloc();
+        tr_warn("Memory full. NULL pointer allocated");
+        ThisThread::sleep_for(500ms);
+    }
+    llp_mail->sensor_type = sensor_type;
+    llp_mail->value = value;
+    llp_mail->quality = quality;
+    llp_mail->time_stamp_ms = EpochMsNow();
+    llp_mail->read_cycles = DiagnosticsCycles();
+#if LATENCY_TRACE_ENABLED
+    llp_mail->trace_cycle = trace_cycle;
+#endif  // LATENCY_TRACE_ENABLED
+    llp_sensor_mail_box.put(llp_mail);
+    DiagnosticsMailPut(DIAG_MAIL_LLP_SENSOR);
+    event_flags.set(FLAG_WAKE_BEHAVIOR);
+}
+
 void execute_sensor_control(int& current_cycle_interval)
 {
     #undef TRACE_GROUP
@@ -26,19 +76,14 @@ void execute_sensor_control(int& current_cycle_interval)
     sensor_control_mail_t *sensor_control_mail = sensor_control_mail_box.try_get_for(1ms);
     if (sensor_control_mail)
     {
-        std::string param = sensor_control_mail->param;
-        free(sensor_control_mail->param);
-        int value = sensor_control_mail->value;
-        std::string msg_id = sensor_control_mail->msg_id;
-        free(sensor_control_mail->msg_id);
-        std::string endpoint_id = sensor_control_mail->endpoint_id;
-        free(sensor_control_mail->endpoint_id);
-
-        if ((param == "sensor_poll_rate") && (value >= 10))      // Lowest bound - 10 seconds
+        DiagnosticsMailGet(DIAG_MAIL_SENSOR_CONTROL);
+        const ControlParam param = sensor_control_mail->param;
+        const int value = sensor_control_mail->value;
+
+        if ((param == PARAM_SENSOR_POLL_RATE) && (value >= 10))      // Lowest bound - 10 seconds
         {
             tr_info("Sensor poll rate changed to %d", value);
-            DecadaServiceResponse(endpoint_id, msg_id, trace_name[POLL_RATE_UPDATE]);
-            sensor_control_mail_box.free(sensor_control_mail);
+            DecadaServiceResponse(param, sensor_control_mail->msg_id, POLL_RATE_UPDATE);
             WriteCycleInterval(to_string(value*1000));          // Convert to miliseconds and save to persistence 
             current_cycle_interval = value*1000;
         }
@@ -59,87 +104,96 @@ void sensor_thread(void)
     const PinName i2c_data_pin = PinName::PB_9;
     const PinName i2c_clk_pin = PinName::PB_6;
 
-    Watchdog &watchdog = Watchdog::get_instance();
-
     int current_cycle_interval = StringToInt(ReadCycleInterval());
-    int current_poll_count = current_cycle_interval / sensor_thread_sleep_ms.count();
-    int poll_counter = 0;
+    const sampling_policy_t sampling_policy = {
+        MBED_CONF_APP_ADAPTIVE_SAMPLING,
+        MBED_CONF_APP_SAMPLING_MIN_INTERVAL * 1000,
+        MBED_CONF_APP_SAMPLING_MAX_INTERVAL * 1000,
+        MBED_CONF_APP_SAMPLING_CHANGE_THRESHOLD,
+        MBED_CONF_APP_SAMPLING_VARIANCE_THRESHOLD
+    };
+
+    const Kernel::Clock::duration_u32 sensor_deadline_ms(MBED_CONF_APP_SENSOR_DEADLINE);
+    uint32_t sample_cycle = 0;
 
     Tmp75 onboard_temp_sensor(i2c_data_pin, i2c_clk_pin);
     onboard_temp_sensor.Enable();
+    sensor_buses.Attach(&onboard_temp_sensor, i2c_data_pin);
+
+#if MBED_CONF_APP_SPS30_ENABLED
+    Sps30 particulate_sensor(MBED_CONF_APP_SPS30_I2C_SDA, MBED_CONF_APP_SPS30_I2C_SCL, I2C_FREQUENCY_STD);
+    particulate_sensor.Enable();
+    sensor_buses.Attach(&particulate_sensor, MBED_CONF_APP_SPS30_I2C_SDA);
+#endif  // MBED_CONF_APP_SPS30_ENABLED
+
+#if MBED_CONF_APP_SCD30_ENABLED
+    Scd30 co2_sensor(MBED_CONF_APP_SCD30_I2C_SDA, MBED_CONF_APP_SCD30_I2C_SCL, I2C_FREQUENCY);
+    co2_sensor.Enable();
+    sensor_buses.Attach(&co2_sensor, MBED_CONF_APP_SCD30_I2C_SDA);
+#endif  // MBED_CONF_APP_SCD30_ENABLED
+
+    /* Attach other sensors here; the Trust X bus belongs to the communications thread */
+    sensor_buses.SetPolicy(sampling_policy, current_cycle_interval);
+    sensor_buses.Start();
 
     while (1) 
     {
         /* Wait for MQTT connection to be up before continuing */
         event_flags.wait_all(FLAG_MQTT_OK, osWaitForever, false);
+        DiagnosticsBusyBegin();
 
-        current_poll_count = current_cycle_interval / sensor_thread_sleep_ms.count();
-
-        if (poll_counter == 0)
+        /* Each sensor keeps its own schedule: the poll rate, or its adaptive interval */
+        if (sensor_buses.Due())
         {
+#if LATENCY_TRACE_ENABLED
+            trace_cycle++;
+#endif  // LATENCY_TRACE_ENABLED
+            LATENCY_TRACE(trace_cycle, LATENCY_STAGE_READ_BEGIN);
+
             /* Start of sensor data stream - Add header */
-            llp_sensor_mail_t * llp_mail = llp_sensor_mail_box.try_calloc();
-            while (llp_mail == NULL)
-            {
-                llp_mail = llp_sensor_mail_box.try_calloc();
-                tr_warn("Memory full. NULL pointer allocated");
-                ThisThread::sleep_for(500ms);
-            }
-            llp_mail->sensor_type = StringToChar("header");
-            llp_mail->value = StringToChar("start");
-            llp_mail->raw_time_stamp = RawRtcTimeNow();
-            llp_sensor_mail_box.put(llp_mail);
-
-            /* Read internal tmp75 */
-            std::vector<std::pair<std::string, std::string>> s_data;
-            int stat = onboard_temp_sensor.GetData(s_data);
-            if (stat == SensorType::DATA_NOT_RDY || stat == SensorType::DATA_CRC_ERR)
+            PutLlpSensorMail(LLP_STREAM_START, 0.0f, SensorType::READING_OK);
+
+            /* Read every bus with due sensors at once; the cycle takes as long as the slowest bus, up to the deadline */
+            sensor_buses.Acquire(++sample_cycle, sensor_deadline_ms, cycle_record);
+            LATENCY_TRACE(trace_cycle, LATENCY_STAGE_READ_END);
+            tr_debug("Sample cycle %lu: %u readings from %u buses in %lu us", (unsigned long)cycle_record.cycle,
+                (unsigned int)cycle_record.count, (unsigned int)sensor_buses.GetBusCount(), (unsigned long)cycle_record.elapsed_us);
+
+            for (size_t i = 0; i < cycle_record.count; i++)
             {
-                tr_warn("Sensor data error");
-            }
-                
-            if (stat == SensorType::DATA_OK)
-            {   
-                llp_mail = llp_sensor_mail_box.try_calloc();
-                while (llp_mail == NULL)
+                const sensor_reading_t& reading = cycle_record.readings[i];
+
+                /* Events carry no measure point value */
+                if (reading.quality & SensorType::READING_EVENT)
                 {
-                    llp_mail = llp_sensor_mail_box.try_calloc();
-                    tr_warn("Memory full. NULL pointer allocated");
-                    ThisThread::sleep_for(500ms);
-                }      
-                llp_mail->sensor_type = StringToChar(s_data[0].first);
-                llp_mail->value = StringToChar(s_data[0].second);
-                llp_mail->raw_time_stamp = RawRtcTimeNow();
-                llp_sensor_mail_box.put(llp_mail);
+                    continue;
+                }
+                PutLlpSensorMail(reading.measure_point_id, reading.value, reading.quality);
             }
 
-            /* Poll other sensors here */
-
             /* End of sensor data stream  - Add footer */
-            llp_mail = llp_sensor_mail_box.try_calloc();
-            while (llp_mail == NULL)
-            {
-                llp_mail = llp_sensor_mail_box.try_calloc();
-                tr_warn("Memory full. NULL pointer allocated");
-                ThisThread::sleep_for(500ms);
-            }
-            llp_mail->sensor_type = StringToChar("header");
-            llp_mail->value = StringToChar("end");
-            llp_mail->raw_time_stamp = RawRtcTimeNow();
-            llp_sensor_mail_box.put(llp_mail);
+            PutLlpSensorMail(LLP_STREAM_END, 0.0f, SensorType::READING_OK);
+            LATENCY_TRACE(trace_cycle, LATENCY_STAGE_LLP_PUT);
         }
-        poll_counter++;
 
-        if (poll_counter >= current_poll_count)
+        const int previous_cycle_interval = current_cycle_interval;
+        execute_sensor_control(current_cycle_interval);
+        if (current_cycle_interval != previous_cycle_interval)
         {
-            poll_counter = 0;
+            sensor_buses.SetBaseInterval(current_cycle_interval);
         }
-
-        execute_sensor_control(current_cycle_interval);
         
-        watchdog.kick();
+        SupervisorHeartbeat();
+
+        DiagnosticsBusyEnd();
 
-        ThisThread::sleep_for(sensor_thread_sleep_ms);
+        /* Low power: sleep until the next sensor is due; a tick while an overdue sensor waits on a busy bus */
+        uint64_t wake_ms = sensor_buses.NextDue();
+        if (wake_ms <= Kernel::get_ms_count())
+        {
+            wake_ms = Kernel::get_ms_count() + sensor_thread_sleep_ms.count();
+        }
+        PowerIdle(FLAG_WAKE_SENSOR, sensor_thread_sleep_ms, wake_ms);
     }
 }
  
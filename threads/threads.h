@@ -24,6 +24,7 @@ void behavior_coordinator_thread(void);
 
 /* communications_thread.cpp */
 void subscription_manager_thread(DecadaManager* decada_ptr);
+void clock_discipline_thread(NetworkInterface* network);
 void communications_controller_thread(void);
 
 /* event_manager_thread.cpp */
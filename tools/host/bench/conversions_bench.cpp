@@ -0,0 +1,145 @@
+/**
+ * @defgroup conversions_bench Data Structure Conversions Benchmark
+ * @{
+ */
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "conversions.h"
+
+/* The stream-based implementations that conversions.cpp replaced, kept as baselines */
+namespace legacy {
+
+std::string IntToString(int v)
+{
+    std::ostringstream oss;
+    oss << v;
+    return oss.str();
+}
+
+std::string IntToHex(uint32_t i)
+{
+    std::stringstream stream;
+    stream << std::hex << i;
+    return stream.str();
+}
+
+std::string MsPaddingIntToString(int v)
+{
+    std::ostringstream oss;
+    oss << v;
+    return oss.str() + "000";
+}
+
+int StringToInt(const std::string& str)
+{
+    std::istringstream iss(str);
+    int v;
+    iss >> v;
+    return v;
+}
+
+char* DoubleToChar(char* str, double v, int decimal_digits)
+{
+    int i = 1;
+    for (; decimal_digits != 0; i *= 10, decimal_digits--);
+    int int_part = (int)v;
+    if (v < 0)
+    {
+        v = -v;
+    }
+    int fract_part = (int)((v - (double)(int)v) * i);
+    std::sprintf(str, "%i.", int_part);
+    char* ptr = &str[std::strlen(str)];
+    for (i /= 10; i > 1; i /= 10, ptr++)
+    {
+        if (fract_part >= i)
+        {
+            break;
+        }
+        *ptr = '0';
+    }
+    std::sprintf(ptr, "%i", fract_part);
+    return str;
+}
+
+}  // namespace legacy
+
+/* Rotating inputs so that branch predictors do not learn a single value */
+static const int int_inputs[8] = {0, 7, -54321, 1234567890, 1602000000, -1, 999, 2147483647};
+static const double double_inputs[8] = {23.45, -321.9876, 0.52, 1013.25, -0.5, 100.0, 65.4321, 412.0};
+
+template <std::string (*F)(int)>
+static void BM_IntFormat(benchmark::State& state)
+{
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(F(int_inputs[i++ & 7]));
+    }
+}
+BENCHMARK_TEMPLATE(BM_IntFormat, IntToString)->Name("IntToString");
+BENCHMARK_TEMPLATE(BM_IntFormat, legacy::IntToString)->Name("IntToString/legacy");
+BENCHMARK_TEMPLATE(BM_IntFormat, MsPaddingIntToString)->Name("MsPaddingIntToString");
+BENCHMARK_TEMPLATE(BM_IntFormat, legacy::MsPaddingIntToString)->Name("MsPaddingIntToString/legacy");
+
+template <std::string (*F)(uint32_t)>
+static void BM_HexFormat(benchmark::State& state)
+{
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(F((uint32_t)int_inputs[i++ & 7]));
+    }
+}
+BENCHMARK_TEMPLATE(BM_HexFormat, IntToHex)->Name("IntToHex");
+BENCHMARK_TEMPLATE(BM_HexFormat, legacy::IntToHex)->Name("IntToHex/legacy");
+
+static void BM_IntToChar(benchmark::State& state)
+{
+    char buf[INT_TO_CHAR_BUFFER_SIZE];
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(IntToChar(buf, (int64_t)int_inputs[i++ & 7] * 1000));
+    }
+}
+BENCHMARK(BM_IntToChar)->Name("IntToChar");
+
+template <char* (*F)(char*, double, int)>
+static void BM_DoubleFormat(benchmark::State& state)
+{
+    char buf[32];
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(F(buf, double_inputs[i++ & 7], 2));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK_TEMPLATE(BM_DoubleFormat, DoubleToChar)->Name("DoubleToChar");
+BENCHMARK_TEMPLATE(BM_DoubleFormat, legacy::DoubleToChar)->Name("DoubleToChar/legacy");
+
+template <int (*F)(const std::string&)>
+static void BM_IntParse(benchmark::State& state)
+{
+    std::string inputs[8];
+    for (size_t i = 0; i < 8; i++)
+    {
+        inputs[i] = IntToString(int_inputs[i]);
+    }
+
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(F(inputs[i++ & 7]));
+    }
+}
+BENCHMARK_TEMPLATE(BM_IntParse, StringToInt)->Name("StringToInt");
+BENCHMARK_TEMPLATE(BM_IntParse, legacy::StringToInt)->Name("StringToInt/legacy");
+
+BENCHMARK_MAIN();
+
+/** @}*/
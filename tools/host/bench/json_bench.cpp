@@ -0,0 +1,216 @@
+/**
+ * @defgroup json_bench Json Benchmark
+ * @{
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "json.h"
+#include "global_params.h"
+#include "json_stream.h"
+#include "trace_manager.h"
+
+/* Heap bytes allocated, reported per message as the heap_bytes counter */
+static std::atomic<size_t> heap_bytes(0);
+
+void* operator new(size_t size)
+{
+    heap_bytes += size;
+    void* p = malloc(size ? size : 1);
+    if (p == NULL)
+    {
+        abort();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t size) noexcept
+{
+    free(p);
+}
+
+static void ReportHeap(benchmark::State& state, size_t start)
+{
+    state.counters["heap_bytes"] = benchmark::Counter(static_cast<double>(heap_bytes - start) / state.iterations());
+}
+
+static const std::string service_message =
+    "{\"id\":\"1234567890\",\"version\":\"1.0\",\"params\":{\"sensor_poll_rate\":10,\"latency_trace\":1},\"method\":\"thing.service.sensorpollrate\"}";
+static const std::string provisioning_response =
+    "{\"code\":0,\"msg\":\"OK\",\"requestId\":\"4c4c2e2e-8b1d-4d1e-9a0b-1d2e3f405162\","
+    "\"data\":{\"productKey\":\"AbCdEfGh\",\"deviceKey\":\"0123456789abcdef\",\"assetId\":\"XyZ12345\",\"deviceSecret\":\"s3cr3tS3cr3tS3cr3tS3\"}}";
+
+/* Service response as CreateDecadaResponse() built it with JsonCpp */
+static void BM_ResponseJsonCpp(benchmark::State& state)
+{
+    const size_t start = heap_bytes;
+    for (auto _ : state)
+    {
+        Json::Value details;
+        details["sensor_poll_rate_updated"] = "true";
+        Json::Value message_content;
+        message_content["id"] = "1234567890";
+        message_content["code"] = 200;
+        message_content["data"] = details;
+
+        Json::FastWriter fast_writer;
+        std::string decada_message = fast_writer.write(message_content);
+        decada_message.erase(std::remove(decada_message.begin(), decada_message.end(), '\n'), decada_message.end());
+        benchmark::DoNotOptimize(decada_message);
+    }
+    ReportHeap(state, start);
+}
+BENCHMARK(BM_ResponseJsonCpp)->Name("Response/jsoncpp");
+
+static void BM_ResponseWriter(benchmark::State& state)
+{
+    const size_t start = heap_bytes;
+    char buffer[256];
+    for (auto _ : state)
+    {
+        JsonWriter writer(buffer, sizeof(buffer));
+        writer.BeginObject();
+        writer.Key("code");
+        writer.Int(200);
+        writer.Key("data");
+        writer.BeginObject();
+        writer.Key("sensor_poll_rate_updated");
+        writer.String("true");
+        writer.EndObject();
+        writer.Key("id");
+        writer.String("1234567890");
+        writer.EndObject();
+        benchmark::DoNotOptimize(buffer);
+        benchmark::ClobberMemory();
+    }
+    ReportHeap(state, start);
+}
+BENCHMARK(BM_ResponseWriter)->Name("Response/writer");
+
+static void BM_ResponseString(benchmark::State& state)
+{
+    const std::string msg = "sensor_poll_rate_updated";
+    const std::string msg_id = "1234567890";
+    const std::string value = "true";
+    const size_t start = heap_bytes;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(CreateDecadaResponse(msg, msg_id, value));
+    }
+    ReportHeap(state, start);
+}
+BENCHMARK(BM_ResponseString)->Name("Response/CreateDecadaResponse");
+
+/* Service response from its template, through the mail pool */
+static void BM_ResponseMail(benchmark::State& state)
+{
+    const size_t start = heap_bytes;
+    for (auto _ : state)
+    {
+        DecadaServiceResponse(PARAM_SENSOR_POLL_RATE, "1234567890", POLL_RATE_UPDATE);
+        service_response_mail_box.free(service_response_mail_box.try_get());
+    }
+    ReportHeap(state, start);
+}
+BENCHMARK(BM_ResponseMail)->Name("Response/DecadaServiceResponse");
+
+/* Service message read for its id and integer params */
+static void BM_ServiceJsonCpp(benchmark::State& state)
+{
+    const size_t start = heap_bytes;
+    for (auto _ : state)
+    {
+        Json::Reader reader;
+        Json::Value root;
+        reader.parse(service_message, root, false);
+        std::string msg_id = root["id"].asString();
+        const Json::Value& params = root["params"];
+        int sum = 0;
+        for (Json::Value::const_iterator it = params.begin(); it != params.end(); ++it)
+        {
+            sum += it->asInt();
+        }
+        benchmark::DoNotOptimize(msg_id);
+        benchmark::DoNotOptimize(sum);
+    }
+    ReportHeap(state, start);
+}
+BENCHMARK(BM_ServiceJsonCpp)->Name("ServiceMessage/jsoncpp");
+
+static void BM_ServiceReader(benchmark::State& state)
+{
+    const size_t start = heap_bytes;
+    for (auto _ : state)
+    {
+        char msg_id[32];
+        JsonReader reader(service_message.data(), service_message.size());
+        reader.Next();
+        while (reader.Next() == JSON_KEY)
+        {
+            if (reader.Equals("id"))
+            {
+                reader.Next();
+                reader.CopyString(msg_id, sizeof(msg_id));
+            }
+            reader.Skip();
+        }
+
+        JsonReader params(service_message.data(), service_message.size());
+        params.Next();
+        int sum = 0;
+        if (params.FindMember("params") && (params.Next() == JSON_OBJECT_BEGIN))
+        {
+            while (params.Next() == JSON_KEY)
+            {
+                int value = 0;
+                params.Next();
+                params.ToInt(value);
+                sum += value;
+            }
+        }
+        benchmark::DoNotOptimize(msg_id);
+        benchmark::DoNotOptimize(sum);
+    }
+    ReportHeap(state, start);
+}
+BENCHMARK(BM_ServiceReader)->Name("ServiceMessage/reader");
+
+/* One field of a provisioning response */
+static void BM_ProvisioningJsonCpp(benchmark::State& state)
+{
+    const size_t start = heap_bytes;
+    for (auto _ : state)
+    {
+        Json::Reader reader;
+        Json::Value root;
+        reader.parse(provisioning_response, root, false);
+        Json::Value sub_root = root.get("data", "invalid");
+        benchmark::DoNotOptimize(sub_root.get("deviceSecret", "invalid").asString());
+    }
+    ReportHeap(state, start);
+}
+BENCHMARK(BM_ProvisioningJsonCpp)->Name("ProvisioningResponse/jsoncpp");
+
+static void BM_ProvisioningReader(benchmark::State& state)
+{
+    const size_t start = heap_bytes;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(JsonGetString(provisioning_response, "data", "deviceSecret", "invalid"));
+    }
+    ReportHeap(state, start);
+}
+BENCHMARK(BM_ProvisioningReader)->Name("ProvisioningResponse/JsonGetString");
+
+BENCHMARK_MAIN();
+
+/** @}*/
@@ -0,0 +1,85 @@
+/**
+ * @defgroup time_engine_bench Time Engine Benchmark
+ * @{
+ */
+
+#include <ctime>
+#include <string>
+#include <benchmark/benchmark.h>
+#include "conversions.h"
+#include "time_engine.h"
+
+/* The localtime()-based implementation that FormatIso8601() replaced, kept as the baseline */
+namespace legacy {
+
+std::string ConvertRawTimeToIso8601Time(time_t raw_time)
+{
+    struct tm *ptm;
+
+    ptm = localtime(&raw_time);
+    std::string year = IntToString(ptm->tm_year + 1900);
+    std::string month = IntToString(ptm->tm_mon + 1);
+    month = FormatTime(month);
+    std::string day = IntToString(ptm->tm_mday);
+    day = FormatTime(day);
+    std::string hour = IntToString(ptm->tm_hour);
+    hour = FormatTime(hour);
+    std::string min = IntToString(ptm->tm_min);
+    min = FormatTime(min);
+    std::string sec = IntToString(ptm->tm_sec);
+    sec = FormatTime(sec);
+
+    std::string iso8601_timestamp_now = year + "-" + month + "-" + day + 'T' + hour + ":" + min + ":" + sec + "Z";
+
+    return iso8601_timestamp_now;
+}
+
+}  // namespace legacy
+
+/* Timestamps of successive readings within a day, and of readings spread over several days */
+static const int64_t same_day_ms[8] = {1602000000000LL, 1602000000250LL, 1602000001000LL, 1602000059999LL,
+                                       1602000600000LL, 1602003600123LL, 1602010000000LL, 1602020000500LL};
+static const int64_t many_days_ms[8] = {1561519234567LL, 1583020799999LL, 1583020800000LL, 1602000000000LL,
+                                        1609459199999LL, 1609459200000LL, 1640995200000LL, 4102444800000LL};
+
+template <std::string (*F)(time_t)>
+static void BM_Iso8601String(benchmark::State& state)
+{
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(F((time_t)(same_day_ms[i++ & 7] / 1000)));
+    }
+}
+BENCHMARK_TEMPLATE(BM_Iso8601String, ConvertRawTimeToIso8601Time)->Name("ConvertRawTimeToIso8601Time");
+BENCHMARK_TEMPLATE(BM_Iso8601String, legacy::ConvertRawTimeToIso8601Time)->Name("ConvertRawTimeToIso8601Time/legacy");
+
+static void BM_FormatIso8601(benchmark::State& state)
+{
+    const int64_t* inputs = (state.range(0) != 0) ? many_days_ms : same_day_ms;
+    char buf[ISO8601_BUFFER_SIZE];
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(FormatIso8601(buf, inputs[i++ & 7], true));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_FormatIso8601)->Name("FormatIso8601/same_day")->Arg(0);
+BENCHMARK(BM_FormatIso8601)->Name("FormatIso8601/many_days")->Arg(1);
+
+static void BM_EpochMsToChar(benchmark::State& state)
+{
+    char buf[INT_TO_CHAR_BUFFER_SIZE];
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(IntToChar(buf, same_day_ms[i++ & 7]));
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_EpochMsToChar)->Name("IntToChar/epoch_ms");
+
+BENCHMARK_MAIN();
+
+/** @}*/
@@ -0,0 +1,131 @@
+# Generates the MBED_CONF_* macros that mbed-cli derives from mbed_app.json and mbed_lib.json, so host
+# builds see the same configuration as the target. Values in HOST_OVERRIDES ("<prefix>.<key>=<value>",
+# prefix "app" or a library name) replace those of the json files, after target_overrides."*" is applied.
+
+function(mbed_config_macro_name prefix key out)
+    string(TOUPPER "${prefix}_${key}" name)
+    string(REGEX REPLACE "[-.]" "_" name "${name}")
+    set(${out} "MBED_CONF_${name}" PARENT_SCOPE)
+endfunction()
+
+function(mbed_config_value json path_type out)
+    # Scalar json value rendered as the C token mbed-cli would emit
+    string(JSON type TYPE "${json}" ${path_type})
+    string(JSON value GET "${json}" ${path_type})
+    if(type STREQUAL "BOOLEAN")
+        if(value)
+            set(value 1)
+        else()
+            set(value 0)
+        endif()
+    elseif(type STREQUAL "NULL")
+        set(value "")
+    endif()
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+# Reads the "config" section of one json file into <var>_NAMES / <var>_VALUES
+function(mbed_config_read file prefix var)
+    file(READ "${file}" json)
+    string(JSON num_keys ERROR_VARIABLE err LENGTH "${json}" config)
+    if(err)
+        return()
+    endif()
+
+    set(names ${${var}_NAMES})
+    set(values ${${var}_VALUES})
+    math(EXPR last "${num_keys} - 1")
+    foreach(i RANGE ${last})
+        string(JSON key MEMBER "${json}" config ${i})
+        string(JSON type TYPE "${json}" config ${key})
+        if(type STREQUAL "OBJECT")
+            string(JSON macro_name ERROR_VARIABLE err GET "${json}" config ${key} macro_name)
+            if(err)
+                mbed_config_macro_name(${prefix} ${key} macro_name)
+            endif()
+            string(JSON has_value ERROR_VARIABLE err TYPE "${json}" config ${key} value)
+            if(err)
+                continue()
+            endif()
+            mbed_config_value("${json}" "config;${key};value" value)
+        else()
+            mbed_config_macro_name(${prefix} ${key} macro_name)
+            mbed_config_value("${json}" "config;${key}" value)
+        endif()
+        list(APPEND names "${macro_name}")
+        list(APPEND values "${value}")
+    endforeach()
+
+    # Application-wide overrides for every target
+    string(JSON num_overrides ERROR_VARIABLE err LENGTH "${json}" target_overrides "*")
+    if(NOT err AND num_overrides GREATER 0)
+        math(EXPR last "${num_overrides} - 1")
+        foreach(i RANGE ${last})
+            string(JSON key MEMBER "${json}" target_overrides "*" ${i})
+            if(NOT key MATCHES "^app\\.")
+                continue()
+            endif()
+            string(REGEX REPLACE "^app\\." "" key "${key}")
+            mbed_config_macro_name(app ${key} macro_name)
+            mbed_config_value("${json}" "target_overrides;*;app.${key}" value)
+            list(FIND names "${macro_name}" index)
+            if(index GREATER_EQUAL 0)
+                list(REMOVE_AT values ${index})
+                list(INSERT values ${index} "${value}")
+            endif()
+        endforeach()
+    endif()
+
+    set(${var}_NAMES "${names}" PARENT_SCOPE)
+    set(${var}_VALUES "${values}" PARENT_SCOPE)
+endfunction()
+
+# mbed_host_config(<output header> APP <mbed_app.json> LIBS <mbed_lib.json...> HOST_OVERRIDES <prefix.key=value...>)
+function(mbed_host_config output)
+    cmake_parse_arguments(ARG "" "APP" "LIBS;HOST_OVERRIDES" ${ARGN})
+
+    set(CONFIG_NAMES "")
+    set(CONFIG_VALUES "")
+    set(depends "${ARG_APP}")
+    mbed_config_read("${ARG_APP}" app CONFIG)
+    foreach(lib ${ARG_LIBS})
+        file(READ "${lib}" json)
+        string(JSON lib_name GET "${json}" name)
+        mbed_config_read("${lib}" "${lib_name}" CONFIG)
+        list(APPEND depends "${lib}")
+    endforeach()
+
+    foreach(override ${ARG_HOST_OVERRIDES})
+        string(REGEX MATCH "^([^.]+)\\.([^=]+)=(.*)$" match "${override}")
+        mbed_config_macro_name(${CMAKE_MATCH_1} ${CMAKE_MATCH_2} macro_name)
+        set(value "${CMAKE_MATCH_3}")
+        list(FIND CONFIG_NAMES "${macro_name}" index)
+        if(index GREATER_EQUAL 0)
+            list(REMOVE_AT CONFIG_VALUES ${index})
+            list(INSERT CONFIG_VALUES ${index} "${value}")
+        else()
+            list(APPEND CONFIG_NAMES "${macro_name}")
+            list(APPEND CONFIG_VALUES "${value}")
+        endif()
+    endforeach()
+
+    set(content "/* Generated by tools/host/cmake/MbedConfig.cmake from mbed_app.json and mbed_lib.json; do not edit */\n")
+    string(APPEND content "#ifndef HOST_MBED_CONFIG_H\n#define HOST_MBED_CONFIG_H\n\n")
+    # Same guard as the mbed-cli generated mbed_config.h, which is then skipped wherever it is included
+    string(APPEND content "#define __MBED_CONFIG_DATA__\n\n")
+    list(LENGTH CONFIG_NAMES num_names)
+    if(num_names GREATER 0)
+        math(EXPR last "${num_names} - 1")
+        foreach(i RANGE ${last})
+            list(GET CONFIG_NAMES ${i} name)
+            list(GET CONFIG_VALUES ${i} value)
+            if(NOT value STREQUAL "")
+                string(APPEND content "#define ${name} ${value}\n")
+            endif()
+        endforeach()
+    endif()
+    string(APPEND content "\n#endif  // HOST_MBED_CONFIG_H\n")
+
+    file(CONFIGURE OUTPUT "${output}" CONTENT "${content}" @ONLY)
+    set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS ${depends})
+endfunction()
@@ -0,0 +1,177 @@
+/**
+ * @defgroup host_greentea Host Greentea Stand-in
+ * @{
+ */
+
+#include <math.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+
+namespace {
+
+jmp_buf case_abort;
+bool case_running = false;
+bool case_failed = false;
+
+}  // namespace
+
+void greentea_host_setup(const int timeout, const char* host_test_name)
+{
+    /* SIGALRM terminates the binary, which the test runner reports as a failure */
+    alarm(timeout);
+    printf("{{__timeout;%d}}\r\n{{__host_test_name;%s}}\r\n", timeout, host_test_name);
+}
+
+void UnityFail(const char* message, const char* detail, int line)
+{
+    printf("  :%d::FAIL", line);
+    if (detail)
+    {
+        printf(": %s", detail);
+    }
+    if (message)
+    {
+        printf(". %s", message);
+    }
+    printf("\r\n");
+    fflush(stdout);
+
+    case_failed = true;
+    if (case_running)
+    {
+        longjmp(case_abort, 1);
+    }
+}
+
+void UnityAssertEqualNumber(int64_t expected, int64_t actual, const char* message, int line, UNITY_DISPLAY_STYLE_T style)
+{
+    if (expected == actual)
+    {
+        return;
+    }
+
+    char detail[96];
+    switch (style)
+    {
+        case UNITY_DISPLAY_STYLE_HEX8:
+            snprintf(detail, sizeof(detail), "Expected 0x%02llX Was 0x%02llX", (unsigned long long)expected, (unsigned long long)actual);
+            break;
+        case UNITY_DISPLAY_STYLE_HEX16:
+            snprintf(detail, sizeof(detail), "Expected 0x%04llX Was 0x%04llX", (unsigned long long)expected, (unsigned long long)actual);
+            break;
+        case UNITY_DISPLAY_STYLE_HEX32:
+            snprintf(detail, sizeof(detail), "Expected 0x%08llX Was 0x%08llX", (unsigned long long)expected, (unsigned long long)actual);
+            break;
+        case UNITY_DISPLAY_STYLE_UINT:
+            snprintf(detail, sizeof(detail), "Expected %llu Was %llu", (unsigned long long)expected, (unsigned long long)actual);
+            break;
+        default:
+            snprintf(detail, sizeof(detail), "Expected %lld Was %lld", (long long)expected, (long long)actual);
+            break;
+    }
+    UnityFail(message, detail, line);
+}
+
+void UnityAssertEqualString(const char* expected, const char* actual, const char* message, int line)
+{
+    if (expected == actual || (expected && actual && strcmp(expected, actual) == 0))
+    {
+        return;
+    }
+
+    printf("  Expected \"%s\" Was \"%s\"\r\n", expected ? expected : "NULL", actual ? actual : "NULL");
+    UnityFail(message, "String Mismatch", line);
+}
+
+void UnityAssertDoublesWithin(double delta, double expected, double actual, const char* message, int line)
+{
+    if (isinf(expected) && isinf(actual) && (expected > 0) == (actual > 0))
+    {
+        return;
+    }
+
+    double diff = fabs(actual - expected);
+    if (!isnan(diff) && !isinf(diff) && diff <= fabs(delta))
+    {
+        return;
+    }
+
+    char detail[96];
+    snprintf(detail, sizeof(detail), "Expected %.9g Was %.9g", expected, actual);
+    UnityFail(message, detail, line);
+}
+
+void UnityAssertEqualFloatArray(const float* expected, const float* actual, uint32_t num_elements, const char* message, int line)
+{
+    for (uint32_t i = 0; i < num_elements; i++)
+    {
+        double delta = expected[i] * UNITY_FLOAT_PRECISION;
+        double diff = fabs((double)actual[i] - (double)expected[i]);
+        if (isnan(diff) || diff > fabs(delta))
+        {
+            char detail[96];
+            snprintf(detail, sizeof(detail), "Element %u Expected %.9g Was %.9g", i, expected[i], actual[i]);
+            UnityFail(message, detail, line);
+        }
+    }
+}
+
+namespace utest {
+namespace v1 {
+
+status_t greentea_test_setup_handler(const size_t number_of_cases)
+{
+    printf("{{__testcase_count;%u}}\r\n", (unsigned)number_of_cases);
+    return STATUS_CONTINUE;
+}
+
+bool Harness::run(const Specification& specification)
+{
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    if (specification.setup_handler_ && specification.setup_handler_(specification.length_) != STATUS_CONTINUE)
+    {
+        printf("{{end;failure}}\r\n");
+        return false;
+    }
+
+    size_t passed = 0;
+    size_t failed = 0;
+    for (size_t i = 0; i < specification.length_; i++)
+    {
+        const Case& test_case = specification.cases_[i];
+        printf("{{__testcase_start;%s}}\r\n", test_case.get_description());
+
+        case_failed = false;
+        case_running = true;
+        if (setjmp(case_abort) == 0)
+        {
+            test_case.get_handler()(0);
+        }
+        case_running = false;
+
+        printf("{{__testcase_finish;%s;%d;%d}}\r\n", test_case.get_description(), case_failed ? 0 : 1, case_failed ? 1 : 0);
+        if (case_failed)
+        {
+            failed++;
+        }
+        else
+        {
+            passed++;
+        }
+    }
+
+    printf("{{__testcase_summary;%u;%u}}\r\n", (unsigned)passed, (unsigned)failed);
+    printf("{{end;%s}}\r\n", failed ? "failure" : "success");
+    return failed == 0;
+}
+
+}  // namespace v1
+}  // namespace utest
+
+/** @}*/
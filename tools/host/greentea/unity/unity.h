@@ -0,0 +1,109 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_UNITY_H
+#define HOST_UNITY_H
+
+#include <stdint.h>
+
+/* Host stand-in for the Unity assertions used by the greentea tests. A failed assertion ends the current
+ * case, as in Unity. Float comparisons use Unity's relative precision (1e-5 for float, 1e-12 for double). */
+
+#define UNITY_FLOAT_PRECISION   0.00001f
+#define UNITY_DOUBLE_PRECISION  1e-12
+
+typedef enum {
+    UNITY_DISPLAY_STYLE_INT,
+    UNITY_DISPLAY_STYLE_UINT,
+    UNITY_DISPLAY_STYLE_HEX8,
+    UNITY_DISPLAY_STYLE_HEX16,
+    UNITY_DISPLAY_STYLE_HEX32
+} UNITY_DISPLAY_STYLE_T;
+
+void UnityFail(const char* message, const char* detail, int line);
+void UnityAssertEqualNumber(int64_t expected, int64_t actual, const char* message, int line, UNITY_DISPLAY_STYLE_T style);
+void UnityAssertEqualString(const char* expected, const char* actual, const char* message, int line);
+void UnityAssertDoublesWithin(double delta, double expected, double actual, const char* message, int line);
+void UnityAssertEqualFloatArray(const float* expected, const float* actual, uint32_t num_elements, const char* message, int line);
+
+#define TEST_FAIL_MESSAGE(message)                      UnityFail((message), NULL, __LINE__)
+#define TEST_FAIL()                                     UnityFail(NULL, NULL, __LINE__)
+
+#define TEST_ASSERT_MESSAGE(condition, message)         do { if (!(condition)) { UnityFail((message), "Expression Evaluated To FALSE", __LINE__); } } while (0)
+#define TEST_ASSERT(condition)                          TEST_ASSERT_MESSAGE(condition, NULL)
+#define TEST_ASSERT_TRUE(condition)                     TEST_ASSERT_MESSAGE(condition, NULL)
+#define TEST_ASSERT_TRUE_MESSAGE(condition, message)    TEST_ASSERT_MESSAGE(condition, message)
+#define TEST_ASSERT_FALSE(condition)                    do { if (condition) { UnityFail(NULL, "Expected FALSE Was TRUE", __LINE__); } } while (0)
+#define TEST_ASSERT_FALSE_MESSAGE(condition, message)   do { if (condition) { UnityFail((message), "Expected FALSE Was TRUE", __LINE__); } } while (0)
+#define TEST_ASSERT_NULL(pointer)                       TEST_ASSERT_MESSAGE((pointer) == NULL, "Expected NULL")
+#define TEST_ASSERT_NOT_NULL(pointer)                   TEST_ASSERT_MESSAGE((pointer) != NULL, "Expected Non-NULL")
+
+#define TEST_ASSERT_EQUAL_INT_MESSAGE(expected, actual, message) \
+    UnityAssertEqualNumber((int64_t)(expected), (int64_t)(actual), (message), __LINE__, UNITY_DISPLAY_STYLE_INT)
+#define TEST_ASSERT_EQUAL_INT(expected, actual)         TEST_ASSERT_EQUAL_INT_MESSAGE(expected, actual, NULL)
+#define TEST_ASSERT_EQUAL(expected, actual)             TEST_ASSERT_EQUAL_INT_MESSAGE(expected, actual, NULL)
+#define TEST_ASSERT_EQUAL_MESSAGE(expected, actual, message) TEST_ASSERT_EQUAL_INT_MESSAGE(expected, actual, message)
+#define TEST_ASSERT_EQUAL_INT32(expected, actual)       TEST_ASSERT_EQUAL_INT_MESSAGE((int32_t)(expected), (int32_t)(actual), NULL)
+#define TEST_ASSERT_EQUAL_UINT(expected, actual) \
+    UnityAssertEqualNumber((int64_t)(uint32_t)(expected), (int64_t)(uint32_t)(actual), NULL, __LINE__, UNITY_DISPLAY_STYLE_UINT)
+#define TEST_ASSERT_EQUAL_UINT32(expected, actual)      TEST_ASSERT_EQUAL_UINT(expected, actual)
+#define TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected, actual, message) \
+    UnityAssertEqualNumber((int64_t)(uint32_t)(expected), (int64_t)(uint32_t)(actual), (message), __LINE__, UNITY_DISPLAY_STYLE_UINT)
+#define TEST_ASSERT_EQUAL_UINT8(expected, actual) \
+    UnityAssertEqualNumber((int64_t)(uint8_t)(expected), (int64_t)(uint8_t)(actual), NULL, __LINE__, UNITY_DISPLAY_STYLE_UINT)
+#define TEST_ASSERT_EQUAL_UINT16(expected, actual) \
+    UnityAssertEqualNumber((int64_t)(uint16_t)(expected), (int64_t)(uint16_t)(actual), NULL, __LINE__, UNITY_DISPLAY_STYLE_UINT)
+#define TEST_ASSERT_EQUAL_UINT64(expected, actual) \
+    UnityAssertEqualNumber((int64_t)(uint64_t)(expected), (int64_t)(uint64_t)(actual), NULL, __LINE__, UNITY_DISPLAY_STYLE_UINT)
+#define TEST_ASSERT_EQUAL_HEX8(expected, actual) \
+    UnityAssertEqualNumber((int64_t)(uint8_t)(expected), (int64_t)(uint8_t)(actual), NULL, __LINE__, UNITY_DISPLAY_STYLE_HEX8)
+#define TEST_ASSERT_EQUAL_HEX16(expected, actual) \
+    UnityAssertEqualNumber((int64_t)(uint16_t)(expected), (int64_t)(uint16_t)(actual), NULL, __LINE__, UNITY_DISPLAY_STYLE_HEX16)
+#define TEST_ASSERT_EQUAL_HEX32(expected, actual) \
+    UnityAssertEqualNumber((int64_t)(uint32_t)(expected), (int64_t)(uint32_t)(actual), NULL, __LINE__, UNITY_DISPLAY_STYLE_HEX32)
+
+#define TEST_ASSERT_NOT_EQUAL_MESSAGE(expected, actual, message) \
+    do { if ((expected) == (actual)) { UnityFail((message), "Expected Not-Equal", __LINE__); } } while (0)
+#define TEST_ASSERT_NOT_EQUAL(expected, actual)         TEST_ASSERT_NOT_EQUAL_MESSAGE(expected, actual, NULL)
+
+#define TEST_ASSERT_GREATER_THAN(threshold, actual) \
+    do { if (!((actual) > (threshold))) { UnityFail(NULL, "Expected Greater Than Threshold", __LINE__); } } while (0)
+#define TEST_ASSERT_LESS_THAN(threshold, actual) \
+    do { if (!((actual) < (threshold))) { UnityFail(NULL, "Expected Less Than Threshold", __LINE__); } } while (0)
+#define TEST_ASSERT_GREATER_OR_EQUAL(threshold, actual) \
+    do { if (!((actual) >= (threshold))) { UnityFail(NULL, "Expected Greater Or Equal To Threshold", __LINE__); } } while (0)
+#define TEST_ASSERT_LESS_OR_EQUAL(threshold, actual) \
+    do { if (!((actual) <= (threshold))) { UnityFail(NULL, "Expected Less Or Equal To Threshold", __LINE__); } } while (0)
+
+#define TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, actual, message) \
+    UnityAssertEqualString((const char*)(expected), (const char*)(actual), (message), __LINE__)
+#define TEST_ASSERT_EQUAL_STRING(expected, actual)      TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, actual, NULL)
+
+#define TEST_ASSERT_FLOAT_WITHIN_MESSAGE(delta, expected, actual, message) \
+    UnityAssertDoublesWithin((double)(float)(delta), (double)(float)(expected), (double)(float)(actual), (message), __LINE__)
+#define TEST_ASSERT_FLOAT_WITHIN(delta, expected, actual) TEST_ASSERT_FLOAT_WITHIN_MESSAGE(delta, expected, actual, NULL)
+#define TEST_ASSERT_EQUAL_FLOAT(expected, actual) \
+    TEST_ASSERT_FLOAT_WITHIN((float)(expected) * UNITY_FLOAT_PRECISION, expected, actual)
+#define TEST_ASSERT_EQUAL_FLOAT_MESSAGE(expected, actual, message) \
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE((float)(expected) * UNITY_FLOAT_PRECISION, expected, actual, message)
+#define TEST_ASSERT_EQUAL_FLOAT_ARRAY(expected, actual, num_elements) \
+    UnityAssertEqualFloatArray((expected), (actual), (uint32_t)(num_elements), NULL, __LINE__)
+
+#define TEST_ASSERT_DOUBLE_WITHIN(delta, expected, actual) \
+    UnityAssertDoublesWithin((double)(delta), (double)(expected), (double)(actual), NULL, __LINE__)
+#define TEST_ASSERT_EQUAL_DOUBLE(expected, actual) \
+    TEST_ASSERT_DOUBLE_WITHIN((double)(expected) * UNITY_DOUBLE_PRECISION, expected, actual)
+
+#endif  // HOST_UNITY_H
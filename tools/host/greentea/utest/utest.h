@@ -0,0 +1,76 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_UTEST_H
+#define HOST_UTEST_H
+
+#include <stddef.h>
+
+/* Host stand-in for the subset of utest used by the greentea tests: cases run in order, each to completion
+ * or to its first failed assertion, and results are reported with the greentea testcase markers. */
+
+namespace utest {
+namespace v1 {
+
+enum control_t {
+    CaseNext
+};
+
+enum status_t {
+    STATUS_CONTINUE = 0,
+    STATUS_ABORT = -1
+};
+
+typedef control_t (*case_handler_t)(const size_t call_count);
+typedef status_t (*test_setup_handler_t)(const size_t number_of_cases);
+
+class Case
+{
+    public:
+        Case(const char* description, case_handler_t handler) : description_(description), handler_(handler) {}
+
+        const char* get_description() const { return description_; }
+        case_handler_t get_handler() const { return handler_; }
+
+    private:
+        const char* description_;
+        case_handler_t handler_;
+};
+
+class Specification
+{
+    public:
+        template <size_t N>
+        Specification(test_setup_handler_t setup_handler, Case (&cases)[N])
+            : setup_handler_(setup_handler), cases_(cases), length_(N) {}
+
+        test_setup_handler_t setup_handler_;
+        Case* cases_;
+        size_t length_;
+};
+
+class Harness
+{
+    public:
+        /** Runs every case of specification; returns true if all of them passed */
+        static bool run(const Specification& specification);
+};
+
+status_t greentea_test_setup_handler(const size_t number_of_cases);
+
+}  // namespace v1
+}  // namespace utest
+
+#endif  // HOST_UTEST_H
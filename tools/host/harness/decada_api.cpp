@@ -0,0 +1,154 @@
+/**
+ * @defgroup host_decada_api Host DECADA API
+ * @{
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include "decada_api.h"
+
+bool HostDecadaApi::Start(uint16_t port)
+{
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0)
+    {
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd_, 4) != 0)
+    {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    accept_thread_ = std::thread(&HostDecadaApi::AcceptLoop, this);
+    return true;
+}
+
+void HostDecadaApi::Stop(void)
+{
+    if (!running_)
+    {
+        return;
+    }
+
+    running_ = false;
+    shutdown(listen_fd_, SHUT_RDWR);
+    close(listen_fd_);
+    accept_thread_.join();
+}
+
+std::vector<std::string> HostDecadaApi::GetRequests(void)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requests_;
+}
+
+void HostDecadaApi::AcceptLoop(void)
+{
+    while (running_)
+    {
+        int fd = accept(listen_fd_, NULL, NULL);
+        if (fd >= 0)
+        {
+            Serve(fd);
+        }
+    }
+}
+
+/**
+ *  @brief  Response body for a REST call, in the envelope DecadaManager parses ({"data": {...}}).
+ *  @author Lee Tze Han
+ *  @param  method  HTTP method
+ *  @param  uri     Request URI including the query string
+ *  @return JSON body
+ */
+std::string HostDecadaApi::Respond(const std::string& method, const std::string& uri)
+{
+    if (uri.find("/token/get") != std::string::npos)
+    {
+        return "{\"status\":0,\"msg\":\"OK\",\"data\":{\"accessToken\":\"host-access-token\",\"expire\":7199}}";
+    }
+    if (uri.find("/devices") != std::string::npos)
+    {
+        return "{\"code\":0,\"msg\":\"OK\",\"data\":{\"deviceSecret\":\"host-device-secret\"}}";
+    }
+    if (uri.find("/certificates") != std::string::npos)
+    {
+        return "{\"code\":0,\"msg\":\"OK\",\"data\":{\"cert\":\"host-client-certificate\",\"certSN\":\"1\"}}";
+    }
+    return "{\"code\":404,\"msg\":\"Not Found\"}";
+}
+
+/**
+ *  @brief  Reads one request (headers and Content-Length body) and answers it.
+ *  @author Lee Tze Han
+ *  @param  fd  Connection socket
+ */
+void HostDecadaApi::Serve(int fd)
+{
+    std::string request;
+    char buf[1024];
+    size_t header_end = std::string::npos;
+    size_t content_length = 0;
+
+    while (true)
+    {
+        ssize_t received = recv(fd, buf, sizeof(buf), 0);
+        if (received <= 0)
+        {
+            close(fd);
+            return;
+        }
+        request.append(buf, received);
+
+        if (header_end == std::string::npos)
+        {
+            header_end = request.find("\r\n\r\n");
+            if (header_end != std::string::npos)
+            {
+                const char* length_header = strcasestr(request.c_str(), "Content-Length:");
+                if (length_header && length_header < request.c_str() + header_end)
+                {
+                    content_length = strtoul(length_header + strlen("Content-Length:"), NULL, 10);
+                }
+            }
+        }
+        if (header_end != std::string::npos && request.size() >= header_end + 4 + content_length)
+        {
+            break;
+        }
+    }
+
+    std::string request_line = request.substr(0, request.find("\r\n"));
+    size_t method_end = request_line.find(' ');
+    size_t uri_end = request_line.find(' ', method_end + 1);
+    std::string method = request_line.substr(0, method_end);
+    std::string uri = request_line.substr(method_end + 1, uri_end - method_end - 1);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests_.push_back(request_line);
+    }
+
+    std::string body = Respond(method, uri);
+    std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json;charset=UTF-8\r\nContent-Length: " +
+                           std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+    close(fd);
+}
+
+/** @}*/
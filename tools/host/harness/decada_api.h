@@ -0,0 +1,54 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_DECADA_API_H
+#define HOST_DECADA_API_H
+
+#include <stdint.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** HostDecadaApi class.
+ *  @brief  Loopback HTTP server standing in for the DECADA REST API used during provisioning
+ *
+ *  Answers token, device and certificate requests with fixed credentials, one request per connection,
+ *  and records the request line of each call.
+ */
+class HostDecadaApi
+{
+    public:
+        HostDecadaApi() : listen_fd_(-1), running_(false) {}
+        ~HostDecadaApi() { Stop(); }
+
+        bool Start(uint16_t port);
+        void Stop(void);
+        std::vector<std::string> GetRequests(void);
+
+        static std::string Respond(const std::string& method, const std::string& uri);
+
+    private:
+        void AcceptLoop(void);
+        void Serve(int fd);
+
+        int listen_fd_;
+        bool running_;
+        std::thread accept_thread_;
+        std::mutex mutex_;
+        std::vector<std::string> requests_;
+};
+
+#endif  // HOST_DECADA_API_H
@@ -0,0 +1,371 @@
+/**
+ * @defgroup host_mqtt_broker Host MQTT Broker
+ * @{
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include "mbed.h"
+#include "mbed_trace.h"
+#include "MQTTPacket.h"
+#include "mqtt_broker.h"
+
+#define TRACE_GROUP "HostMqttBroker"
+
+/**
+ *  @brief  Listens on the loopback interface and starts accepting connections.
+ *  @author Lee Tze Han
+ *  @param  port    TCP port
+ *  @return false if the port could not be bound
+ */
+bool HostMqttBroker::Start(uint16_t port)
+{
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0)
+    {
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listen_fd_, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listen_fd_, 4) != 0)
+    {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    running_ = true;
+    accept_thread_ = std::thread(&HostMqttBroker::AcceptLoop, this);
+    return true;
+}
+
+void HostMqttBroker::Stop(void)
+{
+    if (!running_)
+    {
+        return;
+    }
+
+    running_ = false;
+    shutdown(listen_fd_, SHUT_RDWR);
+    close(listen_fd_);
+    accept_thread_.join();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& connection : connections_)
+    {
+        shutdown(connection.first, SHUT_RDWR);
+    }
+}
+
+void HostMqttBroker::AcceptLoop(void)
+{
+    while (running_)
+    {
+        int fd = accept(listen_fd_, NULL, NULL);
+        if (fd < 0)
+        {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            connections_[fd] = {fd, {}};
+        }
+        std::thread(&HostMqttBroker::Serve, this, fd).detach();
+    }
+}
+
+/**
+ *  @brief  Reads one control packet (fixed header, remaining length and body).
+ *  @author Lee Tze Han
+ *  @param  fd      Connection socket
+ *  @param  packet  Receives the whole packet
+ *  @return false if the connection was closed
+ */
+bool HostMqttBroker::ReadPacket(int fd, std::vector<unsigned char>& packet)
+{
+    unsigned char byte;
+    packet.clear();
+    if (recv(fd, &byte, 1, MSG_WAITALL) != 1)
+    {
+        return false;
+    }
+    packet.push_back(byte);
+
+    /* Remaining length: up to 4 bytes of 7 bits each */
+    int remaining = 0;
+    int multiplier = 1;
+    do
+    {
+        if (recv(fd, &byte, 1, MSG_WAITALL) != 1 || multiplier > 128*128*128)
+        {
+            return false;
+        }
+        packet.push_back(byte);
+        remaining += (byte & 127) * multiplier;
+        multiplier *= 128;
+    } while (byte & 128);
+
+    size_t header_length = packet.size();
+    packet.resize(header_length + remaining);
+    return remaining == 0 || recv(fd, packet.data() + header_length, remaining, MSG_WAITALL) == remaining;
+}
+
+bool HostMqttBroker::Send(int fd, const unsigned char* buf, int len)
+{
+    return len > 0 && send(fd, buf, len, MSG_NOSIGNAL) == len;
+}
+
+/**
+ *  @brief  Serves one device connection until it disconnects.
+ *  @author Lee Tze Han
+ *  @param  fd  Connection socket
+ */
+void HostMqttBroker::Serve(int fd)
+{
+    std::vector<unsigned char> packet;
+    unsigned char reply[64];
+
+    while (ReadPacket(fd, packet))
+    {
+        MQTTHeader header;
+        header.byte = packet[0];
+        int len = (int)packet.size();
+
+        switch (header.bits.type)
+        {
+            case CONNECT:
+            {
+                MQTTPacket_connectData data = MQTTPacket_connectData_initializer;
+                unsigned char rc = MQTTDeserialize_connect(&data, packet.data(), len) == 1 ? 0 : 2;
+                uint32_t delay_ms;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    connect_count_++;
+                    delay_ms = connack_delay_ms_;
+                }
+                tr_info("CONNECT %.*s (rc = %d)", data.clientID.lenstring.len, data.clientID.lenstring.data, rc);
+                if (delay_ms > 0)
+                {
+                    tr_info("CONNACK held back %lu ms", (unsigned long)delay_ms);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+                }
+                Send(fd, reply, MQTTSerialize_connack(reply, sizeof(reply), rc, 0));
+                break;
+            }
+            case SUBSCRIBE:
+            {
+                const int max_filters = 8;
+                unsigned char dup;
+                unsigned short packet_id;
+                int count = 0;
+                MQTTString filters[max_filters];
+                int qos[max_filters];
+                if (MQTTDeserialize_subscribe(&dup, &packet_id, max_filters, &count, filters, qos, packet.data(), len) != 1)
+                {
+                    break;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (int i = 0; i < count; i++)
+                    {
+                        std::string filter(filters[i].lenstring.data, filters[i].lenstring.len);
+                        connections_[fd].subscriptions[filter] = qos[i];
+                        tr_info("SUBSCRIBE %s (QoS %d)", filter.c_str(), qos[i]);
+                    }
+                }
+                Send(fd, reply, MQTTSerialize_suback(reply, sizeof(reply), packet_id, count, qos));
+                break;
+            }
+            case UNSUBSCRIBE:
+            {
+                const int max_filters = 8;
+                unsigned char dup;
+                unsigned short packet_id;
+                int count = 0;
+                MQTTString filters[max_filters];
+                if (MQTTDeserialize_unsubscribe(&dup, &packet_id, max_filters, &count, filters, packet.data(), len) != 1)
+                {
+                    break;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (int i = 0; i < count; i++)
+                    {
+                        connections_[fd].subscriptions.erase(std::string(filters[i].lenstring.data, filters[i].lenstring.len));
+                    }
+                }
+                Send(fd, reply, MQTTSerialize_unsuback(reply, sizeof(reply), packet_id));
+                break;
+            }
+            case PUBLISH:
+            {
+                unsigned char dup, retained;
+                int qos;
+                unsigned short packet_id;
+                MQTTString topic;
+                unsigned char* payload;
+                int payload_len;
+                if (MQTTDeserialize_publish(&dup, &qos, &retained, &packet_id, &topic, &payload, &payload_len, packet.data(), len) != 1)
+                {
+                    break;
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    publishes_.push_back({std::string(topic.lenstring.data, topic.lenstring.len),
+                                          std::string((const char*)payload, payload_len),
+                                          Kernel::get_ms_count()});
+                }
+                published_.notify_all();
+
+                if (qos == 1)
+                {
+                    Send(fd, reply, MQTTSerialize_puback(reply, sizeof(reply), packet_id));
+                }
+                break;
+            }
+            case PINGREQ:
+            {
+                const unsigned char pingresp[] = {PINGRESP << 4, 0x00};
+                Send(fd, pingresp, sizeof(pingresp));
+                break;
+            }
+            case DISCONNECT:
+                shutdown(fd, SHUT_RDWR);
+                break;
+            default:
+                /* PUBACK for injected QoS 1 messages, and anything else, needs no response */
+                break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    connections_.erase(fd);
+    close(fd);
+}
+
+int HostMqttBroker::Inject(const std::string& topic, const std::string& payload)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    int deliveries = 0;
+    for (auto& connection : connections_)
+    {
+        for (auto& subscription : connection.second.subscriptions)
+        {
+            if (!TopicMatches(subscription.first, topic))
+            {
+                continue;
+            }
+
+            std::vector<unsigned char> buf(topic.size() + payload.size() + 16);
+            MQTTString topic_name = MQTTString_initializer;
+            topic_name.cstring = (char*)topic.c_str();
+            int qos = std::min(subscription.second, 1);
+            int len = MQTTSerialize_publish(buf.data(), (int)buf.size(), 0, qos, 0, next_packet_id_++, topic_name,
+                                            (unsigned char*)payload.data(), (int)payload.size());
+            if (Send(connection.first, buf.data(), len))
+            {
+                deliveries++;
+            }
+            break;
+        }
+    }
+    return deliveries;
+}
+
+size_t HostMqttBroker::CountPublishes(const std::string& topic_suffix)
+{
+    return std::count_if(publishes_.begin(), publishes_.end(), [&topic_suffix](const publish_t& publish) {
+        return publish.topic.size() >= topic_suffix.size() &&
+               publish.topic.compare(publish.topic.size() - topic_suffix.size(), topic_suffix.size(), topic_suffix) == 0;
+    });
+}
+
+bool HostMqttBroker::WaitForPublishes(const std::string& topic_suffix, size_t count, uint32_t timeout_ms)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return published_.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                               [this, &topic_suffix, count] { return CountPublishes(topic_suffix) >= count; });
+}
+
+std::vector<HostMqttBroker::publish_t> HostMqttBroker::GetPublishes(void)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return publishes_;
+}
+
+size_t HostMqttBroker::GetConnectCount(void)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return connect_count_;
+}
+
+void HostMqttBroker::SetConnackDelay(uint32_t delay_ms)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    connack_delay_ms_ = delay_ms;
+}
+
+void HostMqttBroker::DropConnections(void)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& connection : connections_)
+    {
+        shutdown(connection.first, SHUT_RDWR);
+    }
+}
+
+/**
+ *  @brief  MQTT topic filter matching with the + and # wildcards.
+ *  @author Lee Tze Han
+ *  @param  filter  Topic filter
+ *  @param  topic   Topic name
+ *  @return true if topic matches filter
+ */
+bool HostMqttBroker::TopicMatches(const std::string& filter, const std::string& topic)
+{
+    size_t f = 0;
+    size_t t = 0;
+    while (f < filter.size())
+    {
+        if (filter[f] == '#')
+        {
+            return true;
+        }
+
+        size_t f_end = filter.find('/', f);
+        size_t t_end = topic.find('/', t);
+        f_end = (f_end == std::string::npos) ? filter.size() : f_end;
+        t_end = (t_end == std::string::npos) ? topic.size() : t_end;
+
+        if (t > topic.size())
+        {
+            return false;
+        }
+        if (!(filter.compare(f, f_end - f, "+") == 0 || filter.compare(f, f_end - f, topic, t, t_end - t) == 0))
+        {
+            return false;
+        }
+
+        f = f_end + 1;
+        t = t_end + 1;
+    }
+    return t > topic.size();
+}
+
+/** @}*/
@@ -0,0 +1,88 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_MQTT_BROKER_H
+#define HOST_MQTT_BROKER_H
+
+#include <stdint.h>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/** HostMqttBroker class.
+ *  @brief  Loopback MQTT 3.1.1 broker standing in for DECADA, built on the server side of MQTTPacket
+ *
+ *  Accepts any CONNECT, grants every SUBSCRIBE at the requested QoS and records every PUBLISH from the device.
+ *  Messages are delivered to the device with Inject(); there is no routing between clients.
+ */
+class HostMqttBroker
+{
+    public:
+        typedef struct {
+            std::string topic;
+            std::string payload;
+            uint64_t time_ms;               /// Kernel clock at arrival
+        } publish_t;
+
+        HostMqttBroker() : listen_fd_(-1), running_(false), next_packet_id_(1) {}
+        ~HostMqttBroker() { Stop(); }
+
+        bool Start(uint16_t port);
+        void Stop(void);
+
+        /** Publishes payload to every connection subscribed to a filter matching topic; returns number of deliveries */
+        int Inject(const std::string& topic, const std::string& payload);
+
+        /** Waits until count publishes whose topic ends with topic_suffix were recorded */
+        bool WaitForPublishes(const std::string& topic_suffix, size_t count, uint32_t timeout_ms);
+        std::vector<publish_t> GetPublishes(void);
+        size_t GetConnectCount(void);
+
+        /** Holds back the CONNACK of every later CONNECT by delay_ms, as a broker stalled mid-handshake */
+        void SetConnackDelay(uint32_t delay_ms);
+        /** Closes every device connection, as a broker restart would */
+        void DropConnections(void);
+
+        static bool TopicMatches(const std::string& filter, const std::string& topic);
+
+    private:
+        typedef struct {
+            int fd;
+            std::map<std::string, int> subscriptions;      /// topic filter to granted QoS
+        } connection_t;
+
+        void AcceptLoop(void);
+        void Serve(int fd);
+        bool ReadPacket(int fd, std::vector<unsigned char>& packet);
+        bool Send(int fd, const unsigned char* buf, int len);
+        size_t CountPublishes(const std::string& topic_suffix);
+
+        int listen_fd_;
+        bool running_;
+        std::thread accept_thread_;
+
+        std::mutex mutex_;
+        std::condition_variable published_;
+        std::map<int, connection_t> connections_;
+        std::vector<publish_t> publishes_;
+        size_t connect_count_ = 0;
+        uint32_t connack_delay_ms_ = 0;
+        unsigned short next_packet_id_;
+};
+
+#endif  // HOST_MQTT_BROKER_H
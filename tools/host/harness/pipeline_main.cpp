@@ -0,0 +1,318 @@
+/**
+ * @defgroup host_pipeline Host Pipeline
+ * @{
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include "mbed.h"
+#include "mbed_trace.h"
+#include "global_params.h"
+#include "threads.h"
+#include "persist_store.h"
+#include "diagnostics.h"
+#include "power_manager.h"
+#include "watchdog_supervisor.h"
+#include "latency_trace.h"
+#include "decada_endpoints.h"
+#include "dns_cache.h"
+#include "decada_api.h"
+#include "mqtt_broker.h"
+
+#define TRACE_GROUP "HostPipeline"
+
+/* Defined in main.cpp, which is built with MBED_TEST_MODE so that its main() is left out */
+extern Thread thread_1;
+extern Thread thread_2;
+extern Thread thread_3;
+extern Thread thread_4;
+
+namespace {
+
+const uint16_t mqtt_port = 18885;
+const uint16_t api_port = 18080;        /// must match the decada-api-url host override in tools/host/CMakeLists.txt
+const char* const mqtt_host = "mqtt.decada.gov.sg";
+
+typedef struct {
+    int publishes;          /// measure point publishes to wait for
+    int timeout_s;          /// overall limit
+    uint16_t api_port;      /// port of the REST API stand-in
+    bool service;           /// exercise the service request/response path
+    bool warm_boot;         /// RTC and device secret kept from a previous boot
+    int stall_s;            /// drop the MQTT connection and hold back the CONNACK of the reconnection this long; 0 skips
+    int deadline_s;         /// in place of watchdog-thread-deadline for the application threads; 0 keeps it
+} options_t;
+
+void Usage(const char* program)
+{
+    printf("Usage: %s [--publishes N] [--timeout S] [--api-port P] [--no-service] [--warm-boot] [--stall-reconnect S] [--thread-deadline S]\r\n", program);
+}
+
+bool ParseOptions(int argc, char** argv, options_t& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        bool has_value = (i + 1 < argc);
+        if (strcmp(argv[i], "--publishes") == 0 && has_value)
+        {
+            options.publishes = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--timeout") == 0 && has_value)
+        {
+            options.timeout_s = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--api-port") == 0 && has_value)
+        {
+            options.api_port = (uint16_t)atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--no-service") == 0)
+        {
+            options.service = false;
+        }
+        else if (strcmp(argv[i], "--warm-boot") == 0)
+        {
+            options.warm_boot = true;
+        }
+        else if (strcmp(argv[i], "--stall-reconnect") == 0 && has_value)
+        {
+            options.stall_s = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--thread-deadline") == 0 && has_value)
+        {
+            options.deadline_s = atoi(argv[++i]);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options.publishes > 0 && options.timeout_s > 0;
+}
+
+/* Application threads keep running; leave without static destructors, as a reset would */
+void Finish(bool success)
+{
+    fflush(stdout);
+    std::_Exit(success ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+}  // namespace
+
+/**
+ *  @brief  Boots the application threads as main.cpp does, against loopback stand-ins for the DECADA REST API
+ *          and MQTT broker, then checks the sensor -> coordinator -> comms pipeline and a service round trip.
+ *  @author Lee Tze Han
+ */
+int main(int argc, char** argv)
+{
+    options_t options = {3, 60, api_port, true, false, 0, 0};
+    if (!ParseOptions(argc, argv, options))
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    mbed_trace_init();
+
+    HostDecadaApi api;
+    HostMqttBroker broker;
+    if (!api.Start(options.api_port) || !broker.Start(mqtt_port))
+    {
+        tr_err("Failed to bind loopback ports %u/%u", (unsigned)options.api_port, (unsigned)mqtt_port);
+        return EXIT_FAILURE;
+    }
+    HostNetworkAddHost(mqtt_host, "127.0.0.1");
+
+    /* Provisioned state that the boot manager would have written */
+    WriteInitFlag("true");
+    WriteCycleInterval("1000");
+    WriteAggregationWindow("0");
+    if (options.warm_boot)
+    {
+        /* Reset of a provisioned device: the RTC kept running, and the device secret was persisted */
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        set_time(now.tv_sec);
+        WriteDeviceSecret("host-device-secret");
+    }
+
+    uint64_t boot_ms = Kernel::get_ms_count();
+    uint32_t deadline_ms = (uint32_t)options.timeout_s * 1000;
+
+    DecadaEndpointsInit(device_uuid);
+    DnsCacheInit();
+    DiagnosticsInit();
+    DiagnosticsRegisterThread(&thread_1, "comms");
+    DiagnosticsRegisterThread(&thread_2, "sensor");
+    DiagnosticsRegisterThread(&thread_3, "behavior");
+    DiagnosticsRegisterThread(&thread_4, "event");
+    uint32_t thread_deadline_ms = SUPERVISOR_THREAD_DEADLINE_MS;
+    if (options.deadline_s > 0)
+    {
+        /* Low-power sleeps still come on top, as in SUPERVISOR_THREAD_DEADLINE_MS */
+        thread_deadline_ms += (uint32_t)options.deadline_s * 1000 - MBED_CONF_APP_WATCHDOG_THREAD_DEADLINE * 1000UL;
+    }
+    SupervisorRegisterThread(&thread_1, "comms", thread_deadline_ms);
+    SupervisorRegisterThread(&thread_2, "sensor", thread_deadline_ms);
+    SupervisorRegisterThread(&thread_3, "behavior", thread_deadline_ms);
+    SupervisorRegisterThread(&thread_4, "event", thread_deadline_ms);
+#if LATENCY_TRACE_ENABLED
+    LatencyTraceInit();
+#endif  // LATENCY_TRACE_ENABLED
+
+    thread_1.start(communications_controller_thread);
+    thread_2.start(sensor_thread);
+    thread_3.start(behavior_coordinator_thread);
+    thread_4.start(event_manager_thread);
+    Watchdog::get_instance().start(20000);
+    SupervisorInit();
+    PowerInit();
+
+    const std::string measurepoint_suffix = "/thing/measurepoint/post";
+    if (!broker.WaitForPublishes(measurepoint_suffix, options.publishes, deadline_ms))
+    {
+        tr_err("Timed out waiting for %d measure point publishes", options.publishes);
+        Finish(false);
+    }
+
+    std::vector<HostMqttBroker::publish_t> publishes = broker.GetPublishes();
+    uint64_t first_ms = 0;
+    uint64_t last_ms = 0;
+    int num_measurepoints = 0;
+    for (auto& publish : publishes)
+    {
+        if (publish.topic.size() < measurepoint_suffix.size() ||
+            publish.topic.compare(publish.topic.size() - measurepoint_suffix.size(), std::string::npos, measurepoint_suffix) != 0)
+        {
+            continue;
+        }
+        if (publish.payload.find("\"measurepoints\":{\"") == std::string::npos)
+        {
+            tr_err("Published without measure points: %s", publish.payload.c_str());
+            Finish(false);
+        }
+        if (num_measurepoints == 0)
+        {
+            first_ms = publish.time_ms;
+            tr_info("First publish: %s", publish.payload.c_str());
+        }
+        last_ms = publish.time_ms;
+        num_measurepoints++;
+    }
+
+    if (options.service)
+    {
+        const std::string service_topic = std::string("/sys/") + MBED_CONF_APP_DECADA_PRODUCT_KEY + "/" + device_uuid + "/thing/service/sensorpollrate";
+        const std::string request = "{\"id\":\"host-1\",\"method\":\"thing.service.sensorpollrate\",\"params\":{\"sensor_poll_rate\":10}}";
+        const uint64_t request_ms = Kernel::get_ms_count();
+        if (broker.Inject(service_topic, request) == 0)
+        {
+            tr_err("No subscriber for %s", service_topic.c_str());
+            Finish(false);
+        }
+
+        uint32_t elapsed_ms = (uint32_t)(Kernel::get_ms_count() - boot_ms);
+        if (elapsed_ms >= deadline_ms || !broker.WaitForPublishes("/thing/service/sensorpollrate_reply", 1, deadline_ms - elapsed_ms))
+        {
+            tr_err("Timed out waiting for the sensorpollrate service response");
+            Finish(false);
+        }
+        for (auto& reply : broker.GetPublishes())
+        {
+            if (reply.payload.find("\"host-1\"") != std::string::npos)
+            {
+                printf("Service request to response: %llu ms\r\n", (unsigned long long)(reply.time_ms - request_ms));
+            }
+        }
+
+        /* An id too long for control mail is refused under its whole id, not echoed back truncated */
+        const std::string long_msg_id = "host-" + std::string(CONTROL_MSG_ID_SIZE, 'x');
+        const std::string long_request = "{\"id\":\"" + long_msg_id + "\",\"method\":\"thing.service.sensorpollrate\",\"params\":{\"sensor_poll_rate\":10}}";
+        elapsed_ms = (uint32_t)(Kernel::get_ms_count() - boot_ms);
+        if (broker.Inject(service_topic, long_request) == 0 || elapsed_ms >= deadline_ms ||
+            !broker.WaitForPublishes("/thing/service/sensorpollrate_reply", 2, deadline_ms - elapsed_ms))
+        {
+            tr_err("Timed out waiting for the reply to an over-long message id");
+            Finish(false);
+        }
+        const std::string error_reply = "{\"code\":400,\"data\":{},\"id\":\"" + long_msg_id + "\",\"message\":\"message id too long\"}";
+        bool error_replied = false;
+        for (auto& reply : broker.GetPublishes())
+        {
+            error_replied = error_replied || (reply.payload == error_reply);
+        }
+        if (!error_replied)
+        {
+            tr_err("No error reply carrying the whole over-long message id");
+            Finish(false);
+        }
+
+#if LATENCY_TRACE_ENABLED
+        const std::string trace_topic = std::string("/sys/") + MBED_CONF_APP_DECADA_PRODUCT_KEY + "/" + device_uuid + "/thing/service/latencytrace";
+        const std::string trace_request = "{\"id\":\"host-2\",\"method\":\"thing.service.latencytrace\",\"params\":{\"latency_trace\":0}}";
+        elapsed_ms = (uint32_t)(Kernel::get_ms_count() - boot_ms);
+        if (broker.Inject(trace_topic, trace_request) == 0 || elapsed_ms >= deadline_ms ||
+            !broker.WaitForPublishes("/thing/service/latencytrace_reply", 1, deadline_ms - elapsed_ms))
+        {
+            tr_err("Timed out waiting for the latencytrace service response");
+            Finish(false);
+        }
+#endif  // LATENCY_TRACE_ENABLED
+    }
+
+    if (options.stall_s > 0)
+    {
+        /* The subscription manager thread reconnects while the other threads keep running on their own deadlines */
+        const size_t connects = broker.GetConnectCount();
+        broker.SetConnackDelay((uint32_t)options.stall_s * 1000);
+        const uint64_t stall_ms = Kernel::get_ms_count();
+        broker.DropConnections();
+        size_t measurepoints_before = 0;
+        for (auto& publish : broker.GetPublishes())
+        {
+            measurepoints_before += (publish.topic.size() >= measurepoint_suffix.size() &&
+                publish.topic.compare(publish.topic.size() - measurepoint_suffix.size(), std::string::npos, measurepoint_suffix) == 0);
+        }
+
+        uint32_t elapsed_ms = (uint32_t)(Kernel::get_ms_count() - boot_ms);
+        if (elapsed_ms >= deadline_ms || !broker.WaitForPublishes(measurepoint_suffix, measurepoints_before + options.publishes, deadline_ms - elapsed_ms))
+        {
+            tr_err("Timed out waiting for publishes after a reconnection stalled for %d s", options.stall_s);
+            Finish(false);
+        }
+        if (broker.GetConnectCount() <= connects)
+        {
+            tr_err("Publishes resumed without a reconnection");
+            Finish(false);
+        }
+        if (!SupervisorCheck(Kernel::get_ms_count()))
+        {
+            tr_err("A thread missed its deadline while the reconnection stalled");
+            Finish(false);
+        }
+        printf("Publishing resumed %llu ms after the connection dropped, through a %d s reconnection stall\r\n",
+               (unsigned long long)(Kernel::get_ms_count() - stall_ms), options.stall_s);
+    }
+
+    printf("Host pipeline: %zu REST calls, %zu MQTT connects, %d measure point publishes\r\n",
+           api.GetRequests().size(), broker.GetConnectCount(), num_measurepoints);
+    printf("Boot to first publish: %llu ms\r\n", (unsigned long long)(first_ms - boot_ms));
+    if (options.warm_boot && !api.GetRequests().empty())
+    {
+        tr_err("Warm boot made %zu REST calls", api.GetRequests().size());
+        Finish(false);
+    }
+    if (num_measurepoints > 1)
+    {
+        printf("Mean publish interval: %llu ms\r\n", (unsigned long long)((last_ms - first_ms) / (num_measurepoints - 1)));
+    }
+    DiagnosticsPrint();
+#if LATENCY_TRACE_ENABLED
+    printf("Latency trace (avg/max us): %s\r\n", LatencyTraceCreateSummary().c_str());
+#endif  // LATENCY_TRACE_ENABLED
+    Finish(true);
+}
+
+/** @}*/
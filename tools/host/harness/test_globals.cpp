@@ -0,0 +1,12 @@
+/**
+ * @defgroup host_test_globals Host Test Globals
+ * @{
+ */
+
+#include "mbed.h"
+#include "global_params.h"
+
+/* main.cpp declares stdio_mutex only outside MBED_TEST_MODE; the greentea runtime provides it on the target */
+Mutex stdio_mutex;
+
+/** @}*/
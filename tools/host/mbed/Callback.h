@@ -0,0 +1,76 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_CALLBACK_H
+#define HOST_CALLBACK_H
+
+#include <functional>
+#include <utility>
+
+namespace mbed {
+
+template <typename F>
+class Callback;
+
+/** Callback class.
+ *  @brief  Host stand-in for mbed::Callback, backed by std::function
+ */
+template <typename R, typename... Args>
+class Callback<R(Args...)>
+{
+    public:
+        Callback() {}
+        Callback(R (*func)(Args...)) { if (func) { func_ = func; } }
+
+        template <typename F, typename = decltype(std::declval<F&>()(std::declval<Args>()...))>
+        Callback(F f) : func_(std::move(f)) {}
+
+        template <typename T, typename U>
+        Callback(U* obj, R (T::*method)(Args...))
+            : func_([obj, method](Args... args) { return (obj->*method)(std::forward<Args>(args)...); }) {}
+
+        template <typename T, typename U>
+        Callback(U* obj, R (*func)(T*, Args...))
+            : func_([obj, func](Args... args) { return func(obj, std::forward<Args>(args)...); }) {}
+
+        R call(Args... args) const { return func_(std::forward<Args>(args)...); }
+        R operator()(Args... args) const { return func_(std::forward<Args>(args)...); }
+        explicit operator bool() const { return static_cast<bool>(func_); }
+
+    private:
+        std::function<R(Args...)> func_;
+};
+
+template <typename R, typename... Args>
+Callback<R(Args...)> callback(R (*func)(Args...))
+{
+    return Callback<R(Args...)>(func);
+}
+
+template <typename T, typename U, typename R, typename... Args>
+Callback<R(Args...)> callback(U* obj, R (T::*method)(Args...))
+{
+    return Callback<R(Args...)>(obj, method);
+}
+
+template <typename T, typename U, typename R, typename... Args>
+Callback<R(Args...)> callback(R (*func)(T*, Args...), U* arg)
+{
+    return Callback<R(Args...)>(arg, func);
+}
+
+}  // namespace mbed
+
+#endif  // HOST_CALLBACK_H
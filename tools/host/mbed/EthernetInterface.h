@@ -0,0 +1,28 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_ETHERNET_INTERFACE_H
+#define HOST_ETHERNET_INTERFACE_H
+
+#include "NetworkInterface.h"
+
+/** EthernetInterface class.
+ *  @brief  Host stand-in for EthernetInterface, over the host network stack
+ */
+class EthernetInterface : public NetworkInterface
+{
+};
+
+#endif  // HOST_ETHERNET_INTERFACE_H
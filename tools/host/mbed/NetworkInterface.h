@@ -0,0 +1,120 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_NETWORK_INTERFACE_H
+#define HOST_NETWORK_INTERFACE_H
+
+#include <stdint.h>
+#include <string.h>
+#include <netinet/in.h>
+#include "Callback.h"
+
+/* nsapi_types.h error codes */
+typedef int nsapi_error_t;
+typedef unsigned int nsapi_size_t;
+typedef int nsapi_size_or_error_t;
+typedef int nsapi_value_or_error_t;
+
+enum nsapi_error {
+    NSAPI_ERROR_OK                  =  0,
+    NSAPI_ERROR_WOULD_BLOCK         = -3001,
+    NSAPI_ERROR_UNSUPPORTED         = -3002,
+    NSAPI_ERROR_PARAMETER           = -3003,
+    NSAPI_ERROR_NO_CONNECTION       = -3004,
+    NSAPI_ERROR_NO_SOCKET           = -3005,
+    NSAPI_ERROR_NO_ADDRESS          = -3006,
+    NSAPI_ERROR_NO_MEMORY           = -3007,
+    NSAPI_ERROR_NO_SSID             = -3008,
+    NSAPI_ERROR_DNS_FAILURE         = -3009,
+    NSAPI_ERROR_DHCP_FAILURE        = -3010,
+    NSAPI_ERROR_AUTH_FAILURE        = -3011,
+    NSAPI_ERROR_DEVICE_ERROR        = -3012,
+    NSAPI_ERROR_IN_PROGRESS         = -3013,
+    NSAPI_ERROR_ALREADY             = -3014,
+    NSAPI_ERROR_IS_CONNECTED        = -3015,
+    NSAPI_ERROR_CONNECTION_LOST     = -3016,
+    NSAPI_ERROR_CONNECTION_TIMEOUT  = -3017,
+    NSAPI_ERROR_ADDRESS_IN_USE      = -3018,
+    NSAPI_ERROR_TIMEOUT             = -3019,
+    NSAPI_ERROR_BUSY                = -3020,
+};
+
+typedef enum nsapi_connection_status {
+    NSAPI_STATUS_LOCAL_UP           = 0,
+    NSAPI_STATUS_GLOBAL_UP          = 1,
+    NSAPI_STATUS_DISCONNECTED       = 2,
+    NSAPI_STATUS_CONNECTING         = 3,
+    NSAPI_STATUS_ERROR_UNSUPPORTED  = NSAPI_ERROR_UNSUPPORTED
+} nsapi_connection_status_t;
+
+typedef enum nsapi_version {
+    NSAPI_UNSPEC,
+    NSAPI_IPv4,
+    NSAPI_IPv6,
+} nsapi_version_t;
+
+/** SocketAddress class.
+ *  @brief  Host stand-in for SocketAddress (IPv4 only)
+ */
+class SocketAddress
+{
+    public:
+        SocketAddress() : port_(0) { memset(&addr_, 0, sizeof(addr_)); ip_[0] = '\0'; }
+        SocketAddress(const char* addr, uint16_t port = 0);
+
+        bool set_ip_address(const char* addr);
+        const char* get_ip_address() const { return ip_[0] ? ip_ : NULL; }
+        void set_port(uint16_t port) { port_ = port; }
+        uint16_t get_port() const { return port_; }
+        nsapi_version_t get_ip_version() const { return ip_[0] ? NSAPI_IPv4 : NSAPI_UNSPEC; }
+        operator bool() const { return ip_[0] != '\0'; }
+
+        const struct in_addr& get_in_addr() const { return addr_; }
+        void set_in_addr(const struct in_addr& addr);
+
+    private:
+        struct in_addr addr_;
+        char ip_[16];
+        uint16_t port_;
+};
+
+/** NetworkInterface class.
+ *  @brief  Host stand-in for NetworkInterface; the host network stack is already up
+ *
+ *  Names registered with HostNetworkAddHost() resolve before the system resolver is consulted,
+ *  so that the cloud endpoints can be pointed at local stand-ins. Asynchronous lookups run on a
+ *  thread of their own, as they do on the shared event queue on the target.
+ */
+class NetworkInterface
+{
+    public:
+        typedef mbed::Callback<void(nsapi_value_or_error_t result, SocketAddress* address)> hostbyname_cb_t;
+
+        virtual ~NetworkInterface() {}
+
+        virtual nsapi_error_t connect() { return NSAPI_ERROR_OK; }
+        virtual nsapi_error_t disconnect() { return NSAPI_ERROR_OK; }
+        virtual nsapi_connection_status_t get_connection_status() const { return NSAPI_STATUS_GLOBAL_UP; }
+        virtual nsapi_error_t get_ip_address(SocketAddress* address);
+        virtual nsapi_error_t gethostbyname(const char* host, SocketAddress* address,
+                                            nsapi_version_t version = NSAPI_UNSPEC, const char* interface_name = NULL);
+        virtual nsapi_value_or_error_t gethostbyname_async(const char* host, hostbyname_cb_t callback,
+                                                           nsapi_version_t version = NSAPI_UNSPEC, const char* interface_name = NULL);
+};
+
+/** Resolves host to ip on the host network stand-in */
+void HostNetworkAddHost(const char* host, const char* ip);
+
+#endif  // HOST_NETWORK_INTERFACE_H
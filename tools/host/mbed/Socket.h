@@ -0,0 +1,45 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_SOCKET_H
+#define HOST_SOCKET_H
+
+#include "NetworkInterface.h"
+
+/** Socket class.
+ *  @brief  Host stand-in for Socket, over a POSIX stream socket
+ *
+ *  Sockets block by default, as on the target; set_timeout() bounds recv() and send().
+ */
+class Socket
+{
+    public:
+        Socket() : fd_(-1), timeout_ms_(-1) {}
+        virtual ~Socket() { close(); }
+
+        nsapi_error_t open(NetworkInterface* stack);
+        virtual nsapi_error_t close();
+        virtual nsapi_error_t connect(const SocketAddress& address);
+        virtual nsapi_size_or_error_t send(const void* data, nsapi_size_t size);
+        virtual nsapi_size_or_error_t recv(void* data, nsapi_size_t size);
+        void set_blocking(bool blocking) { set_timeout(blocking ? -1 : 0); }
+        void set_timeout(int timeout);
+
+    protected:
+        int fd_;
+        int timeout_ms_;
+};
+
+#endif  // HOST_SOCKET_H
@@ -0,0 +1,32 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_TCP_SOCKET_H
+#define HOST_TCP_SOCKET_H
+
+#include "Socket.h"
+
+/** TCPSocket class.
+ *  @brief  Host stand-in for TCPSocket
+ */
+class TCPSocket : public Socket
+{
+    public:
+        nsapi_error_t connect(const char* host, uint16_t port);
+        using Socket::connect;
+        void set_hostname(const char* hostname) {}
+};
+
+#endif  // HOST_TCP_SOCKET_H
@@ -0,0 +1,33 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_TLS_SOCKET_H
+#define HOST_TLS_SOCKET_H
+
+#include "TCPSocket.h"
+
+/** TLSSocket class.
+ *  @brief  Host stand-in for TLSSocket; carries the session in plain TCP to the local cloud stand-ins
+ *
+ *  Certificates and keys are accepted and ignored.
+ */
+class TLSSocket : public TCPSocket
+{
+    public:
+        nsapi_error_t set_root_ca_cert(const char* root_ca_pem) { return NSAPI_ERROR_OK; }
+        nsapi_error_t set_client_cert_key(const char* client_cert_pem, const char* client_private_key_pem) { return NSAPI_ERROR_OK; }
+};
+
+#endif  // HOST_TLS_SOCKET_H
@@ -0,0 +1,75 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_CMSIS_H
+#define HOST_CMSIS_H
+
+#include <stdint.h>
+
+/* Core registers of the Cortex-M7 used by the application, emulated on the host clock */
+
+#define CoreDebug_DEMCR_TRCENA_Msk      (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk          (1UL)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Core clock of the NUCLEO_F767ZI; DWT cycles are counted at this rate */
+extern uint32_t SystemCoreClock;
+
+#ifdef __cplusplus
+}
+
+/** Free-running 32-bit cycle counter at SystemCoreClock, derived from the monotonic clock */
+class HostCycleCounter
+{
+    public:
+        operator uint32_t() const;
+        HostCycleCounter& operator=(uint32_t value);
+
+    private:
+        uint32_t offset_ = 0;
+};
+
+typedef struct {
+    volatile uint32_t CTRL;
+    HostCycleCounter CYCCNT;
+    volatile uint32_t LAR;
+} HostDwt_Type;
+
+typedef struct {
+    volatile uint32_t DEMCR;
+} HostCoreDebug_Type;
+
+/** RTC backup registers; retained for the life of the host process */
+typedef struct {
+    volatile uint32_t BKP0R;
+    volatile uint32_t BKP1R_31R[31];
+} HostRtc_Type;
+
+extern HostDwt_Type host_dwt;
+extern HostCoreDebug_Type host_core_debug;
+extern HostRtc_Type host_rtc;
+
+#define DWT         (&host_dwt)
+#define CoreDebug   (&host_core_debug)
+#define RTC         (&host_rtc)
+
+/** Backup domain write access of the STM32 HAL; always granted on the host */
+inline void HAL_PWR_EnableBkUpAccess(void) {}
+#endif  // __cplusplus
+
+#endif  // HOST_CMSIS_H
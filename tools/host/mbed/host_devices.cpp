@@ -0,0 +1,398 @@
+/**
+ * @defgroup host_devices Host Device Models
+ * @{
+ */
+
+#include <math.h>
+#include <chrono>
+#include <map>
+#include <thread>
+#include "mbed.h"
+#include "host_devices.h"
+
+namespace {
+
+/* Devices of one I2C bus, keyed by 8-bit address; transfers hold the bus mutex for their duration */
+struct HostI2CBus
+{
+    std::mutex mutex;
+    std::map<int, HostI2CDevice*> devices;
+};
+
+std::mutex registry_mutex;
+std::map<int, HostI2CBus> i2c_buses;       // keyed by SDA pin
+
+std::mutex pin_mutex;
+std::map<int, int> pin_levels;
+
+const int general_call_address = 0x00;
+
+/* Typical readings of the Sensirion sensors (SPS30: mass and number concentrations, particle size; SCD30: CO2, T, RH) */
+const float sps30_baseline[] = {8.0f, 12.0f, 14.0f, 15.0f, 50.0f, 60.0f, 62.0f, 62.5f, 63.0f, 0.6f};
+const float scd30_baseline[] = {450.0f, 26.0f, 55.0f};
+
+/* Models of the peripherals fitted to the board */
+HostTmp75 onboard_tmp75(PD_10);
+HostSensirion sps30(sps30_baseline, sizeof(sps30_baseline) / sizeof(float), 2000);
+HostSensirion scd30(scd30_baseline, sizeof(scd30_baseline) / sizeof(float), 3000);
+
+struct HostBoard
+{
+    HostBoard()
+    {
+        HostI2CAttach(PB_9, 0x96, &onboard_tmp75);
+        HostI2CAttach(MBED_CONF_APP_SPS30_I2C_SDA, 0xD2, &sps30);
+        HostI2CAttach(MBED_CONF_APP_SCD30_I2C_SDA, 0xC2, &scd30);
+    }
+} host_board;
+
+HostI2CBus& Bus(PinName sda)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    return i2c_buses[sda];
+}
+
+/* Time to clock the address byte and length data bytes, 9 bits each */
+void Transfer(int length, int frequency, int response_time)
+{
+    std::this_thread::sleep_for(std::chrono::microseconds((length + 1) * 9 * 1000000LL / frequency + response_time));
+}
+
+}  // namespace
+
+void HostI2CAttach(PinName sda, int address, HostI2CDevice* device)
+{
+    HostI2CBus& bus = Bus(sda);
+    std::lock_guard<std::mutex> lock(bus.mutex);
+    if (device)
+    {
+        bus.devices[address & 0xFE] = device;
+    }
+    else
+    {
+        bus.devices.erase(address & 0xFE);
+    }
+}
+
+void HostPinWrite(PinName pin, int value)
+{
+    std::lock_guard<std::mutex> lock(pin_mutex);
+    pin_levels[pin] = value ? 1 : 0;
+}
+
+int HostPinRead(PinName pin)
+{
+    std::lock_guard<std::mutex> lock(pin_mutex);
+    auto it = pin_levels.find(pin);
+    return (it == pin_levels.end()) ? 0 : it->second;
+}
+
+namespace mbed {
+
+I2C::I2C(PinName sda, PinName scl) : sda_(sda), scl_(scl), frequency_(100000)
+{
+}
+
+int I2C::write(int address, const char* data, int length, bool repeated)
+{
+    HostI2CBus& bus = Bus(sda_);
+    std::lock_guard<std::mutex> lock(bus.mutex);
+    Transfer(length, frequency_, 0);
+    if ((address & 0xFE) == general_call_address)
+    {
+        for (auto& device : bus.devices)
+        {
+            device.second->GeneralCall(data, length);
+        }
+        return 0;
+    }
+
+    auto it = bus.devices.find(address & 0xFE);
+    return (it == bus.devices.end()) ? -1 : it->second->Write(data, length);
+}
+
+int I2C::read(int address, char* data, int length, bool repeated)
+{
+    HostI2CBus& bus = Bus(sda_);
+    std::lock_guard<std::mutex> lock(bus.mutex);
+    auto it = bus.devices.find(address & 0xFE);
+    if (it == bus.devices.end())
+    {
+        Transfer(0, frequency_, 0);
+        return -1;
+    }
+
+    Transfer(length, frequency_, it->second->ResponseTime());
+    return it->second->Read(data, length);
+}
+
+int I2C::read(int ack)
+{
+    return 0xFF;
+}
+
+int I2C::write(int data)
+{
+    return NoACK;
+}
+
+int DigitalIn::read()
+{
+    return HostPinRead(pin_);
+}
+
+void DigitalOut::write(int value)
+{
+    HostPinWrite(pin_, value);
+}
+
+int DigitalOut::read()
+{
+    return HostPinRead(pin_);
+}
+
+}  // namespace mbed
+
+/* ---------------------------------------------------------------------------------------------------
+ * TMP75
+ * --------------------------------------------------------------------------------------------------- */
+
+#define TMP75_REG_TEMP      0x00
+#define TMP75_REG_CONFIG    0x01
+#define TMP75_REG_T_LOW     0x02
+#define TMP75_REG_T_HIGH    0x03
+
+#define TMP75_CONFIG_SD     0x01
+#define TMP75_CONFIG_TM     0x02
+#define TMP75_CONFIG_POL    0x04
+
+HostTmp75::HostTmp75(PinName alert_pin) : alert_pin_(alert_pin), fixed_temperature_(NAN)
+{
+    PowerUp();
+}
+
+/**
+ *  @brief  Power-up register values (Tlow 75 C, Thigh 80 C, continuous conversion, ALERT active low).
+ *  @author Lee Tze Han
+ */
+void HostTmp75::PowerUp()
+{
+    pointer_ = TMP75_REG_TEMP;
+    config_ = 0x00;
+    t_low_ = 75 * 256;
+    t_high_ = 80 * 256;
+    alert_ = false;
+    HostPinWrite(alert_pin_, 1);
+}
+
+void HostTmp75::SetTemperature(float celsius)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    fixed_temperature_ = celsius;
+}
+
+/**
+ *  @brief  Current conversion result, left-justified 12-bit two's complement as in the temperature register.
+ *  @author Lee Tze Han
+ *  @return Temperature register value
+ */
+int16_t HostTmp75::Temperature()
+{
+    float celsius = fixed_temperature_;
+    if (isnan(celsius))
+    {
+        /* 25 C +/- 2 C over a one minute period */
+        float t_s = Kernel::get_ms_count() / 1000.0f;
+        celsius = 25.0f + 2.0f * sinf(2.0f * (float)M_PI * t_s / 60.0f);
+    }
+    return (int16_t)lrintf(celsius * 16.0f) * 16;
+}
+
+/**
+ *  @brief  Comparator/interrupt mode output: asserted at Thigh, released below Tlow.
+ *  @author Lee Tze Han
+ *  @param  temp    Temperature register value
+ */
+void HostTmp75::UpdateAlert(int16_t temp)
+{
+    if (!alert_ && temp >= t_high_)
+    {
+        alert_ = true;
+    }
+    else if (alert_ && temp < t_low_)
+    {
+        alert_ = false;
+    }
+
+    int active_level = (config_ & TMP75_CONFIG_POL) ? 1 : 0;
+    HostPinWrite(alert_pin_, alert_ ? active_level : !active_level);
+}
+
+int HostTmp75::Write(const char* data, int length)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (length < 1)
+    {
+        return 0;
+    }
+
+    pointer_ = data[0] & 0x03;
+    if (pointer_ == TMP75_REG_CONFIG && length >= 2)
+    {
+        config_ = data[1];
+    }
+    else if (pointer_ == TMP75_REG_T_LOW && length >= 3)
+    {
+        t_low_ = (int16_t)(((uint8_t)data[1] << 8) | (uint8_t)data[2]) & (int16_t)0xFFF0;
+    }
+    else if (pointer_ == TMP75_REG_T_HIGH && length >= 3)
+    {
+        t_high_ = (int16_t)(((uint8_t)data[1] << 8) | (uint8_t)data[2]) & (int16_t)0xFFF0;
+    }
+
+    UpdateAlert(Temperature());
+    return 0;
+}
+
+int HostTmp75::Read(char* data, int length)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint16_t value = 0;
+    switch (pointer_)
+    {
+        case TMP75_REG_TEMP:
+        {
+            int16_t temp = Temperature();
+            UpdateAlert(temp);
+            value = (uint16_t)temp;
+            break;
+        }
+        case TMP75_REG_CONFIG:
+            value = (uint16_t)(config_ << 8 | config_);
+            break;
+        case TMP75_REG_T_LOW:
+            value = (uint16_t)t_low_;
+            break;
+        case TMP75_REG_T_HIGH:
+            value = (uint16_t)t_high_;
+            break;
+    }
+
+    for (int i = 0; i < length; i++)
+    {
+        data[i] = (i % 2 == 0) ? (char)(value >> 8) : (char)(value & 0xFF);
+    }
+    return 0;
+}
+
+void HostTmp75::GeneralCall(const char* data, int length)
+{
+    /* General call reset */
+    if (length >= 1 && data[0] == 0x06)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        PowerUp();
+    }
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * Sensirion SPS30 / SCD30
+ * --------------------------------------------------------------------------------------------------- */
+
+#define SENSIRION_CMD_START_MEAS    0x0010
+#define SENSIRION_CMD_STOP_MEAS     0x0104
+#define SENSIRION_CMD_READY         0x0202
+#define SENSIRION_CMD_READ_MEAS     0x0300
+#define SENSIRION_CMD_SOFT_RESET    0xD304
+
+/* CRC-8 of a data word: polynomial 0x31, initial value 0xFF */
+static uint8_t SensirionCrc(uint16_t word)
+{
+    uint8_t crc = 0xFF;
+    const uint8_t bytes[2] = {(uint8_t)(word >> 8), (uint8_t)(word & 0xFF)};
+    for (uint8_t byte : bytes)
+    {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x31) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+HostSensirion::HostSensirion(const float* baseline, int num_values, int response_time)
+    : baseline_(baseline), num_values_(num_values), response_time_(response_time), command_(0), measuring_(false)
+{
+}
+
+int HostSensirion::Write(const char* data, int length)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (length < 2)
+    {
+        return 0;
+    }
+
+    command_ = (uint16_t)(((uint8_t)data[0] << 8) | (uint8_t)data[1]);
+    if (command_ == SENSIRION_CMD_START_MEAS)
+    {
+        measuring_ = true;
+    }
+    else if (command_ == SENSIRION_CMD_STOP_MEAS || command_ == SENSIRION_CMD_SOFT_RESET)
+    {
+        measuring_ = false;
+    }
+    return 0;
+}
+
+/**
+ *  @brief  Writes one response word and its CRC-8 at offset, as far as the read transfer goes.
+ *  @author Lee Tze Han
+ *  @param  data    read transfer
+ *  @param  length  length of the read transfer
+ *  @param  offset  position of the triplet in the transfer
+ *  @param  word    response word
+ *  @return Offset of the next triplet
+ */
+int HostSensirion::PutWord(char* data, int length, int offset, uint16_t word)
+{
+    const char triplet[3] = {(char)(word >> 8), (char)(word & 0xFF), (char)SensirionCrc(word)};
+    for (int i = 0; i < 3 && offset + i < length; i++)
+    {
+        data[offset + i] = triplet[i];
+    }
+    return offset + 3;
+}
+
+int HostSensirion::Read(char* data, int length)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    memset(data, 0, length);
+    switch (command_)
+    {
+        case SENSIRION_CMD_READY:
+            PutWord(data, length, 0, measuring_ ? 1 : 0);
+            break;
+        case SENSIRION_CMD_READ_MEAS:
+        {
+            float t_s = Kernel::get_ms_count() / 1000.0f;
+            float drift = 1.0f + 0.05f * sinf(2.0f * (float)M_PI * t_s / 60.0f);
+            int offset = 0;
+            for (int i = 0; i < num_values_ && offset < length; i++)
+            {
+                float value = baseline_[i] * drift;
+                uint32_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                offset = PutWord(data, length, offset, (uint16_t)(bits >> 16));
+                offset = PutWord(data, length, offset, (uint16_t)(bits & 0xFFFF));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return 0;
+}
+
+/** @}*/
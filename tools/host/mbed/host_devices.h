@@ -0,0 +1,117 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_DEVICES_H
+#define HOST_DEVICES_H
+
+#include <stdint.h>
+#include <mutex>
+#include "PinNames.h"
+
+/** HostI2CDevice class.
+ *  @brief  Register model of an I2C peripheral on a host bus
+ *
+ *  Write() receives the bytes of a write transfer and Read() fills a read transfer. Both return 0 on ACK.
+ *  Transfers on one bus are serialized and take as long as they would at the bus frequency, plus the
+ *  ResponseTime() of the device before each read; separate buses transfer concurrently.
+ */
+class HostI2CDevice
+{
+    public:
+        virtual ~HostI2CDevice() {}
+
+        virtual int Write(const char* data, int length) = 0;
+        virtual int Read(char* data, int length) = 0;
+
+        /** Called for the general call address (0x00) */
+        virtual void GeneralCall(const char* data, int length) {}
+
+        /** Microseconds the device stretches SCL before answering a read */
+        virtual int ResponseTime(void) { return 0; }
+};
+
+/** Attaches a device model at an 8-bit I2C address of the bus on sda; nullptr detaches it */
+void HostI2CAttach(PinName sda, int address, HostI2CDevice* device);
+
+/** Drives the level seen by DigitalIn on pin */
+void HostPinWrite(PinName pin, int value);
+int HostPinRead(PinName pin);
+
+/** HostTmp75 class.
+ *  @brief  TMP75 register model: temperature, configuration and the Tlow/Thigh comparator driving ALERT
+ *
+ *  The temperature follows a slow sine around 25 C so that successive readings change. It is attached
+ *  at 0x96 with ALERT on PD_10, where the NUCLEO_F767ZI board has it.
+ */
+class HostTmp75 : public HostI2CDevice
+{
+    public:
+        HostTmp75(PinName alert_pin);
+
+        int Write(const char* data, int length) override;
+        int Read(char* data, int length) override;
+        void GeneralCall(const char* data, int length) override;
+
+        /** Overrides the temperature model with a fixed temperature; NAN resumes the model */
+        void SetTemperature(float celsius);
+
+    private:
+        void PowerUp();
+        int16_t Temperature();
+        void UpdateAlert(int16_t temp);
+
+        std::mutex mutex_;
+        PinName alert_pin_;
+        uint8_t pointer_;
+        uint8_t config_;
+        int16_t t_low_;
+        int16_t t_high_;
+        bool alert_;
+        float fixed_temperature_;
+};
+
+/** HostSensirion class.
+ *  @brief  Sensirion command model (SPS30, SCD30): start/stop measurement, data ready and read measurement
+ *
+ *  Each command is a 16 bit word, optionally followed by an argument triplet, and each response is a
+ *  sequence of 16 bit words followed by their CRC-8. Once measuring, the measurement is always ready and
+ *  each value drifts within 5% of its baseline over a one minute period.
+ */
+class HostSensirion : public HostI2CDevice
+{
+    public:
+        /**
+         *  @param  baseline        typical value of each float of the measurement
+         *  @param  num_values      number of floats in the measurement
+         *  @param  response_time   microseconds the device stretches SCL before answering a read
+         */
+        HostSensirion(const float* baseline, int num_values, int response_time);
+
+        int Write(const char* data, int length) override;
+        int Read(char* data, int length) override;
+        int ResponseTime(void) override { return response_time_; }
+
+    private:
+        int PutWord(char* data, int length, int offset, uint16_t word);
+
+        std::mutex mutex_;
+        const float* baseline_;
+        int num_values_;
+        int response_time_;
+        uint16_t command_;
+        bool measuring_;
+};
+
+#endif  // HOST_DEVICES_H
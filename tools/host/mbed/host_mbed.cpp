@@ -0,0 +1,685 @@
+/**
+ * @defgroup host_mbed Host mbed-os Stand-in
+ * @{
+ */
+
+#include <stdarg.h>
+#include <poll.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <string>
+#include "mbed.h"
+#include "mbed_trace.h"
+#include "kvstore_global_api.h"
+#include "host_target.h"
+
+namespace {
+
+using host_clock = std::chrono::steady_clock;
+
+const host_clock::time_point boot_time = host_clock::now();
+
+/* RTC seconds at boot; a cold-booted target reads 0 until set_time() */
+std::atomic<int64_t> rtc_offset_s(0);
+
+std::mutex trace_mutex;
+bool trace_enabled = false;
+
+std::recursive_mutex critical_section_mutex;
+
+std::mutex kv_mutex;
+std::map<std::string, std::string> kv_store;
+
+uint64_t HostUs(void)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(host_clock::now() - boot_time).count();
+}
+
+uint64_t HostMs(void)
+{
+    return HostUs() / 1000;
+}
+
+/* Matches newlib on the target, whose localtime() is UTC */
+struct HostTimezone
+{
+    HostTimezone()
+    {
+        setenv("TZ", "UTC", 1);
+        tzset();
+    }
+} host_timezone;
+
+}  // namespace
+
+/* 96-bit UID in the layout of the STM32 UID registers */
+extern "C" const uint32_t host_device_uid[3] = {0x00420038, 0x3137510c, 0x36383330};
+
+/* ---------------------------------------------------------------------------------------------------
+ * Platform
+ * --------------------------------------------------------------------------------------------------- */
+
+/**
+ *  @brief  RTC read, as retargeted by mbed-os.
+ *  @author Lee Tze Han
+ *  @param  t   Optional storage for the result
+ *  @return Seconds since epoch according to the RTC
+ */
+extern "C" time_t time(time_t* t)
+{
+    time_t now = (time_t)(rtc_offset_s.load() + (int64_t)(HostMs() / 1000));
+    if (t)
+    {
+        *t = now;
+    }
+    return now;
+}
+
+/**
+ *  @brief  Elapsed time at the CLOCKS_PER_SEC of the target C library (100 Hz), not process CPU time.
+ *  @author Lee Tze Han
+ *  @return Ticks since boot
+ */
+extern "C" clock_t clock(void)
+{
+    return (clock_t)(HostMs() / 10);
+}
+
+extern "C" void set_time(time_t t)
+{
+    rtc_offset_s = (int64_t)t - (int64_t)(HostMs() / 1000);
+}
+
+extern "C" void wait_us(int us)
+{
+    uint64_t end = HostUs() + us;
+    while (HostUs() < end)
+    {
+    }
+}
+
+extern "C" void core_util_critical_section_enter(void)
+{
+    critical_section_mutex.lock();
+}
+
+extern "C" void core_util_critical_section_exit(void)
+{
+    critical_section_mutex.unlock();
+}
+
+/**
+ *  @brief  CPU statistics; the host process counts as asleep while none of its threads are on a CPU.
+ *  @author Lee Tze Han
+ *  @param  stats   Statistics to fill
+ */
+extern "C" void mbed_stats_cpu_get(mbed_stats_cpu_t* stats)
+{
+    struct timespec cpu_time;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_time);
+    const uint64_t busy_us = (uint64_t)cpu_time.tv_sec * 1000000 + cpu_time.tv_nsec / 1000;
+    const uint64_t uptime_us = HostUs();
+
+    stats->uptime = uptime_us;
+    stats->sleep_time = (busy_us < uptime_us) ? uptime_us - busy_us : 0;
+    stats->idle_time = stats->sleep_time;
+    stats->deep_sleep_time = 0;
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * Core registers
+ * --------------------------------------------------------------------------------------------------- */
+
+extern "C" {
+uint32_t SystemCoreClock = 216000000;
+}
+
+HostDwt_Type host_dwt;
+HostCoreDebug_Type host_core_debug;
+HostRtc_Type host_rtc;
+
+HostCycleCounter::operator uint32_t() const
+{
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(host_clock::now() - boot_time).count();
+    return (uint32_t)(ns * (SystemCoreClock / 1000000) / 1000) - offset_;
+}
+
+HostCycleCounter& HostCycleCounter::operator=(uint32_t value)
+{
+    offset_ = 0;
+    offset_ = (uint32_t)*this - value;
+    return *this;
+}
+
+extern "C" void NVIC_SystemReset(void)
+{
+    fflush(stdout);
+    fprintf(stderr, "\r\n[HOST] NVIC_SystemReset\r\n");
+    _Exit(EXIT_FAILURE);
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * Console
+ * --------------------------------------------------------------------------------------------------- */
+
+ssize_t mbed::FileHandle::read(void* buffer, size_t size)
+{
+    return ::read(fd_, buffer, size);
+}
+
+ssize_t mbed::FileHandle::write(const void* buffer, size_t size)
+{
+    return ::write(fd_, buffer, size);
+}
+
+bool mbed::FileHandle::readable() const
+{
+    struct pollfd pfd = {fd_, POLLIN, 0};
+    return poll(&pfd, 1, 0) == 1 && (pfd.revents & POLLIN);
+}
+
+mbed::FileHandle* mbed::mbed_file_handle(int fd)
+{
+    static FileHandle std_handles[3] = {FileHandle(STDIN_FILENO), FileHandle(STDOUT_FILENO), FileHandle(STDERR_FILENO)};
+    return (fd >= 0 && fd < 3) ? &std_handles[fd] : NULL;
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * mbed-trace
+ * --------------------------------------------------------------------------------------------------- */
+
+extern "C" int mbed_trace_init(void)
+{
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    trace_enabled = true;
+    return 0;
+}
+
+extern "C" void mbed_trace_free(void)
+{
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    trace_enabled = false;
+}
+
+extern "C" void mbed_trace_config_set(uint8_t config)
+{
+}
+
+extern "C" uint8_t mbed_trace_config_get(void)
+{
+    return TRACE_ACTIVE_LEVEL_ALL;
+}
+
+extern "C" void mbed_tracef(uint8_t dlevel, const char* grp, const char* fmt, ...)
+{
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    if (!trace_enabled)
+    {
+        return;
+    }
+
+    const char* level = "CMD ";
+    switch (dlevel)
+    {
+        case TRACE_LEVEL_DEBUG: level = "DBG "; break;
+        case TRACE_LEVEL_INFO:  level = "INFO"; break;
+        case TRACE_LEVEL_WARN:  level = "WARN"; break;
+        case TRACE_LEVEL_ERROR: level = "ERR "; break;
+    }
+
+    va_list args;
+    va_start(args, fmt);
+    printf("[%s][%-4s]: ", level, grp);
+    vprintf(fmt, args);
+    printf("\r\n");
+    va_end(args);
+    fflush(stdout);
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * KVStore
+ * --------------------------------------------------------------------------------------------------- */
+
+int kv_set(const char* full_name_key, const void* buffer, size_t size, uint32_t create_flags)
+{
+    if (full_name_key == NULL || (buffer == NULL && size > 0))
+    {
+        return MBED_ERROR_INVALID_ARGUMENT;
+    }
+
+    std::lock_guard<std::mutex> lock(kv_mutex);
+    kv_store[full_name_key] = std::string((const char*)buffer, size);
+    return MBED_SUCCESS;
+}
+
+int kv_get(const char* full_name_key, void* buffer, size_t buffer_size, size_t* actual_size)
+{
+    std::lock_guard<std::mutex> lock(kv_mutex);
+    auto it = kv_store.find(full_name_key);
+    if (it == kv_store.end())
+    {
+        return MBED_ERROR_ITEM_NOT_FOUND;
+    }
+
+    size_t size = std::min(buffer_size, it->second.size());
+    memcpy(buffer, it->second.data(), size);
+    if (actual_size)
+    {
+        *actual_size = size;
+    }
+    return MBED_SUCCESS;
+}
+
+int kv_get_info(const char* full_name_key, kv_info_t* info)
+{
+    std::lock_guard<std::mutex> lock(kv_mutex);
+    auto it = kv_store.find(full_name_key);
+    if (it == kv_store.end())
+    {
+        return MBED_ERROR_ITEM_NOT_FOUND;
+    }
+
+    info->size = it->second.size();
+    info->flags = 0;
+    return MBED_SUCCESS;
+}
+
+int kv_remove(const char* full_name_key)
+{
+    std::lock_guard<std::mutex> lock(kv_mutex);
+    return kv_store.erase(full_name_key) ? MBED_SUCCESS : MBED_ERROR_ITEM_NOT_FOUND;
+}
+
+int kv_reset(const char* kvstore_path)
+{
+    std::lock_guard<std::mutex> lock(kv_mutex);
+    kv_store.clear();
+    return MBED_SUCCESS;
+}
+
+namespace rtos {
+
+/* ---------------------------------------------------------------------------------------------------
+ * Kernel / ThisThread
+ * --------------------------------------------------------------------------------------------------- */
+
+Kernel::Clock::time_point Kernel::Clock::now()
+{
+    return time_point(duration(HostMs()));
+}
+
+uint64_t Kernel::get_ms_count()
+{
+    return HostMs();
+}
+
+void ThisThread::sleep_for(Kernel::Clock::duration_u32 rel_time)
+{
+    std::this_thread::sleep_for(rel_time);
+}
+
+void ThisThread::sleep_for(uint32_t millisec)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(millisec));
+}
+
+void ThisThread::sleep_until(Kernel::Clock::time_point abs_time)
+{
+    Kernel::Clock::time_point now = Kernel::Clock::now();
+    if (abs_time > now)
+    {
+        std::this_thread::sleep_for(abs_time - now);
+    }
+}
+
+void ThisThread::yield()
+{
+    std::this_thread::yield();
+}
+
+static thread_local const char* this_thread_name = "main";
+static thread_local osThreadId_t this_thread_id = nullptr;
+
+const char* ThisThread::get_name()
+{
+    return this_thread_name;
+}
+
+osThreadId_t ThisThread::get_id()
+{
+    return this_thread_id;
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * Semaphore
+ * --------------------------------------------------------------------------------------------------- */
+
+void Semaphore::acquire()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return count_ > 0; });
+    count_--;
+}
+
+bool Semaphore::try_acquire()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (count_ == 0)
+    {
+        return false;
+    }
+    count_--;
+    return true;
+}
+
+bool Semaphore::try_acquire_for(Kernel::Clock::duration_u32 rel_time)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!cv_.wait_for(lock, rel_time, [this] { return count_ > 0; }))
+    {
+        return false;
+    }
+    count_--;
+    return true;
+}
+
+osStatus Semaphore::release()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ >= max_count_)
+        {
+            return osErrorResource;
+        }
+        count_++;
+    }
+    cv_.notify_one();
+    return osOK;
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * EventFlags
+ * --------------------------------------------------------------------------------------------------- */
+
+uint32_t EventFlags::set(uint32_t flags)
+{
+    uint32_t result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        flags_ |= flags;
+        result = flags_;
+    }
+    cv_.notify_all();
+    return result;
+}
+
+uint32_t EventFlags::clear(uint32_t flags)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t result = flags_;
+    flags_ &= ~flags;
+    return result;
+}
+
+uint32_t EventFlags::get() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return flags_;
+}
+
+uint32_t EventFlags::wait_all(uint32_t flags, uint32_t millisec, bool clear)
+{
+    return Wait(flags, millisec, clear, true);
+}
+
+uint32_t EventFlags::wait_any(uint32_t flags, uint32_t millisec, bool clear)
+{
+    return Wait(flags, millisec, clear, false);
+}
+
+uint32_t EventFlags::wait_all_for(uint32_t flags, Kernel::Clock::duration_u32 rel_time, bool clear)
+{
+    return Wait(flags, rel_time.count(), clear, true);
+}
+
+uint32_t EventFlags::wait_any_for(uint32_t flags, Kernel::Clock::duration_u32 rel_time, bool clear)
+{
+    return Wait(flags, rel_time.count(), clear, false);
+}
+
+uint32_t EventFlags::Wait(uint32_t flags, uint32_t millisec, bool clear, bool all)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto satisfied = [this, flags, all] { return all ? (flags_ & flags) == flags : (flags_ & flags) != 0; };
+
+    if (millisec == osWaitForever)
+    {
+        cv_.wait(lock, satisfied);
+    }
+    else if (!cv_.wait_for(lock, std::chrono::milliseconds(millisec), satisfied))
+    {
+        return osFlagsErrorTimeout;
+    }
+
+    uint32_t result = flags_;
+    if (clear)
+    {
+        flags_ &= ~flags;
+    }
+    return result;
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * Thread
+ * --------------------------------------------------------------------------------------------------- */
+
+Thread::Thread(osPriority priority, uint32_t stack_size, unsigned char* stack_mem, const char* name)
+    : priority_(priority), stack_size_(stack_size), name_(name), state_(Inactive)
+{
+}
+
+Thread::~Thread()
+{
+    if (thread_.joinable())
+    {
+        thread_.detach();
+    }
+}
+
+osStatus Thread::start(mbed::Callback<void()> task)
+{
+    if (state_ != Inactive)
+    {
+        return osErrorParameter;
+    }
+
+    state_ = Running;
+    thread_ = std::thread([this, task] {
+        this_thread_name = name_ ? name_ : "application_unnamed_thread";
+        this_thread_id = (osThreadId_t)this;
+        task();
+        state_ = Deleted;
+    });
+    return osOK;
+}
+
+osStatus Thread::join()
+{
+    if (!thread_.joinable())
+    {
+        return osErrorResource;
+    }
+    thread_.join();
+    return osOK;
+}
+
+osStatus Thread::terminate()
+{
+    /* std::thread cannot be cancelled; the thread is abandoned instead */
+    if (thread_.joinable())
+    {
+        thread_.detach();
+    }
+    state_ = Deleted;
+    return osOK;
+}
+
+}  // namespace rtos
+
+namespace mbed {
+
+/* ---------------------------------------------------------------------------------------------------
+ * Timer
+ * --------------------------------------------------------------------------------------------------- */
+
+void Timer::start()
+{
+    if (!running_)
+    {
+        start_us_ = HostUs();
+        running_ = true;
+    }
+}
+
+void Timer::stop()
+{
+    if (running_)
+    {
+        elapsed_us_ += HostUs() - start_us_;
+        running_ = false;
+    }
+}
+
+void Timer::reset()
+{
+    elapsed_us_ = 0;
+    start_us_ = HostUs();
+}
+
+std::chrono::microseconds Timer::elapsed_time()
+{
+    uint64_t elapsed = elapsed_us_;
+    if (running_)
+    {
+        elapsed += HostUs() - start_us_;
+    }
+    return std::chrono::microseconds(elapsed);
+}
+
+int Timer::read_us()
+{
+    return (int)elapsed_time().count();
+}
+
+int Timer::read_ms()
+{
+    return (int)(elapsed_time().count() / 1000);
+}
+
+float Timer::read()
+{
+    return elapsed_time().count() / 1000000.0f;
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * LowPowerTicker
+ * --------------------------------------------------------------------------------------------------- */
+
+void LowPowerTicker::attach(Callback<void()> func, std::chrono::microseconds period)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    const uint32_t generation = ++generation_;
+
+    std::thread([this, func, period, generation]() {
+        uint64_t next_us = HostUs() + period.count();
+        while (1)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(next_us - std::min(next_us, HostUs())));
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (generation_ != generation)
+                {
+                    return;
+                }
+            }
+            func();
+            next_us += period.count();
+        }
+    }).detach();
+}
+
+void LowPowerTicker::detach()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    generation_++;
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * Watchdog
+ * --------------------------------------------------------------------------------------------------- */
+
+Watchdog& Watchdog::get_instance()
+{
+    static Watchdog instance;
+    return instance;
+}
+
+bool Watchdog::start(uint32_t timeout)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_)
+    {
+        return false;
+    }
+
+    timeout_ms_ = timeout;
+    last_kick_ms_ = HostMs();
+    running_ = true;
+    std::thread(&Watchdog::Monitor, this).detach();
+    return true;
+}
+
+bool Watchdog::start()
+{
+    return start(get_max_timeout());
+}
+
+bool Watchdog::stop()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+    kicked_.notify_all();
+    return true;
+}
+
+void Watchdog::kick()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_kick_ms_ = HostMs();
+}
+
+/**
+ *  @brief  Resets the host process when the watchdog is not kicked within its timeout.
+ *  @author Lee Tze Han
+ */
+void Watchdog::Monitor()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_)
+    {
+        uint64_t deadline = last_kick_ms_ + timeout_ms_;
+        uint64_t now = HostMs();
+        if (now >= deadline)
+        {
+            fflush(stdout);
+            fprintf(stderr, "\r\n[HOST] Watchdog reset (not kicked for %lu ms)\r\n", (unsigned long)timeout_ms_);
+            _Exit(EXIT_FAILURE);
+        }
+        kicked_.wait_for(lock, std::chrono::milliseconds(deadline - now));
+    }
+}
+
+}  // namespace mbed
+
+/** @}*/
@@ -0,0 +1,240 @@
+/**
+ * @defgroup host_network Host Network Stand-in
+ * @{
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "mbed.h"
+#include "NetworkInterface.h"
+#include "TCPSocket.h"
+#include "NTPClient.h"
+
+namespace {
+
+std::mutex hosts_mutex;
+std::map<std::string, std::string> hosts;
+
+}  // namespace
+
+void HostNetworkAddHost(const char* host, const char* ip)
+{
+    std::lock_guard<std::mutex> lock(hosts_mutex);
+    hosts[host] = ip;
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * SocketAddress
+ * --------------------------------------------------------------------------------------------------- */
+
+SocketAddress::SocketAddress(const char* addr, uint16_t port) : port_(port)
+{
+    memset(&addr_, 0, sizeof(addr_));
+    ip_[0] = '\0';
+    set_ip_address(addr);
+}
+
+bool SocketAddress::set_ip_address(const char* addr)
+{
+    struct in_addr in;
+    if (addr == NULL || inet_pton(AF_INET, addr, &in) != 1)
+    {
+        ip_[0] = '\0';
+        return false;
+    }
+    set_in_addr(in);
+    return true;
+}
+
+void SocketAddress::set_in_addr(const struct in_addr& addr)
+{
+    addr_ = addr;
+    inet_ntop(AF_INET, &addr_, ip_, sizeof(ip_));
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * NetworkInterface
+ * --------------------------------------------------------------------------------------------------- */
+
+nsapi_error_t NetworkInterface::get_ip_address(SocketAddress* address)
+{
+    address->set_ip_address("127.0.0.1");
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t NetworkInterface::gethostbyname(const char* host, SocketAddress* address,
+                                              nsapi_version_t version, const char* interface_name)
+{
+    {
+        std::lock_guard<std::mutex> lock(hosts_mutex);
+        auto it = hosts.find(host);
+        if (it != hosts.end())
+        {
+            return address->set_ip_address(it->second.c_str()) ? NSAPI_ERROR_OK : NSAPI_ERROR_DNS_FAILURE;
+        }
+    }
+
+    if (address->set_ip_address(host))
+    {
+        return NSAPI_ERROR_OK;
+    }
+
+    struct addrinfo hints;
+    struct addrinfo* result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, NULL, &hints, &result) != 0 || result == NULL)
+    {
+        return NSAPI_ERROR_DNS_FAILURE;
+    }
+
+    address->set_in_addr(((struct sockaddr_in*)result->ai_addr)->sin_addr);
+    freeaddrinfo(result);
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_value_or_error_t NetworkInterface::gethostbyname_async(const char* host, hostbyname_cb_t callback,
+                                                             nsapi_version_t version, const char* interface_name)
+{
+    std::string name(host);
+    std::thread([this, name, callback, version]() {
+        SocketAddress address;
+        nsapi_error_t rc = gethostbyname(name.c_str(), &address, version);
+        callback(rc, (rc == NSAPI_ERROR_OK) ? &address : NULL);
+    }).detach();
+
+    /* Positive id of the pending lookup */
+    return 1;
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * Socket
+ * --------------------------------------------------------------------------------------------------- */
+
+nsapi_error_t Socket::open(NetworkInterface* stack)
+{
+    if (fd_ >= 0)
+    {
+        return NSAPI_ERROR_PARAMETER;
+    }
+
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd_ < 0)
+    {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    int one = 1;
+    setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t Socket::close()
+{
+    if (fd_ < 0)
+    {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    /* Wakes a thread blocked in recv(), as closing a socket does on the target */
+    shutdown(fd_, SHUT_RDWR);
+    ::close(fd_);
+    fd_ = -1;
+    return NSAPI_ERROR_OK;
+}
+
+nsapi_error_t Socket::connect(const SocketAddress& address)
+{
+    if (fd_ < 0)
+    {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(address.get_port());
+    addr.sin_addr = address.get_in_addr();
+
+    if (::connect(fd_, (struct sockaddr*)&addr, sizeof(addr)) != 0)
+    {
+        return (errno == EISCONN) ? NSAPI_ERROR_IS_CONNECTED : NSAPI_ERROR_NO_CONNECTION;
+    }
+    return NSAPI_ERROR_OK;
+}
+
+void Socket::set_timeout(int timeout)
+{
+    timeout_ms_ = timeout;
+}
+
+nsapi_size_or_error_t Socket::send(const void* data, nsapi_size_t size)
+{
+    if (fd_ < 0)
+    {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    struct pollfd pfd = {fd_, POLLOUT, 0};
+    if (timeout_ms_ >= 0 && poll(&pfd, 1, timeout_ms_) == 0)
+    {
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    ssize_t sent = ::send(fd_, data, size, MSG_NOSIGNAL);
+    return (sent < 0) ? NSAPI_ERROR_CONNECTION_LOST : (nsapi_size_or_error_t)sent;
+}
+
+nsapi_size_or_error_t Socket::recv(void* data, nsapi_size_t size)
+{
+    if (fd_ < 0)
+    {
+        return NSAPI_ERROR_NO_SOCKET;
+    }
+
+    struct pollfd pfd = {fd_, POLLIN, 0};
+    if (timeout_ms_ >= 0 && poll(&pfd, 1, timeout_ms_) == 0)
+    {
+        return NSAPI_ERROR_WOULD_BLOCK;
+    }
+
+    ssize_t received = ::recv(fd_, data, size, 0);
+    return (received < 0) ? NSAPI_ERROR_CONNECTION_LOST : (nsapi_size_or_error_t)received;
+}
+
+nsapi_error_t TCPSocket::connect(const char* host, uint16_t port)
+{
+    SocketAddress address;
+    NetworkInterface network;
+    nsapi_error_t rc = network.gethostbyname(host, &address);
+    if (rc != NSAPI_ERROR_OK)
+    {
+        return rc;
+    }
+
+    address.set_port(port);
+    return Socket::connect(address);
+}
+
+/* ---------------------------------------------------------------------------------------------------
+ * NTPClient
+ * --------------------------------------------------------------------------------------------------- */
+
+time_t NTPClient::get_timestamp(int timeout)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return now.tv_sec;
+}
+
+/** @}*/
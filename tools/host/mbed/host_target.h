@@ -0,0 +1,39 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_TARGET_H
+#define HOST_TARGET_H
+
+#include <stdint.h>
+
+/* Force-included into every host translation unit, in place of the target macros of mbed_app.json */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 96-bit device UID, standing in for the factory-programmed UID of the STM32 */
+extern const uint32_t host_device_uid[3];
+
+#ifdef __cplusplus
+}
+#endif
+
+#define DEVICE_UID_ADDR ((uintptr_t)host_device_uid)
+
+/** The host kernel has no tick interrupt */
+#define MBED_TICKLESS
+
+#endif  // HOST_TARGET_H
@@ -0,0 +1,49 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_KVSTORE_GLOBAL_API_H
+#define HOST_KVSTORE_GLOBAL_API_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* mbed_error.h status codes returned by the KVStore API */
+#define MBED_SUCCESS                    0
+#define MBED_ERROR_INVALID_ARGUMENT     ((int)0x80FF0101)
+#define MBED_ERROR_ITEM_NOT_FOUND       ((int)0x80FF0117)
+#define MBED_ERROR_INVALID_SIZE         ((int)0x80FF0108)
+
+#define MBED_GET_ERROR_CODE(error)      ((int)((uint32_t)(error) & 0x0000FFFF))
+
+#define KV_WRITE_ONCE_FLAG              (1 << 0)
+#define KV_REQUIRE_CONFIDENTIALITY_FLAG (1 << 1)
+#define KV_RESERVED_FLAG                (1 << 2)
+#define KV_REQUIRE_REPLAY_PROTECTION_FLAG (1 << 3)
+
+#define KV_MAX_KEY_LENGTH               128
+
+typedef struct info {
+    size_t size;
+    uint32_t flags;
+} kv_info_t;
+
+/* Host stand-in for the global KVStore API; entries live in process memory and are lost on exit */
+int kv_set(const char* full_name_key, const void* buffer, size_t size, uint32_t create_flags);
+int kv_get(const char* full_name_key, void* buffer, size_t buffer_size, size_t* actual_size);
+int kv_get_info(const char* full_name_key, kv_info_t* info);
+int kv_remove(const char* full_name_key);
+int kv_reset(const char* kvstore_path);
+
+#endif  // HOST_KVSTORE_GLOBAL_API_H
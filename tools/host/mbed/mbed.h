@@ -0,0 +1,247 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_MBED_H
+#define HOST_MBED_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <string>
+#include "PinNames.h"
+#include "cmsis.h"
+#include "Callback.h"
+#include "rtos.h"
+
+/* Host stand-in for the mbed-os 6.5.0 APIs used by the application core */
+#define MBED_MAJOR_VERSION  6
+#define MBED_MINOR_VERSION  5
+#define MBED_PATCH_VERSION  0
+
+#define MBED_ENCODE_VERSION(major, minor, patch) ((major)*10000 + (minor)*100 + (patch))
+#define MBED_VERSION MBED_ENCODE_VERSION(MBED_MAJOR_VERSION, MBED_MINOR_VERSION, MBED_PATCH_VERSION)
+
+#define MBED_UNUSED         __attribute__((__unused__))
+#define MBED_WEAK           __attribute__((weak))
+#define MBED_NORETURN       __attribute__((noreturn))
+
+#define NSAPI_SECURITY_WPA_WPA2 4
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Sets the RTC; time() reports the new value from then on */
+void set_time(time_t t);
+
+/** Busy-waits, as on the target */
+void wait_us(int us);
+
+/** Reports the reset and terminates the host process */
+MBED_NORETURN void NVIC_SystemReset(void);
+
+/** Critical sections nest; on the host they exclude the other application threads */
+void core_util_critical_section_enter(void);
+void core_util_critical_section_exit(void);
+
+/** CPU statistics of mbed_stats.h, in microseconds; sleep is the wall time the host process spent off-CPU */
+typedef struct {
+    uint64_t uptime;
+    uint64_t idle_time;
+    uint64_t sleep_time;
+    uint64_t deep_sleep_time;
+} mbed_stats_cpu_t;
+
+void mbed_stats_cpu_get(mbed_stats_cpu_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+namespace mbed {
+
+/** Timer class.
+ *  @brief  Host stand-in for mbed::Timer, on the monotonic clock
+ */
+class Timer
+{
+    public:
+        Timer() : running_(false), elapsed_us_(0), start_us_(0) {}
+
+        void start();
+        void stop();
+        void reset();
+        int read_ms();
+        int read_us();
+        float read();
+        std::chrono::microseconds elapsed_time();
+
+    private:
+        bool running_;
+        uint64_t elapsed_us_;
+        uint64_t start_us_;
+};
+
+/** I2C class.
+ *  @brief  Host stand-in for mbed::I2C, addressing the device models registered with HostI2CAttach()
+ *
+ *  Addresses are 8-bit, as on the target. Returns 0 on ACK and non-zero on NACK.
+ */
+class I2C
+{
+    public:
+        enum Acknowledge {
+            NoACK = 0,
+            ACK = 1
+        };
+
+        I2C(PinName sda, PinName scl);
+
+        void frequency(int hz) { frequency_ = hz; }
+        int read(int address, char* data, int length, bool repeated = false);
+        int write(int address, const char* data, int length, bool repeated = false);
+        int read(int ack);
+        int write(int data);
+        void start(void) {}
+        void stop(void) {}
+        void lock(void) {}
+        void unlock(void) {}
+
+    private:
+        PinName sda_;
+        PinName scl_;
+        int frequency_;
+};
+
+/** DigitalIn class.
+ *  @brief  Host stand-in for mbed::DigitalIn; reads the level driven onto the pin by HostPinWrite()
+ */
+class DigitalIn
+{
+    public:
+        DigitalIn(PinName pin) : pin_(pin) {}
+        DigitalIn(PinName pin, PinMode mode) : pin_(pin) {}
+
+        int read();
+        void mode(PinMode pull) {}
+        int is_connected() { return pin_ != NC; }
+        operator int() { return read(); }
+
+    private:
+        PinName pin_;
+};
+
+/** DigitalOut class.
+ *  @brief  Host stand-in for mbed::DigitalOut; drives the pin level seen by DigitalIn
+ */
+class DigitalOut
+{
+    public:
+        DigitalOut(PinName pin) : pin_(pin) {}
+        DigitalOut(PinName pin, int value) : pin_(pin) { write(value); }
+
+        void write(int value);
+        int read();
+        int is_connected() { return pin_ != NC; }
+        DigitalOut& operator=(int value) { write(value); return *this; }
+        operator int() { return read(); }
+
+    private:
+        PinName pin_;
+};
+
+/** Watchdog class.
+ *  @brief  Host stand-in for mbed::Watchdog; the process is terminated when the timeout elapses without a kick
+ */
+class Watchdog
+{
+    public:
+        static Watchdog& get_instance();
+
+        bool start(uint32_t timeout);
+        bool start();
+        bool stop();
+        void kick();
+        uint32_t get_timeout() const { return timeout_ms_; }
+        uint32_t get_max_timeout() const { return 32760; }
+        bool is_running() const { return running_; }
+
+    private:
+        Watchdog() : timeout_ms_(0), running_(false) {}
+        void Monitor();
+
+        uint32_t timeout_ms_;
+        volatile bool running_;
+        std::mutex mutex_;
+        std::condition_variable kicked_;
+        uint64_t last_kick_ms_;
+};
+
+/** LowPowerTicker class.
+ *  @brief  Host stand-in for mbed::LowPowerTicker; the callback runs on a host thread in place of the interrupt
+ */
+class LowPowerTicker
+{
+    public:
+        LowPowerTicker() : generation_(0) {}
+        ~LowPowerTicker() { detach(); }
+
+        void attach(Callback<void()> func, std::chrono::microseconds period);
+        void detach();
+
+    private:
+        std::mutex mutex_;
+        uint32_t generation_;           /// bumped by attach and detach, ending the thread of the previous attach
+};
+
+/** FileHandle class.
+ *  @brief  Host stand-in for mbed::FileHandle over a POSIX file descriptor
+ */
+class FileHandle
+{
+    public:
+        explicit FileHandle(int fd) : fd_(fd) {}
+
+        ssize_t read(void* buffer, size_t size);
+        ssize_t write(const void* buffer, size_t size);
+        bool readable() const;
+        bool writable() const { return true; }
+
+    private:
+        int fd_;
+};
+
+/** File handle of a standard stream (STDIN_FILENO, STDOUT_FILENO or STDERR_FILENO), or NULL */
+FileHandle* mbed_file_handle(int fd);
+
+}  // namespace mbed
+
+/* Network stack; the target reaches these through the netsocket feature */
+#include "NetworkInterface.h"
+#include "EthernetInterface.h"
+#include "TCPSocket.h"
+#include "TLSSocket.h"
+
+using namespace mbed;
+using namespace std;
+using namespace std::chrono_literals;
+
+#endif  // HOST_MBED_H
@@ -0,0 +1,78 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_MBED_TRACE_H
+#define HOST_MBED_TRACE_H
+
+#include <stdint.h>
+
+#define TRACE_LEVEL_DEBUG       0x10
+#define TRACE_LEVEL_INFO        0x08
+#define TRACE_LEVEL_WARN        0x04
+#define TRACE_LEVEL_ERROR       0x02
+#define TRACE_LEVEL_CMD         0x01
+
+#define TRACE_ACTIVE_LEVEL_ALL  0x1F
+
+#ifndef MBED_TRACE_MAX_LEVEL
+#define MBED_TRACE_MAX_LEVEL    TRACE_LEVEL_INFO
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Enables trace output; nothing is printed before the first call, as on the target */
+int mbed_trace_init(void);
+void mbed_trace_free(void);
+void mbed_trace_config_set(uint8_t config);
+uint8_t mbed_trace_config_get(void);
+void mbed_tracef(uint8_t dlevel, const char* grp, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+
+#ifdef __cplusplus
+}
+#endif
+
+#if MBED_TRACE_MAX_LEVEL >= TRACE_LEVEL_DEBUG
+#define tr_debug(...)   mbed_tracef(TRACE_LEVEL_DEBUG, TRACE_GROUP, __VA_ARGS__)
+#else
+#define tr_debug(...)
+#endif
+
+#if MBED_TRACE_MAX_LEVEL >= TRACE_LEVEL_INFO
+#define tr_info(...)    mbed_tracef(TRACE_LEVEL_INFO, TRACE_GROUP, __VA_ARGS__)
+#else
+#define tr_info(...)
+#endif
+
+#if MBED_TRACE_MAX_LEVEL >= TRACE_LEVEL_WARN
+#define tr_warning(...) mbed_tracef(TRACE_LEVEL_WARN, TRACE_GROUP, __VA_ARGS__)
+#define tr_warn(...)    mbed_tracef(TRACE_LEVEL_WARN, TRACE_GROUP, __VA_ARGS__)
+#else
+#define tr_warning(...)
+#define tr_warn(...)
+#endif
+
+#if MBED_TRACE_MAX_LEVEL >= TRACE_LEVEL_ERROR
+#define tr_error(...)   mbed_tracef(TRACE_LEVEL_ERROR, TRACE_GROUP, __VA_ARGS__)
+#define tr_err(...)     mbed_tracef(TRACE_LEVEL_ERROR, TRACE_GROUP, __VA_ARGS__)
+#else
+#define tr_error(...)
+#define tr_err(...)
+#endif
+
+#define tr_cmdline(...) mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, __VA_ARGS__)
+
+#endif  // HOST_MBED_TRACE_H
@@ -0,0 +1,333 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef HOST_RTOS_H
+#define HOST_RTOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include "Callback.h"
+
+/* CMSIS-RTOS2 definitions used by the application */
+typedef int32_t osStatus;
+typedef void* osThreadId_t;
+#define osOK                0
+#define osError             -1
+#define osErrorTimeout      -2
+#define osErrorResource     -3
+#define osErrorParameter    -4
+#define osWaitForever       0xFFFFFFFFU
+#define osFlagsError        0x80000000U     // set in the result of a failed EventFlags wait
+#define osFlagsErrorTimeout 0xFFFFFFFEU
+
+typedef enum {
+    osPriorityIdle = 1,
+    osPriorityLow = 8,
+    osPriorityBelowNormal = 16,
+    osPriorityNormal = 24,
+    osPriorityAboveNormal = 32,
+    osPriorityHigh = 40,
+    osPriorityRealtime = 48
+} osPriority;
+
+#define OS_STACK_SIZE       4096
+
+namespace rtos {
+
+namespace Kernel {
+
+/** Kernel::Clock, milliseconds since the host process started */
+struct Clock
+{
+    using duration = std::chrono::milliseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<Clock>;
+    using duration_u32 = std::chrono::duration<uint32_t, std::milli>;
+    static constexpr bool is_steady = true;
+
+    static time_point now();
+};
+
+constexpr Clock::duration_u32 wait_for_u32_forever{osWaitForever};
+constexpr Clock::duration_u32 wait_for_u32_max{osWaitForever - 1};
+
+uint64_t get_ms_count();
+
+}  // namespace Kernel
+
+namespace ThisThread {
+
+void sleep_for(Kernel::Clock::duration_u32 rel_time);
+void sleep_for(uint32_t millisec);
+void sleep_until(Kernel::Clock::time_point abs_time);
+void yield();
+const char* get_name();
+osThreadId_t get_id();
+
+}  // namespace ThisThread
+
+/** Mutex class.
+ *  @brief  Host stand-in for rtos::Mutex; recursive, as on the target
+ */
+class Mutex
+{
+    public:
+        Mutex() {}
+        Mutex(const char* name) {}
+
+        void lock() { mutex_.lock(); }
+        bool trylock() { return mutex_.try_lock(); }
+        bool trylock_for(Kernel::Clock::duration_u32 rel_time) { return mutex_.try_lock_for(rel_time); }
+        void unlock() { mutex_.unlock(); }
+
+    private:
+        std::recursive_timed_mutex mutex_;
+};
+
+/** Semaphore class.
+ *  @brief  Host stand-in for rtos::Semaphore
+ */
+class Semaphore
+{
+    public:
+        Semaphore(int32_t count = 0, uint16_t max_count = 0xffff) : count_(count), max_count_(max_count) {}
+
+        void acquire();
+        bool try_acquire();
+        bool try_acquire_for(Kernel::Clock::duration_u32 rel_time);
+        osStatus release();
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        int32_t count_;
+        uint16_t max_count_;
+};
+
+/** EventFlags class.
+ *  @brief  Host stand-in for rtos::EventFlags
+ */
+class EventFlags
+{
+    public:
+        EventFlags() : flags_(0) {}
+        EventFlags(const char* name) : flags_(0) {}
+
+        uint32_t set(uint32_t flags);
+        uint32_t clear(uint32_t flags = 0x7fffffff);
+        uint32_t get() const;
+        uint32_t wait_all(uint32_t flags = 0, uint32_t millisec = osWaitForever, bool clear = true);
+        uint32_t wait_any(uint32_t flags = 0, uint32_t millisec = osWaitForever, bool clear = true);
+        uint32_t wait_all_for(uint32_t flags, Kernel::Clock::duration_u32 rel_time, bool clear = true);
+        uint32_t wait_any_for(uint32_t flags, Kernel::Clock::duration_u32 rel_time, bool clear = true);
+
+    private:
+        uint32_t Wait(uint32_t flags, uint32_t millisec, bool clear, bool all);
+
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        uint32_t flags_;
+};
+
+/** Thread class.
+ *  @brief  Host stand-in for rtos::Thread, backed by std::thread
+ *
+ *  Priorities are recorded but not enforced, and the stack is sized by the host. Threads still running
+ *  when the Thread object is destroyed are detached, as a target thread would keep running until reset.
+ */
+class Thread
+{
+    public:
+        enum State {
+            Inactive,
+            Ready,
+            Running,
+            WaitingDelay,
+            WaitingJoin,
+            WaitingThreadFlag,
+            WaitingEventFlag,
+            WaitingMutex,
+            WaitingSemaphore,
+            WaitingMemoryPool,
+            WaitingMessageGet,
+            WaitingMessagePut,
+            WaitingInterval,
+            WaitingOr,
+            WaitingAnd,
+            WaitingMailbox,
+            Deleted = 0x7fffffff
+        };
+
+        Thread(osPriority priority = osPriorityNormal, uint32_t stack_size = OS_STACK_SIZE,
+               unsigned char* stack_mem = nullptr, const char* name = nullptr);
+        ~Thread();
+
+        osStatus start(mbed::Callback<void()> task);
+        osStatus join();
+        osStatus terminate();
+
+        osPriority get_priority() const { return priority_; }
+        osStatus set_priority(osPriority priority) { priority_ = priority; return osOK; }
+        State get_state() const { return state_; }
+        const char* get_name() const { return name_; }
+        uint32_t stack_size() const { return stack_size_; }
+        uint32_t max_stack() const { return 0; }        /// no stack watermark on the host
+        osThreadId_t get_id() const { return state_ == Inactive ? nullptr : (osThreadId_t)this; }
+
+    private:
+        std::thread thread_;
+        osPriority priority_;
+        uint32_t stack_size_;
+        const char* name_;
+        volatile State state_;
+};
+
+/** Mail class.
+ *  @brief  Host stand-in for rtos::Mail; a fixed pool of queue_sz slots and a FIFO of posted slots
+ */
+template <typename T, uint32_t queue_sz>
+class Mail
+{
+    public:
+        Mail() : num_free_(queue_sz)
+        {
+            for (uint32_t i = 0; i < queue_sz; i++)
+            {
+                used_[i] = false;
+            }
+        }
+
+        bool empty() const { std::lock_guard<std::mutex> lock(mutex_); return queue_.empty(); }
+        bool full() const { std::lock_guard<std::mutex> lock(mutex_); return queue_.size() >= queue_sz; }
+
+        T* try_alloc() { return Allocate(false); }
+        T* try_calloc() { return Allocate(true); }
+        T* try_alloc_for(Kernel::Clock::duration_u32 rel_time) { return AllocateFor(false, rel_time); }
+        T* try_calloc_for(Kernel::Clock::duration_u32 rel_time) { return AllocateFor(true, rel_time); }
+
+        osStatus put(T* mptr)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.push_back(mptr);
+            }
+            posted_.notify_one();
+            return osOK;
+        }
+
+        T* try_get()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return Pop();
+        }
+
+        T* try_get_for(Kernel::Clock::duration_u32 rel_time)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (rel_time == Kernel::wait_for_u32_forever)
+            {
+                posted_.wait(lock, [this] { return !queue_.empty(); });
+            }
+            else
+            {
+                posted_.wait_for(lock, rel_time, [this] { return !queue_.empty(); });
+            }
+            return Pop();
+        }
+
+        osStatus free(T* mptr)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                size_t index = reinterpret_cast<Slot*>(mptr) - slots_;
+                if (index >= queue_sz || !used_[index])
+                {
+                    return osErrorParameter;
+                }
+                used_[index] = false;
+                num_free_++;
+            }
+            freed_.notify_one();
+            return osOK;
+        }
+
+    private:
+        typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Slot;
+
+        T* Allocate(bool zero)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return AllocateLocked(zero);
+        }
+
+        T* AllocateFor(bool zero, Kernel::Clock::duration_u32 rel_time)
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            freed_.wait_for(lock, rel_time, [this] { return num_free_ > 0; });
+            return AllocateLocked(zero);
+        }
+
+        T* AllocateLocked(bool zero)
+        {
+            for (uint32_t i = 0; i < queue_sz; i++)
+            {
+                if (!used_[i])
+                {
+                    used_[i] = true;
+                    num_free_--;
+                    if (zero)
+                    {
+                        memset(&slots_[i], 0, sizeof(Slot));
+                    }
+                    return reinterpret_cast<T*>(&slots_[i]);
+                }
+            }
+            return nullptr;
+        }
+
+        T* Pop()
+        {
+            if (queue_.empty())
+            {
+                return nullptr;
+            }
+            T* mptr = queue_.front();
+            queue_.pop_front();
+            return mptr;
+        }
+
+        mutable std::mutex mutex_;
+        std::condition_variable posted_;
+        std::condition_variable freed_;
+        std::deque<T*> queue_;
+        Slot slots_[queue_sz];
+        bool used_[queue_sz];
+        uint32_t num_free_;
+};
+
+}  // namespace rtos
+
+using namespace rtos;
+
+#endif  // HOST_RTOS_H
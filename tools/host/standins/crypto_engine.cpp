@@ -0,0 +1,31 @@
+/**
+ * @defgroup crypto_engine_host Crypto Engine (Host)
+ * @{
+ */
+
+#include <stdio.h>
+#include <openssl/sha.h>
+#include "crypto_engine.h"
+
+/**
+ *  @brief  Generic SHA256 Signature Generator.
+ *  @author Lee Tze Han
+ *  @param  input  Content required to generate signature
+ *  @return C++ string containing 64-character hexadecimal representation of signature
+ */
+std::string CryptoEngine::GenericSHA256Generator(std::string input)
+{
+    unsigned char output[SHA256_DIGEST_LENGTH];
+    SHA256((const unsigned char*)input.c_str(), input.size(), output);
+
+    char converted[SHA256_DIGEST_LENGTH*2 + 1];
+    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++)
+    {
+        snprintf(&converted[i*2], sizeof(converted) - (i*2), "%02X", output[i]);
+    }
+    converted[SHA256_DIGEST_LENGTH*2] = '\0';
+
+    return converted;
+}
+
+/** @}*/
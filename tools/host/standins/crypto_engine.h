@@ -0,0 +1,40 @@
+/*******************************************************************************************************
+ * Copyright (c) 2018-2020 Government Technology Agency of Singapore (GovTech)
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND,
+ * either express or implied.
+ *
+ * See the License for the specific language governing permissions and limitations under the License.
+ *******************************************************************************************************/
+#ifndef CRYPTO_ENGINE_H
+#define CRYPTO_ENGINE_H
+
+#include <string>
+#include "mbed.h"
+#include "persist_store.h"
+
+/** CryptoEngine class.
+ *  @brief  Host stand-in for the mbedTLS CryptoEngine of src/CryptoEngine
+ *
+ *  The host session to the local cloud stand-ins is not encrypted, so no keypair or CSR is generated
+ *  (csr_ stays empty and DecadaManager skips certificate signing). SHA-256 is computed with OpenSSL.
+ */
+class CryptoEngine
+{
+    public:
+        CryptoEngine(void) : csr_("") {}
+
+        static std::string GenericSHA256Generator(std::string input);
+
+    protected:
+        std::string csr_;
+};
+
+#endif  // CRYPTO_ENGINE_H